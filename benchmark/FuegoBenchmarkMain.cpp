@@ -0,0 +1,405 @@
+//----------------------------------------------------------------------------
+/** @file FuegoBenchmarkMain.cpp
+    Main function for FuegoBenchmark.
+
+    Replays the main lines of the games in a corpus of SGF files and times
+    the board operations used by the search (GoBoard, GoUctBoard and the
+    playout policy). Optionally, the benchmarks are also run on games with
+    random moves (see GoBoardCheckPerformance::RandomGames()). The results
+    are written as tab-separated lines (see
+    GoBoardCheckPerformance::WriteResult()), one line per benchmark, corpus
+    and board size, such that the output of different versions can be
+    compared with standard tools. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include "GoBoard.h"
+#include "GoBoardCheckPerformance.h"
+#include "GoBoardUpdater.h"
+#include "GoInit.h"
+#include "GoUctBoard.h"
+#include "GoUctPlayoutPolicy.h"
+#include "SgDebug.h"
+#include "SgException.h"
+#include "SgGameReader.h"
+#include "SgInit.h"
+#include "SgNode.h"
+#include "SgRandom.h"
+#include "SgTime.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/cmdline.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/program_options/parsers.hpp>
+
+using std::map;
+using std::string;
+using std::vector;
+using GoBoardCheckPerformance::Game;
+using GoBoardCheckPerformance::Result;
+namespace fs = boost::filesystem;
+namespace po = boost::program_options;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** @name Settings from command line options */
+// @{
+
+vector<string> g_files;
+
+int g_nuRandomGames;
+
+int g_nuRepetitions;
+
+int g_size;
+
+int g_seed;
+
+// @} // @name
+
+/** A playout is started in every PLAYOUT_INTERVAL-th position of a game. */
+const int PLAYOUT_INTERVAL = 10;
+
+/** Read the main line of the first game in a SGF file.
+    The game ends at the first move that is not legal on a GoBoard with
+    the default rules, is not played by the color to play, or at the first
+    setup property after the root node, because GoUctBoard cannot replay
+    such moves. Files without moves are used if they contain setup stones,
+    e.g. the test positions in regression/sgf/safetytest-whole-board. */
+void ReadGame(const string& fileName, vector<Game>& games)
+{
+    std::ifstream in(fileName.c_str());
+    if (! in)
+        throw SgException("could not open " + fileName);
+    SgGameReader reader(in);
+    SgNode* root = reader.ReadGame();
+    if (root == 0)
+    {
+        SgDebug() << "FuegoBenchmark: no game in " << fileName << '\n';
+        return;
+    }
+    GoBoard bd;
+    GoBoardUpdater().Update(root, bd);
+    for (const SgNode* node = root->LeftMostSon(); node != 0;
+         node = node->LeftMostSon())
+    {
+        if (  node->HasProp(SG_PROP_ADD_BLACK)
+           || node->HasProp(SG_PROP_ADD_WHITE)
+           || node->HasProp(SG_PROP_ADD_EMPTY)
+           )
+            break;
+        if (! node->HasNodeMove())
+            continue;
+        const SgPoint p = node->NodeMove();
+        if (  node->NodePlayer() != bd.ToPlay()
+           || (p != SG_PASS && ! bd.IsLegal(p))
+           )
+            break;
+        bd.Play(p);
+    }
+    root->DeleteTree();
+    if (bd.MoveNumber() > 0 || bd.Occupied().NonEmpty())
+        games.push_back(Game(bd));
+}
+
+/** Read all games in a SGF file or in the SGF files of a directory tree.
+    Files are read in sorted order, such that the checksums of the
+    benchmarks do not depend on the order of the directory entries. */
+void ReadGames(const string& fileName, map<int,vector<Game> >& games)
+{
+    vector<string> files;
+    if (fs::is_directory(fileName))
+    {
+        for (fs::recursive_directory_iterator it(fileName);
+             it != fs::recursive_directory_iterator(); ++it)
+            if (  fs::is_regular_file(it->status())
+               && it->path().extension() == ".sgf"
+               )
+                files.push_back(it->path().string());
+        std::sort(files.begin(), files.end());
+    }
+    else
+        files.push_back(fileName);
+    for (vector<string>::const_iterator it = files.begin();
+         it != files.end(); ++it)
+    {
+        vector<Game> fileGames;
+        ReadGame(*it, fileGames);
+        for (vector<Game>::const_iterator game = fileGames.begin();
+             game != fileGames.end(); ++game)
+            if (g_size == 0 || game->m_size == g_size)
+                games[game->m_size].push_back(*game);
+    }
+}
+
+/** Operation for UctBoardInit(). */
+class UctBoardInitOp
+{
+public:
+    explicit UctBoardInitOp(const GoBoard& bd)
+        : m_uctBd(bd)
+    { }
+
+    void operator()(GoBoard& bd, Result& result)
+    {
+        ++result.m_nuOperations;
+        m_uctBd.Init(bd);
+        result.m_checksum += m_uctBd.NumEmpty();
+    }
+
+private:
+    GoUctBoard m_uctBd;
+};
+
+/** Call GoUctBoard::Init() in all positions of the games.
+    Operations: Init calls. The time includes replaying the games on a
+    GoBoard. */
+Result UctBoardInit(const vector<Game>& games, int nuRepetitions)
+{
+    Result result("gouctboard_init");
+    GoBoard bd;
+    UctBoardInitOp op(bd);
+    GoBoardCheckPerformance::TimePositions(games, nuRepetitions, bd, op,
+                                           result);
+    return result;
+}
+
+/** Benchmark for UctBoardPlay(). */
+class UctBoardPlayBenchmark
+{
+public:
+    UctBoardPlayBenchmark()
+        : m_uctBd(m_bd)
+    { }
+
+    void Init(const Game& game)
+    {
+        m_bd.Init(game.m_size, game.m_setup);
+        m_uctBd.Init(m_bd);
+    }
+
+    void Run(const Game& game, Result& result)
+    {
+        for (vector<GoPlayerMove>::const_iterator move =
+                 game.m_moves.begin(); move != game.m_moves.end(); ++move)
+        {
+            m_uctBd.Play(move->Point());
+            result.m_checksum += m_uctBd.NumEmpty();
+        }
+        result.m_nuOperations += game.m_moves.size();
+    }
+
+private:
+    GoBoard m_bd;
+
+    GoUctBoard m_uctBd;
+};
+
+/** Replay the games with GoUctBoard::Play().
+    Operations: Play calls. */
+Result UctBoardPlay(const vector<Game>& games, int nuRepetitions)
+{
+    Result result("gouctboard_play");
+    UctBoardPlayBenchmark benchmark;
+    GoBoardCheckPerformance::TimeGames(games, nuRepetitions, benchmark,
+                                       result);
+    return result;
+}
+
+/** Run playouts with the default GoUctPlayoutPolicy.
+    A playout is started in every PLAYOUT_INTERVAL-th position of the games
+    and ends after two passes or 3 * size * size moves. Adds two results:
+    operations are playouts for the first and playout moves for the
+    second. */
+void Playouts(const vector<Game>& games, int nuRepetitions,
+              vector<Result>& results)
+{
+    Result result("gouct_playout");
+    Result resultMoves("gouct_playout_move");
+    SgRandom::SetSeed(g_seed);
+    GoBoard bd;
+    GoUctBoard uctBd(bd);
+    GoUctPlayoutPolicyParam param;
+    for (vector<Game>::const_iterator it = games.begin(); it != games.end();
+         ++it)
+    {
+        bd.Init(it->m_size, it->m_setup);
+        uctBd.Init(bd);
+        GoUctPlayoutPolicy<GoUctBoard> policy(uctBd, param);
+        const int maxLength = 3 * it->m_size * it->m_size;
+        for (std::size_t j = 0; j <= it->m_moves.size(); ++j)
+        {
+            if (j % PLAYOUT_INTERVAL == 0)
+            {
+                const double startTime = SgTime::Get(SG_TIME_REAL);
+                for (int i = 0; i < nuRepetitions; ++i)
+                {
+                    uctBd.Init(bd);
+                    policy.StartPlayout();
+                    int nuPass = 0;
+                    int length = 0;
+                    for ( ; length < maxLength && nuPass < 2; ++length)
+                    {
+                        const SgPoint move = policy.GenerateMove();
+                        nuPass = (move == SG_PASS ? nuPass + 1 : 0);
+                        uctBd.Play(move);
+                        policy.OnPlay();
+                    }
+                    policy.EndPlayout();
+                    ++result.m_nuOperations;
+                    resultMoves.m_nuOperations += length;
+                    result.m_checksum += uctBd.NumPrisoners(SG_BLACK);
+                    resultMoves.m_checksum += length;
+                }
+                result.m_time += SgTime::Get(SG_TIME_REAL) - startTime;
+            }
+            if (j < it->m_moves.size())
+                bd.Play(it->m_moves[j]);
+        }
+    }
+    resultMoves.m_time = result.m_time;
+    results.push_back(result);
+    results.push_back(resultMoves);
+}
+
+/** Run all benchmarks on the games of a corpus, grouped by board size. */
+void RunBenchmarks(const string& corpus, const map<int,vector<Game> >& games)
+{
+    for (map<int,vector<Game> >::const_iterator it = games.begin();
+         it != games.end(); ++it)
+    {
+        const int size = it->first;
+        std::size_t nuMoves = 0;
+        for (vector<Game>::const_iterator game = it->second.begin();
+             game != it->second.end(); ++game)
+            nuMoves += game->m_moves.size();
+        std::cout << "# " << corpus << " size " << size << ": "
+                  << it->second.size() << " games, " << nuMoves
+                  << " moves\n";
+        vector<Result> results;
+        GoBoardCheckPerformance::RunBenchmarks(it->second, g_nuRepetitions,
+                                               results);
+        results.push_back(UctBoardInit(it->second, g_nuRepetitions));
+        results.push_back(UctBoardPlay(it->second, g_nuRepetitions));
+        Playouts(it->second, g_nuRepetitions, results);
+        for (vector<Result>::const_iterator result = results.begin();
+             result != results.end(); ++result)
+            GoBoardCheckPerformance::WriteResult(std::cout, corpus, size,
+                                                 *result);
+        std::cout.flush();
+    }
+}
+
+void RunBenchmarks()
+{
+    map<int,vector<Game> > games;
+    for (vector<string>::const_iterator it = g_files.begin();
+         it != g_files.end(); ++it)
+        ReadGames(*it, games);
+    map<int,vector<Game> > randomGames;
+    if (g_nuRandomGames > 0)
+    {
+        SgRandom::SetSeed(g_seed);
+        vector<int> sizes;
+        if (g_size != 0)
+            sizes.push_back(g_size);
+        else
+        {
+            sizes.push_back(9);
+            sizes.push_back(13);
+            sizes.push_back(19);
+        }
+        for (vector<int>::const_iterator it = sizes.begin();
+             it != sizes.end(); ++it)
+            GoBoardCheckPerformance::RandomGames(*it, g_nuRandomGames,
+                                                 randomGames[*it]);
+    }
+    GoBoardCheckPerformance::WriteHeader(std::cout);
+    RunBenchmarks("sgf", games);
+    RunBenchmarks("random", randomGames);
+}
+
+void Help(po::options_description& desc)
+{
+    std::cout << "Usage: fuego_benchmark [options] [file|directory...]\n"
+              << "Options:\n" << desc << '\n';
+    exit(1);
+}
+
+void ParseOptions(int argc, char** argv)
+{
+    po::options_description desc;
+    desc.add_options()
+        ("help", "displays this help and exit")
+        ("quiet", "don't print debug messages")
+        ("random-games",
+         po::value<int>(&g_nuRandomGames)->default_value(0),
+         "number of games with random moves per board size")
+        ("repeat",
+         po::value<int>(&g_nuRepetitions)->default_value(5),
+         "number of times each game is replayed")
+        ("size",
+         po::value<int>(&g_size)->default_value(0),
+         "use only games with this board size (0: all)")
+        ("srand",
+         po::value<int>(&g_seed)->default_value(1),
+         "random seed for the playouts (0: time(0))");
+    po::options_description hidden;
+    hidden.add_options()
+        ("files", po::value<vector<string> >(&g_files), "input files");
+    po::options_description allOptions;
+    allOptions.add(desc).add(hidden);
+    po::positional_options_description positional;
+    positional.add("files", -1);
+    po::variables_map vm;
+    try
+    {
+        po::store(po::command_line_parser(argc, argv).options(allOptions)
+                  .positional(positional).run(), vm);
+        po::notify(vm);
+    }
+    catch (...)
+    {
+        Help(desc);
+    }
+    if (  vm.count("help")
+       || (g_files.empty() && g_nuRandomGames == 0)
+       || g_nuRepetitions < 1
+       )
+        Help(desc);
+    if (vm.count("quiet"))
+        SgDebugToNull();
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    ParseOptions(argc, argv);
+    try
+    {
+        SgInit();
+        GoInit();
+        RunBenchmarks();
+        GoFini();
+        SgFini();
+    }
+    catch (const std::exception& e)
+    {
+        SgDebug() << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
+
+//----------------------------------------------------------------------------
@@ -16,8 +16,11 @@
 #include <boost/program_options/parsers.hpp>
 #include <boost/utility.hpp>
 #include "FuegoMainEngine.h"
+#include "FuegoMainServer.h"
 #include "FuegoMainUtil.h"
+#include "GoBook.h"
 #include "GoInit.h"
+#include "GoUctPatternDatabase.h"
 #include "SgDebug.h"
 #include "SgException.h"
 #include "SgInit.h"
@@ -39,6 +42,12 @@ namespace {
 /** Use opening book */
 bool g_useBook = true;
 
+/** Load pattern database from a known path */
+bool g_usePatternDatabase = true;
+
+/** Pattern database file, overrides the known paths */
+string g_patternDatabase;
+
 /** Allow handicap games */
 bool g_allowHandicap = true;
 
@@ -48,6 +57,9 @@ int g_fixedBoardSize;
 
 int g_maxGames;
 
+/** Run a server for several games on this port, 0 for the normal mode */
+int g_serverPort;
+
 string g_config;
 
 const char* g_programPath;
@@ -105,7 +117,14 @@ void ParseOptions(int argc, char** argv)
          "make clear_board fail after n invocations")
         ("nobook", "don't automatically load opening book")
         ("nohandicap", "don't support handicap commands")
+        ("nopatterns", "don't automatically load pattern database")
+        ("patterns",
+         po::value<std::string>(&g_patternDatabase)->default_value(""),
+         "load pattern database from file")
         ("quiet", "don't print debug messages")
+        ("server",
+         po::value<int>(&g_serverPort)->default_value(0),
+         "play one game per connection to this local port")
         ("srand", 
          po::value<int>(&g_srand)->default_value(0),
          "set random seed (-1:none, 0:time(0))")
@@ -137,6 +156,8 @@ void ParseOptions(int argc, char** argv)
         g_useBook = false;
     if (vm.count("nohandicap"))
         g_allowHandicap = false;
+    if (vm.count("nopatterns"))
+        g_usePatternDatabase = false;
     if (vm.count("quiet"))
         g_quiet = true;
 }
@@ -180,6 +201,26 @@ int main(int argc, char** argv)
         GoInit();
         PrintStartupMessage();
         SgRandom::SetSeed(g_srand);
+        // Must be opened before the engine creates the player
+        if (g_patternDatabase != "")
+            GoUctPatternDatabase::Global().Open(g_patternDatabase);
+        else if (g_usePatternDatabase)
+            FuegoMainUtil::LoadPatternDatabase(SgPlatform::GetProgramDir());
+        if (g_serverPort > 0)
+        {
+            GoBook book;
+            FuegoMainServer server(g_fixedBoardSize, g_programPath,
+                                   ! g_allowHandicap);
+            if (g_useBook)
+            {
+                FuegoMainUtil::LoadBook(book, SgPlatform::GetProgramDir());
+                server.SetBook(&book);
+            }
+            server.SetMaxGames(g_maxGames);
+            server.SetConfig(g_config);
+            server.Run(g_serverPort);
+            return 0;
+        }
         FuegoMainEngine engine(g_fixedBoardSize, g_programPath, ! g_allowHandicap);
         GoGtpAssertionHandler assertionHandler(engine);
         if (g_maxGames >= 0)
@@ -0,0 +1,136 @@
+//----------------------------------------------------------------------------
+/** @file FuegoMainServer.cpp
+    See FuegoMainServer.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "FuegoMainServer.h"
+
+#include <boost/asio.hpp>
+#include <boost/format.hpp>
+#include <boost/thread/thread.hpp>
+#include "FuegoMainEngine.h"
+#include "SgDebug.h"
+#include "SgException.h"
+#include "SgRandom.h"
+
+using boost::asio::ip::tcp;
+
+//----------------------------------------------------------------------------
+
+/** The connection of a session. */
+class FuegoMainServer::Stream
+    : public tcp::iostream
+{
+};
+
+//----------------------------------------------------------------------------
+
+FuegoMainServer::Session::Session(FuegoMainServer& server,
+                                  boost::shared_ptr<Stream> stream, int id)
+    : m_server(server),
+      m_stream(stream),
+      m_id(id)
+{ }
+
+void FuegoMainServer::Session::operator()()
+{
+    m_server.RunSession(*m_stream, m_id);
+}
+
+//----------------------------------------------------------------------------
+
+FuegoMainServer::FuegoMainServer(int fixedBoardSize,
+                                 const char* programPath, bool noHandicap)
+    : m_fixedBoardSize(fixedBoardSize),
+      m_programPath(programPath),
+      m_noHandicap(noHandicap),
+      m_book(0),
+      m_maxGames(-1),
+      m_nuSessions(0),
+      m_nuActiveSessions(0)
+{ }
+
+void FuegoMainServer::Run(int port)
+{
+    boost::asio::io_service ioService;
+    tcp::acceptor acceptor(ioService);
+    try
+    {
+        const tcp::endpoint
+            endpoint(boost::asio::ip::address_v4::loopback(), port);
+        acceptor.open(endpoint.protocol());
+        acceptor.set_option(tcp::acceptor::reuse_address(true));
+        acceptor.bind(endpoint);
+        acceptor.listen();
+    }
+    catch (const boost::system::system_error& e)
+    {
+        throw SgException(boost::format("Could not open port %1%: %2%")
+                          % port % e.what());
+    }
+    // Changing the seed or engine would reset the random generators used
+    // by the searches of all sessions
+    SgRandom::LockSettings();
+    SgDebug() << "FuegoMainServer: listening on port " << port << '\n';
+    while (true)
+    {
+        boost::shared_ptr<Stream> stream(new Stream());
+        boost::system::error_code error;
+#if BOOST_VERSION >= 106600
+        acceptor.accept(stream->socket(), error);
+#else
+        acceptor.accept(*stream->rdbuf(), error);
+#endif
+        if (error)
+        {
+            SgWarning() << "FuegoMainServer: " << error.message() << '\n';
+            continue;
+        }
+        boost::thread thread(Session(*this, stream, ++m_nuSessions));
+        thread.detach();
+    }
+}
+
+void FuegoMainServer::RunSession(Stream& stream, int id)
+{
+    // Declared before the engine, which uses it until it is destroyed
+    volatile bool userAbort = false;
+    SgSetUserAbortFlag(&userAbort);
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        ++m_nuActiveSessions;
+        SgDebug() << "FuegoMainServer: starting session " << id << " ("
+                  << m_nuActiveSessions << " active)\n";
+    }
+    try
+    {
+        FuegoMainEngine engine(m_fixedBoardSize, m_programPath,
+                               m_noHandicap);
+        engine.SetSharedBook(m_book);
+        if (m_maxGames >= 0)
+            engine.SetMaxClearBoard(m_maxGames);
+        if (m_config != "")
+            engine.ExecuteFile(m_config, SgDebug());
+        GtpInputStream in(stream);
+        GtpOutputStream out(stream);
+        engine.MainLoop(in, out);
+    }
+    catch (const GtpFailure& e)
+    {
+        SgWarning() << "FuegoMainServer: session " << id << ": "
+                    << e.Response() << '\n';
+    }
+    catch (const std::exception& e)
+    {
+        SgWarning() << "FuegoMainServer: session " << id << ": "
+                    << e.what() << '\n';
+    }
+    SgSetUserAbortFlag(0);
+    boost::mutex::scoped_lock lock(m_mutex);
+    --m_nuActiveSessions;
+    SgDebug() << "FuegoMainServer: finished session " << id << " ("
+              << m_nuActiveSessions << " active)\n";
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,143 @@
+//----------------------------------------------------------------------------
+/** @file FuegoMainServer.h */
+//----------------------------------------------------------------------------
+
+#ifndef FUEGOMAIN_SERVER_H
+#define FUEGOMAIN_SERVER_H
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+class GoBook;
+
+//----------------------------------------------------------------------------
+
+/** Server that plays several games at the same time in one process.
+    Accepts GTP connections on a TCP port of the local host. Each
+    connection gets its own FuegoMainEngine, which runs in its own thread
+    and reads the commands from the connection and writes the responses
+    to it, like the engine of the normal mode with standard input and
+    output. The connection is closed after the quit command.
+
+    The sessions share the data that does not change during a game, so
+    an additional game needs much less memory than an additional process:
+    the opening book (see GoGtpEngine::SetSharedBook()), the pattern
+    database GoUctPatternDatabase::Global(), the Greenpeep pattern values
+    (see GoUctKnowledgeFactory::GreenpeepParam()) and the ladder cache
+    GoLadderCache::Global(), if it is enabled. Each session has its own
+    user abort flag (see SgSetUserAbortFlag()), so interrupting or stopping
+    the pondering of one game does not abort the searches of the others.
+    The random seed and engine are shared, too, and are locked when the
+    server starts (see SgRandom::LockSettings()), so commands like
+    <tt>set_random_seed</tt> or <tt>reg_genmove</tt> fail in the sessions.
+    The seed can be set with the option --srand.
+
+    The search tree of each player is allocated while it grows, its
+    maximum size can be limited with the command
+    <tt>uct_max_memory</tt> in the configuration file, which is executed
+    for each session. Some state is still global: the debug stream
+    SgDebug() is shared by all sessions, so the server should run with
+    the option --quiet, and engine features that redirect it (like
+    <tt>go_param debug_to_comment</tt>) must not be used. */
+class FuegoMainServer
+{
+public:
+    /** Constructor.
+        @param fixedBoardSize See GoGtpEngine::GoGtpEngine()
+        @param programPath See GoGtpEngine::GoGtpEngine()
+        @param noHandicap See GoGtpEngine::GoGtpEngine() */
+    FuegoMainServer(int fixedBoardSize, const char* programPath,
+                    bool noHandicap);
+
+    /** Opening book used by all sessions.
+        If a book is set, the book commands that modify the book, like
+        <tt>book_load</tt>, fail in the sessions. Without a shared book,
+        each session can load its own book in the configuration file.
+        @param book The book (not owned), 0 for no book (default) */
+    void SetBook(const GoBook* book);
+
+    /** File with GTP commands executed at the start of each session.
+        Default is no file. */
+    void SetConfig(const std::string& fileName);
+
+    /** See GoGtpEngine::SetMaxClearBoard().
+        Default is -1 (no limit). */
+    void SetMaxGames(int n);
+
+    /** Accept connections and run the sessions.
+        Does not return, unless the port cannot be opened.
+        @param port The port on the local host (127.0.0.1)
+        @throws SgException if the port cannot be opened. */
+    void Run(int port);
+
+private:
+    class Stream;
+
+    /** Function object for the thread of a session. */
+    class Session
+    {
+    public:
+        Session(FuegoMainServer& server, boost::shared_ptr<Stream> stream,
+                int id);
+
+        void operator()();
+
+    private:
+        FuegoMainServer& m_server;
+
+        boost::shared_ptr<Stream> m_stream;
+
+        int m_id;
+    };
+
+    friend class Session;
+
+    const int m_fixedBoardSize;
+
+    const char* m_programPath;
+
+    const bool m_noHandicap;
+
+    const GoBook* m_book;
+
+    std::string m_config;
+
+    int m_maxGames;
+
+    /** Number of sessions started since the server was started. */
+    int m_nuSessions;
+
+    /** Number of running sessions. */
+    int m_nuActiveSessions;
+
+    /** Protects m_nuActiveSessions. */
+    boost::mutex m_mutex;
+
+    /** Not implemented. */
+    FuegoMainServer(const FuegoMainServer&);
+
+    /** Not implemented. */
+    FuegoMainServer& operator=(const FuegoMainServer&);
+
+    void RunSession(Stream& stream, int id);
+};
+
+inline void FuegoMainServer::SetBook(const GoBook* book)
+{
+    m_book = book;
+}
+
+inline void FuegoMainServer::SetConfig(const std::string& fileName)
+{
+    m_config = fileName;
+}
+
+inline void FuegoMainServer::SetMaxGames(int n)
+{
+    m_maxGames = n;
+}
+
+//----------------------------------------------------------------------------
+
+#endif // FUEGOMAIN_SERVER_H
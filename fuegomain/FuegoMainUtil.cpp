@@ -10,6 +10,7 @@
 #include <fstream>
 #include <sstream>
 #include "GoBook.h"
+#include "GoUctPatternDatabase.h"
 #include "SgDebug.h"
 #include "SgStringUtil.h"
 
@@ -31,7 +32,30 @@ bool LoadBookFile(GoBook& book, const path& file)
     }
     try
     {
-        book.Read(in);
+        // Also detects binary books, see GoBinaryBook
+        book.Read(nativeFile);
+    }
+    catch (const SgException& e)
+    {
+        SgDebug() << "error: " << e.what() << '\n';
+        return false;
+    }
+    SgDebug() << "ok\n";
+    return true;
+}
+
+bool LoadPatternDatabaseFile(const path& file)
+{
+    std::string nativeFile = SgStringUtil::GetNativeFileName(file);
+    SgDebug() << "Loading pattern database from '" << nativeFile << "'... ";
+    if (! exists(file))
+    {
+        SgDebug() << "not found\n";
+        return false;
+    }
+    try
+    {
+        GoUctPatternDatabase::Global().Open(nativeFile);
     }
     catch (const SgException& e)
     {
@@ -63,6 +87,26 @@ void FuegoMainUtil::LoadBook(GoBook& book,
     throw SgException("Could not find opening book.");
 }
 
+bool FuegoMainUtil::LoadPatternDatabase(const path& programDir)
+{
+    const std::string fileName = "patterns.dat";
+    #ifdef ABS_TOP_SRCDIR
+        if (LoadPatternDatabaseFile(path(ABS_TOP_SRCDIR) / "book" / fileName))
+            return true;
+    #endif
+    if (LoadPatternDatabaseFile(programDir / fileName))
+        return true;
+    #if defined(DATADIR) && defined(PACKAGE)
+        if (LoadPatternDatabaseFile(path(DATADIR) / PACKAGE / fileName))
+            return true;
+    #endif
+    #ifdef DISABLE_BUILTIN_PATTERNS
+        SgWarning() << "no pattern database, Greenpeep knowledge and "
+                       "playout patterns are disabled\n";
+    #endif
+    return false;
+}
+
 std::string FuegoMainUtil::Version()
 {
     std::ostringstream s;
@@ -27,6 +27,15 @@ namespace FuegoMainUtil
         @throws SgException, if book is not found */
     void LoadBook(GoBook& book, const path& programDir);
 
+    /** Try to open the pattern database GoUctPatternDatabase::Global()
+        from the same set of paths as LoadBook().
+        The file name is "patterns.dat". If no database is found, the
+        pattern tables compiled into the program are used.
+        @param programDir the directory of the executable (may be a relative
+        path or an empty string)
+        @return @c true if a database was opened */
+    bool LoadPatternDatabase(const path& programDir);
+
     /** Return Fuego version.
         If the macro VERSION was defined by the build system during compile
         time, its value is used as the version, otherwise the version
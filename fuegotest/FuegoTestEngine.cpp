@@ -8,8 +8,12 @@
 
 #include <boost/preprocessor/stringize.hpp>
 #include <boost/algorithm/string.hpp>
+#include <fstream>
+#include <boost/filesystem.hpp>
 #include "GoGtpCommandUtil.h"
 #include "GoGtpExtraCommands.h"
+#include "GoUctAdditiveKnowledgeGreenpeep.h"
+#include "GoUctPatternDatabase.h"
 #include "SpAveragePlayer.h"
 #include "SpCapturePlayer.h"
 #include "SpDumbTacticalPlayer.h"
@@ -34,6 +38,13 @@ FuegoTestEngine::FuegoTestEngine(int fixedBoardSize, const char* programPath,
       m_safetyCommands(Board())
 {
     Register("fuegotest_param", &FuegoTestEngine::CmdParam, this);
+    Register("pattern_db_write", &FuegoTestEngine::CmdPatternDbWrite, this);
+    Register("pattern_train_add", &FuegoTestEngine::CmdPatternTrainAdd, this);
+    Register("pattern_train_clear", &FuegoTestEngine::CmdPatternTrainClear,
+             this);
+    Register("pattern_train_fit", &FuegoTestEngine::CmdPatternTrainFit, this);
+    Register("pattern_train_write", &FuegoTestEngine::CmdPatternTrainWrite,
+             this);
     m_extraCommands.Register(*this);
     m_safetyCommands.Register(*this);
     SetPlayer(player);
@@ -100,6 +111,114 @@ void FuegoTestEngine::CmdParam(GtpCommand& cmd)
         throw GtpFailure() << "need 0 or 2 arguments";
 }
 
+/** Write the pattern tables compiled into the program to a pattern
+    database.
+    The file can be used by fuego with the option --patterns, or installed
+    as patterns.dat to be loaded automatically by a program configured with
+    --disable-builtin-patterns.
+    Arguments: file name @n
+    Returns: number of Greenpeep patterns (9x9 and 19x19) and number of
+    gamma table entries (global and local)
+    @see GoUctPatternDatabase */
+void FuegoTestEngine::CmdPatternDbWrite(GtpCommand& cmd)
+{
+    cmd.CheckNuArg(1);
+    const string fileName = cmd.Arg(0);
+    std::vector<GoUctPatternDatabase::GreenpeepEntry> greenpeep9;
+    std::vector<GoUctPatternDatabase::GreenpeepEntry> greenpeep19;
+    GoUctAdditiveKnowledgeParamGreenpeep::GetBuiltinPatterns(9, greenpeep9);
+    GoUctAdditiveKnowledgeParamGreenpeep::GetBuiltinPatterns(19,
+                                                             greenpeep19);
+    const GoUctPatternData::PatternData& global =
+        GoUctPatternData::BuiltinGlobalData();
+    const GoUctPatternData::PatternData& local =
+        GoUctPatternData::BuiltinLocalData();
+    std::ofstream out(fileName.c_str(), std::ios::binary);
+    if (! out)
+        throw GtpFailure() << "could not open " << fileName;
+    GoUctPatternDatabase::Write(out, greenpeep9, greenpeep19, global, local);
+    out.close();
+    if (! out)
+        throw GtpFailure() << "could not write " << fileName;
+    int nuGamma = 0;
+    for (SgBWIterator it; it; ++it)
+        nuGamma += global.m_edgePatterns[*it].m_nuPatterns
+                 + global.m_centerPatterns[*it].m_nuPatterns
+                 + local.m_edgePatterns[*it].m_nuPatterns
+                 + local.m_centerPatterns[*it].m_nuPatterns;
+    cmd << (greenpeep9.size() + greenpeep19.size()) << ' ' << nuGamma;
+}
+
+/** Add games to the pattern trainer.
+    Adds all games of an SGF file or of all SGF files in a directory and its
+    subdirectories.
+    Arguments: file or directory @n
+    Returns: number of games and total number of competitions
+    @see GoUctPatternTrainer */
+void FuegoTestEngine::CmdPatternTrainAdd(GtpCommand& cmd)
+{
+    cmd.CheckNuArg(1);
+    const string path = cmd.Arg(0);
+    int nuGames;
+    try
+    {
+        if (boost::filesystem::is_directory(path))
+            nuGames = m_patternTrainer.AddDirectory(path);
+        else
+            nuGames = m_patternTrainer.AddFile(path);
+    }
+    catch (const SgException& e)
+    {
+        throw GtpFailure(e.what());
+    }
+    cmd << nuGames << ' ' << m_patternTrainer.NuCompetitions();
+}
+
+/** Remove all games from the pattern trainer.
+    Arguments: optional table type local|global (default global) */
+void FuegoTestEngine::CmdPatternTrainClear(GtpCommand& cmd)
+{
+    cmd.CheckNuArgLessEqual(1);
+    GoUctPatternGammaTable::TableType type =
+        GoUctPatternGammaTable::TABLE_GLOBAL;
+    if (cmd.NuArg() == 1)
+    {
+        const string arg = cmd.Arg(0);
+        if (arg == "local")
+            type = GoUctPatternGammaTable::TABLE_LOCAL;
+        else if (arg != "global")
+            throw GtpFailure() << "unknown table type: " << arg;
+    }
+    m_patternTrainer.SetTableType(type);
+}
+
+/** Run iterations of the pattern trainer.
+    Arguments: number of iterations @n
+    Returns: average log-likelihood of the games */
+void FuegoTestEngine::CmdPatternTrainFit(GtpCommand& cmd)
+{
+    cmd.CheckNuArg(1);
+    cmd << m_patternTrainer.Train(cmd.ArgMin<int>(0, 1));
+}
+
+/** Write the gammas of the pattern trainer.
+    The file can be loaded with uct_load_pattern_gammas.
+    Arguments: file name */
+void FuegoTestEngine::CmdPatternTrainWrite(GtpCommand& cmd)
+{
+    cmd.CheckNuArg(1);
+    GoUctPatternGammaTable table;
+    m_patternTrainer.GetTable(table);
+    try
+    {
+        table.Write(cmd.Arg(0));
+    }
+    catch (const SgException& e)
+    {
+        throw GtpFailure(e.what());
+    }
+}
+
 void FuegoTestEngine::CmdVersion(GtpCommand& cmd)
 {
 #ifdef VERSION
@@ -8,6 +8,7 @@
 #include "GoGtpEngine.h"
 #include "GoGtpExtraCommands.h"
 #include "GoSafetyCommands.h"
+#include "GoUctPatternTrainer.h"
 
 //----------------------------------------------------------------------------
 
@@ -28,10 +29,20 @@ public:
     ~FuegoTestEngine();
 
     /** @page fuegotestenginecommands FuegoTestEngine Commands
-        - @link CmdParam() @c fuegotest_param @endlink */
+        - @link CmdParam() @c fuegotest_param @endlink
+        - @link CmdPatternDbWrite() @c pattern_db_write @endlink
+        - @link CmdPatternTrainAdd() @c pattern_train_add @endlink
+        - @link CmdPatternTrainClear() @c pattern_train_clear @endlink
+        - @link CmdPatternTrainFit() @c pattern_train_fit @endlink
+        - @link CmdPatternTrainWrite() @c pattern_train_write @endlink */
     void CmdAnalyzeCommands(GtpCommand& cmd);
     void CmdName(GtpCommand& cmd);
     void CmdParam(GtpCommand& cmd);
+    void CmdPatternDbWrite(GtpCommand& cmd);
+    void CmdPatternTrainAdd(GtpCommand& cmd);
+    void CmdPatternTrainClear(GtpCommand& cmd);
+    void CmdPatternTrainFit(GtpCommand& cmd);
+    void CmdPatternTrainWrite(GtpCommand& cmd);
     void CmdVersion(GtpCommand& cmd);
 
 private:
@@ -39,6 +50,9 @@ private:
 
     GoSafetyCommands m_safetyCommands;
 
+    /** Used by the pattern_train commands. */
+    GoUctPatternTrainer m_patternTrainer;
+
     /** Player ID as in CreatePlayer() */
     std::string m_playerId;
 
@@ -6,12 +6,15 @@
 #include "SgSystem.h"
 #include "GoAutoBook.h"
 
+#include <boost/filesystem.hpp>
+
 //----------------------------------------------------------------------------
 
 GoAutoBookState::GoAutoBookState(const GoBoard& brd)
     : m_synchronizer(brd)
 {
-    m_synchronizer.SetSubscriber(m_brd[0]);
+    m_synchronizer.SetSubscriber(m_brd);
+    m_hash.Init(m_brd);
 }
 
 GoAutoBookState::~GoAutoBookState()
@@ -19,50 +22,136 @@ GoAutoBookState::~GoAutoBookState()
 
 SgHashCode GoAutoBookState::GetHashCode() const
 {
-    return m_hash;
+    return m_hash.Canonical();
 }
 
 void GoAutoBookState::Synchronize()
 {
     m_synchronizer.UpdateSubscriber();
-    int size = m_brd[0].Size();
-    int numMoves = m_brd[0].MoveNumber();
-    for (int rot = 1; rot < 8; ++rot)
-    {
-        m_brd[rot].Init(size, size);
-        for (int i = 0; i < numMoves; ++i)
-        {
-            SgMove move = m_brd[0].Move(i).Point();
-            m_brd[rot].Play(SgPointUtil::Rotate(rot, move, size));
-        }
-    }
-    ComputeHashCode();
+    m_hash.Init(m_brd);
 }
 
 void GoAutoBookState::Play(SgMove move)
 {
-    m_hash = m_brd[0].GetHashCodeInclToPlay();
-    for (int rot = 0; rot < 8; ++rot)
-        m_brd[rot].Play(SgPointUtil::Rotate(rot, move, m_brd[0].Size()));
-    ComputeHashCode();
+    m_brd.Play(move);
+    m_hash.Play(m_brd);
 }
 
 void GoAutoBookState::Undo()
 {
+    m_brd.Undo();
+    m_hash.Undo();
+}
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Start of the first line of a book file, followed by the version.
+    Version 2 uses the hash codes of GoCanonicalHash. Earlier versions did
+    not write the version line. */
+const std::string VERSION_PREFIX = "#GoAutoBook ";
+
+const int FORMAT_VERSION = 2;
+
+/** Parse a line of a book or journal file.
+    @return false if the line is too short to contain a node or is the
+    version line. */
+bool ParseLine(const std::string& line, SgHashCode& hash, SgBookNode& node)
+{
+    if (line.size() < 19 || line[0] == '#')
+        return false;
+    std::string str;
+    std::istringstream iss(line);
+    iss >> str;
+    hash.FromString(str);
+    node = SgBookNode(line.substr(19));
+    return true;
+}
+
+/** Read the nodes of a book or journal file without checking the version
+    and ignoring lines that cannot be parsed. */
+void ReadNodes(const std::string& fileName,
+               std::map<SgHashCode, SgBookNode>& data)
+{
+    std::ifstream in(fileName.c_str());
+    std::string line;
+    while (std::getline(in, line))
+    {
+        SgHashCode hash;
+        SgBookNode node;
+        if (ParseLine(line, hash, node))
+            data[hash] = node;
+    }
+}
+
+void WriteLine(std::ostream& out, const SgHashCode& hash,
+               const SgBookNode& node)
+{
+    out << hash.ToString() << '\t' << node.ToString() << '\n';
+}
+
+void WriteVersion(std::ostream& out)
+{
+    out << VERSION_PREFIX << FORMAT_VERSION << '\n';
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+/** Hash codes of the book files without version line.
+    Computes the smallest hash code of eight boards with the transformed
+    moves. Only needed for converting old books, see GoAutoBook::Upgrade() */
+class GoAutoBook::OldHashState
+{
+public:
+    OldHashState(const GoBoard& bd);
+
+    SgHashCode GetHashCode() const;
+
+    void Play(SgMove move);
+
+    void Undo();
+
+private:
+    GoBoard m_brd[8];
+};
+
+GoAutoBook::OldHashState::OldHashState(const GoBoard& bd)
+{
+    const int size = bd.Size();
     for (int rot = 0; rot < 8; ++rot)
-        m_brd[rot].Undo();
-    ComputeHashCode();
+    {
+        m_brd[rot].Init(size, size);
+        for (int i = 0; i < bd.MoveNumber(); ++i)
+            m_brd[rot].Play(SgPointUtil::Rotate(rot, bd.Move(i).Point(),
+                                                size));
+    }
 }
 
-void GoAutoBookState::ComputeHashCode()
+SgHashCode GoAutoBook::OldHashState::GetHashCode() const
 {
-    m_hash = m_brd[0].GetHashCodeInclToPlay();
+    SgHashCode hash = m_brd[0].GetHashCodeInclToPlay();
     for (int rot = 1; rot < 8; ++rot)
     {
         SgHashCode curHash = m_brd[rot].GetHashCodeInclToPlay();
-        if (curHash < m_hash)
-            m_hash = curHash;
+        if (curHash < hash)
+            hash = curHash;
     }
+    return hash;
+}
+
+void GoAutoBook::OldHashState::Play(SgMove move)
+{
+    for (int rot = 0; rot < 8; ++rot)
+        m_brd[rot].Play(SgPointUtil::Rotate(rot, move, m_brd[0].Size()));
+}
+
+void GoAutoBook::OldHashState::Undo()
+{
+    for (int rot = 0; rot < 8; ++rot)
+        m_brd[rot].Undo();
 }
 
 //----------------------------------------------------------------------------
@@ -77,34 +166,55 @@ GoAutoBookParam::GoAutoBookParam()
 GoAutoBook::GoAutoBook(const std::string& filename,
                        const GoAutoBookParam& param)
     : m_param(param), 
-      m_filename(filename)
+      m_filename(filename),
+      m_nuJournalEntries(0)
 {
+    if (GoBinaryBook::IsBinaryBook(filename))
+    {
+        m_binaryBook.Open(filename);
+        SgDebug() << "GoAutoBook: Mapped " << m_binaryBook.NuEntries()
+                  << " nodes.\n";
+        return;
+    }
     std::ifstream is(filename.c_str());
     if (! is)
     {
         std::ofstream of(filename.c_str());
         if (! of)
             throw SgException("Invalid file name!");
+        WriteVersion(of);
         of.close();
     }
     else
     {
-        while (is)
+        std::string line;
+        std::getline(is, line);
+        if (line.compare(0, VERSION_PREFIX.size(), VERSION_PREFIX) == 0)
+        {
+            std::istringstream in(line.substr(VERSION_PREFIX.size()));
+            int version;
+            in >> version;
+            if (! in || version != FORMAT_VERSION)
+                throw SgException("unknown autobook version in "
+                                  + filename);
+        }
+        else if (! is.eof() || ! line.empty()
+                 || boost::filesystem::exists(JournalFileName()))
+            // A file without version line is empty only if it was created
+            // by the current version
+            throw SgException(filename + " has the hash codes of an old"
+                              " autobook version, convert it with"
+                              " autobook_upgrade");
+        while (std::getline(is, line))
         {
-            std::string line;
-            std::getline(is, line);
-            if (line.size() < 19)
-                continue;
-            std::string str;
-            std::istringstream iss(line);
-            iss >> str;
             SgHashCode hash;
-            hash.FromString(str);
-            SgBookNode node(line.substr(19));
-            m_data[hash] = node;
+            SgBookNode node;
+            if (ParseLine(line, hash, node))
+                m_data[hash] = node;
         }
         SgDebug() << "GoAutoBook: Parsed " << m_data.size() << " lines.\n";
     }
+    ReadJournal();
 }
 
 GoAutoBook::~GoAutoBook()
@@ -112,6 +222,8 @@ GoAutoBook::~GoAutoBook()
 
 bool GoAutoBook::Get(const GoAutoBookState& state, SgBookNode& node) const
 {
+    if (m_binaryBook.IsOpen())
+        return m_binaryBook.LookupNode(state.GetHashCode(), node);
     Map::const_iterator it = m_data.find(state.GetHashCode());
     if (it != m_data.end())
     {
@@ -123,28 +235,204 @@ bool GoAutoBook::Get(const GoAutoBookState& state, SgBookNode& node) const
 
 void GoAutoBook::Put(const GoAutoBookState& state, const SgBookNode& node)
 {
-    m_data[state.GetHashCode()] = node;
+    ThrowIfBinary("modify");
+    PutNode(state.GetHashCode(), node);
+}
+
+void GoAutoBook::PutNode(const SgHashCode& hash, const SgBookNode& node)
+{
+    m_data[hash] = node;
+    m_changed.insert(hash);
 }
 
 void GoAutoBook::Flush()
 {
+    ThrowIfBinary("save");
+    WriteJournal();
+    if (m_nuJournalEntries > 0 && m_nuJournalEntries >= m_data.size())
+        Compact();
+}
+
+void GoAutoBook::Compact()
+{
+    ThrowIfBinary("save");
+    // The changes are written to the journal first, such that replaying
+    // the journal after a crash before it is removed restores the same
+    // nodes
+    WriteJournal();
     Save(m_filename);
+    boost::filesystem::remove(JournalFileName());
+    SgDebug() << "GoAutoBook: Compacted " << m_nuJournalEntries
+              << " journal entries.\n";
+    m_nuJournalEntries = 0;
+}
+
+std::string GoAutoBook::JournalFileName() const
+{
+    return m_filename + ".journal";
+}
+
+void GoAutoBook::ReadJournal()
+{
+    const std::string fileName = JournalFileName();
+    std::ifstream in(fileName.c_str(), std::ios::binary);
+    if (! in)
+        return;
+    std::streamoff length = 0;
+    bool isTruncated = false;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        SgHashCode hash;
+        SgBookNode node;
+        // The last line has no newline, if writing it was interrupted
+        if (in.eof() || ! ParseLine(line, hash, node))
+        {
+            isTruncated = true;
+            break;
+        }
+        m_data[hash] = node;
+        ++m_nuJournalEntries;
+        length = in.tellg();
+    }
+    in.close();
+    SgDebug() << "GoAutoBook: Replayed " << m_nuJournalEntries
+              << " journal entries.\n";
+    if (isTruncated)
+    {
+        SgWarning() << "GoAutoBook: ignoring incomplete entry at end of "
+                    << fileName << '\n';
+        boost::filesystem::resize_file(fileName, length);
+    }
 }
 
 void GoAutoBook::Save(const std::string& filename) const
 {
-    std::ofstream out(filename.c_str());
+    ThrowIfBinary("save");
+    const std::string tmpFileName = filename + ".tmp";
+    std::ofstream out(tmpFileName.c_str());
+    WriteVersion(out);
     for (Map::const_iterator it = m_data.begin(); it != m_data.end(); ++it)
+        WriteLine(out, it->first, it->second);
+    out.close();
+    if (! out)
+        throw SgException("error writing " + tmpFileName);
+    boost::filesystem::rename(tmpFileName, filename);
+}
+
+void GoAutoBook::WriteJournal()
+{
+    if (m_changed.empty())
+        return;
+    const std::string fileName = JournalFileName();
+    std::ofstream out(fileName.c_str(), std::ios::app | std::ios::binary);
+    for (std::set<SgHashCode>::const_iterator it = m_changed.begin();
+         it != m_changed.end(); ++it)
+        WriteLine(out, *it, m_data[*it]);
+    out.close();
+    if (! out)
+        throw SgException("error writing " + fileName);
+    m_nuJournalEntries += m_changed.size();
+    m_changed.clear();
+}
+
+std::size_t GoAutoBook::Upgrade(const std::string& oldFileName,
+                                const std::string& newFileName,
+                                const GoBoard& bd)
+{
+    {
+        std::ifstream in(oldFileName.c_str());
+        if (! in)
+            throw SgException("could not open " + oldFileName);
+        std::string line;
+        std::getline(in, line);
+        if (line.compare(0, VERSION_PREFIX.size(), VERSION_PREFIX) == 0)
+            throw SgException(oldFileName + " has a version line");
+    }
+    if (  boost::filesystem::exists(newFileName)
+       && boost::filesystem::equivalent(oldFileName, newFileName)
+       )
+        throw SgException("old and new autobook must be different files");
+    Map oldData;
+    ReadNodes(oldFileName, oldData);
+    ReadNodes(oldFileName + ".journal", oldData);
+    OldHashState oldState(bd);
+    GoAutoBookState state(bd);
+    state.Synchronize();
+    Map data;
+    std::set<SgHashCode> seen;
+    Upgrade(oldData, oldState, state, data, seen);
+    // The root is converted first, so nothing is converted if the book
+    // was built from another position or has other hash codes
+    if (data.empty())
+        throw SgException("position not found in " + oldFileName);
+    const std::string tmpFileName = newFileName + ".tmp";
+    std::ofstream out(tmpFileName.c_str());
+    WriteVersion(out);
+    for (Map::const_iterator it = data.begin(); it != data.end(); ++it)
+        WriteLine(out, it->first, it->second);
+    out.close();
+    if (! out)
+        throw SgException("error writing " + tmpFileName);
+    boost::filesystem::rename(tmpFileName, newFileName);
+    SgDebug() << "GoAutoBook::Upgrade: converted " << data.size()
+              << " of " << oldData.size() << " nodes.\n";
+    return data.size();
+}
+
+void GoAutoBook::Upgrade(const Map& oldData, OldHashState& oldState,
+                         GoAutoBookState& state, Map& data,
+                         std::set<SgHashCode>& seen)
+{
+    const SgHashCode oldHash = oldState.GetHashCode();
+    if (seen.count(oldHash))
+        return;
+    seen.insert(oldHash);
+    Map::const_iterator it = oldData.find(oldHash);
+    if (it == oldData.end())
+        return;
+    data[state.GetHashCode()] = it->second;
+    if (it->second.IsLeaf())
+        return;
+    GoBoard& bd = state.Board();
+    std::vector<SgMove> moves;
+    for (GoBoard::Iterator p(bd); p; ++p)
+        if (bd.IsLegal(*p))
+            moves.push_back(*p);
+    moves.push_back(SG_PASS);
+    for (std::size_t i = 0; i < moves.size(); ++i)
     {
-        out << it->first.ToString() << '\t' 
-            << it->second.ToString() << '\n';
+        oldState.Play(moves[i]);
+        state.Play(moves[i]);
+        Upgrade(oldData, oldState, state, data, seen);
+        state.Undo();
+        oldState.Undo();
     }
+}
+
+void GoAutoBook::SaveBinary(const std::string& filename) const
+{
+    ThrowIfBinary("convert");
+    std::vector<GoBinaryBook::NodesEntry> entries(m_data.begin(),
+                                                  m_data.end());
+    std::ofstream out(filename.c_str(), std::ios::binary);
+    GoBinaryBook::WriteNodes(out, entries);
     out.close();
+    if (! out)
+        throw SgException("error writing " + filename);
+}
+
+void GoAutoBook::ThrowIfBinary(const std::string& operation) const
+{
+    if (m_binaryBook.IsOpen())
+        throw SgException("cannot " + operation + " binary book");
 }
 
 void GoAutoBook::Merge(const GoAutoBook& other)
 {
     SgDebug() << "GoAutoBook::Merge()\n";
+    ThrowIfBinary("merge into");
+    other.ThrowIfBinary("merge");
     std::size_t newLeafs = 0;
     std::size_t newInternal = 0;
     std::size_t leafsInCommon = 0;
@@ -157,7 +445,7 @@ void GoAutoBook::Merge(const GoAutoBook& other)
         SgBookNode newNode(it->second);
         if (mine == m_data.end())
         {
-            m_data[it->first] = it->second;
+            PutNode(it->first, it->second);
             if (newNode.IsLeaf())
                 newLeafs++;
             else
@@ -170,7 +458,7 @@ void GoAutoBook::Merge(const GoAutoBook& other)
             {
                 newNode.m_heurValue = 0.5f * (newNode.m_heurValue 
                                              + oldNode.m_heurValue);
-                m_data[it->first] = newNode;
+                PutNode(it->first, newNode);
                 leafsInCommon++;
             }
             else if (! newNode.IsLeaf())
@@ -183,7 +471,7 @@ void GoAutoBook::Merge(const GoAutoBook& other)
                 // accurate after the merge.  I don't think it matters
                 // that much.
                 newNode.m_count = std::max(newNode.m_count, oldNode.m_count);
-                m_data[it->first] = newNode;
+                PutNode(it->first, newNode);
                 if (! oldNode.IsLeaf())
                     internalInCommon++;
                 else 
@@ -246,6 +534,7 @@ void GoAutoBook::TruncateByDepth(int depth, GoAutoBookState& state,
 
 void GoAutoBook::ImportHashValuePairs(std::istream& in)
 {
+    ThrowIfBinary("import into");
     std::size_t count = 0;
     while (in)
     {
@@ -266,7 +555,7 @@ void GoAutoBook::ImportHashValuePairs(std::istream& in)
         SgBookNode node(m_data[hash]);
         node.m_heurValue = value;
         node.m_value = value;
-        m_data[hash] = node;
+        PutNode(hash, node);
         count++;
     }
     SgDebug() << "GoAutoBook::ImportHashValue: imported " 
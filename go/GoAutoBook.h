@@ -10,6 +10,8 @@
 #include <fstream>
 #include <set>
 #include <map>
+#include "GoBinaryBook.h"
+#include "GoCanonicalHash.h"
 #include "SgBookBuilder.h"
 #include "SgThreadedWorker.h"
 #include "GoBoard.h"
@@ -17,7 +19,9 @@
 
 //----------------------------------------------------------------------------
 
-/** Tracks canonical hash. */
+/** Tracks canonical hash.
+    The hash code is maintained incrementally with GoCanonicalHash, so only
+    a single board is needed. */
 class GoAutoBookState
 {
 public:
@@ -40,21 +44,19 @@ public:
 private:
     GoBoardSynchronizer m_synchronizer;
 
-    GoBoard m_brd[8]; 
+    GoBoard m_brd;
 
-    SgHashCode m_hash;
-
-    void ComputeHashCode();
+    GoCanonicalHash m_hash;
 }; 
 
 inline GoBoard& GoAutoBookState::Board()
 {
-    return m_brd[0];
+    return m_brd;
 }
 
 inline const GoBoard& GoAutoBookState::Board() const
 {
-    return m_brd[0];
+    return m_brd;
 }
 
 //----------------------------------------------------------------------------
@@ -84,10 +86,33 @@ struct GoAutoBookParam
 //----------------------------------------------------------------------------
 
 /** Simple text-based book format.
-    Entire book is loaded into memory. */
+    Entire book is loaded into memory.
+
+    The first line of the file contains the format version. Books of
+    earlier versions without version line are not opened, because their
+    hash codes differ, see Upgrade().
+
+    Changes are saved incrementally: Flush() appends the nodes that changed
+    since the last flush to a journal file (the file name of the book with
+    the extension .journal appended) in the same format as the book. When
+    the journal contains at least as many nodes as the book, the book is
+    compacted: the entire book is written to a temporary file, which
+    replaces the book file, and the journal is removed. Opening the book
+    replays the journal. A journal line that was only partially written,
+    because the program was killed, is ignored and removed from the
+    journal.
+
+    A book can also be opened from a binary file written by SaveBinary(),
+    which is memory-mapped instead of loaded, see GoBinaryBook. A binary
+    book is read-only, functions that modify or save it throw an
+    SgException. */
 class GoAutoBook
 {
 public:
+    /** Open a book.
+        Opens a binary book, if the file is a binary book, otherwise reads
+        the text format. Creates an empty file, if the file does not
+        exist. */
     GoAutoBook(const std::string& filename,
                const GoAutoBookParam& param);
 
@@ -100,12 +125,28 @@ public:
     /** Store the node in the given state. */
     void Put(const GoAutoBookState& state, const SgBookNode& node);
 
-    /** Since there is no cache, same as Save(). */
+    /** Appends the nodes changed since the last flush to the journal.
+        Compacts the book if the journal contains at least as many nodes
+        as the book. */
     void Flush();
 
-    /** Writes book to disk. */
+    /** Writes the entire book to its file and removes the journal. */
+    void Compact();
+
+    /** Number of nodes in the journal. */
+    std::size_t NuJournalEntries() const;
+
+    /** Writes book to disk.
+        Writes to a temporary file first, which replaces the file after it
+        was written completely. Does not write the journal, use Compact()
+        to write the book to its own file. */
     void Save(const std::string& filename) const;
 
+    /** Writes book to disk in the format of GoBinaryBook. */
+    void SaveBinary(const std::string& filename) const;
+
+    bool IsBinary() const;
+
     /** Helper function: calls FindBestChild() on the given board.*/
     SgMove LookupMove(const GoBoard& brd) const;
 
@@ -153,9 +194,31 @@ public:
     /** Parses a worklist from a stream. */
     static std::vector< std::vector<SgMove> > ParseWorkList(std::istream& in);
 
+    /** Convert a book written by an earlier version.
+        Book files start with a version line since the hash codes are
+        computed with GoCanonicalHash, which changed the hash codes of
+        positions after moves that capture more than one stone. Books
+        without version line cannot be opened and must be converted: the
+        nodes of the old book and its journal are searched with the old
+        hash codes from the given position, and the nodes reachable from it
+        are written with the new hash codes to a new book file. Nodes that
+        are not reachable are dropped.
+        @param oldFileName The book without version line
+        @param newFileName The converted book
+        @param bd The position the book was built from, usually the empty
+        board
+        @return The number of converted nodes
+        @throws SgException If the position is not in the old book; the
+        new file is not written in this case. */
+    static std::size_t Upgrade(const std::string& oldFileName,
+                               const std::string& newFileName,
+                               const GoBoard& bd);
+
 private:
     typedef std::map<SgHashCode, SgBookNode> Map;
 
+    class OldHashState;
+
     Map m_data;
 
     const GoAutoBookParam& m_param;
@@ -166,6 +229,25 @@ private:
 
     std::string m_filename;
 
+    /** Binary book, used instead of m_data if open. */
+    GoBinaryBook m_binaryBook;
+
+    /** Nodes that changed since the last Flush(). */
+    std::set<SgHashCode> m_changed;
+
+    /** See NuJournalEntries() */
+    std::size_t m_nuJournalEntries;
+
+    std::string JournalFileName() const;
+
+    void PutNode(const SgHashCode& hash, const SgBookNode& node);
+
+    void ReadJournal();
+
+    void ThrowIfBinary(const std::string& operation) const;
+
+    void WriteJournal();
+
     void TruncateByDepth(int depth, GoAutoBookState& state, 
                          GoAutoBook& other, 
                          std::set<SgHashCode>& seen) const;
@@ -173,8 +255,22 @@ private:
     void ExportToOldFormat(GoAutoBookState& state, std::ostream& out,
                            std::set<SgHashCode>& seen) const;
 
+    static void Upgrade(const Map& oldData, OldHashState& oldState,
+                        GoAutoBookState& state, Map& data,
+                        std::set<SgHashCode>& seen);
+
 };
 
+inline bool GoAutoBook::IsBinary() const
+{
+    return m_binaryBook.IsOpen();
+}
+
+inline std::size_t GoAutoBook::NuJournalEntries() const
+{
+    return m_nuJournalEntries;
+}
+
 inline void GoAutoBook::AddForcedLines(const std::set<SgHashCode>& forced)
 {
     m_forced.insert(forced.begin(), forced.end());
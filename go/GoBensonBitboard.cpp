@@ -0,0 +1,209 @@
+//----------------------------------------------------------------------------
+/** @file GoBensonBitboard.cpp
+    See GoBensonBitboard.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoBensonBitboard.h"
+
+#include "GoBoard.h"
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+const int NEIGHBOR_OFFSET[4] = { SG_NS, SG_WE, -SG_NS, -SG_WE };
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+void GoBensonBitboard::FindBlocksRegions(const SgPointSet& stones,
+                                         int boardSize)
+{
+    m_blocks.clear();
+    m_regions.clear();
+    m_adjacent.clear();
+    const SgPoint first = SgPointUtil::Pt(1, 1);
+    const SgPoint last = SgPointUtil::Pt(boardSize, boardSize);
+    SgPoint stack[SG_MAXPOINT];
+    // Start points are searched in increasing order, such that the
+    // components are found with a single scan of the board. The points of
+    // the color planes are only on the board, so the flood fill never
+    // leaves the board.
+    SgPointSet rest(stones);
+    for (SgPoint p = first; p <= last; ++p)
+    {
+        if (! rest[p])
+            continue;
+        const int index = static_cast<int>(m_blocks.size());
+        m_blocks.push_back(Block());
+        Block& block = m_blocks.back();
+        block.m_nuVital = 0;
+        block.m_isAlive = true;
+        block.m_lastRegion = -1;
+        int top = 0;
+        stack[0] = p;
+        rest.Exclude(p);
+        while (top >= 0)
+        {
+            const SgPoint q = stack[top--];
+            block.m_stones.Include(q);
+            m_blockOf[q] = index;
+            for (int i = 0; i < 4; ++i)
+            {
+                const SgPoint nb = q + NEIGHBOR_OFFSET[i];
+                if (rest[nb])
+                {
+                    rest.Exclude(nb);
+                    stack[++top] = nb;
+                }
+            }
+        }
+        block.m_border = block.m_stones.Border(boardSize);
+    }
+    rest = SgPointSet::AllPoints(boardSize);
+    rest -= stones;
+    for (SgPoint p = first; p <= last; ++p)
+    {
+        if (! rest[p])
+            continue;
+        const int index = static_cast<int>(m_regions.size());
+        m_regions.push_back(Region());
+        Region& region = m_regions.back();
+        region.m_isVital = true;
+        region.m_isHealthy = false;
+        region.m_adjacentBegin = m_adjacent.size();
+        int top = 0;
+        stack[0] = p;
+        rest.Exclude(p);
+        while (top >= 0)
+        {
+            const SgPoint q = stack[top--];
+            region.m_points.Include(q);
+            for (int i = 0; i < 4; ++i)
+            {
+                const SgPoint nb = q + NEIGHBOR_OFFSET[i];
+                if (rest[nb])
+                {
+                    rest.Exclude(nb);
+                    stack[++top] = nb;
+                }
+                else if (stones[nb])
+                {
+                    Block& block = m_blocks[m_blockOf[nb]];
+                    if (block.m_lastRegion != index)
+                    {
+                        block.m_lastRegion = index;
+                        AdjacentBlock adjacent;
+                        adjacent.m_block = m_blockOf[nb];
+                        adjacent.m_isHealthy = false;
+                        m_adjacent.push_back(adjacent);
+                    }
+                }
+            }
+        }
+        region.m_adjacentEnd = m_adjacent.size();
+    }
+}
+
+void GoBensonBitboard::FindHealthy(const SgPointSet& empty)
+{
+    for (std::vector<Region>::iterator r = m_regions.begin();
+         r != m_regions.end(); ++r)
+    {
+        const SgPointSet regionEmpty(r->m_points & empty);
+        for (std::size_t i = r->m_adjacentBegin; i < r->m_adjacentEnd; ++i)
+        {
+            AdjacentBlock& adjacent = m_adjacent[i];
+            Block& block = m_blocks[adjacent.m_block];
+            // Healthy: all empty points of the region are liberties
+            if (regionEmpty.SubsetOf(block.m_border))
+            {
+                adjacent.m_isHealthy = true;
+                ++block.m_nuVital;
+                r->m_isHealthy = true;
+            }
+        }
+    }
+}
+
+void GoBensonBitboard::FindSafePoints(const SgBWSet& stones, int boardSize,
+                                      SgBWSet* safe)
+{
+    for (SgBWIterator it; it; ++it)
+        FindSafePoints(stones, boardSize, *it, &(*safe)[*it]);
+}
+
+void GoBensonBitboard::FindSafePoints(const SgBWSet& stones, int boardSize,
+                                      SgBlackWhite color, SgPointSet* safe)
+{
+    safe->Clear();
+    FindBlocksRegions(stones[color], boardSize);
+    FindHealthy(SgPointSet::AllPoints(boardSize) - stones.Both());
+    RemoveBlocks();
+    for (std::vector<Block>::const_iterator it = m_blocks.begin();
+         it != m_blocks.end(); ++it)
+        if (it->m_isAlive)
+            *safe |= it->m_stones;
+    // All blocks adjacent to a vital region are alive, so a vital region
+    // is safe if it is healthy for any block
+    for (std::vector<Region>::const_iterator it = m_regions.begin();
+         it != m_regions.end(); ++it)
+        if (it->m_isVital && it->m_isHealthy)
+            *safe |= it->m_points;
+}
+
+void GoBensonBitboard::FindSafePoints(const GoBoard& bd, SgBWSet* safe)
+{
+    SgBWSet stones;
+    stones[SG_BLACK] = bd.All(SG_BLACK);
+    stones[SG_WHITE] = bd.All(SG_WHITE);
+    FindSafePoints(stones, bd.Size(), safe);
+}
+
+void GoBensonBitboard::RemoveBlocks()
+{
+    for (std::vector<Block>::iterator it = m_blocks.begin();
+         it != m_blocks.end(); ++it)
+        if (it->m_nuVital < 2)
+            it->m_isAlive = false;
+    // A region is vital as long as all adjacent blocks are alive. Removing
+    // a block makes its adjacent regions non-vital, which can leave other
+    // blocks with less than two vital healthy regions.
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (std::vector<Region>::iterator r = m_regions.begin();
+             r != m_regions.end(); ++r)
+        {
+            if (! r->m_isVital)
+                continue;
+            bool isVital = true;
+            for (std::size_t i = r->m_adjacentBegin; i < r->m_adjacentEnd;
+                 ++i)
+                if (! m_blocks[m_adjacent[i].m_block].m_isAlive)
+                {
+                    isVital = false;
+                    break;
+                }
+            if (isVital)
+                continue;
+            r->m_isVital = false;
+            for (std::size_t i = r->m_adjacentBegin; i < r->m_adjacentEnd;
+                 ++i)
+                if (m_adjacent[i].m_isHealthy)
+                {
+                    Block& block = m_blocks[m_adjacent[i].m_block];
+                    if (--block.m_nuVital < 2 && block.m_isAlive)
+                    {
+                        block.m_isAlive = false;
+                        changed = true;
+                    }
+                }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
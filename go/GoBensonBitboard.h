@@ -0,0 +1,131 @@
+//----------------------------------------------------------------------------
+/** @file GoBensonBitboard.h
+    Benson's algorithm for unconditionally alive blocks on point sets. */
+//----------------------------------------------------------------------------
+
+#ifndef GO_BENSONBITBOARD_H
+#define GO_BENSONBITBOARD_H
+
+#include <vector>
+#include "SgArray.h"
+#include "SgBWSet.h"
+#include "SgBlackWhite.h"
+#include "SgBoardColor.h"
+#include "SgPointSet.h"
+
+class GoBoard;
+
+//----------------------------------------------------------------------------
+
+/** Benson's algorithm computed directly on the point sets of the stones.
+    Finds the same safe points as GoBensonSolver, but does not need a
+    GoRegionBoard with its GoBlock and GoRegion objects. Blocks and regions
+    are the connected components of the color planes, found with a single
+    flood fill per color that also records the blocks adjacent to each
+    region. A region is healthy for a block if the empty points of the
+    region are a subset of the neighbors of the block.
+
+    The board class is a template parameter of FindSafePoints(), such that
+    it can be used with GoUctBoard during the playouts. The class keeps its
+    buffers between calls, so a search should use one instance per thread.
+    @see GoBensonSolver */
+class GoBensonBitboard
+{
+public:
+    /** Find the safe points of both colors.
+        @param stones The stones of both colors
+        @param boardSize
+        @param[out] safe The stones of the unconditionally alive blocks and
+        the regions that are healthy for them and surrounded by them. */
+    void FindSafePoints(const SgBWSet& stones, int boardSize, SgBWSet* safe);
+
+    /** Find the safe points of one color.
+        @see FindSafePoints(const SgBWSet&, int, SgBWSet*) */
+    void FindSafePoints(const SgBWSet& stones, int boardSize,
+                        SgBlackWhite color, SgPointSet* safe);
+
+    /** Find the safe points of both colors on a board.
+        Uses GoBoard::All(). */
+    void FindSafePoints(const GoBoard& bd, SgBWSet* safe);
+
+    /** Find the safe points of both colors on a board.
+        Version for other board classes, e.g. GoUctBoard. The color planes
+        are collected from GetColor(). */
+    template<class BOARD>
+    void FindSafePoints(const BOARD& bd, SgBWSet* safe);
+
+private:
+    struct Block
+    {
+        SgPointSet m_stones;
+
+        /** Neighbors of the stones. */
+        SgPointSet m_border;
+
+        /** Number of healthy regions that are still vital. */
+        int m_nuVital;
+
+        bool m_isAlive;
+
+        /** Index of the last region that was found adjacent to the block.
+            Avoids duplicates in the adjacent blocks of a region. */
+        int m_lastRegion;
+    };
+
+    struct AdjacentBlock
+    {
+        int m_block;
+
+        /** The region is healthy for the block. */
+        bool m_isHealthy;
+    };
+
+    struct Region
+    {
+        SgPointSet m_points;
+
+        /** Region is surrounded by alive blocks. */
+        bool m_isVital;
+
+        /** Region is healthy for at least one block. */
+        bool m_isHealthy;
+
+        /** Range of the blocks adjacent to the region in m_adjacent. */
+        std::size_t m_adjacentBegin;
+
+        std::size_t m_adjacentEnd;
+    };
+
+    std::vector<Block> m_blocks;
+
+    std::vector<Region> m_regions;
+
+    /** Adjacent blocks of all regions. */
+    std::vector<AdjacentBlock> m_adjacent;
+
+    /** Index of the block of each stone. */
+    SgArray<int,SG_MAXPOINT> m_blockOf;
+
+    void FindBlocksRegions(const SgPointSet& stones, int boardSize);
+
+    void FindHealthy(const SgPointSet& empty);
+
+    void RemoveBlocks();
+};
+
+template<class BOARD>
+void GoBensonBitboard::FindSafePoints(const BOARD& bd, SgBWSet* safe)
+{
+    SgBWSet stones;
+    for (typename BOARD::Iterator it(bd); it; ++it)
+    {
+        const SgBoardColor c = bd.GetColor(*it);
+        if (c != SG_EMPTY)
+            stones[c].Include(*it);
+    }
+    FindSafePoints(stones, bd.Size(), safe);
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GO_BENSONBITBOARD_H
@@ -0,0 +1,373 @@
+//----------------------------------------------------------------------------
+/** @file GoBinaryBook.cpp
+    See GoBinaryBook.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoBinaryBook.h"
+
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <boost/crc.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "SgDebug.h"
+#include "SgException.h"
+
+using boost::uint16_t;
+using boost::uint32_t;
+using boost::interprocess::file_mapping;
+using boost::interprocess::interprocess_exception;
+using boost::interprocess::mapped_region;
+using boost::interprocess::read_only;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+const char MAGIC[4] = { 'F', 'B', 'O', 'K' };
+
+/** Version 2 uses the hash codes of GoCanonicalHash for books of type
+    NODES. Books of type MOVES are the same in version 1. */
+const uint32_t FORMAT_VERSION = 2;
+
+const std::size_t HEADER_SIZE = 32;
+
+/** Size of the part of the header that is covered by the checksum. */
+const std::size_t HEADER_CRC_SIZE = 28;
+
+const std::size_t SLOT_SIZE = 32;
+
+/** Maximum number of slots, such that the table fits into 32-bit
+    offsets. */
+const uint32_t MAX_NU_SLOTS = 1u << 26;
+
+bool IsLittleEndian()
+{
+    const uint32_t one = 1;
+    unsigned char firstByte;
+    std::memcpy(&firstByte, &one, 1);
+    return firstByte == 1;
+}
+
+uint32_t Crc32(const unsigned char* data, std::size_t size)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(data, size);
+    return crc.checksum();
+}
+
+uint32_t GetUInt32(const unsigned char* data)
+{
+    return   uint32_t(data[0])
+          | (uint32_t(data[1]) << 8)
+          | (uint32_t(data[2]) << 16)
+          | (uint32_t(data[3]) << 24);
+}
+
+void PutUInt16(std::string& buffer, uint16_t value)
+{
+    buffer += static_cast<char>(value & 0xff);
+    buffer += static_cast<char>(value >> 8);
+}
+
+void PutUInt32(std::string& buffer, uint32_t value)
+{
+    buffer += static_cast<char>(value & 0xff);
+    buffer += static_cast<char>((value >> 8) & 0xff);
+    buffer += static_cast<char>((value >> 16) & 0xff);
+    buffer += static_cast<char>(value >> 24);
+}
+
+uint32_t FloatToUInt32(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float UInt32ToFloat(uint32_t bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+GoBinaryBook::GoBinaryBook()
+{
+    Close();
+}
+
+GoBinaryBook::~GoBinaryBook()
+{ }
+
+void GoBinaryBook::Close()
+{
+    m_fileName.clear();
+    m_region.reset();
+    m_type = MOVES;
+    m_nuEntries = 0;
+    m_mask = 0;
+    m_slots = 0;
+    m_nuMoves = 0;
+    m_moves = 0;
+}
+
+const GoBinaryBook::Slot* GoBinaryBook::Find(const SgHashCode& hash,
+                                             int size) const
+{
+    SG_ASSERT(IsOpen());
+    const uint32_t code1 = hash.Code1();
+    const uint32_t code2 = hash.Code2();
+    uint32_t i = code1 & m_mask;
+    // Open() checks that there is an empty slot, the loop limit protects
+    // only against files that were modified after they were opened
+    for (uint32_t n = 0; n <= m_mask; ++n, i = (i + 1) & m_mask)
+    {
+        const Slot& slot = m_slots[i];
+        if (slot.m_used == 0)
+            return 0;
+        if (  slot.m_code1 == code1
+           && slot.m_code2 == code2
+           && (m_type == NODES || slot.m_data[0] == uint32_t(size))
+           )
+            return &slot;
+    }
+    return 0;
+}
+
+bool GoBinaryBook::IsBinaryBook(const std::string& fileName)
+{
+    std::ifstream in(fileName.c_str(), std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    return in.read(magic, sizeof(magic))
+        && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool GoBinaryBook::LookupMoves(const SgHashCode& hash, int size,
+                               std::vector<SgPoint>& moves, int& line) const
+{
+    SG_ASSERT(m_type == MOVES);
+    moves.clear();
+    const Slot* slot = Find(hash, size);
+    if (slot == 0)
+        return false;
+    const std::size_t first = slot->m_data[2];
+    const std::size_t nuMoves = slot->m_data[3];
+    if (first > m_nuMoves || nuMoves > m_nuMoves - first)
+    {
+        SgWarning() << "invalid move list in binary book\n";
+        return false;
+    }
+    for (std::size_t i = first; i < first + nuMoves; ++i)
+    {
+        const SgPoint p = m_moves[i];
+        if (p != SG_PASS && ! SgPointUtil::InBoardRange(p))
+        {
+            SgWarning() << "invalid move in binary book\n";
+            moves.clear();
+            return false;
+        }
+        moves.push_back(p);
+    }
+    line = static_cast<int>(slot->m_data[1]);
+    return true;
+}
+
+bool GoBinaryBook::LookupNode(const SgHashCode& hash, SgBookNode& node) const
+{
+    SG_ASSERT(m_type == NODES);
+    const Slot* slot = Find(hash, 0);
+    if (slot == 0)
+        return false;
+    node.m_heurValue = UInt32ToFloat(slot->m_data[0]);
+    node.m_value = UInt32ToFloat(slot->m_data[1]);
+    node.m_priority = UInt32ToFloat(slot->m_data[2]);
+    node.m_count = slot->m_data[3];
+    return true;
+}
+
+void GoBinaryBook::Open(const std::string& fileName)
+{
+    Close();
+    if (! IsLittleEndian())
+        throw SgException("binary book requires little-endian host");
+    boost::scoped_ptr<mapped_region> region;
+    try
+    {
+        file_mapping file(fileName.c_str(), read_only);
+        region.reset(new mapped_region(file, read_only));
+    }
+    catch (const interprocess_exception& e)
+    {
+        throw SgException("could not map " + fileName + ": " + e.what());
+    }
+    try
+    {
+        const unsigned char* data =
+            static_cast<const unsigned char*>(region->get_address());
+        const std::size_t size = region->get_size();
+        if (  size < HEADER_SIZE
+           || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0
+           )
+            throw SgException("not a binary book");
+        const uint32_t version = GetUInt32(data + 4);
+        if (version != 1 && version != FORMAT_VERSION)
+            throw SgException("unknown binary book version");
+        if (Crc32(data, HEADER_CRC_SIZE) != GetUInt32(data + 28))
+            throw SgException("binary book header checksum error");
+        const uint32_t type = GetUInt32(data + 8);
+        if (type != MOVES && type != NODES)
+            throw SgException("unknown binary book type");
+        if (version == 1 && type == NODES)
+            throw SgException("binary autobook has the hash codes of an old"
+                              " version, convert the text book with"
+                              " autobook_upgrade and save it again");
+        if (GetUInt32(data + 12) != uint32_t(SG_MAX_SIZE))
+            throw SgException("binary book was written with a different "
+                              "SG_MAX_SIZE");
+        const uint32_t nuSlots = GetUInt32(data + 16);
+        const uint32_t nuEntries = GetUInt32(data + 20);
+        const uint32_t nuMoves = GetUInt32(data + 24);
+        if (  nuSlots == 0
+           || nuSlots > MAX_NU_SLOTS
+           || (nuSlots & (nuSlots - 1)) != 0
+           || nuEntries >= nuSlots
+           )
+            throw SgException("invalid binary book table size");
+        const std::size_t tableSize = std::size_t(nuSlots) * SLOT_SIZE;
+        if (  size - HEADER_SIZE < tableSize
+           || (size - HEADER_SIZE - tableSize) / 2 < nuMoves
+           )
+            throw SgException("truncated binary book");
+        m_type = static_cast<Type>(type);
+        m_nuEntries = nuEntries;
+        m_mask = nuSlots - 1;
+        // The mapping is page-aligned and the header and slot sizes are
+        // multiples of 4, so the arrays are aligned
+        m_slots = reinterpret_cast<const Slot*>(data + HEADER_SIZE);
+        m_nuMoves = nuMoves;
+        m_moves =
+            reinterpret_cast<const uint16_t*>(data + HEADER_SIZE + tableSize);
+    }
+    catch (const SgException& e)
+    {
+        Close();
+        throw SgException(fileName + ": " + e.what());
+    }
+    m_region.swap(region);
+    m_fileName = fileName;
+}
+
+void GoBinaryBook::Write(std::ostream& out, Type type,
+                         const std::vector<Slot>& entries,
+                         const std::vector<uint16_t>& moves)
+{
+    uint32_t nuSlots = 1;
+    while (nuSlots < 2 * entries.size())
+    {
+        if (nuSlots >= MAX_NU_SLOTS)
+            throw SgException("too many entries for binary book");
+        nuSlots *= 2;
+    }
+    const uint32_t mask = nuSlots - 1;
+    Slot empty;
+    std::memset(&empty, 0, sizeof(empty));
+    std::vector<Slot> table(nuSlots, empty);
+    for (std::vector<Slot>::const_iterator it = entries.begin();
+         it != entries.end(); ++it)
+    {
+        uint32_t i = it->m_code1 & mask;
+        while (table[i].m_used != 0)
+        {
+            if (  table[i].m_code1 == it->m_code1
+               && table[i].m_code2 == it->m_code2
+               && (type == NODES || table[i].m_data[0] == it->m_data[0])
+               )
+                throw SgException("duplicate entry in binary book");
+            i = (i + 1) & mask;
+        }
+        table[i] = *it;
+    }
+    std::string header(MAGIC, sizeof(MAGIC));
+    PutUInt32(header, FORMAT_VERSION);
+    PutUInt32(header, type);
+    PutUInt32(header, SG_MAX_SIZE);
+    PutUInt32(header, nuSlots);
+    PutUInt32(header, uint32_t(entries.size()));
+    PutUInt32(header, uint32_t(moves.size()));
+    PutUInt32(header, Crc32(
+        reinterpret_cast<const unsigned char*>(header.data()),
+        header.size()));
+    SG_ASSERT(header.size() == HEADER_SIZE);
+    std::string buffer;
+    buffer.reserve(nuSlots * SLOT_SIZE + 2 * moves.size());
+    for (std::vector<Slot>::const_iterator it = table.begin();
+         it != table.end(); ++it)
+    {
+        PutUInt32(buffer, it->m_code1);
+        PutUInt32(buffer, it->m_code2);
+        PutUInt32(buffer, it->m_used);
+        for (int i = 0; i < 5; ++i)
+            PutUInt32(buffer, it->m_data[i]);
+    }
+    for (std::vector<uint16_t>::const_iterator it = moves.begin();
+         it != moves.end(); ++it)
+        PutUInt16(buffer, *it);
+    out << header << buffer;
+}
+
+void GoBinaryBook::WriteMoves(std::ostream& out,
+                              const std::vector<MovesEntry>& entries)
+{
+    std::vector<Slot> slots;
+    std::vector<uint16_t> moves;
+    for (std::vector<MovesEntry>::const_iterator it = entries.begin();
+         it != entries.end(); ++it)
+    {
+        Slot slot;
+        std::memset(&slot, 0, sizeof(slot));
+        slot.m_code1 = it->m_hash.Code1();
+        slot.m_code2 = it->m_hash.Code2();
+        slot.m_used = 1;
+        slot.m_data[0] = it->m_size;
+        slot.m_data[1] = it->m_line;
+        slot.m_data[2] = uint32_t(moves.size());
+        slot.m_data[3] = uint32_t(it->m_moves.size());
+        for (std::vector<SgPoint>::const_iterator p = it->m_moves.begin();
+             p != it->m_moves.end(); ++p)
+            moves.push_back(uint16_t(*p));
+        slots.push_back(slot);
+    }
+    Write(out, MOVES, slots, moves);
+}
+
+void GoBinaryBook::WriteNodes(std::ostream& out,
+                              const std::vector<NodesEntry>& entries)
+{
+    std::vector<Slot> slots;
+    for (std::vector<NodesEntry>::const_iterator it = entries.begin();
+         it != entries.end(); ++it)
+    {
+        const SgBookNode& node = it->second;
+        Slot slot;
+        std::memset(&slot, 0, sizeof(slot));
+        slot.m_code1 = it->first.Code1();
+        slot.m_code2 = it->first.Code2();
+        slot.m_used = 1;
+        slot.m_data[0] = FloatToUInt32(node.m_heurValue);
+        slot.m_data[1] = FloatToUInt32(node.m_value);
+        slot.m_data[2] = FloatToUInt32(node.m_priority);
+        slot.m_data[3] = node.m_count;
+        slots.push_back(slot);
+    }
+    Write(out, NODES, slots, std::vector<uint16_t>());
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,217 @@
+//----------------------------------------------------------------------------
+/** @file GoBinaryBook.h
+    Opening book in a memory-mapped binary file. */
+//----------------------------------------------------------------------------
+
+#ifndef GO_BINARYBOOK_H
+#define GO_BINARYBOOK_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/scoped_ptr.hpp>
+#include "SgBookBuilder.h"
+#include "SgHash.h"
+#include "SgPoint.h"
+
+namespace boost {
+namespace interprocess {
+    class mapped_region;
+}
+}
+
+//----------------------------------------------------------------------------
+
+/** Opening book in a memory-mapped binary file.
+    Compiled form of the text formats of GoBook and GoAutoBook. A GoBook or
+    GoAutoBook that is created from a binary file uses it read-only instead
+    of parsing the file into a map. The file is mapped with
+    boost::interprocess, such that the operating system reads only the pages
+    that are used and shares them between all processes that use the same
+    book.
+
+    The entries are stored in an open-addressed hash table with linear
+    probing, indexed by the low bits of the hash code. The table has at
+    least twice as many slots as entries, so a lookup usually reads one
+    slot. A GoBook is stored with all rotations of each position and the
+    moves already rotated, such that a lookup needs no transformation. A
+    GoAutoBook is stored with the canonical hash codes of GoAutoBookState.
+
+    The hash codes depend on SG_MAX_SIZE, which is stored in the file; a
+    book compiled with a different SG_MAX_SIZE is rejected by Open(). Only
+    the header has a checksum, such that opening a book does not read the
+    whole table; the move lists are checked against the bounds of the file
+    when they are looked up.
+
+    File format (all numbers 32-bit little-endian unless noted):
+    @verbatim
+    "FBOK"                          magic
+    version                         currently 2; version 1 is still
+                                    read for type MOVES, the hash codes
+                                    of type NODES changed in version 2
+    type                            a Type
+    maxSize                         SG_MAX_SIZE of the writer
+    nuSlots                         size of the table, a power of two
+    nuEntries                       number of used slots
+    nuMoves                         size of the move pool
+    crc                             CRC-32 of the preceding 28 bytes
+    nuSlots * (code1, code2, used, data[5])
+                                    the table; code1 and code2 are the
+                                    words of the hash code, used is 1 for
+                                    used slots, 0 for empty slots
+    nuMoves * point                 move pool, 16-bit points
+    @endverbatim
+    The data of a slot in a book of type MOVES is the board size, the line
+    number in the original file, the index of the first move in the move
+    pool and the number of moves. The data of a slot in a book of type NODES
+    are the fields of SgBookNode (m_heurValue, m_value, m_priority as IEEE
+    754 single precision and m_count). */
+class GoBinaryBook
+{
+public:
+    enum Type
+    {
+        /** Moves of a GoBook. */
+        MOVES = 1,
+
+        /** Nodes of a GoAutoBook. */
+        NODES = 2
+    };
+
+    /** Entry of a book of type MOVES. */
+    struct MovesEntry
+    {
+        SgHashCode m_hash;
+
+        int m_size;
+
+        /** Line number in the original file, see GoBook::Line() */
+        int m_line;
+
+        std::vector<SgPoint> m_moves;
+    };
+
+    typedef std::pair<SgHashCode,SgBookNode> NodesEntry;
+
+    GoBinaryBook();
+
+    ~GoBinaryBook();
+
+    /** Check if a file starts with the magic number of a binary book. */
+    static bool IsBinaryBook(const std::string& fileName);
+
+    /** Map a book file.
+        Closes the current book first.
+        @throws SgException if the file cannot be mapped or has an invalid
+        format. */
+    void Open(const std::string& fileName);
+
+    void Close();
+
+    bool IsOpen() const;
+
+    /** Name of the book file or an empty string, if not open. */
+    const std::string& FileName() const;
+
+    /** Type of the open book. */
+    Type GetType() const;
+
+    std::size_t NuEntries() const;
+
+    /** Look up the moves of a position in a book of type MOVES.
+        @param hash GoBoard::GetHashCodeInclToPlay() of the position
+        @param size The board size
+        @param[out] moves The moves
+        @param[out] line The line number in the original file
+        @return @c false, if the position is not in the book. */
+    bool LookupMoves(const SgHashCode& hash, int size,
+                     std::vector<SgPoint>& moves, int& line) const;
+
+    /** Look up a node in a book of type NODES.
+        @param hash GoAutoBookState::GetHashCode()
+        @param[out] node
+        @return @c false, if the node is not in the book. */
+    bool LookupNode(const SgHashCode& hash, SgBookNode& node) const;
+
+    /** Write a book of type MOVES.
+        @throws SgException if entries contains a position twice. */
+    static void WriteMoves(std::ostream& out,
+                           const std::vector<MovesEntry>& entries);
+
+    /** Write a book of type NODES.
+        @throws SgException if entries contains a hash code twice. */
+    static void WriteNodes(std::ostream& out,
+                           const std::vector<NodesEntry>& entries);
+
+private:
+    struct Slot
+    {
+        boost::uint32_t m_code1;
+
+        boost::uint32_t m_code2;
+
+        boost::uint32_t m_used;
+
+        boost::uint32_t m_data[5];
+    };
+
+    std::string m_fileName;
+
+    boost::scoped_ptr<boost::interprocess::mapped_region> m_region;
+
+    Type m_type;
+
+    std::size_t m_nuEntries;
+
+    boost::uint32_t m_mask;
+
+    const Slot* m_slots;
+
+    std::size_t m_nuMoves;
+
+    const boost::uint16_t* m_moves;
+
+    /** Not implemented */
+    GoBinaryBook(const GoBinaryBook&);
+
+    /** Not implemented */
+    GoBinaryBook& operator=(const GoBinaryBook&);
+
+    /** Find the slot of a hash code.
+        @param hash
+        @param size The board size, ignored for books of type NODES
+        @return The slot or 0, if not found. */
+    const Slot* Find(const SgHashCode& hash, int size) const;
+
+    static void Write(std::ostream& out, Type type,
+                      const std::vector<Slot>& entries,
+                      const std::vector<boost::uint16_t>& moves);
+};
+
+inline const std::string& GoBinaryBook::FileName() const
+{
+    return m_fileName;
+}
+
+inline GoBinaryBook::Type GoBinaryBook::GetType() const
+{
+    SG_ASSERT(IsOpen());
+    return m_type;
+}
+
+inline bool GoBinaryBook::IsOpen() const
+{
+    return m_region.get() != 0;
+}
+
+inline std::size_t GoBinaryBook::NuEntries() const
+{
+    return m_nuEntries;
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GO_BINARYBOOK_H
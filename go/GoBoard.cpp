@@ -23,14 +23,6 @@ namespace {
     time. */
 const bool CONSISTENCY = false;
 
-void UpdateChanges(SgPoint p, SgArrayList<SgPoint,SG_MAXPOINT>& changes,
-                   int& nuChanges)
-{
-    if (! changes.Exclude(p))
-        changes.PushBack(p);
-    ++nuChanges;
-}
-
 } // namespace
 
 //----------------------------------------------------------------------------
@@ -39,8 +31,8 @@ GoBoard::GoBoard(int size, const GoSetup& setup, const GoRules& rules)
     : m_snapshot(new Snapshot()),
       m_const(size),
       m_blockList(new SgArrayList<Block,GO_MAX_NUM_MOVES>()),
-      m_moves(new SgArrayList<StackEntry,GO_MAX_NUM_MOVES>())
-
+      m_moves(new SgArrayList<StackEntry,GO_MAX_NUM_MOVES>()),
+      m_history(new HashHistory())
 {
     GoInitCheck();
     Init(size, rules, setup);
@@ -52,6 +44,44 @@ GoBoard::~GoBoard()
     m_blockList = 0;
     delete m_moves;
     m_moves = 0;
+    delete m_history;
+    m_history = 0;
+}
+
+//----------------------------------------------------------------------------
+
+GoBoard::HashHistory::HashHistory()
+{
+    m_first.Fill(-1);
+}
+
+void GoBoard::HashHistory::Clear()
+{
+    Resize(0);
+}
+
+void GoBoard::HashHistory::CopyFrom(const HashHistory& history)
+{
+    Clear();
+    for (int i = 0; i < history.Size(); ++i)
+        Push(history.m_entries[i].m_code, history.m_entries[i].m_toPlay);
+}
+
+void GoBoard::HashHistory::Resize(int size)
+{
+    SG_ASSERT(size <= Size());
+    while (Size() > size)
+        Pop();
+}
+
+//----------------------------------------------------------------------------
+
+void GoBoard::AddToHistory()
+{
+    const int moveNumber = m_moves->Length() - 1;
+    const int toPlay = (1 << (*m_moves)[moveNumber].m_toPlay);
+    m_history->Push(m_state.m_positionHash.Get(),
+                    toPlay | PassesBefore(moveNumber));
 }
 
 void GoBoard::CheckConsistency() const
@@ -422,7 +452,11 @@ void GoBoard::Init(int size, const GoRules& rules, const GoSetup& setup)
     m_size = size;
     SG_ASSERTRANGE(m_size, SG_MIN_SIZE, SG_MAX_SIZE);
     m_state.m_hash.Clear();
+    m_state.m_positionHash.Clear();
     m_moves->Clear();
+    m_history->Clear();
+    m_initialPasses = 0;
+    m_initialMoveNumber = 0;
     m_state.m_prisoners[SG_BLACK] = 0;
     m_state.m_prisoners[SG_WHITE] = 0;
     m_state.m_numStones[SG_BLACK] = 0;
@@ -477,6 +511,7 @@ void GoBoard::Init(int size, const GoRules& rules, const GoSetup& setup)
             AddStone(p, *c);
             ++m_state.m_numStones[*c];
             m_state.m_hash.XorStone(p, *c);
+            m_state.m_positionHash.XorStone(p, *c);
             m_state.m_isFirst[p] = false;
         }
     m_state.m_toPlay = setup.m_player;
@@ -495,6 +530,46 @@ void GoBoard::Init(int size, const GoRules& rules, const GoSetup& setup)
     CheckConsistency();
 }
 
+void GoBoard::InitClone(const GoBoard& bd)
+{
+    SG_ASSERT(&bd != this);
+    m_rules = bd.m_rules;
+    m_size = bd.m_size;
+    m_const.ChangeSize(m_size);
+    m_isBorder = bd.m_isBorder;
+    m_state = bd.m_state;
+    m_setup.m_stones = bd.m_state.m_all;
+    m_setup.m_player = bd.ToPlay();
+    m_moves->Clear();
+    m_history->CopyFrom(*bd.m_history);
+    m_initialPasses = bd.PassesBefore(bd.MoveNumber());
+    m_initialMoveNumber = bd.m_initialMoveNumber + bd.MoveNumber();
+    m_countPlay = 0;
+    m_allowAnyRepetition = bd.m_allowAnyRepetition;
+    m_allowKoRepetition = bd.m_allowKoRepetition;
+    m_koColor = bd.m_koColor;
+    m_koLoser = bd.m_koLoser;
+    m_koModifiesHash = bd.m_koModifiesHash;
+    m_capturedStones.Clear();
+    m_moveInfo.reset();
+    // Copy only the blocks on the board, the other board's block list
+    // also contains blocks that were merged or captured
+    m_blockList->Clear();
+    for (GoBoard::Iterator it(bd); it; ++it)
+    {
+        const Block* oldBlock = bd.m_state.m_block[*it];
+        if (oldBlock != 0 && oldBlock->Anchor() == *it)
+        {
+            Block& block = CreateNewBlock();
+            block = *oldBlock;
+            for (Block::StoneIterator it2(block.Stones()); it2; ++it2)
+                m_state.m_block[*it2] = &block;
+        }
+    }
+    m_snapshot->m_moveNumber = -1;
+    CheckConsistency();
+}
+
 void GoBoard::InitBlock(GoBoard::Block& block, SgBlackWhite c, SgPoint anchor)
 {
     SG_ASSERT_BW(c);
@@ -670,6 +745,7 @@ void GoBoard::KillBlock(const Block* block)
         SgPoint stn = *it;
         AddLibToAdjBlocks(stn, opp);
         m_state.m_hash.XorStone(stn, c);
+        m_state.m_positionHash.XorStone(stn, c);
         RemoveStone(stn);
         m_capturedStones.PushBack(stn);
         m_state.m_block[stn] = 0;
@@ -694,44 +770,21 @@ bool GoBoard::FullBoardRepetition() const
         const StackEntry& entry = (*m_moves)[nuMoves - 1];
         return (entry.m_point == entry.m_koPoint);
     }
-    SgBWArray<SgArrayList<SgPoint,SG_MAXPOINT> > changes;
-    int nuChanges = 0;
-    int moveNumber = m_moves->Length() - 1;
-    bool requireSameToPlay = (koRule == GoRules::SUPERKO);
-    while (moveNumber >= 0)
-    {
-        const StackEntry& entry = (*m_moves)[moveNumber];
-        SgPoint p = entry.m_point;
-        if (! IsPass(p) && entry.m_color != SG_EMPTY
-            && entry.m_color == GetColor(p)
-            && entry.m_isFirst)
-            // In this case we know that all erlier positions are
-            // empty at p, therefore different to current position
-            return false;
-
-        if (! IsPass(entry.m_point))
-        {
-            UpdateChanges(entry.m_point, changes[entry.m_color], nuChanges);
-            for (SgArrayList<Block*,4>::Iterator it(entry.m_killed); it; ++it)
-            {
-                Block* killed = *it;
-                for (GoPointList::Iterator stn(killed->Stones()); stn; ++stn)
-                    UpdateChanges(*stn, changes[killed->Color()], nuChanges);
-            }
-            Block* suicide = entry.m_suicide;
-            if (suicide != 0)
-                for (GoPointList::Iterator stn(suicide->Stones()); stn;
-                     ++stn)
-                    UpdateChanges(*stn, changes[suicide->Color()], nuChanges);
-        }
+    int toPlay = (1 << SG_BLACK) | (1 << SG_WHITE);
+    if (koRule == GoRules::SUPERKO)
+        toPlay = (1 << m_state.m_toPlay);
+    return m_history->Contains(m_state.m_positionHash.Get(), toPlay);
+}
 
-        if (nuChanges > 0
-            && (! requireSameToPlay || entry.m_toPlay == m_state.m_toPlay)
-            && changes[SG_BLACK].IsEmpty() && changes[SG_WHITE].IsEmpty())
-            return true;
-        --moveNumber;
-    }
-    return false;
+int GoBoard::PassesBefore(int moveNumber) const
+{
+    int passes = 0;
+    int i;
+    for (i = moveNumber - 1; i >= 0 && IsPass((*m_moves)[i].m_point); --i)
+        passes |= (1 << (*m_moves)[i].m_toPlay);
+    if (i < 0)
+        passes |= m_initialPasses;
+    return passes;
 }
 
 bool GoBoard::CheckSuicide(SgPoint p, StackEntry& entry)
@@ -774,7 +827,9 @@ void GoBoard::Play(SgPoint p, SgBlackWhite player)
     // for full-board repetition below.
     bool wasFirstStone = IsFirst(p);
     m_state.m_isFirst[p] = false;
+    AddToHistory();
     m_state.m_hash.XorStone(p, player);
+    m_state.m_positionHash.XorStone(p, player);
     AddStone(p, player);
     ++m_state.m_numStones[player];
     RemoveLibAndKill(p, opp, entry);
@@ -803,7 +858,8 @@ void GoBoard::Play(SgPoint p, SgBlackWhite player)
         // be captured in the same sequence. Currently holds due to the
         // way KillBlockIfNoLiberty is implemented; may be fragile.
         SgPoint firstCapturedStone = m_capturedStones[0];
-        m_state.m_hash.XorCaptured(MoveNumber(), firstCapturedStone);
+        m_state.m_hash.XorCaptured(m_initialMoveNumber + MoveNumber(),
+                                   firstCapturedStone);
     }
     CheckConsistency();
 }
@@ -812,6 +868,8 @@ void GoBoard::Undo()
 {
     CheckConsistency();
     const StackEntry& entry = m_moves->Last();
+    if (! IsPass(entry.m_point))
+        m_history->Pop();
     RestoreState(entry);
     UpdateBlocksAfterUndo(entry);
     m_moves->PopBack();
@@ -842,6 +900,7 @@ void GoBoard::RemoveLibAndKill(SgPoint p, SgBlackWhite opp,
 void GoBoard::RestoreState(const StackEntry& entry)
 {
     m_state.m_hash = entry.m_hash;
+    m_state.m_positionHash = entry.m_positionHash;
     m_state.m_koPoint = entry.m_koPoint;
     if (! IsPass(entry.m_point))
     {
@@ -858,6 +917,7 @@ void GoBoard::RestoreState(const StackEntry& entry)
 void GoBoard::SaveState(StackEntry& entry)
 {
     entry.m_hash = m_state.m_hash;
+    entry.m_positionHash = m_state.m_positionHash;
     if (! IsPass(entry.m_point))
     {
         entry.m_isFirst = m_state.m_isFirst[entry.m_point];
@@ -875,6 +935,7 @@ void GoBoard::TakeSnapshot()
 {
     m_snapshot->m_moveNumber = MoveNumber();
     m_snapshot->m_blockListSize = m_blockList->Length();
+    m_snapshot->m_historySize = m_history->Size();
     m_snapshot->m_state = m_state;
     for (GoBoard::Iterator it(*this); it; ++it)
     {
@@ -892,6 +953,7 @@ void GoBoard::RestoreSnapshot()
         return;
     m_blockList->Resize(m_snapshot->m_blockListSize);
     m_moves->Resize(m_snapshot->m_moveNumber);
+    m_history->Resize(m_snapshot->m_historySize);
     m_state = m_snapshot->m_state;
     for (GoBoard::Iterator it(*this); it; ++it)
     {
@@ -128,6 +128,19 @@ public:
     void Init(int size, const GoRules& rules,
               const GoSetup& setup = GoSetup());
 
+    /** Re-initializes the board with the current position of another board.
+        Much cheaper than initializing the board with the setup of the other
+        board and replaying its moves. Intended for handing positions to
+        tactical searches in other threads, which can reuse their board for
+        each new clone. The board keeps only the history needed by the ko
+        and repetition rules: the move number is 0, Setup() contains the
+        stones of the current position and the color to play, and Undo()
+        cannot go back to earlier positions. Legality, repetitions and hash
+        codes of followup positions are the same as on the other board.
+        The other board is not modified, so it can be cloned by several
+        threads at the same time, if no thread changes it. */
+    void InitClone(const GoBoard& bd);
+
     /** Non-const access to current game rules.
         The game rules are attached to a GoBoard for convenient access
         by the players only.
@@ -155,6 +168,16 @@ public:
         with no possibility of repetition */
     bool IsNewPosition() const;
 
+    /** Check if the current position repeats an earlier position of the
+        game.
+        Uses the ko rule of the current rules: with simple ko only the
+        position two moves ago is checked, with situational superko the
+        positions must also have the same color to play. Positions that
+        differ only by passes are not repetitions. Takes constant time, the
+        hash codes of the earlier positions are stored in a hash table,
+        which is updated by Play() and Undo(). */
+    bool FullBoardRepetition() const;
+
     /** Check if point is occupied by a stone.
         Can be called with border points. */
     bool Occupied(SgPoint p) const;
@@ -657,6 +680,67 @@ private:
         SgHashCode m_hash;
     };
 
+    /** Hash codes of the earlier positions of the game.
+        Used by FullBoardRepetition(). Each entry stores the hash code of the
+        stones on the board and the colors to play in this position. Entries
+        are added by Play() and removed in reverse order by Undo(), so the
+        set can be a chained hash table with the entries stored in a
+        stack. */
+    class HashHistory
+    {
+    public:
+        HashHistory();
+
+        void Clear();
+
+        /** Replace the contents by the contents of another set. */
+        void CopyFrom(const HashHistory& history);
+
+        /** Check if the set contains a position.
+            @param code The hash code of the stones on the board
+            @param toPlay Bit mask of colors to play (bit 0: Black, bit 1:
+            White), the position must have occurred with at least one of
+            them. */
+        bool Contains(const SgHashCode& code, int toPlay) const;
+
+        /** Remove the most recently added position. */
+        void Pop();
+
+        /** Add a position.
+            @param code The hash code of the stones on the board
+            @param toPlay Bit mask of colors to play in the position */
+        void Push(const SgHashCode& code, int toPlay);
+
+        /** Remove the most recently added positions until the set has the
+            given size. */
+        void Resize(int size);
+
+        int Size() const;
+
+    private:
+        static const int NU_BUCKETS = 4096;
+
+        struct Entry
+        {
+            SgHashCode m_code;
+
+            int m_toPlay;
+
+            /** Index of the next entry in the same bucket, -1 if none. */
+            int m_next;
+        };
+
+        /** Index of the most recently added entry of each bucket, -1 if
+            none. */
+        SgArray<int,NU_BUCKETS> m_first;
+
+        /** Each position is added at most once, when the first move that
+            changes the stones on the board is played. */
+        SgArrayList<Entry,GO_MAX_NUM_MOVES> m_entries;
+
+        static int Bucket(const SgHashCode& code);
+    };
+
     /** Information to undo a move.
         Holds information necessary to undo a play. */
     struct StackEntry
@@ -696,6 +780,9 @@ private:
         /** Old value of m_hash */
         HashCode m_hash;
 
+        /** Old value of m_positionHash */
+        HashCode m_positionHash;
+
         /** Old value of m_koPoint */
         SgPoint m_koPoint;
 
@@ -733,6 +820,11 @@ private:
         /** Hash code for this board position. */
         HashCode m_hash;
 
+        /** Hash code of the stones on the board.
+            Unlike m_hash, not modified by captures and ko wins. Used for
+            the full board repetition check. */
+        HashCode m_positionHash;
+
         SgBWSet m_all;
 
         SgPointSet m_empty;
@@ -773,6 +865,8 @@ private:
 
         int m_blockListSize;
 
+        int m_historySize;
+
         State m_state;
 
         /** State of blocks currently on the board. */
@@ -830,6 +924,20 @@ private:
 
     SgArrayList<StackEntry, GO_MAX_NUM_MOVES>* m_moves;
 
+    /** Earlier positions of the game.
+        @see FullBoardRepetition() */
+    HashHistory* m_history;
+
+    /** Colors that passed directly before the first move in m_moves.
+        Bit mask as in HashHistory. Only non-zero after InitClone(). */
+    int m_initialPasses;
+
+    /** Move number of the position at Init() or InitClone() in the
+        original game.
+        Only non-zero after InitClone(). Added to the move number in the hash
+        code of captures, see Play(). */
+    int m_initialMoveNumber;
+
     static bool IsPass(SgPoint p);
 
     /** Not implemented. */
@@ -879,7 +987,17 @@ private:
 
     void CheckConsistencyBlock(SgPoint p) const;
 
-    bool FullBoardRepetition() const;
+    /** Add the position left by the current move to m_history.
+        Called by Play() before a move that is not a pass changes the
+        stones on the board. The colors to play of the position are the
+        colors to play before the move and before directly preceding
+        passes. */
+    void AddToHistory();
+
+    /** Colors that passed directly before a move.
+        Bit mask as in HashHistory.
+        @param moveNumber The number of the move */
+    int PassesBefore(int moveNumber) const;
 
     /** Kill own block if no liberties.
         Sets isSuicide flag.
@@ -1210,6 +1328,44 @@ inline void GoBoard::HashCode::XorWinKo(int level, SgBlackWhite c)
     SgHashUtil::XorZobrist(m_hash, index);
 }
 
+inline int GoBoard::HashHistory::Bucket(const SgHashCode& code)
+{
+    return code.Code1() & (NU_BUCKETS - 1);
+}
+
+inline bool GoBoard::HashHistory::Contains(const SgHashCode& code,
+                                           int toPlay) const
+{
+    for (int i = m_first[Bucket(code)]; i >= 0; i = m_entries[i].m_next)
+        if ((m_entries[i].m_toPlay & toPlay) != 0
+            && m_entries[i].m_code == code)
+            return true;
+    return false;
+}
+
+inline void GoBoard::HashHistory::Pop()
+{
+    const Entry& entry = m_entries.Last();
+    m_first[Bucket(entry.m_code)] = entry.m_next;
+    m_entries.PopBack();
+}
+
+inline void GoBoard::HashHistory::Push(const SgHashCode& code, int toPlay)
+{
+    int& first = m_first[Bucket(code)];
+    m_entries.Resize(m_entries.Length() + 1);
+    Entry& entry = m_entries.Last();
+    entry.m_code = code;
+    entry.m_toPlay = toPlay;
+    entry.m_next = first;
+    first = m_entries.Length() - 1;
+}
+
+inline int GoBoard::HashHistory::Size() const
+{
+    return m_entries.Length();
+}
+
 inline const SgPointSet& GoBoard::All(SgBlackWhite color) const
 {
     return m_state.m_all[color];
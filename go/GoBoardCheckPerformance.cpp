@@ -7,10 +7,452 @@
 #include "GoBoardCheckPerformance.h"
 
 #include <fstream>
+#include <iomanip>
+#include "GoBensonBitboard.h"
+#include "GoBensonSolver.h"
 #include "GoBoard.h"
 #include "GoBoardUtil.h"
+#include "GoCanonicalHash.h"
+#include "GoLadder.h"
+#include "GoLadderCache.h"
+#include "GoLightLadder.h"
+#include "GoRegionBoard.h"
+#include "GoSafetySolver.h"
+#include "SgRandom.h"
 #include "SgTime.h"
 
+using std::vector;
+using GoBoardCheckPerformance::Game;
+using GoBoardCheckPerformance::Result;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Number of moves played between TakeSnapshot and RestoreSnapshot in
+    GoBoardCheckPerformance::Snapshot(). */
+const int SNAPSHOT_NU_MOVES = 8;
+
+GoRules SuperkoRules()
+{
+    GoRules rules;
+    rules.SetKoRule(GoRules::POS_SUPERKO);
+    return rules;
+}
+
+/** Number of positions after a move, in which
+    GoBoardCheckPerformance::LadderMoves() queries the ladders in addition to
+    each position of the games. */
+const int LADDER_NU_SIBLINGS = 8;
+
+/** Ladder queries of GoUctLadderKnowledge in a position.
+    See GoBoardCheckPerformance::LadderMoves(). */
+void LadderQueries(const GoBoard& bd, Result& result)
+{
+    // The ladder reading plays and undoes moves, which can change the order
+    // of the blocks and liberties, so they are copied first
+    vector<SgPoint> blocks;
+    for (GoBlockIterator block(bd); block; ++block)
+        blocks.push_back(*block);
+    for (vector<SgPoint>::const_iterator block = blocks.begin();
+         block != blocks.end(); ++block)
+        if (bd.NumLiberties(*block) == 2)
+        {
+            vector<SgPoint> libs;
+            for (GoBoard::LibertyIterator lib(bd, *block); lib; ++lib)
+                libs.push_back(*lib);
+            for (vector<SgPoint>::const_iterator lib = libs.begin();
+                 lib != libs.end(); ++lib)
+            {
+                ++result.m_nuOperations;
+                if (GoLadderUtil::IsLadderCaptureMove(bd, *block, *lib))
+                    ++result.m_checksum;
+            }
+        }
+        else if (bd.NumLiberties(*block) == 1)
+        {
+            ++result.m_nuOperations;
+            SgVector<SgPoint> escapeMoves;
+            GoLadderUtil::FindLadderEscapeMoves(bd, *block, escapeMoves);
+            result.m_checksum += escapeMoves.Length();
+        }
+}
+
+/** Operation for GoBoardCheckPerformance::Benson(). */
+struct BensonOp
+{
+    void operator()(GoBoard& bd, Result& result)
+    {
+        ++result.m_nuOperations;
+        GoBensonSolver solver(bd);
+        SgBWSet safe;
+        solver.FindSafePoints(&safe);
+        result.m_checksum += safe.Both().Size();
+    }
+};
+
+/** Operation for GoBoardCheckPerformance::BensonBitboard(). */
+struct BensonBitboardOp
+{
+    GoBensonBitboard m_benson;
+
+    void operator()(GoBoard& bd, Result& result)
+    {
+        ++result.m_nuOperations;
+        SgBWSet safe;
+        m_benson.FindSafePoints(bd, &safe);
+        result.m_checksum += safe.Both().Size();
+    }
+};
+
+/** Benchmark for GoBoardCheckPerformance::CanonicalHash(). */
+class CanonicalHashBenchmark
+{
+public:
+    void Init(const Game& game)
+    {
+        m_bd.Init(game.m_size, game.m_setup);
+        m_hash.Init(m_bd);
+    }
+
+    void Run(const Game& game, Result& result)
+    {
+        for (vector<GoPlayerMove>::const_iterator move =
+                 game.m_moves.begin(); move != game.m_moves.end(); ++move)
+        {
+            m_bd.Play(*move);
+            m_hash.Play(m_bd);
+            result.m_checksum += m_hash.Canonical().Code1();
+        }
+        for (std::size_t i = 0; i < game.m_moves.size(); ++i)
+        {
+            m_bd.Undo();
+            m_hash.Undo();
+        }
+        result.m_nuOperations += 2 * game.m_moves.size();
+    }
+
+private:
+    GoBoard m_bd;
+
+    GoCanonicalHash m_hash;
+};
+
+/** Benchmark for GoBoardCheckPerformance::CanonicalHashBoards(). */
+class CanonicalHashBoardsBenchmark
+{
+public:
+    void Init(const Game& game)
+    {
+        for (int rot = 0; rot < NU_SYMMETRIES; ++rot)
+        {
+            GoSetup setup;
+            setup.m_player = game.m_setup.m_player;
+            for (SgBWIterator c; c; ++c)
+                for (SgSetIterator p(game.m_setup.m_stones[*c]); p; ++p)
+                    setup.m_stones[*c].Include(
+                                  SgPointUtil::Rotate(rot, *p, game.m_size));
+            m_boards[rot].Init(game.m_size, setup);
+        }
+    }
+
+    void Run(const Game& game, Result& result)
+    {
+        for (vector<GoPlayerMove>::const_iterator move =
+                 game.m_moves.begin(); move != game.m_moves.end(); ++move)
+        {
+            for (int rot = 0; rot < NU_SYMMETRIES; ++rot)
+                m_boards[rot].Play(SgPointUtil::Rotate(rot, move->Point(),
+                                                       game.m_size),
+                                   move->Color());
+            SgHashCode hash = m_boards[0].GetHashCodeInclToPlay();
+            for (int rot = 1; rot < NU_SYMMETRIES; ++rot)
+            {
+                const SgHashCode curHash =
+                    m_boards[rot].GetHashCodeInclToPlay();
+                if (curHash < hash)
+                    hash = curHash;
+            }
+            result.m_checksum += hash.Code1();
+        }
+        for (std::size_t i = 0; i < game.m_moves.size(); ++i)
+            for (int rot = 0; rot < NU_SYMMETRIES; ++rot)
+                m_boards[rot].Undo();
+        result.m_nuOperations += 2 * game.m_moves.size();
+    }
+
+private:
+    static const int NU_SYMMETRIES = GoCanonicalHash::NU_SYMMETRIES;
+
+    GoBoard m_boards[NU_SYMMETRIES];
+};
+
+/** Operation for GoBoardCheckPerformance::Clone(). */
+struct CloneOp
+{
+    GoBoard m_clone;
+
+    void operator()(GoBoard& bd, Result& result)
+    {
+        ++result.m_nuOperations;
+        m_clone.InitClone(bd);
+        result.m_checksum += m_clone.TotalNumStones(SG_BLACK);
+    }
+};
+
+/** Benchmark for GoBoardCheckPerformance::CopyReplay(). */
+class CopyReplayBenchmark
+{
+public:
+    void Init(const Game& game)
+    {
+        SG_UNUSED(game);
+    }
+
+    void Run(const Game& game, Result& result)
+    {
+        for (std::size_t i = 0; i <= game.m_moves.size(); ++i)
+        {
+            m_copy.Init(game.m_size, game.m_setup);
+            for (std::size_t j = 0; j < i; ++j)
+                m_copy.Play(game.m_moves[j]);
+            result.m_checksum += m_copy.TotalNumStones(SG_BLACK);
+        }
+        result.m_nuOperations += game.m_moves.size() + 1;
+    }
+
+private:
+    GoBoard m_copy;
+};
+
+/** Benchmark for GoBoardCheckPerformance::FullBoardRepetition(). */
+class FullBoardRepetitionBenchmark
+{
+public:
+    FullBoardRepetitionBenchmark()
+        : m_bd(GO_DEFAULT_SIZE, GoSetup(), SuperkoRules())
+    { }
+
+    void Init(const Game& game)
+    {
+        m_bd.Init(game.m_size, game.m_setup);
+    }
+
+    void Run(const Game& game, Result& result)
+    {
+        for (vector<GoPlayerMove>::const_iterator move =
+                 game.m_moves.begin(); move != game.m_moves.end(); ++move)
+        {
+            m_bd.Play(*move);
+            if (m_bd.FullBoardRepetition())
+                ++result.m_checksum;
+        }
+        for (std::size_t i = 0; i < game.m_moves.size(); ++i)
+            m_bd.Undo();
+        result.m_nuOperations += game.m_moves.size();
+    }
+
+private:
+    GoBoard m_bd;
+};
+
+/** Operation for GoBoardCheckPerformance::IsLegal(). */
+struct IsLegalOp
+{
+    void operator()(GoBoard& bd, Result& result)
+    {
+        for (GoBoard::Iterator p(bd); p; ++p)
+            if (bd.IsEmpty(*p))
+            {
+                ++result.m_nuOperations;
+                if (bd.IsLegal(*p))
+                    ++result.m_checksum;
+            }
+    }
+};
+
+/** Operation for GoBoardCheckPerformance::LadderMoves(). */
+struct LadderMovesOp
+{
+    /** Empty points of the current position. */
+    vector<SgPoint> m_empty;
+
+    void operator()(GoBoard& bd, Result& result)
+    {
+        LadderQueries(bd, result);
+        m_empty.clear();
+        for (GoBoard::Iterator p(bd); p; ++p)
+            if (bd.IsEmpty(*p))
+                m_empty.push_back(*p);
+        for (int i = 0; i < LADDER_NU_SIBLINGS; ++i)
+        {
+            const SgPoint p =
+                m_empty[(i * m_empty.size()) / LADDER_NU_SIBLINGS];
+            if (GoBoardUtil::PlayIfLegal(bd, p))
+            {
+                LadderQueries(bd, result);
+                bd.Undo();
+            }
+        }
+    }
+};
+
+/** Benchmark for GoBoardCheckPerformance::LadderMoves().
+    Clears the ladder cache before each game. */
+class LadderMovesBenchmark
+{
+public:
+    void Init(const Game& game)
+    {
+        GoLadderCache::Global().Clear();
+        m_bd.Init(game.m_size, game.m_setup);
+    }
+
+    void Run(const Game& game, Result& result)
+    {
+        GoBoardCheckPerformance::ForEachPosition(m_bd, game, m_op, result);
+    }
+
+private:
+    GoBoard m_bd;
+
+    LadderMovesOp m_op;
+};
+
+/** Operation for GoBoardCheckPerformance::LadderStatus(). */
+struct LadderStatusOp
+{
+    void operator()(GoBoard& bd, Result& result)
+    {
+        for (GoBlockIterator block(bd); block; ++block)
+            if (bd.NumLiberties(*block) <= 2)
+            {
+                ++result.m_nuOperations;
+                result.m_checksum += GoLadderUtil::LadderStatus(bd, *block);
+            }
+    }
+};
+
+/** Operation for GoBoardCheckPerformance::LightLadderStatus(). */
+struct LightLadderStatusOp
+{
+    GoLightLadder m_ladder;
+
+    void operator()(GoBoard& bd, Result& result)
+    {
+        m_ladder.Init(bd);
+        for (GoBlockIterator block(bd); block; ++block)
+            if (bd.NumLiberties(*block) <= 2)
+            {
+                ++result.m_nuOperations;
+                result.m_checksum += m_ladder.LadderStatus(*block);
+            }
+    }
+};
+
+/** Benchmark for GoBoardCheckPerformance::PlayUndo(). */
+class PlayUndoBenchmark
+{
+public:
+    void Init(const Game& game)
+    {
+        m_bd.Init(game.m_size, game.m_setup);
+    }
+
+    void Run(const Game& game, Result& result)
+    {
+        for (vector<GoPlayerMove>::const_iterator move =
+                 game.m_moves.begin(); move != game.m_moves.end(); ++move)
+        {
+            m_bd.Play(*move);
+            result.m_checksum += m_bd.TotalNumStones(SG_BLACK);
+        }
+        for (std::size_t i = 0; i < game.m_moves.size(); ++i)
+            m_bd.Undo();
+        result.m_nuOperations += 2 * game.m_moves.size();
+    }
+
+private:
+    GoBoard m_bd;
+};
+
+/** Benchmark for GoBoardCheckPerformance::Snapshot(). */
+class SnapshotBenchmark
+{
+public:
+    void Init(const Game& game)
+    {
+        m_bd.Init(game.m_size, game.m_setup);
+    }
+
+    void Run(const Game& game, Result& result)
+    {
+        const std::size_t nuMoves = game.m_moves.size();
+        for (std::size_t i = 0; i < nuMoves; ++i)
+        {
+            m_bd.TakeSnapshot();
+            for (std::size_t j = i;
+                 j < nuMoves && j < i + SNAPSHOT_NU_MOVES; ++j)
+                m_bd.Play(game.m_moves[j]);
+            result.m_checksum += m_bd.TotalNumStones(SG_WHITE);
+            m_bd.RestoreSnapshot();
+            m_bd.Play(game.m_moves[i]);
+        }
+        result.m_nuOperations += nuMoves;
+    }
+
+private:
+    GoBoard m_bd;
+};
+
+/** Operation for GoBoardCheckPerformance::StaticSafety(). */
+struct StaticSafetyOp
+{
+    void operator()(GoBoard& bd, Result& result)
+    {
+        ++result.m_nuOperations;
+        GoRegionBoard regions(bd);
+        GoSafetySolver solver(bd, &regions);
+        SgBWSet safe;
+        solver.FindSafePoints(&safe);
+        result.m_checksum += safe.Both().Size();
+    }
+};
+
+/** Benchmark for GoBoardCheckPerformance::StaticSafetyIncremental(). */
+class StaticSafetyIncrementalBenchmark
+{
+public:
+    void Init(const Game& game)
+    {
+        m_bd.Init(game.m_size, game.m_setup);
+    }
+
+    void Run(const Game& game, Result& result)
+    {
+        GoRegionBoard regions(m_bd);
+        for (std::size_t i = 0; i <= game.m_moves.size(); ++i)
+        {
+            GoSafetySolver solver(m_bd, &regions);
+            SgBWSet safe;
+            solver.FindSafePoints(&safe);
+            result.m_checksum += safe.Both().Size();
+            if (i < game.m_moves.size())
+            {
+                regions.ExecuteMovePrologue();
+                m_bd.Play(game.m_moves[i]);
+                regions.OnExecutedMove(game.m_moves[i]);
+            }
+        }
+        result.m_nuOperations += game.m_moves.size() + 1;
+    }
+
+private:
+    GoBoard m_bd;
+};
+
+} // namespace
+
 //----------------------------------------------------------------------------
 
 void GoBoardCheckPerformance::CheckPerformance(const GoBoard& board,
@@ -90,3 +532,249 @@ void GoBoardCheckPerformance::CheckPerformance(const GoBoard& board,
         << "Time4: " << time4 << " For 0..SG_MAXPOINT, no dependency\n"
         << "Time5: " << time5 << " First/LastBoardPoint, no dependency\n";
 }
+
+//----------------------------------------------------------------------------
+
+Game::Game(const GoBoard& bd)
+    : m_size(bd.Size()),
+      m_setup(bd.Setup())
+{
+    for (int i = 0; i < bd.MoveNumber(); ++i)
+        m_moves.push_back(bd.Move(i));
+}
+
+//----------------------------------------------------------------------------
+
+Result::Result(const std::string& name)
+    : m_name(name),
+      m_nuOperations(0),
+      m_time(0),
+      m_checksum(0)
+{ }
+
+double Result::NsPerOperation() const
+{
+    if (m_nuOperations == 0)
+        return 0;
+    return 1e9 * m_time / double(m_nuOperations);
+}
+
+//----------------------------------------------------------------------------
+
+Result GoBoardCheckPerformance::Benson(const vector<Game>& games,
+                                       int nuRepetitions)
+{
+    Result result("goboard_benson");
+    GoBoard bd;
+    BensonOp op;
+    TimePositions(games, nuRepetitions, bd, op, result);
+    return result;
+}
+
+Result GoBoardCheckPerformance::BensonBitboard(const vector<Game>& games,
+                                               int nuRepetitions)
+{
+    Result result("goboard_benson_bitboard");
+    GoBoard bd;
+    BensonBitboardOp op;
+    TimePositions(games, nuRepetitions, bd, op, result);
+    return result;
+}
+
+Result GoBoardCheckPerformance::CanonicalHash(const vector<Game>& games,
+                                              int nuRepetitions)
+{
+    Result result("goboard_canonical_hash");
+    CanonicalHashBenchmark benchmark;
+    TimeGames(games, nuRepetitions, benchmark, result);
+    return result;
+}
+
+Result GoBoardCheckPerformance::CanonicalHashBoards(
+                                                const vector<Game>& games,
+                                                int nuRepetitions)
+{
+    Result result("goboard_canonical_hash_boards");
+    CanonicalHashBoardsBenchmark benchmark;
+    TimeGames(games, nuRepetitions, benchmark, result);
+    return result;
+}
+
+Result GoBoardCheckPerformance::Clone(const vector<Game>& games,
+                                      int nuRepetitions)
+{
+    Result result("goboard_clone");
+    GoBoard bd;
+    CloneOp op;
+    TimePositions(games, nuRepetitions, bd, op, result);
+    return result;
+}
+
+Result GoBoardCheckPerformance::CopyReplay(const vector<Game>& games,
+                                           int nuRepetitions)
+{
+    Result result("goboard_copy_replay");
+    CopyReplayBenchmark benchmark;
+    TimeGames(games, nuRepetitions, benchmark, result);
+    return result;
+}
+
+Result GoBoardCheckPerformance::FullBoardRepetition(const vector<Game>& games,
+                                                    int nuRepetitions)
+{
+    Result result("goboard_full_board_repetition");
+    FullBoardRepetitionBenchmark benchmark;
+    TimeGames(games, nuRepetitions, benchmark, result);
+    return result;
+}
+
+Result GoBoardCheckPerformance::IsLegal(const vector<Game>& games,
+                                        int nuRepetitions)
+{
+    Result result("goboard_is_legal");
+    GoBoard bd;
+    IsLegalOp op;
+    TimePositions(games, nuRepetitions, bd, op, result);
+    return result;
+}
+
+Result GoBoardCheckPerformance::LadderMoves(const vector<Game>& games,
+                                            int nuRepetitions, bool useCache)
+{
+    Result result(useCache ? "goboard_ladder_moves_cached"
+                           : "goboard_ladder_moves");
+    GoLadderCache& cache = GoLadderCache::Global();
+    const bool wasEnabled = cache.IsEnabled();
+    cache.SetEnabled(useCache);
+    LadderMovesBenchmark benchmark;
+    TimeGames(games, nuRepetitions, benchmark, result);
+    cache.SetEnabled(wasEnabled);
+    return result;
+}
+
+Result GoBoardCheckPerformance::LadderStatus(const vector<Game>& games,
+                                             int nuRepetitions)
+{
+    Result result("goboard_ladder_status");
+    GoBoard bd;
+    LadderStatusOp op;
+    TimePositions(games, nuRepetitions, bd, op, result);
+    return result;
+}
+
+Result GoBoardCheckPerformance::LightLadderStatus(const vector<Game>& games,
+                                                  int nuRepetitions)
+{
+    Result result("goboard_light_ladder_status");
+    GoBoard bd;
+    LightLadderStatusOp op;
+    TimePositions(games, nuRepetitions, bd, op, result);
+    return result;
+}
+
+Result GoBoardCheckPerformance::PlayUndo(const vector<Game>& games,
+                                         int nuRepetitions)
+{
+    Result result("goboard_play_undo");
+    PlayUndoBenchmark benchmark;
+    TimeGames(games, nuRepetitions, benchmark, result);
+    return result;
+}
+
+void GoBoardCheckPerformance::RandomGames(int size, int nuGames,
+                                          vector<Game>& games)
+{
+    SgRandom random;
+    GoBoard bd(size);
+    vector<SgPoint> moves;
+    for (int i = 0; i < nuGames; ++i)
+    {
+        bd.Init(size);
+        int nuPass = 0;
+        while (nuPass < 2 && bd.MoveNumber() < 3 * size * size)
+        {
+            moves.clear();
+            for (GoBoard::Iterator it(bd); it; ++it)
+                if (  bd.IsLegal(*it)
+                   && ! GoBoardUtil::IsCompletelySurrounded(bd, *it)
+                   )
+                    moves.push_back(*it);
+            SgPoint p = SG_PASS;
+            if (! moves.empty())
+                p = moves[random.SmallInt(int(moves.size()))];
+            nuPass = (p == SG_PASS ? nuPass + 1 : 0);
+            bd.Play(p);
+        }
+        games.push_back(Game(bd));
+    }
+}
+
+void GoBoardCheckPerformance::RunBenchmarks(const vector<Game>& games,
+                                            int nuRepetitions,
+                                            vector<Result>& results)
+{
+    results.push_back(PlayUndo(games, nuRepetitions));
+    results.push_back(IsLegal(games, nuRepetitions));
+    results.push_back(FullBoardRepetition(games, nuRepetitions));
+    results.push_back(LadderStatus(games, nuRepetitions));
+    results.push_back(LadderMoves(games, nuRepetitions, false));
+    results.push_back(LadderMoves(games, nuRepetitions, true));
+    results.push_back(LightLadderStatus(games, nuRepetitions));
+    results.push_back(Snapshot(games, nuRepetitions));
+    results.push_back(Clone(games, nuRepetitions));
+    results.push_back(CopyReplay(games, nuRepetitions));
+    results.push_back(StaticSafety(games, nuRepetitions));
+    results.push_back(StaticSafetyIncremental(games, nuRepetitions));
+    results.push_back(Benson(games, nuRepetitions));
+    results.push_back(BensonBitboard(games, nuRepetitions));
+    results.push_back(CanonicalHashBoards(games, nuRepetitions));
+    results.push_back(CanonicalHash(games, nuRepetitions));
+}
+
+Result GoBoardCheckPerformance::Snapshot(const vector<Game>& games,
+                                         int nuRepetitions)
+{
+    Result result("goboard_snapshot");
+    SnapshotBenchmark benchmark;
+    TimeGames(games, nuRepetitions, benchmark, result);
+    return result;
+}
+
+Result GoBoardCheckPerformance::StaticSafety(const vector<Game>& games,
+                                             int nuRepetitions)
+{
+    Result result("goboard_static_safety");
+    GoBoard bd;
+    StaticSafetyOp op;
+    TimePositions(games, nuRepetitions, bd, op, result);
+    return result;
+}
+
+Result GoBoardCheckPerformance::StaticSafetyIncremental(
+                                                    const vector<Game>& games,
+                                                    int nuRepetitions)
+{
+    Result result("goboard_static_safety_incremental");
+    StaticSafetyIncrementalBenchmark benchmark;
+    TimeGames(games, nuRepetitions, benchmark, result);
+    return result;
+}
+
+void GoBoardCheckPerformance::WriteHeader(std::ostream& out)
+{
+    out << "# benchmark\tcorpus\tsize\toperations\ttime\tns_per_operation"
+        "\tchecksum\n";
+}
+
+void GoBoardCheckPerformance::WriteResult(std::ostream& out,
+                                          const std::string& corpus,
+                                          int boardSize, const Result& result)
+{
+    out << result.m_name << '\t' << corpus << '\t' << boardSize << '\t'
+        << result.m_nuOperations << '\t'
+        << std::fixed << std::setprecision(3) << result.m_time << '\t'
+        << std::setprecision(1) << result.NsPerOperation() << '\t'
+        << result.m_checksum << '\n';
+}
+
+//----------------------------------------------------------------------------
@@ -2,15 +2,21 @@
 /** @file GoBoardCheckPerformance.h
     Check performance of the GoBoard class.
 
-    @todo check performance on different kinds of positions.
-    check execute/undo move, full board repetition, etc. */
+    Contains the GoBoard part of the benchmark suite run by the program
+    fuego_benchmark (see benchmark/FuegoBenchmarkMain.cpp), which replays
+    the games of a corpus of SGF files. */
 //----------------------------------------------------------------------------
 
 #ifndef GO_BOARDCHECKPERFORMANCE_H
 #define GO_BOARDCHECKPERFORMANCE_H
 
 #include <iosfwd>
+#include <string>
+#include <vector>
 #include "GoBoard.h"
+#include "GoPlayerMove.h"
+#include "GoSetup.h"
+#include "SgTime.h"
 
 //----------------------------------------------------------------------------
 
@@ -49,6 +55,266 @@ namespace GoBoardCheckPerformance
     @endverbatim */
 void CheckPerformance(const GoBoard& board, std::ostream& out);
 
+/** Game replayed by the benchmarks. */
+struct Game
+{
+    int m_size;
+
+    GoSetup m_setup;
+
+    std::vector<GoPlayerMove> m_moves;
+
+    /** Take the setup and the moves played on a board. */
+    explicit Game(const GoBoard& bd);
+};
+
+/** Result of a benchmark. */
+struct Result
+{
+    std::string m_name;
+
+    /** Number of timed operations.
+        See the benchmark functions for what is counted as an operation. */
+    std::size_t m_nuOperations;
+
+    /** Total time in seconds (real time). */
+    double m_time;
+
+    /** Checksum of values computed by the benchmark.
+        Does not depend on the speed of the machine and changes only if the
+        benchmarked code changes its behavior. Also avoids that the
+        benchmark loops are optimized away. */
+    std::size_t m_checksum;
+
+    explicit Result(const std::string& name);
+
+    /** Time per operation in nanoseconds. */
+    double NsPerOperation() const;
+};
+
+/** Time a benchmark on all games.
+    For each repetition and game, calls <code>benchmark.Init(game)</code>,
+    which is not timed, and <code>benchmark.Run(game, result)</code>, which
+    is timed. Run() adds the operations and the checksum to the result.
+    @see TimePositions() */
+template<class BENCHMARK>
+void TimeGames(const std::vector<Game>& games, int nuRepetitions,
+               BENCHMARK& benchmark, Result& result)
+{
+    for (int i = 0; i < nuRepetitions; ++i)
+        for (std::vector<Game>::const_iterator it = games.begin();
+             it != games.end(); ++it)
+        {
+            benchmark.Init(*it);
+            const double startTime = SgTime::Get(SG_TIME_REAL);
+            benchmark.Run(*it, result);
+            result.m_time += SgTime::Get(SG_TIME_REAL) - startTime;
+        }
+}
+
+/** Call an operation in all positions of a game.
+    The board must be in the start position of the game. Calls
+    <code>op(bd, result)</code> before each move of the game and after the
+    last move. The operation adds its operations and the checksum to the
+    result; it may play moves, but must restore the position. */
+template<class OPERATION>
+void ForEachPosition(GoBoard& bd, const Game& game, OPERATION& op,
+                     Result& result)
+{
+    for (std::size_t i = 0; i <= game.m_moves.size(); ++i)
+    {
+        op(bd, result);
+        if (i < game.m_moves.size())
+            bd.Play(game.m_moves[i]);
+    }
+}
+
+/** Benchmark for TimeGames() that calls an operation in all positions of
+    the games.
+    See TimePositions() */
+template<class OPERATION>
+class PositionBenchmark
+{
+public:
+    PositionBenchmark(GoBoard& bd, OPERATION& op);
+
+    void Init(const Game& game);
+
+    void Run(const Game& game, Result& result);
+
+private:
+    GoBoard& m_bd;
+
+    OPERATION& m_op;
+};
+
+template<class OPERATION>
+PositionBenchmark<OPERATION>::PositionBenchmark(GoBoard& bd, OPERATION& op)
+    : m_bd(bd),
+      m_op(op)
+{ }
+
+template<class OPERATION>
+void PositionBenchmark<OPERATION>::Init(const Game& game)
+{
+    m_bd.Init(game.m_size, game.m_setup);
+}
+
+template<class OPERATION>
+void PositionBenchmark<OPERATION>::Run(const Game& game, Result& result)
+{
+    ForEachPosition(m_bd, game, m_op, result);
+}
+
+/** Time an operation in all positions of the games.
+    Replays the games on the board and calls the operation as in
+    ForEachPosition(). Initializing the board with the setup of a game is
+    not timed, replaying the moves is. */
+template<class OPERATION>
+void TimePositions(const std::vector<Game>& games, int nuRepetitions,
+                   GoBoard& bd, OPERATION& op, Result& result)
+{
+    PositionBenchmark<OPERATION> benchmark(bd, op);
+    TimeGames(games, nuRepetitions, benchmark, result);
+}
+
+/** Generate games with random moves.
+    The moves are legal with situational superko and do not fill
+    completely surrounded points (see GoBoardUtil::IsCompletelySurrounded).
+    A game ends after two passes or 3 * size * size moves. The games are
+    longer than real games and contain many captures, which makes most
+    moves potential full board repetitions. */
+void RandomGames(int size, int nuGames, std::vector<Game>& games);
+
+/** Write the column names of WriteResult() as a comment line. */
+void WriteHeader(std::ostream& out);
+
+/** Write a result as one line of tab-separated columns.
+    Columns: benchmark name, name of the games corpus, board size, number of
+    operations, total time in seconds, time per operation in nanoseconds,
+    checksum. */
+void WriteResult(std::ostream& out, const std::string& corpus, int boardSize,
+                 const Result& result);
+
+/** Replay the games with GoBoard::Play() and take back all moves with
+    GoBoard::Undo().
+    Operations: Play and Undo calls. */
+Result PlayUndo(const std::vector<Game>& games, int nuRepetitions);
+
+/** Call GoBensonSolver::FindSafePoints() in all positions of the games.
+    Operations: FindSafePoints calls. The checksum is the number of safe
+    points and is the same as the checksum of BensonBitboard(). The time
+    includes replaying the games. */
+Result Benson(const std::vector<Game>& games, int nuRepetitions);
+
+/** Call GoBensonBitboard::FindSafePoints() in all positions of the games.
+    Operations: FindSafePoints calls. The time includes replaying the
+    games.
+    @see Benson() */
+Result BensonBitboard(const std::vector<Game>& games, int nuRepetitions);
+
+/** Replay the games on a GoBoard, update a GoCanonicalHash after each
+    move and take back all moves.
+    This is how GoAutoBookState tracks the canonical hash code.
+    Operations: Play and Undo calls. The checksum is computed from the
+    canonical hash codes; it can differ from the checksum of
+    CanonicalHashBoards() in games with captures of more than one stone
+    (see GoCanonicalHash).
+    @see CanonicalHashBoards() */
+Result CanonicalHash(const std::vector<Game>& games, int nuRepetitions);
+
+/** Replay the games on eight boards with the moves transformed by each
+    symmetry, compute the minimum of their hash codes after each move and
+    take back all moves.
+    This is how GoAutoBookState tracked the canonical hash code before
+    GoCanonicalHash existed.
+    Operations: Play and Undo calls on the first board.
+    @see CanonicalHash() */
+Result CanonicalHashBoards(const std::vector<Game>& games,
+                           int nuRepetitions);
+
+/** Copy each position of the games to another board with
+    GoBoard::InitClone().
+    Operations: InitClone calls. The time includes replaying the games,
+    which is small compared to the InitClone calls.
+    @see CopyReplay() */
+Result Clone(const std::vector<Game>& games, int nuRepetitions);
+
+/** Copy each position of the games to another board by initializing it
+    with the setup of the game and replaying the moves.
+    This is how positions were copied before GoBoard::InitClone() existed
+    (e.g. in GoBoardSynchronizer).
+    Operations: copied positions. */
+Result CopyReplay(const std::vector<Game>& games, int nuRepetitions);
+
+/** Call GoBoard::IsLegal() for all empty points in all positions of the
+    games.
+    Operations: IsLegal calls. The time includes replaying the games, which
+    is small compared to the IsLegal calls. */
+Result IsLegal(const std::vector<Game>& games, int nuRepetitions);
+
+/** Call GoBoard::FullBoardRepetition() after each move of the games with
+    positional superko rules.
+    Operations: FullBoardRepetition calls. The time includes PlayUndo(),
+    subtract its time per operation to get the time of the repetition
+    check. */
+Result FullBoardRepetition(const std::vector<Game>& games,
+                           int nuRepetitions);
+
+/** Call GoLadderUtil::LadderStatus() for all blocks with one or two
+    liberties in all positions of the games.
+    Uses the default rules (situational superko), such that the ladder
+    search checks for full board repetitions.
+    Operations: LadderStatus calls. */
+Result LadderStatus(const std::vector<Game>& games, int nuRepetitions);
+
+/** Call GoLadderUtil::IsLadderCaptureMove() for the liberties of all blocks
+    with two liberties and GoLadderUtil::FindLadderEscapeMoves() for all
+    blocks in atari, like GoUctLadderKnowledge does.
+    The queries are done in all positions of the games and in the positions
+    after eight moves spread over the empty points, which are similar to
+    the child nodes that a search expands.
+    Operations: IsLadderCaptureMove and FindLadderEscapeMoves calls.
+    @param games
+    @param nuRepetitions
+    @param useCache Use GoLadderCache::Global(). The cache is cleared before
+    each game. Has the same checksum as without the cache. */
+Result LadderMoves(const std::vector<Game>& games, int nuRepetitions,
+                   bool useCache);
+
+/** Call GoLightLadder::LadderStatus() for all blocks with one or two
+    liberties in all positions of the games.
+    Same queries as LadderStatus(). The time includes copying each position
+    with GoLightLadder::Init().
+    Operations: LadderStatus calls. */
+Result LightLadderStatus(const std::vector<Game>& games, int nuRepetitions);
+
+/** Call GoBoard::TakeSnapshot() in each position of the games, play the
+    next moves of the game and restore the position with
+    GoBoard::RestoreSnapshot().
+    Operations: TakeSnapshot/RestoreSnapshot pairs. The time includes
+    playing the moves. */
+Result Snapshot(const std::vector<Game>& games, int nuRepetitions);
+
+/** Call GoSafetySolver::FindSafePoints() in all positions of the games
+    with a GoRegionBoard computed from scratch in each position.
+    Operations: FindSafePoints calls. The checksum is the number of safe
+    points and is the same as the checksum of StaticSafetyIncremental().
+    The time includes replaying the games. */
+Result StaticSafety(const std::vector<Game>& games, int nuRepetitions);
+
+/** Call GoSafetySolver::FindSafePoints() in all positions of the games
+    with a GoRegionBoard that is updated incrementally after each move.
+    Operations: FindSafePoints calls. The time includes replaying the games
+    and updating the GoRegionBoard.
+    @see StaticSafety() */
+Result StaticSafetyIncremental(const std::vector<Game>& games,
+                               int nuRepetitions);
+
+/** Run all GoBoard benchmarks. */
+void RunBenchmarks(const std::vector<Game>& games, int nuRepetitions,
+                   std::vector<Result>& results);
+
 } // namespace GoBoardCheckPerformance
 
 //----------------------------------------------------------------------------
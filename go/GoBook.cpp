@@ -85,6 +85,7 @@ void GoBook::Entry::ApplyTo(GoBoard& bd) const
 
 void GoBook::Add(const GoBoard& bd, SgPoint move)
 {
+    ThrowIfBinary("add moves to");
     if (move != SG_PASS && bd.Occupied(move))
         throw SgException("point is not empty");
     if (! bd.IsLegal(move))
@@ -113,10 +114,12 @@ void GoBook::Clear()
 {
     m_entries.clear();
     m_map.clear();
+    m_binaryBook.Close();
 }
 
 void GoBook::Delete(const GoBoard& bd, SgPoint move)
 {
+    ThrowIfBinary("delete moves from");
     const GoBook::MapEntry* mapEntry = LookupEntry(bd);
     if (mapEntry == 0)
         return;
@@ -201,6 +204,15 @@ void GoBook::InsertEntry(const vector<SgPoint>& sequence,
 
 int GoBook::Line(const GoBoard& bd) const
 {
+    if (m_binaryBook.IsOpen())
+    {
+        vector<SgPoint> moves;
+        int line;
+        if (! m_binaryBook.LookupMoves(bd.GetHashCodeInclToPlay(), bd.Size(),
+                                       moves, line))
+            return 0;
+        return line;
+    }
     const GoBook::MapEntry* mapEntry = LookupEntry(bd);
     if (mapEntry == 0)
         return 0;
@@ -234,18 +246,32 @@ SgPoint GoBook::LookupMove(const GoBoard& bd) const
 vector<SgPoint> GoBook::LookupAllMoves(const GoBoard& bd) const
 {
     vector<SgPoint> result;
-    const GoBook::MapEntry* mapEntry = LookupEntry(bd);
-    if (mapEntry == 0)
-        return result;
-    size_t id = mapEntry->m_id;
-    SG_ASSERT(id < m_entries.size());
-    const vector<SgPoint>& moves = m_entries[id].m_moves;
-    const int rotation = mapEntry->m_rotation;
-    const int size = mapEntry->m_size;
+    vector<SgPoint> moves;
+    if (m_binaryBook.IsOpen())
+    {
+        // Moves in a binary book are already rotated
+        int line;
+        m_binaryBook.LookupMoves(bd.GetHashCodeInclToPlay(), bd.Size(),
+                                 moves, line);
+    }
+    else
+    {
+        const GoBook::MapEntry* mapEntry = LookupEntry(bd);
+        if (mapEntry == 0)
+            return result;
+        size_t id = mapEntry->m_id;
+        SG_ASSERT(id < m_entries.size());
+        const vector<SgPoint>& entryMoves = m_entries[id].m_moves;
+        const int rotation = mapEntry->m_rotation;
+        const int size = mapEntry->m_size;
+        for (vector<SgPoint>::const_iterator it = entryMoves.begin();
+             it != entryMoves.end(); ++it)
+            moves.push_back(SgPointUtil::Rotate(rotation, *it, size));
+    }
     for (vector<SgPoint>::const_iterator it = moves.begin();
          it != moves.end(); ++it)
     {
-        SgPoint p = SgPointUtil::Rotate(rotation, *it, size);
+        SgPoint p = *it;
         if (! bd.IsLegal(p))
         {
             // Should not happen with 64-bit hashes, but not impossible
@@ -299,6 +325,12 @@ void GoBook::Read(std::istream& in, const string& streamName)
 
 void GoBook::Read(const string& filename)
 {
+    if (GoBinaryBook::IsBinaryBook(filename))
+    {
+        Clear();
+        m_binaryBook.Open(filename);
+        return;
+    }
     std::ifstream in(filename.c_str());
     if (! in)
         throw SgException("Cannot find file " + filename);
@@ -324,6 +356,12 @@ vector<SgPoint> GoBook::ReadPoints(std::istream& in) const
     return result;
 }
 
+void GoBook::ThrowIfBinary(const string& operation) const
+{
+    if (m_binaryBook.IsOpen())
+        throw SgException("cannot " + operation + " binary book");
+}
+
 void GoBook::ThrowError(const string& message) const
 {
     std::ostringstream out;
@@ -335,6 +373,7 @@ void GoBook::ThrowError(const string& message) const
 
 void GoBook::Write(std::ostream& out) const
 {
+    ThrowIfBinary("write text format of");
     for (vector<Entry>::const_iterator it = m_entries.begin();
          it != m_entries.end(); ++it)
     {
@@ -355,8 +394,40 @@ void GoBook::Write(std::ostream& out) const
     }
 }
 
+void GoBook::WriteBinary(std::ostream& out) const
+{
+    ThrowIfBinary("convert");
+    vector<GoBinaryBook::MovesEntry> binaryEntries;
+    for (Map::const_iterator it = m_map.begin(); it != m_map.end(); ++it)
+    {
+        const MapEntry& mapEntry = it->second;
+        SG_ASSERT(mapEntry.m_id < m_entries.size());
+        const Entry& entry = m_entries[mapEntry.m_id];
+        if (entry.m_moves.empty())
+            continue;
+        GoBinaryBook::MovesEntry binaryEntry;
+        binaryEntry.m_hash = it->first;
+        binaryEntry.m_size = mapEntry.m_size;
+        binaryEntry.m_line = entry.m_line;
+        for (vector<SgPoint>::const_iterator it2 = entry.m_moves.begin();
+             it2 != entry.m_moves.end(); ++it2)
+            binaryEntry.m_moves.push_back(
+                  SgPointUtil::Rotate(mapEntry.m_rotation, *it2,
+                                      mapEntry.m_size));
+        binaryEntries.push_back(binaryEntry);
+    }
+    GoBinaryBook::WriteMoves(out, binaryEntries);
+}
+
 void GoBook::WriteInfo(std::ostream& out) const
 {
+    if (m_binaryBook.IsOpen())
+    {
+        out << SgWriteLabel("Binary") << m_binaryBook.FileName() << '\n'
+            << SgWriteLabel("NuTransformed") << m_binaryBook.NuEntries()
+            << '\n';
+        return;
+    }
     out << SgWriteLabel("NuBasic") << m_entries.size() << '\n'
         << SgWriteLabel("NuTransformed") << m_map.size() << '\n';
 }
@@ -366,7 +437,8 @@ void GoBook::WriteInfo(std::ostream& out) const
 GoBookCommands::GoBookCommands(GoGtpEngine &engine, const GoBoard& bd, GoBook& book)
     : m_engine(engine),
       m_bd(bd),
-      m_book(book)
+      m_book(book),
+      m_sharedBook(0)
 { }
 
 void GoBookCommands::AddGoGuiAnalyzeCommands(GtpCommand& cmd)
@@ -380,7 +452,8 @@ void GoBookCommands::AddGoGuiAnalyzeCommands(GtpCommand& cmd)
         "plist/Book Moves/book_moves\n"
         "gfx/Book Position/book_position\n"
         "none/Book Save/book_save\n"
-        "none/Book Save As/book_save_as %w\n";
+        "none/Book Save As/book_save_as %w\n"
+        "none/Book Save Binary/book_save_binary %w\n";
 }
 
 /** Add a move for the current position to the book.
@@ -391,7 +464,7 @@ void GoBookCommands::CmdAdd(GtpCommand& cmd)
     SgPoint p = GoGtpCommandUtil::PointArg(cmd, m_bd);
     try
     {
-        m_book.Add(m_bd, p);
+        ModifiableBook().Add(m_bd, p);
     }
     catch (const SgException& e)
     {
@@ -403,7 +476,7 @@ void GoBookCommands::CmdAdd(GtpCommand& cmd)
 void GoBookCommands::CmdClear(GtpCommand& cmd)
 {
     cmd.CheckArgNone();
-    m_book.Clear();
+    ModifiableBook().Clear();
 }
 
 /** Delete a move for the current position to the book.
@@ -411,13 +484,16 @@ void GoBookCommands::CmdClear(GtpCommand& cmd)
     Returns: Position information after the move deletion as in CmdPosition() */
 void GoBookCommands::CmdDelete(GtpCommand& cmd)
 {
-    vector<SgPoint> moves = m_book.LookupAllMoves(m_bd);
+    GoBook& book = ModifiableBook();
+    if (book.IsBinary())
+        throw GtpFailure("cannot delete moves from binary book");
+    vector<SgPoint> moves = book.LookupAllMoves(m_bd);
     if (moves.empty())
         throw GtpFailure("book contains no moves for current position");
     SgPoint p = GoGtpCommandUtil::PointArg(cmd, m_bd);
     try
     {
-        m_book.Delete(m_bd, p);
+        book.Delete(m_bd, p);
     }
     catch (const SgException& e)
     {
@@ -432,15 +508,16 @@ void GoBookCommands::CmdInfo(GtpCommand& cmd)
 {
     cmd.CheckArgNone();
     cmd << SgWriteLabel("FileName") << m_fileName << '\n';
-    m_book.WriteInfo(cmd);
+    Book().WriteInfo(cmd);
 }
 
 void GoBookCommands::CmdLoad(GtpCommand& cmd)
 {
+    GoBook& book = ModifiableBook();
     m_fileName = cmd.Arg();
     try
     {
-        m_book.Read(m_fileName);
+        book.Read(m_fileName);
     }
     catch (const SgException& e)
     {
@@ -452,7 +529,7 @@ void GoBookCommands::CmdLoad(GtpCommand& cmd)
 void GoBookCommands::CmdMoves(GtpCommand& cmd)
 {
     cmd.CheckArgNone();
-    vector<SgPoint> active = m_book.LookupAllMoves(m_bd);
+    vector<SgPoint> active = Book().LookupAllMoves(m_bd);
     for (vector<SgPoint>::const_iterator it = active.begin();
          it != active.end(); ++it)
         cmd << SgWritePoint(*it) << ' ';
@@ -478,8 +555,10 @@ void GoBookCommands::CmdSave(GtpCommand& cmd)
     cmd.CheckArgNone();
     if (m_fileName == "")
         throw GtpFailure("no filename associated with current book");
+    if (Book().IsBinary())
+        throw GtpFailure("cannot save binary book");
     ofstream out(m_fileName.c_str());
-    m_book.Write(out);
+    Book().Write(out);
     if (! out)
     {
         throw GtpFailure() << "error writing to file '" << m_fileName << "'";
@@ -491,9 +570,11 @@ void GoBookCommands::CmdSaveAs(GtpCommand& cmd)
 {
     if (m_engine.MpiSynchronizer()->IsRootProcess())
     {
+        if (Book().IsBinary())
+            throw GtpFailure("cannot save binary book");
         m_fileName = cmd.Arg();
         ofstream out(m_fileName.c_str());
-        m_book.Write(out);
+        Book().Write(out);
         if (! out)
         {
             m_fileName = "";
@@ -502,9 +583,40 @@ void GoBookCommands::CmdSaveAs(GtpCommand& cmd)
     }
 }
 
+/** Convert the current book to a binary book.
+    See GoBinaryBook. The book can then be loaded with book_load.
+    Arguments: file name */
+void GoBookCommands::CmdSaveBinary(GtpCommand& cmd)
+{
+    if (m_engine.MpiSynchronizer()->IsRootProcess())
+    {
+        if (Book().IsBinary())
+            throw GtpFailure("book is already a binary book");
+        ofstream out(cmd.Arg().c_str(), std::ios::binary);
+        try
+        {
+            Book().WriteBinary(out);
+        }
+        catch (const SgException& e)
+        {
+            throw GtpFailure(e.what());
+        }
+        if (! out)
+            throw GtpFailure("write error");
+    }
+}
+
+GoBook& GoBookCommands::ModifiableBook()
+{
+    if (m_sharedBook != 0)
+        throw GtpFailure("opening book is shared with other engines"
+                         " and cannot be modified");
+    return m_book;
+}
+
 void GoBookCommands::PositionInfo(GtpCommand& cmd)
 {
-    vector<SgPoint> active = m_book.LookupAllMoves(m_bd);
+    vector<SgPoint> active = Book().LookupAllMoves(m_bd);
     vector<SgPoint> other;
     {
         GoModBoard modBoard(m_bd);
@@ -513,7 +625,7 @@ void GoBookCommands::PositionInfo(GtpCommand& cmd)
             if (bd.IsLegal(*it) && ! Contains(active, *it))
             {
                 bd.Play(*it);
-                if (! m_book.LookupAllMoves(bd).empty())
+                if (! Book().LookupAllMoves(bd).empty())
                     other.push_back(*it);
                 bd.Undo();
             }
@@ -526,7 +638,7 @@ void GoBookCommands::PositionInfo(GtpCommand& cmd)
     for (vector<SgPoint>::const_iterator it = other.begin();
          it != other.end(); ++it)
         cmd << ' ' << SgWritePoint(*it);
-    int line = m_book.Line(m_bd);
+    int line = Book().Line(m_bd);
     cmd << "\nTEXT Line=" << line << " Active=" << active.size() << " Other="
         << other.size() << '\n';
 }
@@ -542,6 +654,7 @@ void GoBookCommands::Register(GtpEngine& e)
     e.Register("book_position", &GoBookCommands::CmdPosition, this);
     e.Register("book_save", &GoBookCommands::CmdSave, this);
     e.Register("book_save_as", &GoBookCommands::CmdSaveAs, this);
+    e.Register("book_save_binary", &GoBookCommands::CmdSaveBinary, this);
 }
 
 //----------------------------------------------------------------------------
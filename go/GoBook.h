@@ -10,6 +10,7 @@
 #include <map>
 #include <string>
 #include <vector>
+#include "GoBinaryBook.h"
 #include "GtpEngine.h"
 #include "SgHash.h"
 #include "SgPoint.h"
@@ -32,7 +33,11 @@ class GoBoard;
     mirroring. If there are duplicates, because of sequences with move
     transpositions or rotating/mirroring, reading will throw an exception
     containing an error message with line number information of the
-    duplicates. */
+    duplicates.
+
+    A book can also be read from a binary file written by WriteBinary(),
+    see GoBinaryBook. A binary book is read-only, Add(), Delete() and
+    Write() throw an exception. */
 
 class GoGtpEngine;
 
@@ -58,13 +63,14 @@ public:
 
     /** Add a book move to the current position.
         @throws SgException if move cannot be added (illegal or move sequence
-        to current position cannot be determined) */
+        to current position cannot be determined, or binary book) */
     void Add(const GoBoard& bd, SgPoint move);
 
     void Clear();
 
     /** Deletes a book move in the current position.
-        @throws SgException if the move is not a book move. */
+        @throws SgException if the move is not a book move or the book is a
+        binary book. */
     void Delete(const GoBoard& bd, SgPoint move);
 
     /** Get an entry.
@@ -84,18 +90,30 @@ public:
 
     std::vector<SgPoint> LookupAllMoves(const GoBoard& bd) const;
 
+    /** Number of entries.
+        Always 0 for a binary book, which contains only the transformed
+        entries. */
     std::size_t NuEntries() const;
 
+    bool IsBinary() const;
+
     /** Read book from stream.
         @param in
         @param streamName Name used for error messages (e.g. file name) */
     void Read(std::istream& in, const std::string& streamName = "");
 
-    /** Read book from file. */
+    /** Read book from file.
+        Opens the file as a GoBinaryBook, if it is a binary book. */
     void Read(const std::string& filename);
 
+    /** Write book in text format.
+        @throws SgException if the book is a binary book. */
     void Write(std::ostream& out) const;
 
+    /** Write book in the format of GoBinaryBook.
+        @throws SgException if the book is a binary book. */
+    void WriteBinary(std::ostream& out) const;
+
     void WriteInfo(std::ostream& out) const;
 
 private:
@@ -128,6 +146,9 @@ private:
     /** Mapping hash key to entries. */
     Map m_map;
 
+    /** Binary book, used instead of m_entries and m_map if open. */
+    GoBinaryBook m_binaryBook;
+
     void InsertEntry(const std::vector<SgPoint>& sequence,
                      const std::vector<SgPoint>& moves, int size,
                      GoBoard& tempBoard, int line);
@@ -138,6 +159,8 @@ private:
 
     std::vector<SgPoint> ReadPoints(std::istream& in) const;
 
+    void ThrowIfBinary(const std::string& operation) const;
+
     void ThrowError(const std::string& message) const;
 };
 
@@ -147,6 +170,11 @@ inline const GoBook::Entry& GoBook::GetEntry(std::size_t index) const
     return m_entries[index];
 }
 
+inline bool GoBook::IsBinary() const
+{
+    return m_binaryBook.IsOpen();
+}
+
 inline std::size_t GoBook::NuEntries() const
 {
     return m_entries.size();
@@ -164,6 +192,14 @@ public:
 
     void Register(GtpEngine& e);
 
+    /** Use a book that is shared with other engines.
+        The commands that read the book use the shared book, the commands
+        that modify it fail.
+        @param book The book (not owned), 0 for using the book given in the
+        constructor (default)
+        @see GoGtpEngine::SetSharedBook() */
+    void SetSharedBook(const GoBook* book);
+
     /** @page gobookcommands GoBookCommands
         - @link CmdAdd() @c book_add @endlink
         - @link CmdClear() @c book_clear @endlink
@@ -173,7 +209,8 @@ public:
         - @link CmdMoves() @c book_moves @endlink
         - @link CmdPosition() @c book_position @endlink
         - @link CmdSave() @c book_save @endlink
-        - @link CmdSaveAs() @c book_save_as @endlink */
+        - @link CmdSaveAs() @c book_save_as @endlink
+        - @link CmdSaveBinary() @c book_save_binary @endlink */
     /** @name Command Callbacks */
     // @{
     // The callback functions are documented in the cpp file
@@ -186,6 +223,7 @@ public:
     void CmdPosition(GtpCommand& cmd);
     void CmdSave(GtpCommand& cmd);
     void CmdSaveAs(GtpCommand& cmd);
+    void CmdSaveBinary(GtpCommand& cmd);
     // @} // @name
 
 private:
@@ -195,11 +233,33 @@ private:
 
     GoBook& m_book;
 
+    /** See SetSharedBook() */
+    const GoBook* m_sharedBook;
+
     std::string m_fileName;
 
+    /** The book used by the commands that read the book. */
+    const GoBook& Book() const;
+
+    /** The book used by the commands that modify the book.
+        @throws GtpFailure If a shared book is set. */
+    GoBook& ModifiableBook();
+
     void PositionInfo(GtpCommand& cmd);
 };
 
+inline const GoBook& GoBookCommands::Book() const
+{
+    if (m_sharedBook != 0)
+        return *m_sharedBook;
+    return m_book;
+}
+
+inline void GoBookCommands::SetSharedBook(const GoBook* book)
+{
+    m_sharedBook = book;
+}
+
 //----------------------------------------------------------------------------
 
 #endif // GO_BOOK_H
@@ -0,0 +1,165 @@
+//----------------------------------------------------------------------------
+/** @file GoCanonicalHash.cpp
+    See GoCanonicalHash.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoCanonicalHash.h"
+
+#include <algorithm>
+#include "GoBoard.h"
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Same order as SgHash::operator<, but compares words instead of bits. */
+inline bool Less(const SgHashCode& code1, const SgHashCode& code2)
+{
+    const unsigned int high1 = code1.Code2();
+    const unsigned int high2 = code2.Code2();
+    if (high1 != high2)
+        return high1 < high2;
+    return code1.Code1() < code2.Code1();
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+GoCanonicalHash::GoCanonicalHash()
+    : m_size(0)
+{ }
+
+SgHashCode GoCanonicalHash::Compute(const GoBoard& bd)
+{
+    GoCanonicalHash hash;
+    hash.Init(bd);
+    return hash.Canonical();
+}
+
+SgHashCode GoCanonicalHash::Get(int rotation) const
+{
+    SG_ASSERT(! m_stack.empty());
+    SG_ASSERTRANGE(rotation, 0, NU_SYMMETRIES - 1);
+    const Entry& entry = m_stack.back();
+    SgHashCode hash = entry.m_hash[rotation];
+    XorToPlay(hash, entry.m_toPlay);
+    return hash;
+}
+
+void GoCanonicalHash::Init(const GoBoard& bd)
+{
+    m_size = bd.Size();
+    m_stack.clear();
+    Entry entry;
+    for (int rot = 0; rot < NU_SYMMETRIES; ++rot)
+        entry.m_hash[rot].Clear();
+    const GoSetup& setup = bd.Setup();
+    for (SgBWIterator c; c; ++c)
+        for (SgSetIterator it(setup.m_stones[*c]); it; ++it)
+            for (int rot = 0; rot < NU_SYMMETRIES; ++rot)
+                XorStone(entry.m_hash[rot],
+                         SgPointUtil::Rotate(rot, *it, m_size), *c);
+    m_stack.push_back(entry);
+    if (bd.MoveNumber() > 0)
+    {
+        GoBoard replay(bd.Size(), setup, bd.Rules());
+        replay.SetKoModifiesHash(bd.KoModifiesHash());
+        for (int i = 0; i < bd.MoveNumber(); ++i)
+        {
+            const GoPlayerMove move = bd.Move(i);
+            replay.Play(move.Point(), move.Color());
+            Play(replay);
+        }
+    }
+    m_stack.back().m_toPlay = bd.ToPlay();
+    UpdateCanonical(m_stack.back());
+}
+
+void GoCanonicalHash::Play(const GoBoard& bd)
+{
+    SG_ASSERT(! m_stack.empty());
+    SG_ASSERT(bd.Size() == m_size);
+    SG_ASSERT(bd.MoveNumber() > 0);
+    const GoPlayerMove move = bd.Move(bd.MoveNumber() - 1);
+    const SgPoint p = move.Point();
+    const SgBlackWhite c = move.Color();
+    m_stack.push_back(m_stack.back());
+    Entry& entry = m_stack.back();
+    if (p != SG_PASS)
+    {
+        const GoPointList& captured = bd.CapturedStones();
+        // A suicide removes the own stones, a capture the opponent stones
+        const SgBlackWhite capturedColor =
+            (bd.LastMoveInfo(GO_MOVEFLAG_SUICIDE) ? c : SgOppBW(c));
+        const bool xorCaptured = (! captured.IsEmpty()
+                                  && bd.KoModifiesHash());
+        for (int rot = 0; rot < NU_SYMMETRIES; ++rot)
+        {
+            SgHashCode& hash = entry.m_hash[rot];
+            XorStone(hash, SgPointUtil::Rotate(rot, p, m_size), c);
+            for (GoPointList::Iterator it(captured); it; ++it)
+                XorStone(hash, SgPointUtil::Rotate(rot, *it, m_size),
+                         capturedColor);
+            if (xorCaptured)
+            {
+                // GoBoard uses the first captured stone, but the order of
+                // the captured stones depends on the transformation of the
+                // game, so use the smallest transformed point instead
+                SgPoint first = SG_MAXPOINT;
+                for (GoPointList::Iterator it(captured); it; ++it)
+                    first = std::min(first,
+                                     SgPointUtil::Rotate(rot, *it, m_size));
+                XorCaptured(hash, bd.MoveNumber(), first);
+            }
+        }
+    }
+    entry.m_toPlay = bd.ToPlay();
+    UpdateCanonical(entry);
+}
+
+void GoCanonicalHash::Undo()
+{
+    SG_ASSERT(NuMoves() > 0);
+    m_stack.pop_back();
+}
+
+void GoCanonicalHash::UpdateCanonical(Entry& entry) const
+{
+    SgHashCode hash = entry.m_hash[0];
+    XorToPlay(hash, entry.m_toPlay);
+    entry.m_canonical = hash;
+    entry.m_canonicalRotation = 0;
+    for (int rot = 1; rot < NU_SYMMETRIES; ++rot)
+    {
+        hash = entry.m_hash[rot];
+        XorToPlay(hash, entry.m_toPlay);
+        if (Less(hash, entry.m_canonical))
+        {
+            entry.m_canonical = hash;
+            entry.m_canonicalRotation = rot;
+        }
+    }
+}
+
+void GoCanonicalHash::XorCaptured(SgHashCode& hash, int moveNumber,
+                                  SgPoint p)
+{
+    // Same index as GoBoard::HashCode::XorCaptured()
+    SgHashUtil::XorZobrist(hash, 2 * SG_MAXPOINT + moveNumber % 64 + p);
+}
+
+void GoCanonicalHash::XorStone(SgHashCode& hash, SgPoint p, SgBlackWhite c)
+{
+    // Same index as GoBoard::HashCode::XorStone()
+    SgHashUtil::XorZobrist(hash, p + c * SG_MAXPOINT);
+}
+
+void GoCanonicalHash::XorToPlay(SgHashCode& hash, SgBlackWhite toPlay)
+{
+    // Same index as GoBoard::HashCode::GetInclToPlay()
+    SgHashUtil::XorZobrist(hash, toPlay + 1);
+}
+
+//----------------------------------------------------------------------------
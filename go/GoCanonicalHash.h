@@ -0,0 +1,136 @@
+//----------------------------------------------------------------------------
+/** @file GoCanonicalHash.h
+    Hash code of a position that is invariant under the symmetries of the
+    board. */
+//----------------------------------------------------------------------------
+
+#ifndef GO_CANONICALHASH_H
+#define GO_CANONICALHASH_H
+
+#include <vector>
+#include "SgArray.h"
+#include "SgBlackWhite.h"
+#include "SgHash.h"
+#include "SgPoint.h"
+
+class GoBoard;
+
+//----------------------------------------------------------------------------
+
+/** Hash code of a position that is invariant under the symmetries of the
+    board.
+    Maintains the hash codes of the position transformed by the 8
+    rotations and reflections of SgPointUtil::Rotate() incrementally, while
+    moves are played and taken back on a GoBoard. The canonical hash code
+    is the smallest of them, so it is the same for all symmetric positions
+    and can be used as a key for opening books and transposition tables
+    (e.g. with SgHashTable).
+
+    The hash code of each transformation is the same as
+    GoBoard::GetHashCodeInclToPlay() of a board on which the transformed
+    moves were played, with the following exceptions:
+    - The hash code of GoBoard includes the first captured stone of each
+      capturing move (if GoBoard::KoModifiesHash() is true). The order of
+      the captured stones depends on the transformation of the game, so
+      this class uses the smallest transformed point of the captured
+      stones instead. The hash codes are the same for moves that capture a
+      single stone, but can differ after moves that capture several
+      stones. The canonical hash code of the position after a game and
+      after the transformed game is always the same.
+    - Hash codes of won ko fights (see GoBoard::KoRepetitionAllowed()) are
+      not included.
+    - Boards created with GoBoard::InitClone() count the moves of the
+      original board for the hash code of captures.
+
+    Play() and Undo() take constant time per stone that is added or removed;
+    Init() replays the game of the board. */
+class GoCanonicalHash
+{
+public:
+    static const int NU_SYMMETRIES = 8;
+
+    GoCanonicalHash();
+
+    /** Compute the hash codes of the current position of a board.
+        Replays the setup and the moves of the board, because the hash
+        codes depend on the captures in the game. */
+    void Init(const GoBoard& bd);
+
+    /** Update the hash codes after a move.
+        @param bd The board after GoBoard::Play(). Must be the board that
+        the hash codes were initialized with, the position before the move
+        must be the current position of this class. */
+    void Play(const GoBoard& bd);
+
+    /** Take back the last Play(). */
+    void Undo();
+
+    /** Number of Play() calls that can be taken back. */
+    int NuMoves() const;
+
+    /** Hash code of the position transformed by a symmetry.
+        @param rotation See SgPointUtil::Rotate()
+        @return The hash code including the color to play. */
+    SgHashCode Get(int rotation) const;
+
+    /** The smallest hash code of all transformations. */
+    const SgHashCode& Canonical() const;
+
+    /** The transformation with the smallest hash code.
+        A point p of the current position corresponds to the point
+        SgPointUtil::Rotate(CanonicalRotation(), p, size) of the canonical
+        position. */
+    int CanonicalRotation() const;
+
+    /** Canonical hash code of the current position of a board.
+        Convenience function that calls Init(). */
+    static SgHashCode Compute(const GoBoard& bd);
+
+private:
+    /** Hash codes of a position. */
+    struct Entry
+    {
+        /** Hash codes of the stones of the transformed positions. */
+        SgArray<SgHashCode,NU_SYMMETRIES> m_hash;
+
+        SgBlackWhite m_toPlay;
+
+        SgHashCode m_canonical;
+
+        int m_canonicalRotation;
+    };
+
+    int m_size;
+
+    /** Current position and the positions before each Play(). */
+    std::vector<Entry> m_stack;
+
+    static void XorCaptured(SgHashCode& hash, int moveNumber, SgPoint p);
+
+    static void XorStone(SgHashCode& hash, SgPoint p, SgBlackWhite c);
+
+    static void XorToPlay(SgHashCode& hash, SgBlackWhite toPlay);
+
+    void UpdateCanonical(Entry& entry) const;
+};
+
+inline const SgHashCode& GoCanonicalHash::Canonical() const
+{
+    SG_ASSERT(! m_stack.empty());
+    return m_stack.back().m_canonical;
+}
+
+inline int GoCanonicalHash::CanonicalRotation() const
+{
+    SG_ASSERT(! m_stack.empty());
+    return m_stack.back().m_canonicalRotation;
+}
+
+inline int GoCanonicalHash::NuMoves() const
+{
+    return static_cast<int>(m_stack.size()) - 1;
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GO_CANONICALHASH_H
@@ -7,6 +7,7 @@
 #include "GoGtpEngine.h"
 
 #include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <exception>
 #include <fstream>
@@ -18,6 +19,7 @@
 #include "GoBoardRestorer.h"
 #include "GoEyeUtil.h"
 #include "GoGtpCommandUtil.h"
+#include "GoLadderCache.h"
 #include "GoModBoard.h"
 #include "GoNodeUtil.h"
 #include "GoPlayer.h"
@@ -95,11 +97,15 @@ GoGtpEngine::GoGtpEngine(int fixedBoardSize, const char* programPath,
       m_maxClearBoard(-1),
       m_numberClearBoard(0),
       m_timeLastMove(0),
+      m_analyzeToPlay(SG_BLACK),
+      m_analyzeInterval(1),
       m_timeLimit(10),
       m_overhead(0),
       m_game(fixedBoardSize > 0 ? fixedBoardSize : GO_DEFAULT_SIZE),
       m_sgCommands(*this, programPath),
       m_bookCommands(*this, Board(), m_book),
+      m_sharedBook(0),
+      m_userAbortFlag(SgUserAbortFlag()),
       m_mpiSynchronizer(SgMpiNullSynchronizer::Create())
 {
     Init(Board().Size());
@@ -147,6 +153,9 @@ GoGtpEngine::GoGtpEngine(int fixedBoardSize, const char* programPath,
         Register("go_clock", &GoGtpEngine::CmdClock, this);
         Register("go_param_timecontrol", &GoGtpEngine::CmdParamTimecontrol,
                  this);
+#if GTPENGINE_PONDER
+        Register("lz-analyze", &GoGtpEngine::CmdLzAnalyze, this);
+#endif
         Register("reg_genmove", &GoGtpEngine::CmdRegGenMove, this);
         Register("reg_genmove_toplay", &GoGtpEngine::CmdRegGenMoveToPlay,
                  this);
@@ -224,7 +233,7 @@ void GoGtpEngine::BoardChanged()
 
 void GoGtpEngine::BeforeHandleCommand()
 {
-    SgSetUserAbort(false);
+    *m_userAbortFlag = false;
     SgDebug() << flush;
 }
 
@@ -697,6 +706,40 @@ void GoGtpEngine::CmdLoadSgf(GtpCommand& cmd)
     BoardChanged();
 }
 
+#if GTPENGINE_PONDER
+
+/** Analyze the current position while waiting for the next command.
+    Compatible with the lz-analyze command of Leela Zero, which is supported
+    by GUIs like Lizzie and Sabaki. The response is continued with the
+    output of GoPlayer::Analyze(), for GoUctPlayer a line in the format of
+    GoUctUtil::WriteAnalyzeInfo() every interval, until the next command is
+    received.<br>
+    Arguments: [color] [[interval] centiseconds]<br>
+    The color to play defaults to the color to play on the board, the
+    interval to 100 centiseconds. */
+void GoGtpEngine::CmdLzAnalyze(GtpCommand& cmd)
+{
+    cmd.CheckNuArgLessEqual(3);
+    Player();
+    SgBlackWhite toPlay = Board().ToPlay();
+    int interval = 100;
+    size_t i = 0;
+    if (i < cmd.NuArg() && ! isdigit(cmd.Arg(i)[0])
+        && cmd.ArgToLower(i) != "interval")
+        toPlay = BlackWhiteArg(cmd, i++);
+    if (i < cmd.NuArg() && cmd.ArgToLower(i) == "interval")
+        ++i;
+    if (i < cmd.NuArg())
+        interval = cmd.ArgMin<int>(i++, 1);
+    if (i < cmd.NuArg())
+        throw GtpFailure() << "unknown argument " << cmd.Arg(i);
+    m_analyzeToPlay = toPlay;
+    m_analyzeInterval = 0.01 * interval;
+    StartAnalyze();
+}
+
+#endif // GTPENGINE_PONDER
+
 /** Return name of player, if set, GtpEngine::Name otherwise. */
 void GoGtpEngine::CmdName(GtpCommand& cmd)
 {
@@ -712,6 +755,8 @@ void GoGtpEngine::CmdName(GtpCommand& cmd)
     @arg @c auto_save See SetAutoSave()
     @arg @c accept_illegal Accept illegal ko or suicide moves in CmdPlay()
     @arg @c debug_to_comment See SetDebugToComment()
+    @arg @c ladder_cache Use GoLadderCache::Global() for ladder reading.
+    The cache is shared by all engines of the process.
     @arg @c overhead See SgTimeRecord::SetOverhead()
     @arg @c statistics_file See SetStatisticsFile()
     @arg @c timelimit See TimeLimit() */
@@ -722,6 +767,8 @@ void GoGtpEngine::CmdParam(GtpCommand& cmd)
     {
         cmd << "[bool] accept_illegal " << m_acceptIllegal << '\n'
             << "[bool] debug_to_comment " << m_debugToComment << '\n'
+            << "[bool] ladder_cache "
+            << GoLadderCache::Global().IsEnabled() << '\n'
             << "[bool] use_book " << m_useBook << '\n'
             << "[string] auto_save " << (m_autoSave ? m_autoSavePrefix : "")
             << '\n'
@@ -736,6 +783,8 @@ void GoGtpEngine::CmdParam(GtpCommand& cmd)
             m_acceptIllegal = cmd.Arg<bool>(1);
         else if (name == "debug_to_comment")
             m_debugToComment = cmd.Arg<bool>(1);
+        else if (name == "ladder_cache")
+            GoLadderCache::Global().SetEnabled(cmd.Arg<bool>(1));
         else if (name == "use_book")
             m_useBook = cmd.Arg<bool>(1);
         else if (name == "auto_save")
@@ -1044,10 +1093,13 @@ void GoGtpEngine::CmdQuit(GtpCommand& cmd)
 /** Generate a move, but do not play it.
     Like in GNU Go, if there was a random seed set, it is initialized before
     each reg_genmove to avoid a dependency of the random numbers on previous
-    move generations. */
+    move generations. Fails if the settings of SgRandom are locked,
+    because the random generators of other engines would be reset, too
+    (see SgRandom::LockSettings()). */
 void GoGtpEngine::CmdRegGenMove(GtpCommand& cmd)
 {
     cmd.CheckNuArg(1);
+    SgGtpCommands::CheckRandomSettingsUnlocked();
     SgRandom::SetSeed(SgRandom::Seed());
     SgPoint move = GenMove(BlackWhiteArg(cmd, 0), true);
     if (move == SG_RESIGN)
@@ -1063,6 +1115,7 @@ void GoGtpEngine::CmdRegGenMove(GtpCommand& cmd)
 void GoGtpEngine::CmdRegGenMoveToPlay(GtpCommand& cmd)
 {
     cmd.CheckArgNone();
+    SgGtpCommands::CheckRandomSettingsUnlocked();
     SgRandom::SetSeed(SgRandom::Seed());
     SgPoint move = GenMove(Board().ToPlay(), true);
     cmd << SgWritePoint(move);
@@ -1332,6 +1385,8 @@ SgPoint GoGtpEngine::GenBookMove(SgBlackWhite toPlay)
         return SG_NULLMOVE;
     if (m_autoBook.get() != 0)
         return m_autoBook->LookupMove(Board());
+    if (m_sharedBook != 0)
+        return m_sharedBook->LookupMove(Board());
     return m_book.LookupMove(Board());
 }
 
@@ -1645,6 +1700,7 @@ void GoGtpEngine::Ponder()
 {
     if (m_player == 0 || ! m_isPonderPosition)
         return;
+    SgSetUserAbortFlag(m_userAbortFlag);
     // Call GoPlayer::Ponder() after 0.2 seconds delay to avoid calls in very
     // short intervals between received commands
     boost::xtime time;
@@ -1675,12 +1731,22 @@ void GoGtpEngine::Ponder()
 
 void GoGtpEngine::StopPonder()
 {
-    SgSetUserAbort(true);
+    *m_userAbortFlag = true;
 }
 
 void GoGtpEngine::InitPonder()
 {
-    SgSetUserAbort(false);
+    *m_userAbortFlag = false;
+}
+
+void GoGtpEngine::Analyze(std::ostream& out)
+{
+    if (m_player == 0)
+        return;
+    SgSetUserAbortFlag(m_userAbortFlag);
+    m_mpiSynchronizer->OnStartPonder();
+    m_player->Analyze(m_analyzeToPlay, m_analyzeInterval, out);
+    m_mpiSynchronizer->OnEndPonder();
 }
 
 #endif // GTPENGINE_PONDER
@@ -1689,7 +1755,7 @@ void GoGtpEngine::InitPonder()
 
 void GoGtpEngine::Interrupt()
 {
-    SgSetUserAbort(true);
+    *m_userAbortFlag = true;
 }
 
 #endif // GTPENGINE_INTERRUPT
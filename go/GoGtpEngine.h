@@ -61,6 +61,7 @@ public:
         - @link CmdKgsTimeSettings() @c kgs-time_settings @endlink
         - @link CmdKomi() @c komi @endlink
         - @link CmdListStones() @c list_stones @endlink
+        - @link CmdLzAnalyze() @c lz-analyze @endlink
         - @link CmdLoadSgf() @c loadsgf @endlink
         - @link CmdName() @c name @endlink
         - @link CmdPlaceFreeHandicap() @c place_free_handicap @endlink
@@ -98,6 +99,7 @@ public:
     virtual void CmdKomi(GtpCommand&);
     virtual void CmdListStones(GtpCommand&);
     virtual void CmdLoadSgf(GtpCommand&);
+    virtual void CmdLzAnalyze(GtpCommand&);
     virtual void CmdName(GtpCommand&);
     virtual void CmdParam(GtpCommand&);
     virtual void CmdParamRules(GtpCommand&);
@@ -201,23 +203,38 @@ public:
     /** Time limit in seconds for move generation and other commands. */
     double TimeLimit();
 
+    /** Use an opening book that is shared with other engines.
+        If set, the book is used for generating moves and by the book
+        commands that read the book instead of Book(), and the book commands
+        that modify the book fail (see GoBookCommands::SetSharedBook()).
+        Useful if several engines run in one process, like the games of the
+        server mode of Fuego, which load the book only once. The book must
+        not be modified while it is used.
+        @param book The book (not owned), 0 for using Book() (default) */
+    void SetSharedBook(const GoBook* book);
+
 #if GTPENGINE_PONDER
     /** Implementation of GtpEngine::Ponder()
         Calls GoPlayer::Ponder() if a player is set. */
     void Ponder();
 
     /** Implementation of GtpEngine::StopPonder()
-        Calls SgSetUserAbort() */
+        Sets the user abort flag of the engine. */
     void StopPonder();
 
     /** Implementation of GtpEngine::InitPonder()
-        Calls SgSetUserAbort(false) */
+        Clears the user abort flag of the engine. */
     void InitPonder();
+
+    /** Implementation of GtpEngine::Analyze()
+        Calls GoPlayer::Analyze() with the arguments of the last
+        CmdLzAnalyze(). */
+    void Analyze(std::ostream& out);
 #endif // GTPENGINE_PONDER
 
 #if GTPENGINE_INTERRUPT
     /** Implementation of GtpEngine::Interrupt().
-        Calls SgSetUserAbort() */
+        Sets the user abort flag of the engine. */
     void Interrupt();
 #endif // GTPENGINE_INTERRUPT
 
@@ -366,6 +383,12 @@ private:
 
     double m_timeLastMove;
 
+    /** Color to play in the last CmdLzAnalyze(). */
+    SgBlackWhite m_analyzeToPlay;
+
+    /** Output interval in seconds in the last CmdLzAnalyze(). */
+    double m_analyzeInterval;
+
     /** See GoGtpEngine::CmdTimeLimit */
     double m_timeLimit;
 
@@ -388,6 +411,16 @@ private:
 
     GoBookCommands m_bookCommands;
 
+    /** See SetSharedBook() */
+    const GoBook* m_sharedBook;
+
+    /** The user abort flag of the thread that created the engine.
+        Interrupt() is called by the thread that reads the commands and
+        Ponder() and Analyze() run in their own thread, so they use this
+        flag instead of the one of the current thread (see
+        SgSetUserAbortFlag()). */
+    volatile bool* m_userAbortFlag;
+
     std::string m_autoSaveFileName;
 
     std::string m_autoSavePrefix;
@@ -465,6 +498,12 @@ inline void GoGtpEngine::SetMaxClearBoard(int n)
     m_maxClearBoard = n;
 }
 
+inline void GoGtpEngine::SetSharedBook(const GoBook* book)
+{
+    m_sharedBook = book;
+    m_bookCommands.SetSharedBook(book);
+}
+
 inline void GoGtpEngine::SetTimeLimit(double timeLimit)
 {
     m_timeLimit = timeLimit;
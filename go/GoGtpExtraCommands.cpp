@@ -11,6 +11,7 @@
 #include "GoBoardUtil.h"
 #include "GoGtpCommandUtil.h"
 #include "GoLadder.h"
+#include "GoLightLadder.h"
 #include "GoStaticLadder.h"
 
 using boost::format;
@@ -29,6 +30,7 @@ void GoGtpExtraCommands::AddGoGuiAnalyzeCommands(GtpCommand& cmd)
         "sboard/Go CFG Distance/go_cfg_distance %p\n"
         "sboard/Go CFG Distance N/go_cfg_distance %p %s\n"
         "string/Go Ladder/go_ladder %p\n"
+        "string/Go Light Ladder/go_light_ladder %p\n"
         "string/Go Static Ladder/go_static_ladder %p\n";
 }
 
@@ -78,6 +80,33 @@ void GoGtpExtraCommands::CmdLadder(GtpCommand& cmd)
     }
 }
 
+/** Return ladder status computed on a lightweight board.
+    Arguments: prey point<br>
+    Returns: escaped|captured|unsettled<br>
+    @see GoLightLadder */
+void GoGtpExtraCommands::CmdLightLadder(GtpCommand& cmd)
+{
+    cmd.CheckNuArg(1);
+    SgPoint prey = StoneArg(cmd, 0, m_bd);
+    GoLightLadder ladder;
+    ladder.Init(m_bd);
+    GoLadderStatus status = ladder.LadderStatus(prey);
+    switch (status)
+    {
+    case GO_LADDER_ESCAPED:
+        cmd << "escaped";
+        break;
+    case GO_LADDER_CAPTURED:
+        cmd << "captured";
+        break;
+    case GO_LADDER_UNSETTLED:
+        cmd << "unsettled";
+        break;
+    default:
+        throw GtpFailure() << "Unexpected ladder status: " << status;
+    }
+}
+
 /** Return static ladder status.
     Arguments: prey point<br>
     Returns: escaped|captured|unsettled<br>
@@ -99,6 +128,7 @@ void GoGtpExtraCommands::Register(GtpEngine& e)
 {
     Register(e, "go_cfg_distance", &GoGtpExtraCommands::CmdCfgDistance);
     Register(e, "go_ladder", &GoGtpExtraCommands::CmdLadder);
+    Register(e, "go_light_ladder", &GoGtpExtraCommands::CmdLightLadder);
     Register(e, "go_static_ladder", &GoGtpExtraCommands::CmdStaticLadder);
 }
 
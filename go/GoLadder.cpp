@@ -9,6 +9,7 @@
 #include <memory>
 #include "GoBoard.h"
 #include "GoBoardUtil.h"
+#include "GoLadderCache.h"
 #include "GoModBoard.h"
 #include "SgVector.h"
 #include "SgStack.h"
@@ -28,9 +29,19 @@ const int GOOD_FOR_HUNTER = -1000;
 
 //----------------------------------------------------------------------------
 
-GoLadder::GoLadder()
+GoLadder::GoLadder(bool recordMoves)
+    : m_recordMoves(recordMoves)
 { }
 
+inline void GoLadder::AddMove(SgPoint p)
+{
+    if (m_recordMoves && ! m_isMove[p])
+    {
+        m_isMove.Include(p);
+        m_moves.PushBack(p);
+    }
+}
+
 inline bool GoLadder::CheckMoveOverflow() const
 {
     return m_bd->MoveNumber() >= m_maxMoveNumber;
@@ -109,6 +120,7 @@ int GoLadder::PlayHunterMove(int depth, SgPoint move, SgPoint lib1,
     SG_ASSERT(move == lib1 || move == lib2);
     // TODO: only pass move and otherLib
     int result = 0;
+    AddMove(move);
     if (PlayIfLegal(*m_bd, move, m_hunterColor))
     {
         // Find new adjacent blocks: only block just played can be new
@@ -177,6 +189,7 @@ int GoLadder::PlayPreyMove(int depth, SgPoint move, SgPoint lib1,
         }
         m_partOfPrey.Include(move);
     }
+    AddMove(move);
     if (PlayIfLegal(*m_bd, move, m_preyColor))
     {
         if (move == lib1)
@@ -319,6 +332,7 @@ int GoLadder::HunterLadder(int depth, SgPoint lib1, SgPoint lib2,
     {
         // If not playing at lib1, then prey will play at lib1 and
         // get three liberties; little to update in this case.
+        AddMove(lib1);
         m_bd->Play(lib1, m_hunterColor);
         result = PreyLadder(depth + 1, lib2, adjBlk, sequence);
         if (sequence)
@@ -400,6 +414,7 @@ int GoLadder::Ladder(const GoBoard& bd, SgPoint prey, SgBlackWhite toPlay,
         sequence->Clear();
     if (! m_bd->Occupied(prey))
         return 0;
+    AddMove(prey);
     if (CheckMoveOverflow())
         return GOOD_FOR_PREY;
     int result = 0;
@@ -469,6 +484,7 @@ int GoLadder::Ladder(const GoBoard& bd, SgPoint prey, SgBlackWhite toPlay,
                 // Try whether any of these moves lead to escape.
                 for (SgVectorIterator<SgPoint> it(movesToTry); it; ++it)
                 {
+                    AddMove(*it);
                     if (PlayIfLegal(*m_bd, *it, m_preyColor))
                     {
                         if (Ladder(bd, prey, m_hunterColor, 0, twoLibIsEscape)
@@ -520,6 +536,7 @@ bool GoLadder::IsSnapback(SgPoint prey)
     if (m_bd->IsSingleStone(prey) && m_bd->InAtari(prey))
     {
         SgPoint liberty = *GoBoard::LibertyIterator(*m_bd, prey);
+        AddMove(liberty);
         if (PlayIfLegal(*m_bd, liberty, SgOppBW(m_bd->GetStone(prey))))
         {
             isSnapback = (m_bd->InAtari(liberty)
@@ -605,6 +622,13 @@ bool GoLadderUtil::IsLadderCaptureMove(const GoBoard& constBd,
 {
     SG_ASSERT(constBd.NumLiberties(prey) == 2);
     SG_ASSERT(constBd.IsLibertyOfBlock(firstMove, constBd.Anchor(prey)));
+    GoLadderCache& cache = GoLadderCache::Global();
+    const bool useCache = cache.IsEnabled();
+    bool isCapture = false;
+    if (useCache
+        && cache.Lookup(constBd, GoLadderCache::CAPTURE_MOVE, prey, firstMove,
+                        isCapture))
+        return isCapture;
     
     GoModBoard mbd(constBd);
     GoBoard& bd = mbd.Board();
@@ -612,41 +636,49 @@ bool GoLadderUtil::IsLadderCaptureMove(const GoBoard& constBd,
     const SgBlackWhite attacker = SgOppBW(defender);
     GoRestoreToPlay r(bd);
     bd.SetToPlay(attacker);
+    GoLadder ladder(useCache);
     if (PlayIfLegal(bd, firstMove, attacker))
     {
-	    GoLadder ladder;
-        bool isCapture = ladder.Ladder(bd, prey, defender, 
-                                       0, false/*twoLibIsEscape*/
-                                      ) < 0;
+        isCapture = ladder.Ladder(bd, prey, defender, 
+                                  0, false/*twoLibIsEscape*/
+                                 ) < 0;
     	bd.Undo();
-        return isCapture;
     }
-    else
-    	return false;
+    if (useCache)
+        cache.Store(bd, GoLadderCache::CAPTURE_MOVE, prey, firstMove,
+                    ladder.Moves(), isCapture);
+    return isCapture;
 }
 
 bool GoLadderUtil::IsLadderEscapeMove(const GoBoard& constBd, 
 									   SgPoint prey, SgPoint firstMove)
 {
     SG_ASSERT(constBd.NumLiberties(prey) == 1);
+    GoLadderCache& cache = GoLadderCache::Global();
+    const bool useCache = cache.IsEnabled();
+    bool isEscape = false;
+    if (useCache
+        && cache.Lookup(constBd, GoLadderCache::ESCAPE_MOVE, prey, firstMove,
+                        isEscape))
+        return isEscape;
     GoModBoard mbd(constBd);
     GoBoard& bd = mbd.Board();
     const SgBlackWhite defender = bd.GetStone(prey);
     const SgBlackWhite attacker = SgOppBW(defender);
     GoRestoreToPlay r(bd);
     bd.SetToPlay(defender);
+    GoLadder ladder(useCache);
     if (PlayIfLegal(bd, firstMove, defender))
     {
-	    GoLadder ladder;
-        bool isCapture = ladder.Ladder(bd, prey, attacker, 
-                                       0, false/*twoLibIsEscape*/
-                                      ) < 0;
+        isEscape = ladder.Ladder(bd, prey, attacker, 
+                                 0, false/*twoLibIsEscape*/
+                                ) >= 0;
     	bd.Undo();
-        return ! isCapture;
     }
-    else
-    	return false;
-
+    if (useCache)
+        cache.Store(bd, GoLadderCache::ESCAPE_MOVE, prey, firstMove,
+                    ladder.Moves(), isEscape);
+    return isEscape;
 }
 
 void GoLadderUtil::FindLadderEscapeMoves(const GoBoard& bd, SgPoint prey, 
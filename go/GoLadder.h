@@ -40,7 +40,10 @@ enum GoLadderStatus
 class GoLadder
 {
 public:
-    GoLadder();
+    /** Constructor.
+        @param recordMoves Record the moves for Moves(). Only needed if the
+        result is stored in GoLadderCache. */
+    explicit GoLadder(bool recordMoves = false);
 
     /** Main ladder routine.
         twoLibIsEscape: if prey is to play and has two libs, does it count as
@@ -50,11 +53,18 @@ public:
     int Ladder(const GoBoard& bd, SgPoint prey, SgBlackWhite toPlay,
                SgVector<SgPoint>* sequence, bool twoLibIsEscape = false);
 
-private:
+    /** The prey and all moves played or tried by all calls of Ladder()
+        since construction, without duplicates.
+        Empty, if the moves are not recorded, see GoLadder().
+        Used by GoLadderCache to find the part of the board that the ladder
+        depends on. */
+    const GoPointList& Moves() const;
+
     /** Maximum number of moves in ladder.
         If board has simple ko rule, ladders could not terminate. */
     static const int MAX_LADDER_MOVES = 200;
 
+private:
     /** Maximum move number before ladder should be aborted. */
     int m_maxMoveNumber;
 
@@ -66,6 +76,17 @@ private:
 
     SgBlackWhite m_hunterColor;
 
+    /** See GoLadder() */
+    bool m_recordMoves;
+
+    /** See Moves() */
+    GoPointList m_moves;
+
+    /** Points in m_moves. */
+    SgPointSet m_isMove;
+
+    void AddMove(SgPoint p);
+
     bool CheckMoveOverflow() const;
 
     void InitMaxMoveNumber();
@@ -99,6 +120,11 @@ private:
     void ReduceToBlocks(GoPointList& stones);
 };
 
+inline const GoPointList& GoLadder::Moves() const
+{
+    return m_moves;
+}
+
 //----------------------------------------------------------------------------
 
 namespace GoLadderUtil {
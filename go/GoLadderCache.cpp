@@ -0,0 +1,311 @@
+//----------------------------------------------------------------------------
+/** @file GoLadderCache.cpp
+    See GoLadderCache.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoLadderCache.h"
+
+#include <algorithm>
+#ifndef SG_THREAD_LOCAL
+#include <boost/thread/tss.hpp>
+#endif
+#include "GoBoard.h"
+#include "GoLadder.h"
+#include "SgBWSet.h"
+#include "SgHash.h"
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Finalizer of the SplitMix64 generator, used to spread the bits of
+    small keys over the whole word. */
+inline uint64_t Mix(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+inline uint64_t ToUint64(const SgHashCode& code)
+{
+    return (static_cast<uint64_t>(code.Code2()) << 32) | code.Code1();
+}
+
+uint64_t PackRect(const SgRect& rect)
+{
+    return static_cast<uint64_t>(rect.Left())
+        | (static_cast<uint64_t>(rect.Right()) << 8)
+        | (static_cast<uint64_t>(rect.Top()) << 16)
+        | (static_cast<uint64_t>(rect.Bottom()) << 24);
+}
+
+SgRect UnpackRect(uint64_t data)
+{
+    return SgRect(static_cast<int>(data & 0xff),
+                  static_cast<int>((data >> 8) & 0xff),
+                  static_cast<int>((data >> 16) & 0xff),
+                  static_cast<int>((data >> 24) & 0xff));
+}
+
+/** Lookup statistics of a thread, see GoLadderCache::NuLookups(). */
+struct Statistics
+{
+    std::size_t m_nuLookups;
+
+    std::size_t m_nuHits;
+};
+
+#ifdef SG_THREAD_LOCAL
+
+SG_THREAD_LOCAL Statistics s_statistics = { 0, 0 };
+
+inline Statistics& ThreadStatistics()
+{
+    return s_statistics;
+}
+
+#else
+
+Statistics& ThreadStatistics()
+{
+    static boost::thread_specific_ptr<Statistics> s_statistics;
+    if (s_statistics.get() == 0)
+    {
+        s_statistics.reset(new Statistics());
+        s_statistics->m_nuLookups = 0;
+        s_statistics->m_nuHits = 0;
+    }
+    return *s_statistics;
+}
+
+#endif // SG_THREAD_LOCAL
+
+/** Values of the result entries.
+    Non-zero, such that an empty entry is never mistaken for a result. */
+const uint64_t RESULT_FALSE = 1;
+
+const uint64_t RESULT_TRUE = 2;
+
+/** Add the stones of the block at a point to a rectangle, if the block was
+    not already added.
+    @return @c true, if the block was added. */
+bool IncludeBlock(const GoBoard& bd, SgPoint p, SgPointSet& anchors,
+                  SgRect& rect)
+{
+    if (! bd.Occupied(p))
+        return false;
+    const SgPoint anchor = bd.Anchor(p);
+    if (anchors.Contains(anchor))
+        return false;
+    anchors.Include(anchor);
+    for (GoBoard::StoneIterator it(bd, anchor); it; ++it)
+        rect.Include(*it);
+    return true;
+}
+
+/** Add a point and its neighbors, see IncludeBlock(). */
+void IncludeNeighborBlocks(const GoBoard& bd, SgPoint p, SgBlackWhite preyColor,
+                           SgPointSet& anchors, SgRect& blockRect,
+                           GoPointList& preyBlocks)
+{
+    if (IncludeBlock(bd, p, anchors, blockRect)
+        && bd.GetColor(p) == preyColor)
+        preyBlocks.PushBack(bd.Anchor(p));
+    for (GoNbIterator it(bd, p); it; ++it)
+        if (IncludeBlock(bd, *it, anchors, blockRect)
+            && bd.GetColor(*it) == preyColor)
+            preyBlocks.PushBack(bd.Anchor(*it));
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+GoLadderCache::GoLadderCache(std::size_t nuEntries)
+    : m_isEnabled(false)
+{
+    std::size_t size = 1;
+    while (size < nuEntries)
+        size *= 2;
+    m_mask = size - 1;
+    m_regions.resize(size);
+    m_results.resize(size);
+    for (SgBWIterator c; c; ++c)
+        for (int p = 0; p < SG_MAXPOINT; ++p)
+            m_zobrist[*c][p] =
+                ToUint64(SgHashUtil::GetZobrist<64>(p + *c * SG_MAXPOINT));
+    Clear();
+}
+
+bool GoLadderCache::CanStore(const GoBoard& bd)
+{
+    // The first move and the reading must fit into the move limit used by
+    // GoLadder, see GoLadder::InitMaxMoveNumber()
+    return bd.KoPoint() == SG_NULLPOINT
+        && bd.MoveNumber() + 2 * GoLadder::MAX_LADDER_MOVES
+           < GO_MAX_NUM_MOVES;
+}
+
+void GoLadderCache::Clear()
+{
+    Entry empty;
+    empty.m_check = 0;
+    empty.m_data = 0;
+    std::fill(m_regions.begin(), m_regions.end(), empty);
+    std::fill(m_results.begin(), m_results.end(), empty);
+    ClearStatistics();
+}
+
+void GoLadderCache::ClearStatistics()
+{
+    Statistics& statistics = ThreadStatistics();
+    statistics.m_nuLookups = 0;
+    statistics.m_nuHits = 0;
+}
+
+SgRect GoLadderCache::Footprint(const GoBoard& bd, SgPoint prey,
+                                SgPoint firstMove, const GoPointList& moves)
+{
+    // Works on rectangles instead of point sets, because this is called
+    // for every stored reading and the rectangle of a set of points is the
+    // same as the one of the neighbors of the points expanded by one.
+    const SgBlackWhite preyColor = bd.GetStone(prey);
+    SgPointSet anchors;
+    // Blocks of the prey color that become part of the prey
+    GoPointList preyBlocks;
+    SgRect blockRect;
+    SgRect rect;
+    rect.Include(prey);
+    rect.Include(firstMove);
+    IncludeNeighborBlocks(bd, prey, preyColor, anchors, blockRect,
+                          preyBlocks);
+    IncludeNeighborBlocks(bd, firstMove, preyColor, anchors, blockRect,
+                          preyBlocks);
+    for (GoPointList::Iterator it(moves); it; ++it)
+    {
+        rect.Include(*it);
+        IncludeNeighborBlocks(bd, *it, preyColor, anchors, blockRect,
+                              preyBlocks);
+    }
+    for (GoPointList::Iterator it(preyBlocks); it; ++it)
+        for (GoBoard::StoneIterator stone(bd, *it); stone; ++stone)
+        {
+            rect.Include(*stone);
+            for (GoNbIterator nb(bd, *stone); nb; ++nb)
+                IncludeBlock(bd, *nb, anchors, blockRect);
+        }
+    // Neighbors of the neighbors of the moves and the prey, neighbors of
+    // all blocks
+    rect.Expand(2);
+    if (! blockRect.IsEmpty())
+    {
+        blockRect.Expand(1);
+        rect.Include(blockRect);
+    }
+    rect.Intersect(SgRect(1, bd.Size(), 1, bd.Size()));
+    return rect;
+}
+
+bool GoLadderCache::Get(const std::vector<Entry>& table, uint64_t key,
+                        uint64_t& data) const
+{
+    const Entry& entry = table[key & m_mask];
+    data = entry.m_data;
+    const uint64_t check = entry.m_check;
+    return data != 0 && (check ^ data) == key;
+}
+
+std::size_t GoLadderCache::NuHits()
+{
+    return ThreadStatistics().m_nuHits;
+}
+
+std::size_t GoLadderCache::NuLookups()
+{
+    return ThreadStatistics().m_nuLookups;
+}
+
+GoLadderCache& GoLadderCache::Global()
+{
+    static GoLadderCache s_cache;
+    return s_cache;
+}
+
+bool GoLadderCache::Lookup(const GoBoard& bd, QueryType type, SgPoint prey,
+                           SgPoint firstMove, bool& result)
+{
+    if (! m_isEnabled || ! CanStore(bd))
+        return false;
+    Statistics& statistics = ThreadStatistics();
+    ++statistics.m_nuLookups;
+    const uint64_t queryKey = QueryKey(bd, type, prey, firstMove);
+    uint64_t data;
+    if (! Get(m_regions, queryKey, data))
+        return false;
+    const SgRect footprint = UnpackRect(data);
+    if (! Get(m_results, ResultKey(bd, queryKey, footprint), data)
+        || (data != RESULT_FALSE && data != RESULT_TRUE))
+        return false;
+    ++statistics.m_nuHits;
+    result = (data == RESULT_TRUE);
+    return true;
+}
+
+uint64_t GoLadderCache::QueryKey(const GoBoard& bd, QueryType type,
+                                 SgPoint prey, SgPoint firstMove)
+{
+    const GoRules& rules = bd.Rules();
+    uint64_t key = static_cast<uint64_t>(type);
+    key = (key << 16) | static_cast<uint64_t>(prey);
+    key = (key << 16) | static_cast<uint64_t>(firstMove);
+    key = (key << 8) | static_cast<uint64_t>(bd.Size());
+    key = (key << 4) | static_cast<uint64_t>(rules.GetKoRule());
+    key = (key << 1) | (rules.AllowSuicide() ? 1 : 0);
+    key = (key << 1) | (bd.KoRepetitionAllowed() ? 1 : 0);
+    key = (key << 1) | (bd.AnyRepetitionAllowed() ? 1 : 0);
+    return Mix(key);
+}
+
+uint64_t GoLadderCache::ResultKey(const GoBoard& bd, uint64_t queryKey,
+                                  const SgRect& footprint) const
+{
+    uint64_t hash = 0;
+    for (SgRectIterator it(footprint); it; ++it)
+    {
+        const SgPoint p = *it;
+        if (bd.Occupied(p))
+            hash ^= m_zobrist[bd.GetStone(p)][p];
+    }
+    return Mix(queryKey ^ PackRect(footprint)) ^ hash;
+}
+
+void GoLadderCache::Set(std::vector<Entry>& table, uint64_t key,
+                        uint64_t data)
+{
+    Entry& entry = table[key & m_mask];
+    entry.m_check = key ^ data;
+    entry.m_data = data;
+}
+
+void GoLadderCache::Store(const GoBoard& bd, QueryType type, SgPoint prey,
+                          SgPoint firstMove, const GoPointList& moves,
+                          bool result)
+{
+    if (  ! m_isEnabled
+       || moves.Length() < MIN_NU_MOVES
+       || ! CanStore(bd)
+       )
+        return;
+    const uint64_t queryKey = QueryKey(bd, type, prey, firstMove);
+    const SgRect footprint = Footprint(bd, prey, firstMove, moves);
+    Set(m_regions, queryKey, PackRect(footprint));
+    Set(m_results, ResultKey(bd, queryKey, footprint),
+        result ? RESULT_TRUE : RESULT_FALSE);
+}
+
+//----------------------------------------------------------------------------
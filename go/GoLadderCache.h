@@ -0,0 +1,190 @@
+//----------------------------------------------------------------------------
+/** @file GoLadderCache.h
+    Cache for the results of ladder reading. */
+//----------------------------------------------------------------------------
+
+#ifndef GO_LADDERCACHE_H
+#define GO_LADDERCACHE_H
+
+#include <cstddef>
+#include <vector>
+#include <stdint.h>
+#include "GoBoard.h"
+#include "SgBlackWhite.h"
+#include "SgPoint.h"
+#include "SgRect.h"
+
+//----------------------------------------------------------------------------
+
+/** Cache for the results of ladder reading, shared by all threads.
+    Used by GoLadderUtil::IsLadderCaptureMove() and
+    GoLadderUtil::IsLadderEscapeMove().
+
+    A ladder depends only on a small part of the board. GoLadder records the
+    prey and all moves played during the reading. Footprint() extends them
+    to a rectangle that contains all points that the reading looked at. A
+    result is stored with a key that combines the query (type, prey, first
+    move, board size, rules) with the footprint and a Zobrist hash of the
+    stones inside the footprint. The result can then be reused in all
+    positions that differ only outside the footprint, e.g. in the sibling
+    nodes of a search, where a ladder on the other side of the board is read
+    again and again.
+
+    Lookup needs the footprint before the reading, so there are two tables.
+    The region table maps a query to the footprint of the last reading of
+    this query, the result table maps the query, the footprint and the hash
+    of the stones in the footprint to the result.
+
+    The tables are lock-free. An entry consists of two 64-bit words, the data
+    and the key xor'ed with the data. A reader accepts an entry only if the
+    xor of the two words is the key, such that entries that were partially
+    overwritten by another thread are detected as missing (Hyatt's lockless
+    transposition table). The statistics are counted separately for each
+    thread, see NuLookups().
+
+    Most ladder queries are decided after a few moves and are faster to
+    read again than to look up, so only readings with at least MIN_NU_MOVES
+    moves are stored. Not stored are positions with a ko point, whose
+    legality depends on the hash history, and positions so close to
+    GO_MAX_NUM_MOVES that the ladder reading would be truncated. Full board
+    repetitions with positions before the reading are ignored, i.e. with
+    superko rules, the cached result may differ from a new reading in the
+    rare case that a ladder move repeats an earlier position of the game.
+
+    The cache is disabled by default. In the goboard_ladder_moves benchmark
+    only about 3% of the lookups hit and the timings with and without cache
+    are equal, so the cache has to show a gain on a workload before it is
+    enabled with SetEnabled() (GTP: <tt>go_param ladder_cache 1</tt>). */
+class GoLadderCache
+{
+public:
+    enum QueryType
+    {
+        /** GoLadderUtil::IsLadderCaptureMove() */
+        CAPTURE_MOVE,
+
+        /** GoLadderUtil::IsLadderEscapeMove() */
+        ESCAPE_MOVE
+    };
+
+    /** Minimum number of distinct moves of a reading that is stored.
+        See Store(). */
+    static const int MIN_NU_MOVES = 8;
+
+    /** Constructor.
+        @param nuEntries The number of entries of each table, rounded up to a
+        power of two. */
+    explicit GoLadderCache(std::size_t nuEntries = 65536);
+
+    /** Remove all entries and reset the statistics of the current thread.
+        Not thread-safe. */
+    void Clear();
+
+    bool IsEnabled() const;
+
+    /** Enable or disable the cache.
+        If disabled, Lookup() always fails and Store() does nothing.
+        Default is false. */
+    void SetEnabled(bool enable);
+
+    /** Look up the result of a ladder query.
+        @param bd The position before playing the first move.
+        @param type
+        @param prey
+        @param firstMove
+        @param[out] result The cached result.
+        @return @c true, if a result was found. */
+    bool Lookup(const GoBoard& bd, QueryType type, SgPoint prey,
+                SgPoint firstMove, bool& result);
+
+    /** Store the result of a ladder query.
+        @param bd The position before playing the first move.
+        @param type
+        @param prey
+        @param firstMove
+        @param moves The moves played during the reading
+        (see GoLadder::Moves()).
+        @param result */
+    void Store(const GoBoard& bd, QueryType type, SgPoint prey,
+               SgPoint firstMove, const GoPointList& moves, bool result);
+
+    /** Number of lookups in the current thread.
+        The counters are per thread, not per cache, because the cache is
+        used by all threads of a search and shared counters would need
+        synchronization for every lookup. */
+    static std::size_t NuLookups();
+
+    /** Number of hits in the current thread. See NuLookups() */
+    static std::size_t NuHits();
+
+    /** Reset the number of lookups and hits of the current thread. */
+    static void ClearStatistics();
+
+    /** Rectangle that contains all points that a ladder reading depends
+        on.
+        These are the moves and their neighbors, the blocks that the moves
+        can merge with or capture, the blocks adjacent to the prey (which
+        includes the blocks of the prey color that the moves connect to),
+        the neighbors of all these blocks, which determine their liberties,
+        and the neighbors of the liberties of the prey.
+        @param bd The position before the reading.
+        @param prey
+        @param firstMove
+        @param moves See Store() */
+    static SgRect Footprint(const GoBoard& bd, SgPoint prey,
+                            SgPoint firstMove, const GoPointList& moves);
+
+    /** Cache used by GoLadderUtil, shared by all threads of a search. */
+    static GoLadderCache& Global();
+
+private:
+    struct Entry
+    {
+        /** Key xor'ed with m_data. */
+        uint64_t m_check;
+
+        uint64_t m_data;
+    };
+
+    bool m_isEnabled;
+
+    uint64_t m_mask;
+
+    /** Footprints of the queries. */
+    std::vector<Entry> m_regions;
+
+    /** Results of the queries. */
+    std::vector<Entry> m_results;
+
+    /** Zobrist codes of the stones.
+        Same codes as in GoBoard::HashCode::XorStone(), converted to
+        integers for faster hashing of the footprint. */
+    uint64_t m_zobrist[SG_WHITE + 1][SG_MAXPOINT];
+
+    static bool CanStore(const GoBoard& bd);
+
+    static uint64_t QueryKey(const GoBoard& bd, QueryType type, SgPoint prey,
+                             SgPoint firstMove);
+
+    uint64_t ResultKey(const GoBoard& bd, uint64_t queryKey,
+                       const SgRect& footprint) const;
+
+    bool Get(const std::vector<Entry>& table, uint64_t key,
+             uint64_t& data) const;
+
+    void Set(std::vector<Entry>& table, uint64_t key, uint64_t data);
+};
+
+inline bool GoLadderCache::IsEnabled() const
+{
+    return m_isEnabled;
+}
+
+inline void GoLadderCache::SetEnabled(bool enable)
+{
+    m_isEnabled = enable;
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GO_LADDERCACHE_H
@@ -0,0 +1,452 @@
+//----------------------------------------------------------------------------
+/** @file GoLightLadder.cpp
+    See GoLightLadder.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoLightLadder.h"
+
+#include <algorithm>
+#include "SgNbIterator.h"
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Same values as in GoLadder.cpp */
+const int GOOD_FOR_PREY = 1000;
+
+const int GOOD_FOR_HUNTER = -1000;
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+GoLightLadder::GoLightLadder()
+    : m_koPoint(SG_NULLPOINT),
+      m_koColor(SG_BLACK),
+      m_prey(SG_NULLPOINT),
+      m_preyColor(SG_BLACK),
+      m_hunterColor(SG_WHITE)
+{
+    m_color.Fill(SG_BORDER);
+    m_moves.reserve(GoLadder::MAX_LADDER_MOVES + 1);
+}
+
+/** Remove the block at a point and remember the stones for Undo(). */
+void GoLightLadder::Capture(SgPoint p)
+{
+    GoPointList stones;
+    FindBlock(p, &stones, 0, 0);
+    for (GoPointList::Iterator it(stones); it; ++it)
+    {
+        m_color[*it] = SG_EMPTY;
+        m_captured.push_back(*it);
+    }
+}
+
+/** Find the stones and liberties of a block.
+    @param p A stone of the block
+    @param[out] stones If not 0, the stones of the block are appended.
+    @param[out] libs If not 0, the first maxLibs liberties are stored.
+    @param maxLibs Maximum number of liberties to count. If stones is 0,
+    the search stops when maxLibs liberties are found.
+    @return The number of liberties, at most maxLibs. */
+int GoLightLadder::FindBlock(SgPoint p, GoPointList* stones, SgPoint libs[],
+                             int maxLibs)
+{
+    SG_ASSERT(SgIsBlackWhite(m_color[p]));
+    const SgBoardColor c = m_color[p];
+    m_stoneMarker.Clear();
+    m_libertyMarker.Clear();
+    GoPointList stack;
+    stack.PushBack(p);
+    m_stoneMarker.Include(p);
+    int nuLibs = 0;
+    while (! stack.IsEmpty())
+    {
+        const SgPoint stone = stack.Last();
+        stack.PopBack();
+        if (stones != 0)
+            stones->PushBack(stone);
+        for (SgNb4Iterator it(stone); it; ++it)
+        {
+            const SgPoint nb = *it;
+            if (m_color[nb] == SG_EMPTY)
+            {
+                if (nuLibs < maxLibs && m_libertyMarker.NewMark(nb))
+                {
+                    if (libs != 0)
+                        libs[nuLibs] = nb;
+                    if (++nuLibs == maxLibs && stones == 0)
+                        return nuLibs;
+                }
+            }
+            else if (m_color[nb] == c && m_stoneMarker.NewMark(nb))
+                stack.PushBack(nb);
+        }
+    }
+    return nuLibs;
+}
+
+bool GoLightLadder::HasLiberties(SgPoint p)
+{
+    return FindBlock(p, 0, 0, 1) > 0;
+}
+
+/** Check whether the prey is caught in a snapback.
+    See GoLadder::IsSnapback() */
+bool GoLightLadder::IsSnapback()
+{
+    for (SgNb4Iterator it(m_prey); it; ++it)
+        if (m_color[*it] == m_preyColor)
+            return false;
+    SgPoint libs[2];
+    if (FindBlock(m_prey, 0, libs, 2) != 1)
+        return false;
+    const SgPoint lib = libs[0];
+    bool isSnapback = false;
+    if (Play(lib, m_hunterColor))
+    {
+        GoPointList stones;
+        isSnapback = (FindBlock(lib, &stones, 0, 2) == 1
+                      && stones.Length() > 1);
+        Undo();
+    }
+    return isSnapback;
+}
+
+bool GoLightLadder::IsLadderCaptureMove(SgPoint prey, SgPoint firstMove)
+{
+    SG_ASSERT(SgIsBlackWhite(m_color[prey]));
+    const SgBlackWhite defender = m_color[prey];
+    bool isCapture = false;
+    if (Play(firstMove, SgOppBW(defender)))
+    {
+        isCapture = Ladder(prey, defender);
+        Undo();
+    }
+    return isCapture;
+}
+
+bool GoLightLadder::IsLadderEscapeMove(SgPoint prey, SgPoint firstMove)
+{
+    SG_ASSERT(SgIsBlackWhite(m_color[prey]));
+    const SgBlackWhite defender = m_color[prey];
+    bool isEscape = false;
+    if (Play(firstMove, defender))
+    {
+        isEscape = ! Ladder(prey, SgOppBW(defender));
+        Undo();
+    }
+    return isEscape;
+}
+
+int GoLightLadder::HunterLadder(int depth, SgPoint lib1, SgPoint lib2,
+                                SgPoint* move)
+{
+    if (CheckMoveOverflow())
+        return GOOD_FOR_PREY;
+    if (NumEmptyNeighbors(lib1) < NumEmptyNeighbors(lib2))
+        std::swap(lib1, lib2);
+    int result;
+    if (NumEmptyNeighbors(lib1) == 3 && ! SgPointUtil::AreAdjacent(lib1, lib2))
+    {
+        // If the hunter does not play at lib1, the prey plays there and
+        // gets three liberties
+        const bool isLegal = Play(lib1, m_hunterColor);
+        SG_DEBUG_ONLY(isLegal);
+        SG_ASSERT(isLegal);
+        result = PreyLadder(depth + 1, 0);
+        Undo();
+        if (move != 0)
+            *move = lib1;
+    }
+    else
+    {
+        result = PlayHunterMove(depth, lib1);
+        if (move != 0)
+            *move = lib1;
+        if (0 <= result) // escaped
+        {
+            const int result2 = PlayHunterMove(depth, lib2);
+            if (result2 < result)
+            {
+                result = result2;
+                if (move != 0)
+                    *move = lib2;
+            }
+        }
+    }
+    return result;
+}
+
+bool GoLightLadder::Ladder(SgPoint prey, SgBlackWhite toPlay,
+                           bool twoLibIsEscape, SgPoint* move)
+{
+    SG_ASSERT(SgIsBlackWhite(m_color[prey]));
+    m_prey = prey;
+    m_preyColor = m_color[prey];
+    m_hunterColor = SgOppBW(m_preyColor);
+    if (move != 0)
+        *move = SG_PASS;
+    return Ladder(toPlay == m_preyColor, twoLibIsEscape, move) < 0;
+}
+
+/** Main ladder routine.
+    See GoLadder::Ladder() */
+int GoLightLadder::Ladder(bool toPlayIsPrey, bool twoLibIsEscape,
+                          SgPoint* move)
+{
+    if (CheckMoveOverflow())
+        return GOOD_FOR_PREY;
+    SgPoint libs[3];
+    const int nuLibs = FindBlock(m_prey, 0, libs, 3);
+    if (nuLibs > 2)
+        return GOOD_FOR_PREY;
+    if (! toPlayIsPrey)
+    {
+        if (IsSnapback())
+            return GOOD_FOR_PREY;
+        if (nuLibs == 2)
+            return HunterLadder(0, libs[0], libs[1], move);
+        if (move != 0)
+            *move = libs[0];
+        return GOOD_FOR_HUNTER;
+    }
+    if (nuLibs == 1)
+        return PreyLadder(0, move);
+    if (twoLibIsEscape)
+        return GOOD_FOR_PREY;
+    // Prey to play with two liberties. Try the same moves as GoLadder: the
+    // liberties of adjacent blocks with at most two liberties, the
+    // liberties of the prey and the empty points next to them.
+    SgVector<SgPoint> movesToTry;
+    GoPointList stones;
+    FindBlock(m_prey, &stones, 0, 0);
+    m_blockMarker.Clear();
+    for (GoPointList::Iterator it(stones); it; ++it)
+        for (SgNb4Iterator nb(*it); nb; ++nb)
+            if (m_color[*nb] == m_hunterColor && ! m_blockMarker.Contains(*nb))
+            {
+                GoPointList block;
+                SgPoint blockLibs[3];
+                const int nuBlockLibs = FindBlock(*nb, &block, blockLibs, 3);
+                for (GoPointList::Iterator stone(block); stone; ++stone)
+                    m_blockMarker.Include(*stone);
+                if (nuBlockLibs <= 2)
+                    for (int i = 0; i < nuBlockLibs; ++i)
+                        movesToTry.PushBack(blockLibs[i]);
+            }
+    movesToTry.PushBack(libs[0]);
+    movesToTry.PushBack(libs[1]);
+    for (int i = 0; i < 2; ++i)
+        for (SgNb4Iterator nb(libs[i]); nb; ++nb)
+            if (m_color[*nb] == SG_EMPTY)
+                movesToTry.PushBack(*nb);
+    for (SgVectorIterator<SgPoint> it(movesToTry); it; ++it)
+        if (Play(*it, m_preyColor))
+        {
+            const int result = Ladder(false, twoLibIsEscape, 0);
+            Undo();
+            if (result > 0)
+            {
+                if (move != 0)
+                    *move = *it;
+                return GOOD_FOR_PREY;
+            }
+        }
+    // See GoLadder::Ladder(), approach moves and other escapes are not tried
+    return GOOD_FOR_HUNTER;
+}
+
+GoLadderStatus GoLightLadder::LadderStatus(SgPoint prey, bool twoLibIsEscape,
+                                           SgPoint* toCapture,
+                                           SgPoint* toEscape)
+{
+    SG_ASSERT(SgIsBlackWhite(m_color[prey]));
+    const SgBlackWhite preyColor = m_color[prey];
+    SgPoint captureMove;
+    if (! Ladder(prey, SgOppBW(preyColor), twoLibIsEscape, &captureMove))
+        return GO_LADDER_ESCAPED;
+    SgPoint escapeMove;
+    if (Ladder(prey, preyColor, twoLibIsEscape, &escapeMove))
+        return GO_LADDER_CAPTURED;
+    if (toCapture != 0)
+        *toCapture = captureMove;
+    if (toEscape != 0)
+        *toEscape = escapeMove;
+    return GO_LADDER_UNSETTLED;
+}
+
+int GoLightLadder::NumEmptyNeighbors(SgPoint p) const
+{
+    int n = 0;
+    for (SgNb4Iterator it(p); it; ++it)
+        if (m_color[*it] == SG_EMPTY)
+            ++n;
+    return n;
+}
+
+/** Play a move.
+    @return @c false, if the move is illegal (occupied point, ko or
+    suicide). Then the position is unchanged. */
+bool GoLightLadder::Play(SgPoint p, SgBlackWhite c)
+{
+    if (m_color[p] != SG_EMPTY || (p == m_koPoint && c == m_koColor))
+        return false;
+    const SgBlackWhite opp = SgOppBW(c);
+    const std::size_t oldNuCaptured = m_captured.size();
+    m_color[p] = c;
+    for (SgNb4Iterator it(p); it; ++it)
+        if (m_color[*it] == opp && ! HasLiberties(*it))
+            Capture(*it);
+    const int nuCaptured = static_cast<int>(m_captured.size() - oldNuCaptured);
+    if (nuCaptured == 0 && ! HasLiberties(p))
+    {
+        m_color[p] = SG_EMPTY;
+        return false;
+    }
+    Move move;
+    move.m_point = p;
+    move.m_color = c;
+    move.m_koPoint = m_koPoint;
+    move.m_koColor = m_koColor;
+    move.m_nuCaptured = nuCaptured;
+    m_moves.push_back(move);
+    m_koPoint = SG_NULLPOINT;
+    // Single stone that captured a single stone and has only the liberty at
+    // the captured stone
+    if (nuCaptured == 1 && NumEmptyNeighbors(p) == 1)
+    {
+        bool isSingleStone = true;
+        for (SgNb4Iterator it(p); it; ++it)
+            if (m_color[*it] == c)
+                isSingleStone = false;
+        if (isSingleStone)
+        {
+            m_koPoint = m_captured.back();
+            m_koColor = opp;
+        }
+    }
+    return true;
+}
+
+int GoLightLadder::PlayHunterMove(int depth, SgPoint p)
+{
+    if (! Play(p, m_hunterColor))
+        return GOOD_FOR_PREY - depth;
+    const int result = PreyLadder(depth + 1, 0);
+    Undo();
+    return result;
+}
+
+int GoLightLadder::PlayPreyMove(int depth, SgPoint p)
+{
+    if (! Play(p, m_preyColor))
+        return GOOD_FOR_HUNTER + depth;
+    SgPoint libs[3];
+    int result;
+    switch (FindBlock(m_prey, 0, libs, 3))
+    {
+    case 1:
+        // See GoLadder::HunterLadder(), snapbacks are only detected at the
+        // start of the ladder
+        result = CheckMoveOverflow() ? GOOD_FOR_PREY
+                                     : GOOD_FOR_HUNTER + depth + 1;
+        break;
+    case 2:
+        result = HunterLadder(depth + 1, libs[0], libs[1], 0);
+        break;
+    default:
+        result = GOOD_FOR_PREY - (depth + 1);
+        break;
+    }
+    Undo();
+    return result;
+}
+
+/** Prey to play, prey in atari.
+    Try to capture adjacent hunter blocks in atari, then extend at the
+    liberty. */
+int GoLightLadder::PreyLadder(int depth, SgPoint* move)
+{
+    if (CheckMoveOverflow())
+        return GOOD_FOR_PREY;
+    GoPointList stones;
+    SgPoint libs[2];
+    if (FindBlock(m_prey, &stones, libs, 2) > 1)
+        // Hunter move captured a block and gave the prey liberties
+        return GOOD_FOR_PREY - depth;
+    const SgPoint lib = libs[0];
+    m_preyMarker.Clear();
+    for (GoPointList::Iterator it(stones); it; ++it)
+        m_preyMarker.Include(*it);
+    GoPointList captureMoves;
+    m_blockMarker.Clear();
+    for (GoPointList::Iterator it(stones); it; ++it)
+        for (SgNb4Iterator nb(*it); nb; ++nb)
+            if (m_color[*nb] == m_hunterColor && ! m_blockMarker.Contains(*nb))
+            {
+                GoPointList block;
+                SgPoint blockLibs[2];
+                const int nuBlockLibs = FindBlock(*nb, &block, blockLibs, 2);
+                for (GoPointList::Iterator stone(block); stone; ++stone)
+                    m_blockMarker.Include(*stone);
+                if (nuBlockLibs != 1)
+                    continue;
+                const SgPoint blockLib = blockLibs[0];
+                int nuAdjToPrey = 0;
+                for (GoPointList::Iterator stone(block); stone; ++stone)
+                    for (SgNb4Iterator nb2(*stone); nb2; ++nb2)
+                        if (m_preyMarker.Contains(*nb2))
+                        {
+                            ++nuAdjToPrey;
+                            break;
+                        }
+                // Capturing a block with three stones next to the prey
+                // gives the prey enough liberties
+                if (nuAdjToPrey >= 3)
+                {
+                    if (move != 0)
+                        *move = blockLib;
+                    return GOOD_FOR_PREY - depth;
+                }
+                if (blockLib != lib && ! captureMoves.Contains(blockLib))
+                    captureMoves.PushBack(blockLib);
+            }
+    // Captures first, then extend
+    captureMoves.PushBack(lib);
+    int result = 0;
+    for (GoPointList::Iterator it(captureMoves); it; ++it)
+    {
+        const int result2 = PlayPreyMove(depth, *it);
+        if (result == 0 || result < result2)
+        {
+            result = result2;
+            if (move != 0)
+                *move = *it;
+        }
+        if (0 < result)
+            break;
+    }
+    return result;
+}
+
+void GoLightLadder::Undo()
+{
+    SG_ASSERT(! m_moves.empty());
+    const Move& move = m_moves.back();
+    m_color[move.m_point] = SG_EMPTY;
+    const SgBlackWhite opp = SgOppBW(move.m_color);
+    for (int i = 0; i < move.m_nuCaptured; ++i)
+    {
+        m_color[m_captured.back()] = opp;
+        m_captured.pop_back();
+    }
+    m_koPoint = move.m_koPoint;
+    m_koColor = move.m_koColor;
+    m_moves.pop_back();
+}
+
+//----------------------------------------------------------------------------
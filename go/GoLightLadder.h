@@ -0,0 +1,177 @@
+//----------------------------------------------------------------------------
+/** @file GoLightLadder.h
+    Ladder reading on a lightweight board. */
+//----------------------------------------------------------------------------
+
+#ifndef GO_LIGHTLADDER_H
+#define GO_LIGHTLADDER_H
+
+#include <vector>
+#include "GoBoard.h"
+#include "GoLadder.h"
+#include "SgArray.h"
+#include "SgBlackWhite.h"
+#include "SgBoardColor.h"
+#include "SgMarker.h"
+#include "SgPoint.h"
+
+//----------------------------------------------------------------------------
+
+/** Ladder reading on a lightweight board.
+    Reads ladders with the same search as GoLadder, but plays the moves on
+    an array of point colors instead of a GoBoard, which would update blocks,
+    liberties, hash codes and the move stack. The liberties of the prey and
+    of the hunter blocks adjacent to the prey are computed when they are
+    needed. Ladder breakers (stones of the prey color that the prey runs
+    into, hunter blocks in atari) and snapbacks are handled like in GoLadder.
+
+    The position is copied with Init() from a GoBoard or GoUctBoard and can
+    then be used for any number of queries. Each query restores the position.
+
+    Differences to GoLadder:
+    - Only the simple ko rule is checked, superko rules and the repetition
+      settings of GoBoard are ignored
+    - Suicide is illegal
+    - The liberties of the prey are counted exactly; GoLadder tracks them
+      incrementally and can miss liberties gained by captures of the hunter
+    - The reading is aborted in favor of the prey after
+      GoLadder::MAX_LADDER_MOVES moves per query, not per recursive call
+    - If several moves capture or escape, the returned moves can differ */
+class GoLightLadder
+{
+public:
+    GoLightLadder();
+
+    /** Copy the position of a board.
+        @tparam BOARD GoBoard or GoUctBoard */
+    template<class BOARD>
+    void Init(const BOARD& bd);
+
+    /** See GoLadderUtil::Ladder()
+        @param prey A stone of the block
+        @param toPlay
+        @param twoLibIsEscape
+        @param[out] move If not 0, set to the first move of the sequence
+        that captures or escapes, or SG_PASS if none is needed.
+        @return @c true, if the block is captured. */
+    bool Ladder(SgPoint prey, SgBlackWhite toPlay,
+                bool twoLibIsEscape = false, SgPoint* move = 0);
+
+    /** See GoLadderUtil::LadderStatus() */
+    GoLadderStatus LadderStatus(SgPoint prey, bool twoLibIsEscape = false,
+                                SgPoint* toCapture = 0,
+                                SgPoint* toEscape = 0);
+
+    /** See GoLadderUtil::IsLadderCaptureMove() */
+    bool IsLadderCaptureMove(SgPoint prey, SgPoint firstMove);
+
+    /** See GoLadderUtil::IsLadderEscapeMove() */
+    bool IsLadderEscapeMove(SgPoint prey, SgPoint firstMove);
+
+private:
+    /** Undo information of a move. */
+    struct Move
+    {
+        SgPoint m_point;
+
+        SgBlackWhite m_color;
+
+        /** Old value of m_koPoint. */
+        SgPoint m_koPoint;
+
+        /** Old value of m_koColor. */
+        SgBlackWhite m_koColor;
+
+        /** Number of stones captured by the move, stored at the end of
+            m_captured. */
+        int m_nuCaptured;
+    };
+
+    SgArray<SgBoardColor,SG_MAXPOINT> m_color;
+
+    /** Point that m_koColor cannot play at due to the simple ko rule. */
+    SgPoint m_koPoint;
+
+    SgBlackWhite m_koColor;
+
+    /** A stone of the prey. */
+    SgPoint m_prey;
+
+    SgBlackWhite m_preyColor;
+
+    SgBlackWhite m_hunterColor;
+
+    std::vector<Move> m_moves;
+
+    std::vector<SgPoint> m_captured;
+
+    /** Stones visited by FindBlock(). */
+    SgMarker m_stoneMarker;
+
+    /** Liberties visited by FindBlock(). */
+    SgMarker m_libertyMarker;
+
+    /** Stones of the prey, marked by PreyLadder(). */
+    SgMarker m_preyMarker;
+
+    /** Hunter blocks already looked at by PreyLadder(). */
+    SgMarker m_blockMarker;
+
+    bool CheckMoveOverflow() const;
+
+    int FindBlock(SgPoint p, GoPointList* stones, SgPoint libs[],
+                  int maxLibs);
+
+    void Capture(SgPoint p);
+
+    bool HasLiberties(SgPoint p);
+
+    int NumEmptyNeighbors(SgPoint p) const;
+
+    bool Play(SgPoint p, SgBlackWhite c);
+
+    void Undo();
+
+    bool IsSnapback();
+
+    int Ladder(bool toPlayIsPrey, bool twoLibIsEscape, SgPoint* move);
+
+    int PreyLadder(int depth, SgPoint* move);
+
+    int PlayPreyMove(int depth, SgPoint p);
+
+    int HunterLadder(int depth, SgPoint lib1, SgPoint lib2, SgPoint* move);
+
+    int PlayHunterMove(int depth, SgPoint p);
+
+    /** Not implemented. */
+    GoLightLadder(const GoLightLadder&);
+
+    /** Not implemented. */
+    GoLightLadder& operator=(const GoLightLadder&);
+};
+
+inline bool GoLightLadder::CheckMoveOverflow() const
+{
+    return static_cast<int>(m_moves.size()) >= GoLadder::MAX_LADDER_MOVES;
+}
+
+template<class BOARD>
+void GoLightLadder::Init(const BOARD& bd)
+{
+    m_color.Fill(SG_BORDER);
+    for (SgGrid row = 1; row <= bd.Size(); ++row)
+        for (SgGrid col = 1; col <= bd.Size(); ++col)
+        {
+            const SgPoint p = SgPointUtil::Pt(col, row);
+            m_color[p] = bd.GetColor(p);
+        }
+    m_koPoint = bd.KoPoint();
+    m_koColor = bd.ToPlay();
+    m_moves.clear();
+    m_captured.clear();
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GO_LIGHTLADDER_H
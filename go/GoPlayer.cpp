@@ -28,6 +28,14 @@ GoPlayer::~GoPlayer()
         m_currentNode->DeleteTree();
 }
 
+void GoPlayer::Analyze(SgBlackWhite toPlay, double interval,
+                       std::ostream& out)
+{
+    SG_UNUSED(toPlay);
+    SG_UNUSED(interval);
+    SG_UNUSED(out);
+}
+
 void GoPlayer::ClearSearchTraces()
 {
     if (m_currentNode != 0)
@@ -6,6 +6,7 @@
 #ifndef GO_PLAYER_H
 #define GO_PLAYER_H
 
+#include <iosfwd>
 #include <string>
 #include "GoBoard.h"
 #include "GoBoardSynchronizer.h"
@@ -111,6 +112,19 @@ public:
         Default implementation does nothing and returns immediately. */
     virtual void Ponder();
 
+    /** Analyze the current position for a GTP analysis command.
+        Thinks about the position like Ponder() and writes intermediate
+        results to the stream, for example in the format of
+        GoUctUtil::WriteAnalyzeInfo(). Called like Ponder() and should also
+        return immediately if SgUserAbort() returns true.
+        Default implementation does nothing and returns immediately.
+        @param toPlay The color to play
+        @param interval The interval between outputs in seconds
+        @param out The stream for the output
+        @see GoGtpEngine::CmdLzAnalyze() */
+    virtual void Analyze(SgBlackWhite toPlay, double interval,
+                         std::ostream& out);
+
     /** See m_variant */
     int Variant() const;
 
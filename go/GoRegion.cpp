@@ -796,6 +796,9 @@ void GoRegion::DoComputeFlag(GoRegionFlag flag)
         break;
     case GO_REGION_STATIC_2V:
         {
+            // The flag is computed again after the computed flags were
+            // reset, e.g. in ReplaceChain(), which keeps the old strategy
+            m_miaiStrategy.Clear();
             bool is = Has2SureLibs(&m_miaiStrategy);
             SetFlag(GO_REGION_STATIC_2V, is);
             if (is)
@@ -1154,6 +1157,27 @@ void GoRegion::FindChains(const GoRegionBoard& ra)
     m_computedFlags.set(GO_REGION_COMPUTED_CHAINS);
 }
 
+void GoRegion::ResetSolverData()
+{
+    GoRegionFlags basicFlags;
+    basicFlags.set(GO_REGION_SMALL);
+    basicFlags.set(GO_REGION_CORRIDOR);
+    basicFlags.set(GO_REGION_SINGLE_BLOCK_BOUNDARY);
+    basicFlags.set(GO_REGION_STATIC_1VC);
+    basicFlags.set(GO_REGION_STATIC_2V);
+    basicFlags.set(GO_REGION_VALID);
+    basicFlags.set(GO_REGION_COMPUTED_BLOCKS);
+    m_computedFlags &= basicFlags;
+    m_flags &= basicFlags;
+    if (IsValid())
+        SetFlag(GO_REGION_USED_FOR_MERGE, false);
+    m_chains.Clear();
+    m_eyes = GoEyeCount();
+    m_vitalPoint = SG_NULLMOVE;
+    m_1vcDepth = 0;
+    m_miaiStrategy.Clear();
+}
+
 bool GoRegion::IsSurrounded(const SgVectorOf<GoBlock>& blocks) const
 {
     const int size = m_bd.Size();
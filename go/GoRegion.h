@@ -342,6 +342,12 @@ public:
             @todo There must be faster ways to do this. */
     void FindChains(const GoRegionBoard& ra);
 
+    /** For incremental update - remove the chains and all data computed
+        by the safety solvers. Keeps the blocks and the basic flags
+        (see ComputeBasicFlags), such that the region is in the same state
+        as a region that was computed from scratch. */
+    void ResetSolverData();
+
     /** Set safe flag for region */
     void SetToSafe() {SetFlag(GO_REGION_SAFE, true);}
 
@@ -6,6 +6,7 @@
 #include "SgSystem.h"
 #include "GoRegionBoard.h"
 
+#include <algorithm>
 #include <iostream>
 #include "GoBlock.h"
 #include "GoChain.h"
@@ -31,6 +32,25 @@ const int REGION_REMOVE_BLOCK = REGION_CODE_BASE + 2;
 const int REGION_ADD_BLOCK = REGION_CODE_BASE + 3;
 const int REGION_ADD_STONE = REGION_CODE_BASE + 4;
 const int REGION_ADD_STONE_TO_BLOCK = REGION_CODE_BASE + 5;
+
+/** Order of GoBlockIterator */
+bool LessAnchor(void* block1, void* block2)
+{
+    return   static_cast<GoBlock*>(block1)->Anchor()
+           < static_cast<GoBlock*>(block2)->Anchor();
+}
+
+/** Order of SgConnCompIterator */
+bool LessFirstPoint(void* region1, void* region2)
+{
+    return   static_cast<GoRegion*>(region1)->Points().PointOf()
+           < static_cast<GoRegion*>(region2)->Points().PointOf();
+}
+
+void SortBlocks(SgVectorOf<GoBlock>& blocks)
+{
+    std::sort(blocks.Vector().begin(), blocks.Vector().end(), LessAnchor);
+}
 }
 //----------------------------------------------------------------------------
 
@@ -106,7 +126,7 @@ void GoRegionBoard::Clear()
     m_allRegions[SG_WHITE].Clear();
     m_allChains[SG_BLACK].Clear();
     m_allChains[SG_WHITE].Clear();
-    m_stack.Clear();
+    ClearStack();
     m_code.Invalidate();
     m_invalid = true;
     m_computedHealthy = false;
@@ -127,6 +147,65 @@ void GoRegionBoard::Clear()
         m_block[p] = 0;
 }
 
+void GoRegionBoard::ResetSolverData()
+{
+    for (SgBWIterator it; it; ++it)
+    {
+        SgBlackWhite color(*it);
+        for (SgVectorIteratorOf<GoChain> it2(AllChains(color)); it2; ++it2)
+            delete *it2;
+        AllChains(color).Clear();
+        for (SgVectorIteratorOf<GoBlock> it2(AllBlocks(color)); it2; ++it2)
+            (*it2)->ReInitialize();
+        for (SgVectorIteratorOf<GoRegion> it2(AllRegions(color)); it2; ++it2)
+            (*it2)->ResetSolverData();
+    }
+    m_chainsCode.Invalidate();
+    m_computedHealthy = false;
+}
+
+void GoRegionBoard::ComputeBasicFlags()
+{
+    for (SgBWIterator it; it; ++it)
+    {
+        SgBlackWhite color(*it);
+        for (SgVectorIteratorOf<GoRegion> it2(AllRegions(color)); it2; ++it2)
+            if (! (*it2)->IsValid())
+                (*it2)->ComputeBasicFlags();
+    }
+}
+
+void GoRegionBoard::InvalidateRegions(const SgPointSet& changed)
+{
+    const int size = Board().Size();
+    SgPointSet area(changed | changed.Border(size));
+    SgPointSet blocks;
+    for (SgSetIterator it(area & Board().Occupied()); it; ++it)
+        if (! blocks.Contains(*it))
+            blocks |= BlockAt(*it)->Stones();
+    area |= blocks | blocks.Border(size);
+    for (SgBWIterator it; it; ++it)
+    {
+        SgBlackWhite color(*it);
+        for (SgVectorIteratorOf<GoRegion> it2(AllRegions(color)); it2; ++it2)
+            if ((*it2)->IsValid() && (*it2)->Points().Overlaps(area))
+                (*it2)->ResetNonBlockFlags();
+    }
+}
+
+void GoRegionBoard::SortBlocksRegions()
+{
+    for (SgBWIterator it; it; ++it)
+    {
+        SgBlackWhite color(*it);
+        SortBlocks(AllBlocks(color));
+        std::vector<void*>& regions = AllRegions(color).Vector();
+        std::sort(regions.begin(), regions.end(), LessFirstPoint);
+        for (SgVectorIteratorOf<GoRegion> it2(AllRegions(color)); it2; ++it2)
+            SortBlocks((*it2)->BlocksNonConst());
+    }
+}
+
 void GoRegionBoard::UpdateBlock(int move, SgBlackWhite moveColor)
 {
     SgPoint anchor = Board().Anchor(move); // board is already up to date.
@@ -195,6 +274,7 @@ void GoRegionBoard::OnExecutedUncodedMove(int move, SgBlackWhite moveColor)
         SgDebug() << "OnExecutedUncodedMove " << SgWritePoint(move) << '\n';
     {
         m_stack.StartMoveInfo();
+        ResetSolverData();
         if (move != SG_PASS)
         {
             SG_ASSERT(! Board().LastMoveInfo(GO_MOVEFLAG_SUICIDE));
@@ -225,29 +305,24 @@ void GoRegionBoard::OnExecutedUncodedMove(int move, SgBlackWhite moveColor)
                 }
             }
 
+            SgPointSet changed;
+            changed.Include(move);
             if (fWasCapture)
             {
             //  FindNewNeighborRegions(move, moveColor);
                 MergeAdjacentAndAddBlock(move, SgOppBW(moveColor));
+                for (GoPointList::Iterator it(Board().CapturedStones());
+                     it; ++it)
+                    changed.Include(*it);
             }
-
-            m_code = Board().GetHashCode();
-            if (HEAVYCHECK)
-                CheckConsistency();
-        }
-    }
-
-    {
-        for (SgBWIterator it; it; ++it)
-        {
-            SgBlackWhite color(*it);
-            for (SgVectorIteratorOf<GoRegion> it(AllRegions(color)); it; ++it)
-            {   GoRegion* r1 = *it;
-                if (! r1->IsValid())
-                    r1->ComputeBasicFlags();
-            }
+            InvalidateRegions(changed);
         }
+        m_code = Board().GetHashCode();
+        if (HEAVYCHECK)
+            CheckConsistency();
     }
+    ComputeBasicFlags();
+    SortBlocksRegions();
 }
 
 void GoRegionBoard::CheckConsistency() const
@@ -295,6 +370,41 @@ void GoRegionBoard::CheckConsistency() const
     }
 }
 
+void GoRegionBoard::ClearStack()
+{
+    while (! m_stack.IsEmpty())
+    {
+        int val = m_stack.PopEvent();
+        switch (val)
+        {
+            case SG_NEXTMOVE:
+            break;
+            case REGION_REMOVE:
+                delete static_cast<GoRegion*>(m_stack.PopPtr());
+            break;
+            case REGION_ADD:
+            case REGION_ADD_BLOCK:
+                // Still on the board, deleted by Clear()
+                m_stack.PopPtr();
+            break;
+            case REGION_REMOVE_BLOCK:
+            {
+                delete static_cast<GoBlock*>(m_stack.PopPtr());
+                for (int nu = m_stack.PopInt(); nu > 0; --nu)
+                    m_stack.PopPtr();
+            }
+            break;
+            case REGION_ADD_STONE:
+            case REGION_ADD_STONE_TO_BLOCK:
+                m_stack.PopPtr();
+                m_stack.PopInt();
+            break;
+            default:
+                SG_ASSERT(false);
+        }
+    }
+}
+
 void GoRegionBoard::PushRegion(int type, GoRegion* r)
 {
     m_stack.PushPtrEvent(type, r);
@@ -508,6 +618,8 @@ void GoRegionBoard::OnUndoneMove()
 
     const bool IS_UNDO = false;
     SgVectorOf<GoRegion> changed;
+    SgPointSet changedPoints;
+    ResetSolverData();
 
     for (int val = m_stack.PopEvent(); val != SG_NEXTMOVE;
          val = m_stack.PopEvent())
@@ -529,6 +641,8 @@ void GoRegionBoard::OnUndoneMove()
             case REGION_REMOVE_BLOCK:
             {   GoBlock* b = static_cast<GoBlock*>(m_stack.PopPtr());
                 AddBlock(b, IS_UNDO);
+                // Captured block or block merged by the move
+                changedPoints |= b->Stones();
                 for (int nu = m_stack.PopInt(); nu > 0; --nu)
                 {
                     GoRegion* r = static_cast<GoRegion*>(m_stack.PopPtr());
@@ -550,6 +664,7 @@ void GoRegionBoard::OnUndoneMove()
                 r->OnRemoveStone(p);
                 m_region[r->Color()][p] = r;
                 changed.Insert(r);
+                changedPoints.Include(p);
             }
             break;
             case REGION_ADD_STONE_TO_BLOCK:
@@ -565,10 +680,10 @@ void GoRegionBoard::OnUndoneMove()
     }
 
     for (SgVectorIteratorOf<GoRegion> it(changed); it; ++it)
-    {
         (*it)->ResetNonBlockFlags();
-        (*it)->ComputeBasicFlags();
-    }
+    InvalidateRegions(changedPoints);
+    ComputeBasicFlags();
+    SortBlocksRegions();
 
     if (HEAVYCHECK)
     {
@@ -15,8 +15,17 @@ class GoChain;
 //----------------------------------------------------------------------------
 
 /** GoRegionBoard provides GoRegion, GoBlock and optionally GoChain.
-    To keep it updated during search, call OnExecutedMove
-    (or OnExecutedUncodedMove) and OnUndoneMove when Executing/Undoing a move.
+    To keep it updated during search, call ExecuteMovePrologue before and
+    OnExecutedMove (or OnExecutedUncodedMove) after playing a move on the
+    board, and OnUndoneMove after undoing a move. Blocks and regions are
+    then updated incrementally around the changed points and the basic
+    flags (see GoRegion::ComputeBasicFlags) are recomputed only for the
+    regions that touch a changed block or point. A safety solver using
+    this region board can then be run in any position of the search
+    without recomputing the blocks and regions from scratch. The lists of
+    blocks and regions are kept in the order of GenBlocksRegions(),
+    because the results of the solvers depend on this order.
+    Moves that are suicide are not supported.
 
     A GoRegionBoard depends on a GoBoard (supplied at construction)
     for keeping the low-level board state, Go rules etc.
@@ -25,7 +34,8 @@ class GoChain;
     GoBoard and the GoBlock's in a GoRegionBoard.
 
     GoChain's are not updated automatically for performance reasons
-    - call GenChains() to update them. */
+    - call GenChains() to update them. Chains and all other data computed
+    by the safety solvers are discarded by each incremental update. */
 class GoRegionBoard
 {
 public:
@@ -239,6 +249,27 @@ private:
     /** Sets m_region elements to point to r */
     void SetRegionArrays(GoRegion* r);
 
+    /** Delete all chains and reset the data of blocks and regions that
+        was computed by the safety solvers.
+        Called by incremental updates, which keep only blocks, regions
+        and basic flags. */
+    void ResetSolverData();
+
+    /** Reset the flags of all regions that depend on changed points.
+        These are the regions that contain or are adjacent to a changed
+        point, or are adjacent to or contain a block whose stones or
+        liberties might have changed (a block at or next to a changed
+        point).
+        @param changed Points whose color changed */
+    void InvalidateRegions(const SgPointSet& changed);
+
+    /** Compute the basic flags of all regions that are not valid. */
+    void ComputeBasicFlags();
+
+    /** Sort blocks and regions into the order of GenBlocksRegions().
+        Blocks by anchor, regions by their first point. */
+    void SortBlocksRegions();
+
     /** add block to GoRegionBoard */
     void AddBlock(GoBlock* b, bool isExecute = true);
 
@@ -264,6 +295,12 @@ private:
     /** stores incremental state changes for execute/undo moves */
     SgIncrementalStack m_stack;
 
+    /** Empty m_stack.
+        Deletes the blocks and regions that were removed by the moves on
+        the stack, which are owned by the stack until the moves are
+        undone. */
+    void ClearStack();
+
     /** push on m_stack */
     void PushRegion(int type, GoRegion* r);
 
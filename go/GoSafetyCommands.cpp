@@ -6,6 +6,7 @@
 #include "SgSystem.h"
 #include "GoSafetyCommands.h"
 
+#include "GoBensonBitboard.h"
 #include "GoBensonSolver.h"
 #include "GoBoard.h"
 #include "GoGtpCommandUtil.h"
@@ -48,7 +49,7 @@ void GoSafetyCommands::CmdDameStatic(GtpCommand& cmd)
 
 /** Information about safe points optimized for graphical display in GoGui.
     This command is compatible with GoGui's analyze command type "gfx".
-    Arguments: benson|static <br>
+    Arguments: benson|benson_bitboard|static <br>
     Returns: GoGui gfx commands to display safe points and additional
     information in the status line
     - black and white territory: safe points
@@ -103,7 +104,7 @@ void GoSafetyCommands::CmdGfx(GtpCommand& cmd)
 
 /** List of safe points.
     If no color is given, safe points of both colors are listed.
-    Arguments: benson|static [black|white]<br>
+    Arguments: benson|benson_bitboard|static [black|white]<br>
     Returns: number of point followed bu list of points in one line. */
 void GoSafetyCommands::CmdSafe(GtpCommand& cmd)
 {
@@ -141,6 +142,11 @@ SgBWSet GoSafetyCommands::GetSafe(int& totalRegions, const std::string& type)
         GoBensonSolver solver(bd, &regionAttachment);
         solver.FindSafePoints(&safe);
     }
+    else if (type == "benson_bitboard")
+    {
+        GoBensonBitboard solver;
+        solver.FindSafePoints(bd, &safe);
+    }
     else if (type == "static")
     {
         GoSafetySolver solver(bd, &regionAttachment);
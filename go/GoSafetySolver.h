@@ -38,6 +38,7 @@ public:
     virtual bool UpToDate() const
     {
         return    GoStaticSafetySolver::UpToDate() 
+               && Regions()->ChainsUpToDate()
                && m_code == Board().GetHashCode();
     }
 
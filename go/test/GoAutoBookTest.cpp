@@ -0,0 +1,233 @@
+//----------------------------------------------------------------------------
+/** @file GoAutoBookTest.cpp
+    Unit tests for GoAutoBook. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <boost/filesystem.hpp>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoAutoBook.h"
+#include "GoBoard.h"
+
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+const char* const FILE_NAME = "GoAutoBookTest.tmp";
+
+const char* const JOURNAL_FILE_NAME = "GoAutoBookTest.tmp.journal";
+
+/** Removes the temporary files at the end of the test. */
+struct AutoBookFixture
+{
+    GoAutoBookParam m_param;
+
+    GoBoard m_bd;
+
+    GoAutoBookState m_state;
+
+    AutoBookFixture();
+
+    ~AutoBookFixture();
+
+    int NuJournalLines() const;
+};
+
+AutoBookFixture::AutoBookFixture()
+    : m_bd(9),
+      m_state(m_bd)
+{
+    m_state.Synchronize();
+}
+
+AutoBookFixture::~AutoBookFixture()
+{
+    std::remove(FILE_NAME);
+    std::remove(JOURNAL_FILE_NAME);
+}
+
+int AutoBookFixture::NuJournalLines() const
+{
+    std::ifstream in(JOURNAL_FILE_NAME);
+    int count = 0;
+    std::string line;
+    while (std::getline(in, line))
+        ++count;
+    return count;
+}
+
+/** Flush() appends only the changed nodes to the journal, which is
+    replayed when the book is opened. */
+BOOST_FIXTURE_TEST_CASE(GoAutoBookTest_Journal, AutoBookFixture)
+{
+    {
+        GoAutoBook book(FILE_NAME, m_param);
+        book.Put(m_state, SgBookNode(0.5f));
+        m_state.Play(Pt(3, 3));
+        book.Put(m_state, SgBookNode(0.25f));
+        m_state.Undo();
+        book.Flush();
+        // The journal has as many nodes as the book
+        BOOST_CHECK_EQUAL(book.NuJournalEntries(), 0u);
+        BOOST_CHECK(! boost::filesystem::exists(JOURNAL_FILE_NAME));
+        m_state.Play(Pt(5, 5));
+        book.Put(m_state, SgBookNode(0.75f));
+        book.Put(m_state, SgBookNode(0.125f));
+        m_state.Undo();
+        book.Flush();
+        BOOST_CHECK_EQUAL(book.NuJournalEntries(), 1u);
+        BOOST_CHECK_EQUAL(NuJournalLines(), 1);
+        // Nothing changed
+        book.Flush();
+        BOOST_CHECK_EQUAL(NuJournalLines(), 1);
+    }
+    GoAutoBook book(FILE_NAME, m_param);
+    BOOST_CHECK_EQUAL(book.NuJournalEntries(), 1u);
+    SgBookNode node;
+    BOOST_REQUIRE(book.Get(m_state, node));
+    BOOST_CHECK_EQUAL(node.m_value, 0.5f);
+    m_state.Play(Pt(5, 5));
+    BOOST_REQUIRE(book.Get(m_state, node));
+    BOOST_CHECK_EQUAL(node.m_value, 0.125f);
+    book.Compact();
+    BOOST_CHECK_EQUAL(book.NuJournalEntries(), 0u);
+    BOOST_CHECK(! boost::filesystem::exists(JOURNAL_FILE_NAME));
+    GoAutoBook compacted(FILE_NAME, m_param);
+    BOOST_REQUIRE(compacted.Get(m_state, node));
+    BOOST_CHECK_EQUAL(node.m_value, 0.125f);
+}
+
+/** An entry at the end of the journal that was not written completely is
+    ignored and removed. */
+BOOST_FIXTURE_TEST_CASE(GoAutoBookTest_TruncatedJournal, AutoBookFixture)
+{
+    {
+        GoAutoBook book(FILE_NAME, m_param);
+        book.Put(m_state, SgBookNode(0.5f));
+        book.Compact();
+        m_state.Play(Pt(3, 3));
+        book.Put(m_state, SgBookNode(0.25f));
+        m_state.Undo();
+        book.Flush();
+        BOOST_CHECK_EQUAL(book.NuJournalEntries(), 1u);
+    }
+    std::string journal;
+    {
+        std::ifstream in(JOURNAL_FILE_NAME, std::ios::binary);
+        std::ostringstream buffer;
+        buffer << in.rdbuf();
+        journal = buffer.str();
+    }
+    {
+        std::ofstream out(JOURNAL_FILE_NAME,
+                          std::ios::app | std::ios::binary);
+        out << journal.substr(0, journal.size() / 2);
+    }
+    {
+        GoAutoBook book(FILE_NAME, m_param);
+        BOOST_CHECK_EQUAL(book.NuJournalEntries(), 1u);
+        BOOST_CHECK_EQUAL(boost::filesystem::file_size(JOURNAL_FILE_NAME),
+                          journal.size());
+        SgBookNode node;
+        m_state.Play(Pt(3, 3));
+        BOOST_REQUIRE(book.Get(m_state, node));
+        BOOST_CHECK_EQUAL(node.m_value, 0.25f);
+        m_state.Undo();
+        m_state.Play(Pt(5, 5));
+        book.Put(m_state, SgBookNode(0.75f));
+        m_state.Undo();
+        book.Flush();
+    }
+    BOOST_CHECK_EQUAL(NuJournalLines(), 2);
+    GoAutoBook book(FILE_NAME, m_param);
+    BOOST_CHECK_EQUAL(book.NuJournalEntries(), 2u);
+    SgBookNode node;
+    m_state.Play(Pt(5, 5));
+    BOOST_REQUIRE(book.Get(m_state, node));
+    BOOST_CHECK_EQUAL(node.m_value, 0.75f);
+}
+
+/** A book without version line has the hash codes of an old version and
+    is not opened. */
+BOOST_FIXTURE_TEST_CASE(GoAutoBookTest_OldVersion, AutoBookFixture)
+{
+    {
+        std::ofstream out(FILE_NAME);
+        out << m_state.GetHashCode().ToString() << '\t'
+            << SgBookNode(0.5f).ToString() << '\n';
+    }
+    BOOST_CHECK_THROW(GoAutoBook(FILE_NAME, m_param), SgException);
+}
+
+/** A book written by the version before GoCanonicalHash.
+    Nodes of the line B2 A1 A2 B1 C1 on 9x9, C1 captures two stones, so the
+    hash code of the last position differs from the current version.
+    Contains an additional node for the position after E5, which is a child
+    of the leaf after C1 and not reachable. */
+const char* const OLD_BOOK =
+    "0236cfc22e6b06a5\tVal +0.900000 ExpP 0.000000 Heur +0.900000 Cnt 0\n"
+    "1a37385eab7e2e6d\tVal +0.500000 ExpP 0.000000 Heur +0.500000 Cnt 5\n"
+    "1d5d4fc8bdd49343\tVal +0.200000 ExpP 0.000000 Heur +0.200000 Cnt 2\n"
+    "205e7a449efafdae\tVal +0.400000 ExpP 0.000000 Heur +0.400000 Cnt 4\n"
+    "2b33cc7b76ea4d40\tVal +0.600000 ExpP 0.000000 Heur +0.600000 Cnt 0\n"
+    "37c458c19644c304\tVal +0.300000 ExpP 0.000000 Heur +0.300000 Cnt 3\n"
+    "e7e1faeed5c31f79\tVal +0.100000 ExpP 0.000000 Heur +0.100000 Cnt 1\n";
+
+const char* const OLD_FILE_NAME = "GoAutoBookTest.old.tmp";
+
+/** Upgrade() converts the nodes reachable from the position and drops the
+    others. */
+BOOST_FIXTURE_TEST_CASE(GoAutoBookTest_Upgrade, AutoBookFixture)
+{
+    {
+        std::ofstream out(OLD_FILE_NAME);
+        out << OLD_BOOK;
+    }
+    const std::size_t nuNodes =
+        GoAutoBook::Upgrade(OLD_FILE_NAME, FILE_NAME, m_bd);
+    std::remove(OLD_FILE_NAME);
+    BOOST_CHECK_EQUAL(nuNodes, 6u);
+    GoAutoBook book(FILE_NAME, m_param);
+    const SgPoint moves[5] = { Pt(2, 2), Pt(1, 1), Pt(1, 2), Pt(2, 1),
+                               Pt(3, 1) };
+    for (int i = 0; i <= 5; ++i)
+    {
+        SgBookNode node;
+        BOOST_REQUIRE(book.Get(m_state, node));
+        BOOST_CHECK_CLOSE(node.m_value, 0.1f * float(i + 1), 1e-3f);
+        BOOST_CHECK_EQUAL(node.m_count, (i < 5 ? unsigned(i + 1) : 0u));
+        if (i < 5)
+            m_state.Play(moves[i]);
+    }
+    BOOST_CHECK(m_state.Board().IsEmpty(Pt(1, 1)));
+    BOOST_CHECK(m_state.Board().IsEmpty(Pt(2, 1)));
+    m_state.Play(Pt(5, 5));
+    SgBookNode node;
+    BOOST_CHECK(! book.Get(m_state, node));
+}
+
+/** Upgrade() fails and writes no file if the position is not in the old
+    book. */
+BOOST_FIXTURE_TEST_CASE(GoAutoBookTest_Upgrade_NotFound, AutoBookFixture)
+{
+    {
+        std::ofstream out(OLD_FILE_NAME);
+        out << OLD_BOOK;
+    }
+    GoBoard bd(9);
+    bd.Play(Pt(3, 3), SG_BLACK);
+    BOOST_CHECK_THROW(GoAutoBook::Upgrade(OLD_FILE_NAME, FILE_NAME, bd),
+                      SgException);
+    std::remove(OLD_FILE_NAME);
+    BOOST_CHECK(! boost::filesystem::exists(FILE_NAME));
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,114 @@
+//----------------------------------------------------------------------------
+/** @file GoBensonBitboardTest.cpp
+    Unit tests for GoBensonBitboard. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <vector>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBensonBitboard.h"
+#include "GoBensonSolver.h"
+#include "GoBoard.h"
+#include "GoBoardUtil.h"
+#include "GoSetup.h"
+#include "SgRandom.h"
+
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Compare the safe points with the ones found by GoBensonSolver. */
+void CheckSameAsBensonSolver(GoBoard& bd, GoBensonBitboard& benson)
+{
+    SgBWSet safe;
+    benson.FindSafePoints(bd, &safe);
+    SgBWSet expectedSafe;
+    GoBensonSolver solver(bd);
+    solver.FindSafePoints(&expectedSafe);
+    BOOST_REQUIRE(safe == expectedSafe);
+}
+
+/** Compare with GoBensonSolver in random games.
+    The games do not fill completely surrounded points and are played
+    until no such moves are left, so the final positions contain many
+    unconditionally alive blocks. */
+void CheckRandomGames(int size, int nuGames)
+{
+    GoBoard bd(size);
+    GoBensonBitboard benson;
+    SgRandom random;
+    std::vector<SgPoint> moves;
+    for (int i = 0; i < nuGames; ++i)
+    {
+        bd.Init(size);
+        while (bd.MoveNumber() < 3 * size * size)
+        {
+            CheckSameAsBensonSolver(bd, benson);
+            moves.clear();
+            for (GoBoard::Iterator it(bd); it; ++it)
+                if (  bd.IsLegal(*it)
+                   && ! GoBoardUtil::IsCompletelySurrounded(bd, *it)
+                   )
+                    moves.push_back(*it);
+            if (moves.empty())
+                break;
+            bd.Play(moves[random.SmallInt(int(moves.size()))]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GoBensonBitboardTest_EmptyBoard)
+{
+    GoBoard bd(9);
+    GoBensonBitboard benson;
+    SgBWSet safe;
+    benson.FindSafePoints(bd, &safe);
+    BOOST_CHECK(safe.BothEmpty());
+}
+
+/** Black block with two eyes in the corner.
+    @verbatim
+    5 X X . . .
+    4 . X . . .
+    3 X X . O .
+    2 . X . . .
+    1 X X . . .
+      A B C D E
+    @endverbatim */
+BOOST_AUTO_TEST_CASE(GoBensonBitboardTest_TwoEyes)
+{
+    GoSetup setup;
+    setup.AddBlack(Pt(1, 1));
+    setup.AddBlack(Pt(2, 1));
+    setup.AddBlack(Pt(2, 2));
+    setup.AddBlack(Pt(1, 3));
+    setup.AddBlack(Pt(2, 3));
+    setup.AddBlack(Pt(2, 4));
+    setup.AddBlack(Pt(1, 5));
+    setup.AddBlack(Pt(2, 5));
+    setup.AddWhite(Pt(4, 3));
+    GoBoard bd(9, setup);
+    GoBensonBitboard benson;
+    SgBWSet safe;
+    benson.FindSafePoints(bd, &safe);
+    SgPointSet expected = bd.All(SG_BLACK);
+    expected.Include(Pt(1, 2));
+    expected.Include(Pt(1, 4));
+    BOOST_CHECK(safe[SG_BLACK] == expected);
+    BOOST_CHECK(safe[SG_WHITE].IsEmpty());
+    CheckSameAsBensonSolver(bd, benson);
+}
+
+BOOST_AUTO_TEST_CASE(GoBensonBitboardTest_RandomGames)
+{
+    CheckRandomGames(5, 20);
+    CheckRandomGames(7, 10);
+    CheckRandomGames(9, 5);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,191 @@
+//----------------------------------------------------------------------------
+/** @file GoBinaryBookTest.cpp
+    Unit tests for GoBinaryBook. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoAutoBook.h"
+#include "GoBinaryBook.h"
+#include "GoBoard.h"
+#include "GoBook.h"
+#include "SgException.h"
+
+using std::istringstream;
+using std::vector;
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+const char* const FILE_NAME = "GoBinaryBookTest.tmp";
+
+/** Removes the temporary file at the end of the test. */
+struct BinaryBookFixture
+{
+    ~BinaryBookFixture();
+
+    void Write(const std::string& data);
+};
+
+BinaryBookFixture::~BinaryBookFixture()
+{
+    std::remove(FILE_NAME);
+}
+
+void BinaryBookFixture::Write(const std::string& data)
+{
+    std::ofstream out(FILE_NAME, std::ios::binary);
+    out << data;
+}
+
+/** A GoBook converted to a binary book returns the same moves in all
+    rotations of the positions. */
+BOOST_FIXTURE_TEST_CASE(GoBinaryBookTest_Moves, BinaryBookFixture)
+{
+    istringstream in("9 | E5\n"
+                     "9 C3 C7 E5 | G7 G3\n"
+                     "19 | Q16\n");
+    GoBook book;
+    book.Read(in);
+    {
+        std::ofstream out(FILE_NAME, std::ios::binary);
+        book.WriteBinary(out);
+    }
+    BOOST_CHECK(GoBinaryBook::IsBinaryBook(FILE_NAME));
+    GoBook binaryBook;
+    binaryBook.Read(FILE_NAME);
+    BOOST_CHECK(binaryBook.IsBinary());
+    GoBoard bd(9);
+    vector<SgPoint> moves = binaryBook.LookupAllMoves(bd);
+    BOOST_REQUIRE_EQUAL(moves.size(), 1u);
+    BOOST_CHECK_EQUAL(moves[0], Pt(5, 5));
+    BOOST_CHECK_EQUAL(binaryBook.Line(bd), 1);
+    // Mirrored position
+    bd.Play(Pt(7, 3));
+    bd.Play(Pt(7, 7));
+    bd.Play(Pt(5, 5));
+    BOOST_CHECK(binaryBook.LookupAllMoves(bd) == book.LookupAllMoves(bd));
+    BOOST_CHECK_EQUAL(binaryBook.LookupAllMoves(bd).size(), 2u);
+    BOOST_CHECK_EQUAL(binaryBook.Line(bd), 2);
+    bd.Play(Pt(1, 1));
+    BOOST_CHECK(binaryBook.LookupAllMoves(bd).empty());
+    BOOST_CHECK_EQUAL(binaryBook.Line(bd), 0);
+    // Same hash code as the empty 9x9 board
+    GoBoard bd19(19);
+    moves = binaryBook.LookupAllMoves(bd19);
+    BOOST_REQUIRE_EQUAL(moves.size(), 1u);
+    BOOST_CHECK_EQUAL(moves[0], Pt(16, 16));
+    // Binary books are read-only
+    BOOST_CHECK_THROW(binaryBook.Add(bd19, Pt(4, 4)), SgException);
+    std::ostringstream out;
+    BOOST_CHECK_THROW(binaryBook.Write(out), SgException);
+    // Reading a text book closes the binary book
+    istringstream in2("9 | C3\n");
+    binaryBook.Read(in2);
+    BOOST_CHECK(! binaryBook.IsBinary());
+}
+
+/** A GoAutoBook converted to a binary book returns the same nodes. */
+BOOST_FIXTURE_TEST_CASE(GoBinaryBookTest_Nodes, BinaryBookFixture)
+{
+    GoAutoBookParam param;
+    GoBoard bd(9);
+    GoAutoBookState state(bd);
+    state.Synchronize();
+    SgBookNode root(0.5f);
+    root.m_count = 3;
+    root.m_priority = 1.5f;
+    SgBookNode child(0.25f);
+    {
+        GoAutoBook book(FILE_NAME, param);
+        book.Put(state, root);
+        state.Play(Pt(3, 3));
+        book.Put(state, child);
+        state.Undo();
+        book.SaveBinary(FILE_NAME);
+    }
+    GoAutoBook book(FILE_NAME, param);
+    BOOST_CHECK(book.IsBinary());
+    SgBookNode node;
+    BOOST_REQUIRE(book.Get(state, node));
+    BOOST_CHECK_EQUAL(node.m_heurValue, 0.5f);
+    BOOST_CHECK_EQUAL(node.m_value, 0.5f);
+    BOOST_CHECK_EQUAL(node.m_priority, 1.5f);
+    BOOST_CHECK_EQUAL(node.m_count, 3u);
+    // Canonical hash code of a rotated position
+    state.Play(Pt(7, 3));
+    BOOST_REQUIRE(book.Get(state, node));
+    BOOST_CHECK_EQUAL(node.m_value, 0.25f);
+    BOOST_CHECK(node.IsLeaf());
+    state.Undo();
+    state.Play(Pt(5, 5));
+    BOOST_CHECK(! book.Get(state, node));
+    BOOST_CHECK_THROW(book.Put(state, child), SgException);
+    BOOST_CHECK_THROW(book.Flush(), SgException);
+}
+
+BOOST_FIXTURE_TEST_CASE(GoBinaryBookTest_Empty, BinaryBookFixture)
+{
+    std::ostringstream out;
+    GoBinaryBook::WriteNodes(out, vector<GoBinaryBook::NodesEntry>());
+    Write(out.str());
+    GoBinaryBook book;
+    book.Open(FILE_NAME);
+    BOOST_CHECK(book.IsOpen());
+    BOOST_CHECK_EQUAL(book.GetType(), GoBinaryBook::NODES);
+    BOOST_CHECK_EQUAL(book.NuEntries(), 0u);
+    SgBookNode node;
+    BOOST_CHECK(! book.LookupNode(SgHashCode(), node));
+}
+
+BOOST_FIXTURE_TEST_CASE(GoBinaryBookTest_Duplicate, BinaryBookFixture)
+{
+    vector<GoBinaryBook::MovesEntry> entries(2);
+    entries[0].m_size = 9;
+    entries[0].m_line = 1;
+    entries[0].m_moves.push_back(Pt(5, 5));
+    entries[1] = entries[0];
+    std::ostringstream out;
+    BOOST_CHECK_THROW(GoBinaryBook::WriteMoves(out, entries), SgException);
+    // Same hash code, different board size
+    entries[1].m_size = 19;
+    GoBinaryBook::WriteMoves(out, entries);
+}
+
+BOOST_FIXTURE_TEST_CASE(GoBinaryBookTest_Invalid, BinaryBookFixture)
+{
+    GoBinaryBook book;
+    Write("9 | E5\n");
+    BOOST_CHECK(! GoBinaryBook::IsBinaryBook(FILE_NAME));
+    BOOST_CHECK_THROW(book.Open(FILE_NAME), SgException);
+    BOOST_CHECK(! book.IsOpen());
+    vector<GoBinaryBook::MovesEntry> entries(1);
+    entries[0].m_size = 9;
+    entries[0].m_line = 1;
+    entries[0].m_moves.push_back(Pt(5, 5));
+    std::ostringstream out;
+    GoBinaryBook::WriteMoves(out, entries);
+    const std::string data = out.str();
+    // Truncated
+    Write(data.substr(0, data.size() - 1));
+    BOOST_CHECK_THROW(book.Open(FILE_NAME), SgException);
+    // Header checksum
+    std::string corrupt = data;
+    corrupt[20] = 3;
+    Write(corrupt);
+    BOOST_CHECK_THROW(book.Open(FILE_NAME), SgException);
+    Write(data);
+    book.Open(FILE_NAME);
+    BOOST_CHECK_EQUAL(book.GetType(), GoBinaryBook::MOVES);
+    BOOST_CHECK_EQUAL(book.NuEntries(), 1u);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
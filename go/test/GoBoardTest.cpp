@@ -5,9 +5,11 @@
 
 #include "SgSystem.h"
 
+#include <vector>
 #include <boost/test/auto_unit_test.hpp>
 #include "GoBoard.h"
 #include "GoSetupUtil.h"
+#include "SgRandom.h"
 #include "SgWrite.h"
 
 using SgPointUtil::Pt;
@@ -143,6 +145,117 @@ BOOST_AUTO_TEST_CASE(GoBoardTest_Defaults)
 }
 
 /** Play and undo some moves and remember and compare the hash code. */
+/** Test that GoBoard::FullBoardRepetition() ignores positions that differ
+    only by passes. */
+BOOST_AUTO_TEST_CASE(GoBoardTest_FullBoardRepetition_Pass)
+{
+    GoBoard bd(9);
+    for (int i = 0; i < 2; ++i)
+    {
+        bd.Rules().SetKoRule(i == 0 ? GoRules::SUPERKO : GoRules::POS_SUPERKO);
+        bd.Play(SG_PASS);
+        BOOST_CHECK(! bd.FullBoardRepetition());
+        bd.Play(SG_PASS);
+        BOOST_CHECK(! bd.FullBoardRepetition());
+        bd.Undo();
+        bd.Undo();
+    }
+}
+
+/** Position in the reference implementation used by
+    GoBoardTest_FullBoardRepetition_Random. */
+struct RepetitionTestPosition
+{
+    SgBWSet m_stones;
+
+    /** Number of moves that are not passes before this position. */
+    int m_nuNonPassMoves;
+
+    /** Color to play, when the next move was played. */
+    SgBlackWhite m_toPlay;
+};
+
+/** Check GoBoard::FullBoardRepetition() with superko rules against a
+    comparison with all earlier positions.
+    Plays random games on a small board with many captures and repetitions,
+    including passes, Undo(), SetToPlay() and RestoreSnapshot(). */
+BOOST_AUTO_TEST_CASE(GoBoardTest_FullBoardRepetition_Random)
+{
+    SgRandom random;
+    GoBoard bd(5);
+    std::vector<RepetitionTestPosition> positions;
+    int snapshotSize = -1;
+    int nuRepetitions = 0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        if (i % 400 == 0)
+        {
+            bd.Init(5);
+            positions.assign(1, RepetitionTestPosition());
+            positions[0].m_nuNonPassMoves = 0;
+            snapshotSize = -1;
+        }
+        RepetitionTestPosition& current = positions.back();
+        current.m_stones = SgBWSet(bd.All(SG_BLACK), bd.All(SG_WHITE));
+        for (int j = 0; j < 2; ++j)
+        {
+            const bool situational = (j == 0);
+            bool isRepetition = false;
+            for (std::size_t k = 0; k + 1 < positions.size(); ++k)
+                if (  positions[k].m_nuNonPassMoves < current.m_nuNonPassMoves
+                   && positions[k].m_stones == current.m_stones
+                   && (! situational || positions[k].m_toPlay == bd.ToPlay())
+                   )
+                    isRepetition = true;
+            bd.Rules().SetKoRule(situational ? GoRules::SUPERKO
+                                             : GoRules::POS_SUPERKO);
+            BOOST_REQUIRE_EQUAL(bd.FullBoardRepetition(), isRepetition);
+            if (isRepetition)
+                ++nuRepetitions;
+        }
+        const int action = random.SmallInt(20);
+        if (action < 3 && bd.MoveNumber() > 0)
+        {
+            bd.Undo();
+            positions.pop_back();
+            if (int(positions.size()) < snapshotSize)
+                snapshotSize = -1;
+            continue;
+        }
+        if (action == 3)
+        {
+            bd.SetToPlay(SgOppBW(bd.ToPlay()));
+            continue;
+        }
+        if (action == 4)
+        {
+            bd.TakeSnapshot();
+            snapshotSize = int(positions.size());
+            continue;
+        }
+        if (action == 5 && snapshotSize > 0)
+        {
+            bd.RestoreSnapshot();
+            positions.resize(snapshotSize);
+            continue;
+        }
+        std::vector<SgPoint> moves;
+        for (GoBoard::Iterator it(bd); it; ++it)
+            if (bd.IsEmpty(*it) && ! bd.IsSuicide(*it, bd.ToPlay()))
+                moves.push_back(*it);
+        SgPoint p = SG_PASS;
+        if (action > 6 && ! moves.empty())
+            p = moves[random.SmallInt(int(moves.size()))];
+        current.m_toPlay = bd.ToPlay();
+        bd.Play(p);
+        RepetitionTestPosition next;
+        next.m_nuNonPassMoves =
+            current.m_nuNonPassMoves + (p == SG_PASS ? 0 : 1);
+        positions.push_back(next);
+    }
+    BOOST_CHECK(nuRepetitions > 0);
+}
+
 BOOST_AUTO_TEST_CASE(GoBoardTest_GetHashCode)
 {
     GoBoard bd(9);
@@ -167,6 +280,16 @@ BOOST_AUTO_TEST_CASE(GoBoardTest_GetHashCode)
     BOOST_CHECK_EQUAL(bd.GetHashCode(), h1);
 }
 
+/** Tests that the hash codes do not change between versions.
+    Opening books and other files store hash codes, so the Zobrist table
+    must not depend on the random engine (see SgHashZobrist). */
+BOOST_AUTO_TEST_CASE(GoBoardTest_GetHashCode_Fixed)
+{
+    GoBoard bd(9);
+    bd.Play(Pt(5, 5), SG_BLACK);
+    BOOST_CHECK_EQUAL(bd.GetHashCode().ToString(), "9a1b7d0878d22934");
+}
+
 /** Tests that the hash code is 0 for the empty positions.
     If this is changed later, make sure no code relies on that fact. */
 BOOST_AUTO_TEST_CASE(GoBoardTest_GetHashCode_EmptyPosition)
@@ -273,6 +396,87 @@ BOOST_AUTO_TEST_CASE(GoBoardTest_Init)
                             "Point " << SgWritePoint(*it) << " not empty");
 }
 
+BOOST_AUTO_TEST_CASE(GoBoardTest_InitClone)
+{
+    GoSetup setup;
+    setup.AddWhite(Pt(1, 1));
+    setup.AddWhite(Pt(2, 2));
+    setup.AddWhite(Pt(3, 1));
+    setup.AddBlack(Pt(1, 2));
+    GoBoard bd(9, setup);
+    bd.Rules().SetKomi(GoKomi(7.5));
+    bd.Play(Pt(5, 5), SG_BLACK);
+    bd.Play(Pt(5, 6), SG_WHITE);
+    bd.Play(Pt(2, 1), SG_BLACK);
+    GoBoard clone(5);
+    clone.InitClone(bd);
+    BOOST_CHECK_EQUAL(clone.Size(), 9);
+    BOOST_CHECK_EQUAL(clone.MoveNumber(), 0);
+    BOOST_CHECK_EQUAL(clone.ToPlay(), SG_WHITE);
+    BOOST_CHECK(clone.Rules().Komi() == GoKomi(7.5));
+    BOOST_CHECK_EQUAL(clone.GetHashCode(), bd.GetHashCode());
+    BOOST_CHECK_EQUAL(clone.NumPrisoners(SG_WHITE), 1);
+    BOOST_CHECK(clone.Setup().m_stones == SgBWSet(bd.All(SG_BLACK),
+                                                  bd.All(SG_WHITE)));
+    BOOST_CHECK_EQUAL(clone.Setup().m_player, SG_WHITE);
+    BOOST_CHECK_EQUAL(clone.NumStones(Pt(1, 2)), 1);
+    BOOST_CHECK_EQUAL(clone.NumLiberties(Pt(5, 5)), 3);
+    // Ko
+    BOOST_CHECK(! clone.IsLegal(Pt(1, 1)));
+    clone.Play(Pt(9, 9));
+    bd.Play(Pt(9, 9));
+    BOOST_CHECK_EQUAL(clone.GetHashCode(), bd.GetHashCode());
+    clone.Undo();
+    BOOST_CHECK_EQUAL(clone.MoveNumber(), 0);
+    // Clone is detached from original board
+    bd.Play(Pt(6, 5));
+    BOOST_CHECK_EQUAL(clone.GetColor(Pt(6, 5)), SG_EMPTY);
+    BOOST_CHECK_EQUAL(clone.NumLiberties(Pt(5, 5)), 3);
+}
+
+/** Compare a cloned board with the original board in followup positions of
+    random games with passes and many captures and repetitions. */
+BOOST_AUTO_TEST_CASE(GoBoardTest_InitClone_Random)
+{
+    SgRandom random;
+    GoBoard bd(5);
+    GoBoard clone;
+    for (int i = 0; i < 300; ++i)
+    {
+        if (i % 30 == 0)
+        {
+            bd.Init(5);
+            bd.Rules().SetKoRule(i % 60 == 0 ? GoRules::SUPERKO
+                                             : GoRules::POS_SUPERKO);
+        }
+        clone.InitClone(bd);
+        const int moveNumber = bd.MoveNumber();
+        for (int j = 0; j < 40; ++j)
+        {
+            BOOST_REQUIRE_EQUAL(clone.GetHashCode(), bd.GetHashCode());
+            BOOST_REQUIRE_EQUAL(clone.ToPlay(), bd.ToPlay());
+            std::vector<SgPoint> moves;
+            for (GoBoard::Iterator it(bd); it; ++it)
+            {
+                BOOST_REQUIRE_EQUAL(clone.GetColor(*it), bd.GetColor(*it));
+                BOOST_REQUIRE_EQUAL(clone.IsLegal(*it), bd.IsLegal(*it));
+                if (bd.IsLegal(*it))
+                    moves.push_back(*it);
+            }
+            SgPoint p = SG_PASS;
+            if (random.SmallInt(8) > 0 && ! moves.empty())
+                p = moves[random.SmallInt(int(moves.size()))];
+            bd.Play(p);
+            clone.Play(p);
+        }
+        // Continue with the original board at a random followup position
+        const int nuUndo = 40 - random.SmallInt(20);
+        for (int j = 0; j < nuUndo; ++j)
+            bd.Undo();
+        BOOST_REQUIRE(bd.MoveNumber() >= moveNumber);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(GoBoardTest_IsFirst)
 {
     GoBoard bd;
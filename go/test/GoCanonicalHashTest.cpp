@@ -0,0 +1,150 @@
+//----------------------------------------------------------------------------
+/** @file GoCanonicalHashTest.cpp
+    Unit tests for GoCanonicalHash. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoCanonicalHash.h"
+#include "GoSetup.h"
+
+using SgPointUtil::Pt;
+using SgPointUtil::Rotate;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Hash code of rotation 0 is the hash code of the board. */
+BOOST_AUTO_TEST_CASE(GoCanonicalHashTest_BoardHashCode)
+{
+    GoBoard bd(9);
+    GoCanonicalHash hash;
+    hash.Init(bd);
+    BOOST_CHECK_EQUAL(hash.NuMoves(), 0);
+    BOOST_CHECK_EQUAL(hash.Get(0), bd.GetHashCodeInclToPlay());
+    // Single stone capture
+    const SgPoint moves[] = { Pt(1, 2), Pt(1, 1), Pt(2, 1), SG_PASS };
+    for (int i = 0; i < 4; ++i)
+    {
+        bd.Play(moves[i]);
+        hash.Play(bd);
+        BOOST_CHECK_EQUAL(hash.Get(0), bd.GetHashCodeInclToPlay());
+    }
+    BOOST_CHECK_EQUAL(bd.Occupied(Pt(1, 1)), false);
+    BOOST_CHECK_EQUAL(hash.NuMoves(), 4);
+}
+
+/** Symmetric positions have the same canonical hash code. */
+BOOST_AUTO_TEST_CASE(GoCanonicalHashTest_Symmetric)
+{
+    const SgPoint moves[] = { Pt(3, 3), Pt(7, 4), Pt(5, 2), Pt(2, 8) };
+    GoBoard bd(9);
+    GoCanonicalHash hash;
+    hash.Init(bd);
+    for (int i = 0; i < 4; ++i)
+    {
+        bd.Play(moves[i]);
+        hash.Play(bd);
+    }
+    for (int rot = 0; rot < GoCanonicalHash::NU_SYMMETRIES; ++rot)
+    {
+        GoBoard rotated(9);
+        for (int i = 0; i < 4; ++i)
+            rotated.Play(Rotate(rot, moves[i], 9));
+        GoCanonicalHash rotatedHash;
+        rotatedHash.Init(rotated);
+        BOOST_CHECK_EQUAL(rotatedHash.Canonical(), hash.Canonical());
+        BOOST_CHECK_EQUAL(hash.Get(rot), rotated.GetHashCodeInclToPlay());
+        BOOST_CHECK_EQUAL(GoCanonicalHash::Compute(rotated),
+                          hash.Canonical());
+    }
+    BOOST_CHECK_EQUAL(hash.Get(hash.CanonicalRotation()), hash.Canonical());
+    // Different color to play
+    const SgHashCode beforePass = hash.Canonical();
+    bd.Play(SG_PASS);
+    hash.Play(bd);
+    BOOST_CHECK(hash.Canonical() != beforePass);
+    GoCanonicalHash other;
+    other.Init(bd);
+    BOOST_CHECK_EQUAL(other.Canonical(), hash.Canonical());
+}
+
+/** Undo() restores the hash codes of the previous position. */
+BOOST_AUTO_TEST_CASE(GoCanonicalHashTest_Undo)
+{
+    GoBoard bd(9);
+    GoCanonicalHash hash;
+    hash.Init(bd);
+    const SgHashCode empty = hash.Canonical();
+    bd.Play(Pt(3, 3));
+    hash.Play(bd);
+    const SgHashCode afterMove = hash.Canonical();
+    BOOST_CHECK(afterMove != empty);
+    bd.Play(Pt(5, 5));
+    hash.Play(bd);
+    BOOST_CHECK(hash.Canonical() != afterMove);
+    bd.Undo();
+    hash.Undo();
+    BOOST_CHECK_EQUAL(hash.Canonical(), afterMove);
+    BOOST_CHECK_EQUAL(hash.NuMoves(), 1);
+    bd.Undo();
+    hash.Undo();
+    BOOST_CHECK_EQUAL(hash.Canonical(), empty);
+    BOOST_CHECK_EQUAL(hash.NuMoves(), 0);
+}
+
+/** The canonical hash code does not depend on the transformation of a game
+    with a capture of several stones. */
+BOOST_AUTO_TEST_CASE(GoCanonicalHashTest_MultiStoneCapture)
+{
+    const SgPoint black[] = { Pt(1, 2), Pt(2, 2), Pt(3, 1) };
+    const SgPoint white[] = { Pt(1, 1), Pt(2, 1) };
+    SgHashCode canonical;
+    for (int rot = 0; rot < GoCanonicalHash::NU_SYMMETRIES; ++rot)
+    {
+        GoBoard bd(9);
+        GoCanonicalHash hash;
+        hash.Init(bd);
+        for (int i = 0; i < 2; ++i)
+        {
+            bd.Play(Rotate(rot, black[i], 9), SG_BLACK);
+            hash.Play(bd);
+            bd.Play(Rotate(rot, white[i], 9), SG_WHITE);
+            hash.Play(bd);
+        }
+        bd.Play(Rotate(rot, black[2], 9), SG_BLACK);
+        hash.Play(bd);
+        BOOST_REQUIRE_EQUAL(bd.NuCapturedStones(), 2);
+        if (rot == 0)
+            canonical = hash.Canonical();
+        else
+            BOOST_CHECK_EQUAL(hash.Canonical(), canonical);
+    }
+}
+
+/** Setup stones are included in the hash codes. */
+BOOST_AUTO_TEST_CASE(GoCanonicalHashTest_Setup)
+{
+    GoSetup setup;
+    setup.AddBlack(Pt(3, 3));
+    setup.AddWhite(Pt(7, 7));
+    GoBoard bd(9, setup);
+    GoSetup rotatedSetup;
+    rotatedSetup.AddBlack(Pt(7, 3));
+    rotatedSetup.AddWhite(Pt(3, 7));
+    GoBoard rotated(9, rotatedSetup);
+    BOOST_CHECK_EQUAL(GoCanonicalHash::Compute(bd),
+                      GoCanonicalHash::Compute(rotated));
+    BOOST_CHECK(GoCanonicalHash::Compute(bd)
+                != GoCanonicalHash::Compute(GoBoard(9)));
+    GoCanonicalHash hash;
+    hash.Init(bd);
+    BOOST_CHECK_EQUAL(hash.Get(0), bd.GetHashCodeInclToPlay());
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
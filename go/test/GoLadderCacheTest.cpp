@@ -0,0 +1,142 @@
+//----------------------------------------------------------------------------
+/** @file GoLadderCacheTest.cpp
+    Unit tests for GoLadderCache. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <algorithm>
+#include <vector>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoBoardUtil.h"
+#include "GoLadder.h"
+#include "GoLadderCache.h"
+#include "GoSetup.h"
+#include "SgRandom.h"
+
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Results of all ladder queries of GoUctLadderKnowledge in a position.
+    Contains the results of IsLadderCaptureMove() and the escape moves
+    found by FindLadderEscapeMoves().
+    The blocks and liberties are copied and sorted before the queries,
+    because the ladder reading plays and undoes moves, which can change the
+    order of the blocks and liberties. */
+std::vector<int> LadderMoves(const GoBoard& bd)
+{
+    std::vector<SgPoint> blocks;
+    for (GoBlockIterator it(bd); it; ++it)
+        blocks.push_back(*it);
+    std::sort(blocks.begin(), blocks.end());
+    std::vector<int> result;
+    for (std::vector<SgPoint>::const_iterator it = blocks.begin();
+         it != blocks.end(); ++it)
+    {
+        const SgPoint block = *it;
+        if (bd.NumLiberties(block) == 2)
+        {
+            std::vector<SgPoint> libs;
+            for (GoBoard::LibertyIterator lib(bd, block); lib; ++lib)
+                libs.push_back(*lib);
+            std::sort(libs.begin(), libs.end());
+            for (std::vector<SgPoint>::const_iterator lib = libs.begin();
+                 lib != libs.end(); ++lib)
+                result.push_back(
+                         GoLadderUtil::IsLadderCaptureMove(bd, block, *lib));
+        }
+        else if (bd.NumLiberties(block) == 1)
+        {
+            SgVector<SgPoint> escapeMoves;
+            GoLadderUtil::FindLadderEscapeMoves(bd, block, escapeMoves);
+            for (SgVectorIterator<SgPoint> move(escapeMoves); move; ++move)
+                result.push_back(*move);
+            result.push_back(SG_NULLMOVE);
+        }
+    }
+    return result;
+}
+
+/** Compare the results with and without cache in random games. */
+void CheckRandomGames(int size, int nuGames)
+{
+    GoLadderCache& cache = GoLadderCache::Global();
+    cache.Clear();
+    GoBoard bd(size);
+    SgRandom random;
+    std::vector<SgPoint> moves;
+    for (int i = 0; i < nuGames; ++i)
+    {
+        bd.Init(size);
+        while (bd.MoveNumber() < size * size)
+        {
+            cache.SetEnabled(false);
+            const std::vector<int> expected = LadderMoves(bd);
+            cache.SetEnabled(true);
+            // Second call finds the results stored by the first call
+            BOOST_REQUIRE(LadderMoves(bd) == expected);
+            BOOST_REQUIRE(LadderMoves(bd) == expected);
+            moves.clear();
+            for (GoBoard::Iterator it(bd); it; ++it)
+                if (  bd.IsLegal(*it)
+                   && ! GoBoardUtil::IsCompletelySurrounded(bd, *it)
+                   )
+                    moves.push_back(*it);
+            if (moves.empty())
+                break;
+            bd.Play(moves[random.SmallInt(int(moves.size()))]);
+        }
+    }
+    BOOST_CHECK(cache.NuHits() > 0);
+    BOOST_CHECK(cache.NuHits() <= cache.NuLookups());
+    cache.SetEnabled(false);
+    cache.Clear();
+}
+
+/** Test that the footprint contains the blocks adjacent to the moves.
+    @verbatim
+    5 . . . . . .
+    4 . . . . . .
+    3 . . . . O .
+    2 . . . . O .
+    1 X . . . O .
+      A B C D E F
+    @endverbatim */
+BOOST_AUTO_TEST_CASE(GoLadderCacheTest_Footprint)
+{
+    GoSetup setup;
+    setup.AddBlack(Pt(1, 1));
+    setup.AddWhite(Pt(5, 1));
+    setup.AddWhite(Pt(5, 2));
+    setup.AddWhite(Pt(5, 3));
+    GoBoard bd(9, setup);
+    const SgPoint prey = Pt(1, 1);
+    const SgPoint firstMove = Pt(2, 1);
+    GoPointList moves;
+    // Neighbors of the liberties of the prey
+    BOOST_CHECK_EQUAL(GoLadderCache::Footprint(bd, prey, firstMove, moves),
+                      SgRect(1, 4, 1, 3));
+    moves.PushBack(Pt(3, 1));
+    // E1 is a neighbor of the liberty D1, but the white block is not
+    // adjacent to a move
+    BOOST_CHECK_EQUAL(GoLadderCache::Footprint(bd, prey, firstMove, moves),
+                      SgRect(1, 5, 1, 3));
+    moves.PushBack(Pt(4, 2));
+    // White block is adjacent to D2 and included with its neighbors
+    BOOST_CHECK_EQUAL(GoLadderCache::Footprint(bd, prey, firstMove, moves),
+                      SgRect(1, 6, 1, 4));
+}
+
+BOOST_AUTO_TEST_CASE(GoLadderCacheTest_RandomGames)
+{
+    CheckRandomGames(9, 5);
+    CheckRandomGames(13, 2);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,169 @@
+//----------------------------------------------------------------------------
+/** @file GoLightLadderTest.cpp
+    Unit tests for GoLightLadder. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoLightLadder.h"
+#include "GoSetupUtil.h"
+
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Immediate capture.
+    Same position as GoLadderTest_Captured_1. */
+BOOST_AUTO_TEST_CASE(GoLightLadderTest_Captured_1)
+{
+    std::string s("......\n"
+                  ".XOX..\n"
+                  "..X...\n"
+                  "......\n"
+                  "......\n"
+                  "......");
+    int boardSize;
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(s, boardSize);
+    setup.m_player = SG_BLACK;
+    const GoBoard bd(boardSize, setup);
+    GoLightLadder ladder;
+    ladder.Init(bd);
+    SgPoint move;
+    BOOST_CHECK(ladder.Ladder(Pt(3, 5), SG_BLACK, false, &move));
+    BOOST_CHECK_EQUAL(move, Pt(3, 6));
+    BOOST_CHECK(ladder.Ladder(Pt(3, 5), SG_WHITE));
+    BOOST_CHECK_EQUAL(ladder.LadderStatus(Pt(3, 5)), GO_LADDER_CAPTURED);
+}
+
+/** Same position as GoLadderTest_Unsettled_1. */
+BOOST_AUTO_TEST_CASE(GoLightLadderTest_Unsettled_1)
+{
+    std::string s("......\n"
+                  ".XO...\n"
+                  "..X...\n"
+                  "......\n"
+                  "......\n"
+                  "......");
+    int boardSize;
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(s, boardSize);
+    setup.m_player = SG_BLACK;
+    const GoBoard bd(boardSize, setup);
+    GoLightLadder ladder;
+    ladder.Init(bd);
+    SgPoint toCapture = SG_NULLMOVE;
+    SgPoint toEscape = SG_NULLMOVE;
+    BOOST_CHECK_EQUAL(ladder.LadderStatus(Pt(3, 5), false, &toCapture,
+                                          &toEscape),
+                      GO_LADDER_UNSETTLED);
+    BOOST_CHECK_EQUAL(toCapture, Pt(4, 5));
+    BOOST_CHECK(toEscape == Pt(4, 5) || toEscape == Pt(3, 6));
+    BOOST_CHECK(ladder.IsLadderCaptureMove(Pt(3, 5), Pt(4, 5)));
+    BOOST_CHECK(! ladder.IsLadderCaptureMove(Pt(3, 5), Pt(3, 6)));
+    // The queries do not change the position
+    BOOST_CHECK_EQUAL(ladder.LadderStatus(Pt(3, 5)), GO_LADDER_UNSETTLED);
+}
+
+/** Ladder breaker.
+    Same position as GoLadderTest_Escaped_1. */
+BOOST_AUTO_TEST_CASE(GoLightLadderTest_Escaped_1)
+{
+    std::string s(".OX...\n"
+                  ".XOX..\n"
+                  "..OX..\n"
+                  "......\n"
+                  ".O....\n"
+                  "......");
+    int boardSize;
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(s, boardSize);
+    setup.m_player = SG_BLACK;
+    const GoBoard bd(boardSize, setup);
+    GoLightLadder ladder;
+    ladder.Init(bd);
+    BOOST_CHECK(! ladder.Ladder(Pt(3, 5), SG_BLACK));
+    BOOST_CHECK(! ladder.Ladder(Pt(3, 5), SG_WHITE));
+    BOOST_CHECK_EQUAL(ladder.LadderStatus(Pt(3, 5)), GO_LADDER_ESCAPED);
+}
+
+/** Prey to play with two liberties.
+    Same position as GoLadderTest_TwoLib_1. */
+BOOST_AUTO_TEST_CASE(GoLightLadderTest_TwoLib_1)
+{
+    std::string s("X.OX..\n"
+                  ".OOX..\n"
+                  "OOXX..\n"
+                  "XXX...\n"
+                  "......\n"
+                  "......");
+    int boardSize;
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(s, boardSize);
+    setup.m_player = SG_BLACK;
+    const GoBoard bd(boardSize, setup);
+    GoLightLadder ladder;
+    ladder.Init(bd);
+    BOOST_CHECK(ladder.Ladder(Pt(3, 6), SG_BLACK));
+    BOOST_CHECK(ladder.Ladder(Pt(3, 6), SG_WHITE));
+    BOOST_CHECK(! ladder.Ladder(Pt(3, 6), SG_WHITE, true));
+    BOOST_CHECK_EQUAL(ladder.LadderStatus(Pt(3, 6)), GO_LADDER_CAPTURED);
+}
+
+/** Same position as GoLadderTest_SnapBack_1. */
+BOOST_AUTO_TEST_CASE(GoLightLadderTest_SnapBack_1)
+{
+    std::string s(".........\n"
+                  ".........\n"
+                  "..XXX....\n"
+                  "..O......\n"
+                  "..OX.....\n"
+                  "..XO.....\n"
+                  "..XOX....\n"
+                  "...X.....\n"
+                  ".........");
+    int boardSize;
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(s, boardSize);
+    setup.m_player = SG_BLACK;
+    const GoBoard bd(boardSize, setup);
+    GoLightLadder ladder;
+    ladder.Init(bd);
+    SgPoint move;
+    BOOST_CHECK(ladder.Ladder(Pt(4, 4), SG_BLACK, false, &move));
+    BOOST_CHECK_EQUAL(move, Pt(5, 4));
+    BOOST_CHECK(ladder.Ladder(Pt(4, 4), SG_WHITE, false, &move));
+    BOOST_CHECK_EQUAL(move, Pt(5, 4));
+    BOOST_CHECK_EQUAL(ladder.LadderStatus(Pt(4, 4)), GO_LADDER_CAPTURED);
+}
+
+/** The prey escapes by capturing C1 at C2, because the hunter cannot
+    retake the ko at C1. */
+BOOST_AUTO_TEST_CASE(GoLightLadderTest_Ko)
+{
+    std::string s(".......\n"
+                  ".......\n"
+                  ".......\n"
+                  "OOO....\n"
+                  "O.XO...\n"
+                  "OX.XX..\n"
+                  "OOXO...");
+    int boardSize;
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(s, boardSize);
+    setup.m_player = SG_BLACK;
+    const GoBoard bd(boardSize, setup);
+    GoLightLadder ladder;
+    ladder.Init(bd);
+    SgPoint toCapture = SG_NULLMOVE;
+    SgPoint toEscape = SG_NULLMOVE;
+    BOOST_CHECK_EQUAL(ladder.LadderStatus(Pt(4, 1), false, &toCapture,
+                                          &toEscape),
+                      GO_LADDER_UNSETTLED);
+    BOOST_CHECK_EQUAL(toCapture, Pt(5, 1));
+    BOOST_CHECK_EQUAL(toEscape, Pt(3, 2));
+    BOOST_CHECK(ladder.IsLadderEscapeMove(Pt(4, 1), Pt(3, 2)));
+    BOOST_CHECK(! ladder.IsLadderEscapeMove(Pt(4, 1), Pt(5, 1)));
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -5,10 +5,14 @@
 
 #include "SgSystem.h"
 
+#include <vector>
 #include <boost/test/auto_unit_test.hpp>
+#include "GoBlock.h"
 #include "GoBoard.h"
 #include "GoRegionBoard.h"
+#include "GoSafetySolver.h"
 #include "SgNode.h"
+#include "SgRandom.h"
 
 using SgPointUtil::Pt;
 
@@ -16,6 +20,118 @@ using SgPointUtil::Pt;
 
 namespace {
 
+/** Flags computed by GoRegion::ComputeBasicFlags(). */
+const GoRegionFlag BASIC_FLAGS[] = {
+    GO_REGION_SMALL,
+    GO_REGION_CORRIDOR,
+    GO_REGION_SINGLE_BLOCK_BOUNDARY,
+    GO_REGION_STATIC_1VC,
+    GO_REGION_STATIC_2V
+};
+
+const std::size_t NU_BASIC_FLAGS =
+    sizeof(BASIC_FLAGS) / sizeof(BASIC_FLAGS[0]);
+
+/** Check that two lists of blocks contain the same blocks in the same
+    order. */
+void CheckSameBlocks(const SgVectorOf<GoBlock>& blocks,
+                     const SgVectorOf<GoBlock>& expected)
+{
+    BOOST_REQUIRE_EQUAL(blocks.Length(), expected.Length());
+    SgVectorIteratorOf<GoBlock> it2(expected);
+    for (SgVectorIteratorOf<GoBlock> it(blocks); it; ++it, ++it2)
+        BOOST_REQUIRE_EQUAL((*it)->Anchor(), (*it2)->Anchor());
+}
+
+/** Compare an incrementally updated region board with one that was
+    computed from scratch.
+    Also compares the order of the lists, because the results of the
+    safety solvers depend on it. */
+void CheckSameRegions(const GoRegionBoard& regions,
+                      const GoRegionBoard& expected)
+{
+    BOOST_REQUIRE(regions.UpToDate());
+    const GoBoard& bd = regions.Board();
+    for (SgBWIterator it; it; ++it)
+    {
+        const SgBlackWhite c = *it;
+        CheckSameBlocks(regions.AllBlocks(c), expected.AllBlocks(c));
+        BOOST_REQUIRE_EQUAL(regions.AllRegions(c).Length(),
+                            expected.AllRegions(c).Length());
+        SgVectorIteratorOf<GoRegion> it2(expected.AllRegions(c));
+        for (SgVectorIteratorOf<GoRegion> it3(regions.AllRegions(c)); it3;
+             ++it3, ++it2)
+            BOOST_REQUIRE((*it3)->Points() == (*it2)->Points());
+        for (GoBoard::Iterator it2(bd); it2; ++it2)
+        {
+            const SgPoint p = *it2;
+            if (bd.IsColor(p, c))
+            {
+                const GoBlock* b = regions.BlockAt(p);
+                BOOST_REQUIRE(b->Stones() == expected.BlockAt(p)->Stones());
+                BOOST_REQUIRE_EQUAL(b->Anchor(), bd.Anchor(p));
+                continue;
+            }
+            const GoRegion* r = regions.RegionAt(p, c);
+            const GoRegion* e = expected.RegionAt(p, c);
+            BOOST_REQUIRE(r->Points() == e->Points());
+            CheckSameBlocks(r->Blocks(), e->Blocks());
+            BOOST_REQUIRE(r->IsValid());
+            for (std::size_t i = 0; i < NU_BASIC_FLAGS; ++i)
+                BOOST_REQUIRE_EQUAL(r->GetFlag(BASIC_FLAGS[i]),
+                                    e->GetFlag(BASIC_FLAGS[i]));
+        }
+    }
+}
+
+/** Keep a region board updated with Play and Undo in random games and
+    compare it and the safety solver results with a region board computed
+    from scratch. */
+BOOST_AUTO_TEST_CASE(GoRegionBoardTest_Incremental)
+{
+    SgRandom random;
+    GoBoard bd(7);
+    GoRegionBoard regions(bd);
+    std::vector<SgPoint> moves;
+    for (int i = 0; i < 3000; ++i)
+    {
+        if (i % 300 == 0)
+            bd.Init(7);
+        const int action = random.SmallInt(10);
+        if (action < 3 && bd.MoveNumber() > 0)
+        {
+            bd.Undo();
+            regions.OnUndoneMove();
+        }
+        else
+        {
+            moves.clear();
+            for (GoBoard::Iterator it(bd); it; ++it)
+                if (bd.IsLegal(*it))
+                    moves.push_back(*it);
+            SgPoint p = SG_PASS;
+            if (action > 3 && ! moves.empty())
+                p = moves[random.SmallInt(int(moves.size()))];
+            const GoPlayerMove move(bd.ToPlay(), p);
+            regions.ExecuteMovePrologue();
+            bd.Play(move);
+            regions.OnExecutedMove(move);
+        }
+        GoRegionBoard expected(bd);
+        CheckSameRegions(regions, expected);
+        if (i % 10 == 0)
+        {
+            SgBWSet safe;
+            GoSafetySolver solver(bd, &regions);
+            solver.FindSafePoints(&safe);
+            SgBWSet expectedSafe;
+            GoSafetySolver expectedSolver(bd, &expected);
+            expectedSolver.FindSafePoints(&expectedSafe);
+            BOOST_REQUIRE(safe == expectedSafe);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(GoRegionBoardTest_Setup)
 {
     GoSetup setup;
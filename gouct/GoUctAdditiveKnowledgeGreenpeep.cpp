@@ -22,8 +22,10 @@ struct PatternEntry // common data structure used in both 9x9 and 19x19
     unsigned short code;
 };
 
+#ifndef DISABLE_BUILTIN_PATTERNS
 #include "GoUctGreenpeepPatterns9.h"
 #include "GoUctGreenpeepPatterns19.h"
+#endif
 
 using std::string;
 //----------------------------------------------------------------------------
@@ -127,19 +129,15 @@ unsigned int ExtendedContext(const GoBoard &bd,
     return extendedcontext;
 }
 
-void ComputeContexts(const GoBoard &bd,
-                     vector<SgUctMoveInfo>::const_iterator begin,
-                     vector<SgUctMoveInfo>::const_iterator end,
-                     unsigned int contexts[])
+/** Set the ko and atari bits of the contexts.
+    Only used for board sizes smaller than 15. */
+void AddKoAndAtariBits(const GoBoard& bd,
+                       const vector<SgUctMoveInfo>& moves,
+                       unsigned int contexts[])
 {
-    bool use9x9flag = bd.Size() < 15;
     std::bitset<SG_MAXPOINT + 1> atariBits;
-    SgBlackWhite toplay = bd.ToPlay();
-    SgBlackWhite opponent = bd.Opponent();
-    bool koExists = bd.KoPoint() != SG_NULLPOINT;
-    SgMove lastMove = bd.GetLastMove();
-    if (  use9x9flag 
-       && ! SgIsSpecialMove(lastMove) // skip if Pass or Nullmove
+    const SgMove lastMove = bd.GetLastMove();
+    if (  ! SgIsSpecialMove(lastMove) // skip if Pass or Nullmove
        && ! bd.IsEmpty(lastMove)   // skip if last move was suicide
        )
     {
@@ -148,72 +146,267 @@ void ComputeContexts(const GoBoard &bd,
         for (GoPointList::Iterator it(defenses); it; ++it) 
             atariBits[*it] = 1;
     }
-
-    for (int i = 0; begin != end; ++begin, ++i) 
+    const unsigned int koBit =
+        (bd.KoPoint() != SG_NULLPOINT ? KO_BIT : 0U);
+    for (std::size_t i = 0; i < moves.size(); ++i)
     {
-        SgMove p = begin->m_move;
-        if (p != SG_PASS)
-        {
-            unsigned int blackcontext = SimpleContext(bd, p, SG_BLACK);
-            unsigned int whitecontext = SimpleContext(bd, p, SG_WHITE);
-            unsigned int occupancy = blackcontext ^ whitecontext;
-            unsigned int extendedcontext = 
-                ExtendedContext(bd, p, occupancy, toplay, opponent);
-            unsigned int context = 0;
+        const SgMove p = moves[i].m_move;
+        if (p == SG_PASS)
+            continue;
+        contexts[i] |= koBit;
+        if (atariBits[p])
+            contexts[i] |= ATARI_BIT;
+    }
+}
 
-            if (toplay == SG_BLACK)
-                context = extendedcontext | (blackcontext << 8) | 
-                    (whitecontext << 16);
-            else
-                context = extendedcontext | (whitecontext << 8) | 
-                    (blackcontext << 16);
+/** Padding of the plane used by BoardContexts().
+    Points up to two steps away from any on-board point are inside the
+    padded plane. */
+const int PLANE_PADDING = 2 * SG_NS;
 
-            if (use9x9flag) 
-            {
-                if (koExists)
-                    context |= KO_BIT;
-        
-                if (! SgIsSpecialMove(p) && atariBits[p])
-                    context |= ATARI_BIT;
-            }
+/** Size of the plane used by BoardContexts().
+    Includes 4 extra elements, because BoardContexts() processes blocks of 4
+    points. */
+const int PLANE_SIZE = SG_MAXPOINT + 2 * PLANE_PADDING + 4;
 
-            contexts[i] = context;
-        }
-        else // Pass
-            contexts[i] = PASS_CONTEXT;
+/** @name Fields of the point codes used by BoardContexts() */
+// @{
+
+/** Bit set for stones of the color to play and for border points. */
+const unsigned int CODE_OWN = 1U;
+
+/** Bit set for opponent stones and for border points. */
+const unsigned int CODE_OPP = 1U << 1;
+
+/** Shift of the extended context bits of a neighbor point.
+    Liberty class of stones (1 for 2 liberties, 2 for more), 3 for border
+    points, 0 for empty points. */
+const int CODE_NEAR_SHIFT = 2;
+
+/** Shift of the extended context bits of a point two steps away.
+    Used if the neighbor in between is empty. 1 for stones of the color to
+    play, 2 for opponent stones, 3 for border points, 0 for empty
+    points. */
+const int CODE_FAR_SHIFT = 4;
+
+/** Shift of the bit set for empty points. */
+const int CODE_EMPTY_SHIFT = 6;
+
+// @} // @name
+
+/** Point codes without liberty class indexed by [toPlay][color]. */
+const unsigned int POINT_CODE[2][SG_BORDER + 1] =
+{
+    {
+        // Black to play
+        CODE_OWN | (1U << CODE_FAR_SHIFT),
+        CODE_OPP | (2U << CODE_FAR_SHIFT),
+        1U << CODE_EMPTY_SHIFT,
+        CODE_OWN | CODE_OPP | (3U << CODE_NEAR_SHIFT)
+        | (3U << CODE_FAR_SHIFT)
+    },
+    {
+        // White to play
+        CODE_OPP | (2U << CODE_FAR_SHIFT),
+        CODE_OWN | (1U << CODE_FAR_SHIFT),
+        1U << CODE_EMPTY_SHIFT,
+        CODE_OWN | CODE_OPP | (3U << CODE_NEAR_SHIFT)
+        | (3U << CODE_FAR_SHIFT)
     }
+};
+
+/** Extended context bits in one direction. */
+inline unsigned int DirectionCode(unsigned int nearCode,
+                                  unsigned int farCode)
+{
+    const unsigned int emptyMask = 0U - ((nearCode >> CODE_EMPTY_SHIFT) & 1U);
+    return ((nearCode >> CODE_NEAR_SHIFT) & 3U)
+         | ((farCode >> CODE_FAR_SHIFT) & 3U & emptyMask);
+}
+
+/** Branch-free part of
+    GoUctAdditiveKnowledgeGreenpeep::ComputeContextsBatch().
+    Computes the contexts of a range of points from a plane of point codes.
+    A separate function with non-aliasing pointer arguments, processing
+    blocks of 4 points with only integer arithmetic and constant neighbor
+    offsets, such that compilers vectorize the inner loop. The contexts of
+    border points in the range are not meaningful.
+    @param code Point codes (see CODE_OWN) indexed by point
+    @param[out] contexts Contexts indexed by point
+    @param first First point
+    @param nuBlocks Number of blocks of 4 points starting at first */
+void BoardContexts(const unsigned int* SG_RESTRICT code,
+                   unsigned int* SG_RESTRICT contexts, int first,
+                   int nuBlocks)
+{
+    const int N = -SG_NS;
+    const int S = SG_NS;
+    const int W = -SG_WE;
+    const int E = SG_WE;
+    for (int p = first; p < first + 4 * nuBlocks; p += 4)
+        for (int i = 0; i < 4; ++i)
+        {
+            const int q = p + i;
+            const unsigned int nw = code[q + N + W];
+            const unsigned int w = code[q + W];
+            const unsigned int sw = code[q + S + W];
+            const unsigned int n = code[q + N];
+            const unsigned int s = code[q + S];
+            const unsigned int ne = code[q + N + E];
+            const unsigned int e = code[q + E];
+            const unsigned int se = code[q + S + E];
+            // Own bits at 8..15, opponent bits at 16..23
+            const unsigned int own =
+                  ((nw & CODE_OWN) << 8)
+                | ((w & CODE_OWN) << 9)
+                | ((sw & CODE_OWN) << 10)
+                | ((n & CODE_OWN) << 11)
+                | ((s & CODE_OWN) << 12)
+                | ((ne & CODE_OWN) << 13)
+                | ((e & CODE_OWN) << 14)
+                | ((se & CODE_OWN) << 15);
+            const unsigned int opp =
+                  ((nw & CODE_OPP) << 15)
+                | ((w & CODE_OPP) << 16)
+                | ((sw & CODE_OPP) << 17)
+                | ((n & CODE_OPP) << 18)
+                | ((s & CODE_OPP) << 19)
+                | ((ne & CODE_OPP) << 20)
+                | ((e & CODE_OPP) << 21)
+                | ((se & CODE_OPP) << 22);
+            const unsigned int extended =
+                  DirectionCode(w, code[q + 2 * W])
+                | (DirectionCode(n, code[q + 2 * N]) << 2)
+                | (DirectionCode(s, code[q + 2 * S]) << 4)
+                | (DirectionCode(e, code[q + 2 * E]) << 6);
+            contexts[q] = extended | own | opp;
+        }
 }
 
-void ReadPatternArray(unsigned short predictor[], int size,
-                      PatternEntry patternEntry[], unsigned int nuPatterns)
+/** Get the patterns compiled into the program. */
+void GetBuiltinPatternArray(int boardSize, const PatternEntry*& patternEntry,
+                            unsigned int& nuPatterns)
 {
-    for (int i = 0; i < size; ++i)
-        predictor[i] = NEUTRALPREDICTION;
+#ifdef DISABLE_BUILTIN_PATTERNS
+    SG_UNUSED(boardSize);
+    patternEntry = 0;
+    nuPatterns = 0;
+#else
+    if (boardSize < 15)
+    {
+        patternEntry = greenpeepPatterns9;
+        nuPatterns = nuGreenpeepPatterns9;
+    }
+    else
+    {
+        patternEntry = greenpeepPatterns19;
+        nuPatterns = nuGreenpeepPatterns19;
+    }
+#endif
+}
 
-    for (unsigned int i=0; i< nuPatterns; ++i)
+/** Initialize a predictor from the global pattern database, if it has
+    patterns for this board size, otherwise from the compiled patterns.
+    The table of the database is used in place, the compiled patterns are
+    copied to the arrays 'contexts' and 'values'. */
+void ReadPatterns(int boardSize, unsigned int maxContext,
+                  GoUctGreenpeepPredictor& predictor,
+                  vector<boost::uint32_t>& contexts,
+                  vector<boost::uint16_t>& values)
+{
+    const GoUctPatternDatabase::GreenpeepTable* databaseTable =
+        GoUctPatternDatabase::Global().Greenpeep(boardSize);
+    if (databaseTable != 0)
     {
-        unsigned int context = patternEntry[i].index;
-        SG_ASSERT(context < static_cast<unsigned int>(size));
-        predictor[context] = patternEntry[i].code;
+        predictor.Init(*databaseTable, maxContext);
+        return;
     }
+    const PatternEntry* patternEntry;
+    unsigned int nuPatterns;
+    GetBuiltinPatternArray(boardSize, patternEntry, nuPatterns);
+    contexts.resize(nuPatterns);
+    values.resize(nuPatterns);
+    for (unsigned int i = 0; i < nuPatterns; ++i)
+    {
+        // The predictor needs the contexts in increasing order
+        SG_ASSERT(i == 0 || patternEntry[i].index > patternEntry[i - 1].index);
+        contexts[i] = patternEntry[i].index;
+        values[i] = patternEntry[i].code;
+    }
+    GoUctPatternDatabase::GreenpeepTable table;
+    table.m_nuEntries = nuPatterns;
+    table.m_contexts = (nuPatterns == 0 ? 0 : &contexts[0]);
+    table.m_values = (nuPatterns == 0 ? 0 : &values[0]);
+    predictor.Init(table, maxContext);
 }
 
-void ReadPatterns(unsigned short predictor9[],
-                  unsigned short predictor19[])
+/** Value of a context. */
+inline unsigned short Predict(const GoUctGreenpeepPredictor& predictor,
+                              unsigned int context)
 {
-    ReadPatternArray(predictor9, NUMPATTERNS9X9,
-                     greenpeepPatterns9, nuGreenpeepPatterns9);
-    ReadPatternArray(predictor19, NUMPATTERNS19X19,
-                     greenpeepPatterns19, nuGreenpeepPatterns19);
+    unsigned short value;
+    return predictor.Find(context, value) ? value : NEUTRALPREDICTION;
 }
 
 } // namespace
 
 //----------------------------------------------------------------------------
 
+GoUctGreenpeepPredictor::GoUctGreenpeepPredictor()
+    : m_shift(0)
+{
+    m_table.m_nuEntries = 0;
+    m_table.m_contexts = 0;
+    m_table.m_values = 0;
+}
+
+void GoUctGreenpeepPredictor::Init(
+                            const GoUctPatternDatabase::GreenpeepTable& table,
+                            unsigned int maxContext)
+{
+    m_table = table;
+    m_shift = 0;
+    m_bucketStart.clear();
+    const std::size_t nuEntries = table.m_nuEntries;
+    if (nuEntries == 0)
+        return;
+    SG_ASSERT(table.m_contexts[nuEntries - 1] < maxContext);
+    // Use at least as many buckets as entries
+    while ((maxContext >> (m_shift + 1)) >= nuEntries)
+        ++m_shift;
+    const unsigned int nuBuckets = ((maxContext - 1) >> m_shift) + 1;
+    m_bucketStart.resize(nuBuckets + 1);
+    std::size_t i = 0;
+    for (unsigned int bucket = 0; bucket <= nuBuckets; ++bucket)
+    {
+        while (i < nuEntries && (table.m_contexts[i] >> m_shift) < bucket)
+            ++i;
+        m_bucketStart[bucket] = static_cast<boost::uint32_t>(i);
+    }
+}
+
+//----------------------------------------------------------------------------
+
 GoUctAdditiveKnowledgeParamGreenpeep::GoUctAdditiveKnowledgeParamGreenpeep()
 {
-    ReadPatterns(m_predictor9x9, m_predictor19x19);
+    ReadPatterns(9, NUMPATTERNS9X9, m_predictor9x9, m_builtinContexts9x9,
+                 m_builtinValues9x9);
+    ReadPatterns(19, NUMPATTERNS19X19, m_predictor19x19,
+                 m_builtinContexts19x19, m_builtinValues19x19);
+}
+
+void GoUctAdditiveKnowledgeParamGreenpeep::GetBuiltinPatterns(int boardSize,
+                 std::vector<GoUctPatternDatabase::GreenpeepEntry>& entries)
+{
+    const PatternEntry* patternEntry;
+    unsigned int nuPatterns;
+    GetBuiltinPatternArray(boardSize, patternEntry, nuPatterns);
+    entries.resize(nuPatterns);
+    for (unsigned int i = 0; i < nuPatterns; ++i)
+    {
+        entries[i].m_context = patternEntry[i].index;
+        entries[i].m_value = patternEntry[i].code;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -228,26 +421,111 @@ GoUctAdditiveKnowledgeGreenpeep::GoUctAdditiveKnowledgeGreenpeep(
     SetMoveRange(0, 10000); 
 }
 
+void GoUctAdditiveKnowledgeGreenpeep::ComputeContexts(const GoBoard& bd,
+                                     const vector<SgUctMoveInfo>& moves,
+                                     unsigned int contexts[])
+{
+    // The break-even point measured with uct_benchmark_knowledge is at
+    // about a third (19x19) to a half (9x9) of the board
+    const int size = bd.Size();
+    if (3 * moves.size() >= static_cast<std::size_t>(size * size))
+        ComputeContextsBatch(bd, moves, contexts);
+    else
+        ComputeContextsPointwise(bd, moves, contexts);
+}
+
+void GoUctAdditiveKnowledgeGreenpeep::ComputeContextsBatch(
+                                     const GoBoard& bd,
+                                     const vector<SgUctMoveInfo>& moves,
+                                     unsigned int contexts[])
+{
+    // Indexed by point + PLANE_PADDING
+    unsigned int code[PLANE_SIZE];
+    unsigned int boardContexts[PLANE_SIZE];
+    const int size = bd.Size();
+    const SgPoint last = SgPointUtil::Pt(size, size);
+    const unsigned int* pointCode = POINT_CODE[bd.ToPlay()];
+    // BoardContexts() reads up to 2 * SG_NS + 3 points beyond the last point
+    const unsigned int borderCode = pointCode[SG_BORDER];
+    for (int i = 0; i < last + 2 * PLANE_PADDING + 4; ++i)
+        code[i] = borderCode;
+    for (GoBoard::Iterator it(bd); it; ++it)
+    {
+        const SgBoardColor c = bd.GetColor(*it);
+        unsigned int pCode = pointCode[c];
+        if (c != SG_EMPTY)
+        {
+            const int nuLib = bd.NumLiberties(*it);
+            pCode |= (nuLib >= 3 ? 2U : (nuLib == 2 ? 1U : 0U))
+                     << CODE_NEAR_SHIFT;
+        }
+        code[*it + PLANE_PADDING] = pCode;
+    }
+    // Row by row, because the rows are shorter than SG_NS on small boards
+    const int nuBlocks = (size + 3) / 4;
+    for (int row = 1; row <= size; ++row)
+        BoardContexts(code + PLANE_PADDING, boardContexts + PLANE_PADDING,
+                      SgPointUtil::Pt(1, row), nuBlocks);
+    const unsigned int* pointContexts = boardContexts + PLANE_PADDING;
+    for (std::size_t i = 0; i < moves.size(); ++i)
+    {
+        const SgMove p = moves[i].m_move;
+        contexts[i] = (p == SG_PASS ? PASS_CONTEXT : pointContexts[p]);
+    }
+    if (size < 15)
+        AddKoAndAtariBits(bd, moves, contexts);
+}
+
+void GoUctAdditiveKnowledgeGreenpeep::ComputeContextsPointwise(
+                                     const GoBoard& bd,
+                                     const vector<SgUctMoveInfo>& moves,
+                                     unsigned int contexts[])
+{
+    const SgBlackWhite toplay = bd.ToPlay();
+    const SgBlackWhite opponent = bd.Opponent();
+    for (std::size_t i = 0; i < moves.size(); ++i)
+    {
+        const SgMove p = moves[i].m_move;
+        if (p != SG_PASS)
+        {
+            unsigned int blackcontext = SimpleContext(bd, p, SG_BLACK);
+            unsigned int whitecontext = SimpleContext(bd, p, SG_WHITE);
+            unsigned int occupancy = blackcontext ^ whitecontext;
+            unsigned int extendedcontext = 
+                ExtendedContext(bd, p, occupancy, toplay, opponent);
+            if (toplay == SG_BLACK)
+                contexts[i] = extendedcontext | (blackcontext << 8) | 
+                    (whitecontext << 16);
+            else
+                contexts[i] = extendedcontext | (whitecontext << 8) | 
+                    (blackcontext << 16);
+        }
+        else // Pass
+            contexts[i] = PASS_CONTEXT;
+    }
+    if (bd.Size() < 15)
+        AddKoAndAtariBits(bd, moves, contexts);
+}
 
 void 
 GoUctAdditiveKnowledgeGreenpeep::ProcessPosition(
 									std::vector<SgUctMoveInfo>& moves)
 {
     bool use9x9flag;
-    const unsigned short *pred;
+    const GoUctGreenpeepPredictor* predictor;
 
     if (Board().Size() < 15)
     {
         use9x9flag = true;
-        pred = m_param.m_predictor9x9;
+        predictor = &m_param.m_predictor9x9;
     }
     else
     {
         use9x9flag = false;
-        pred = m_param.m_predictor19x19;
+        predictor = &m_param.m_predictor19x19;
     }
 
-    ComputeContexts(Board(), moves.begin(), moves.end(), m_contexts);
+    ComputeContexts(Board(), moves, m_contexts);
     for (std::size_t i = 0; i < moves.size(); ++i)
     {
         float& value = moves[i].m_predictorValue;
@@ -262,19 +540,19 @@ GoUctAdditiveKnowledgeGreenpeep::ProcessPosition(
                     // Hmm, we could do this max in the feature weights at the
                     // end of training instead.
                     int altContext = m_contexts[i] & ~ATARI_BIT;
-                    value = std::max(pred[m_contexts[i]],
-                                        pred[altContext]);
+                    value = std::max(Predict(*predictor, m_contexts[i]),
+                                     Predict(*predictor, altContext));
                 }
                 else 
                 {
                     /* default, for 19x19 */
-                    value = std::max(pred[m_contexts[i]],
-                                        DEFENSIVEPREDICTION);
+                    value = std::max(Predict(*predictor, m_contexts[i]),
+                                     DEFENSIVEPREDICTION);
                 }
             }
             else
             {
-                value = pred[m_contexts[i]];
+                value = Predict(*predictor, m_contexts[i]);
             }
         }
 	    value /= NEUTRALPREDICTION_FLOAT;
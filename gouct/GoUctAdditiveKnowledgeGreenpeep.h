@@ -5,7 +5,9 @@
 #ifndef GOUCT_ADDITIVEKNOWLEDGEGREENPEEP_H
 #define GOUCT_ADDITIVEKNOWLEDGEGREENPEEP_H
 
+#include <vector>
 #include "GoUctAdditiveKnowledge.h"
+#include "GoUctPatternDatabase.h"
 #include "GoUctPlayoutPolicy.h"
 #include <boost/static_assert.hpp>
 
@@ -19,15 +21,107 @@ const int NUMPATTERNS19X19 = 1<<24;
 
 //----------------------------------------------------------------------------
 
+/** Values of the contexts of a sparse Greenpeep table.
+    The table is not copied; the tables of the database are used in place
+    in the mapped file. An index of the first entry of each bucket of
+    consecutive contexts limits the search to about one entry. The
+    index has about as many elements as the table has entries. */
+class GoUctGreenpeepPredictor
+{
+public:
+    GoUctGreenpeepPredictor();
+
+    /** Build the index of a table.
+        @param table The table, the arrays must stay valid while the
+        predictor is used.
+        @param maxContext All contexts of the table and all contexts passed
+        to Find() are smaller. */
+    void Init(const GoUctPatternDatabase::GreenpeepTable& table,
+              unsigned int maxContext);
+
+    /** Find the value of a context.
+        @return @c false, if the table has no entry for the context. */
+    bool Find(unsigned int context, unsigned short& value) const;
+
+private:
+    GoUctPatternDatabase::GreenpeepTable m_table;
+
+    /** Number of low bits of a context not used for the bucket. */
+    int m_shift;
+
+    /** Index of the first entry of each bucket, followed by the number of
+        entries. Empty, if the table has no entries. */
+    std::vector<boost::uint32_t> m_bucketStart;
+};
+
+inline bool GoUctGreenpeepPredictor::Find(unsigned int context,
+                                          unsigned short& value) const
+{
+    if (m_bucketStart.empty())
+        return false;
+    const unsigned int bucket = context >> m_shift;
+    SG_ASSERT(bucket + 1 < m_bucketStart.size());
+    const boost::uint32_t* begin = m_table.m_contexts + m_bucketStart[bucket];
+    const boost::uint32_t* end =
+        m_table.m_contexts + m_bucketStart[bucket + 1];
+    const boost::uint32_t* it = begin;
+    while (it != end && *it < context)
+        ++it;
+    if (it == end || *it != context)
+        return false;
+    value = m_table.m_values[it - m_table.m_contexts];
+    return true;
+}
+
+//----------------------------------------------------------------------------
+
+/** Pattern values of the Greenpeep knowledge.
+    The values are taken from GoUctPatternDatabase::Global(), if it contains
+    them, otherwise from the tables compiled into the program. */
 class GoUctAdditiveKnowledgeParamGreenpeep: public GoUctAdditiveKnowledgeParam
 {
 private:
 public:
     GoUctAdditiveKnowledgeParamGreenpeep();
 
-    unsigned short m_predictor9x9[NUMPATTERNS9X9];
-    
-    unsigned short m_predictor19x19[NUMPATTERNS19X19];
+    /** Values of the contexts for board sizes smaller than 15.
+        Contexts not in the table have the neutral value. */
+    GoUctGreenpeepPredictor m_predictor9x9;
+
+    /** Values of the contexts for board sizes 15 and larger.
+        See m_predictor9x9 */
+    GoUctGreenpeepPredictor m_predictor19x19;
+
+    /** Get the patterns compiled into the program.
+        Used for writing them to a GoUctPatternDatabase.
+        @param boardSize
+        @param[out] entries */
+    static void GetBuiltinPatterns(int boardSize,
+                 std::vector<GoUctPatternDatabase::GreenpeepEntry>& entries);
+
+private:
+    /** Contexts of the compiled table for m_predictor9x9.
+        The compiled tables store contexts and values interleaved, they are
+        copied to these arrays, if the database does not contain the
+        table. */
+    std::vector<boost::uint32_t> m_builtinContexts9x9;
+
+    /** Values of the compiled table for m_predictor9x9. */
+    std::vector<boost::uint16_t> m_builtinValues9x9;
+
+    /** Contexts of the compiled table for m_predictor19x19. */
+    std::vector<boost::uint32_t> m_builtinContexts19x19;
+
+    /** Values of the compiled table for m_predictor19x19. */
+    std::vector<boost::uint16_t> m_builtinValues19x19;
+
+    /** Not implemented, the predictors can point to the member arrays. */
+    GoUctAdditiveKnowledgeParamGreenpeep(
+                             const GoUctAdditiveKnowledgeParamGreenpeep&);
+
+    /** Not implemented */
+    GoUctAdditiveKnowledgeParamGreenpeep& operator=(
+                             const GoUctAdditiveKnowledgeParamGreenpeep&);
 };
 
 /** Use Greenpeep-style pattern values to make predictions. */
@@ -37,6 +131,35 @@ public:
     GoUctAdditiveKnowledgeGreenpeep(const GoBoard& bd,
 				 const GoUctAdditiveKnowledgeParamGreenpeep& param);
 
+    /** Compute the pattern contexts of moves.
+        Uses ComputeContextsBatch() if the moves cover a large part of the
+        board, otherwise ComputeContextsPointwise(). Used by
+        ProcessPosition().
+        @param bd
+        @param moves
+        @param[out] contexts Context of each move, must have room for
+        moves.size() elements */
+    static void ComputeContexts(const GoBoard& bd,
+                                const std::vector<SgUctMoveInfo>& moves,
+                                unsigned int contexts[]);
+
+    /** Compute the pattern contexts of moves from the contexts of all
+        points.
+        Computes the contexts of all points of the board at once with a
+        branch-free loop over a plane of point codes, which the compiler
+        vectorizes, and then picks the contexts of the moves. The cost
+        depends on the board size, not on the number of moves.
+        @see ComputeContexts() */
+    static void ComputeContextsBatch(const GoBoard& bd,
+                                     const std::vector<SgUctMoveInfo>& moves,
+                                     unsigned int contexts[]);
+
+    /** Compute the pattern contexts of moves point by point.
+        @see ComputeContexts() */
+    static void ComputeContextsPointwise(const GoBoard& bd,
+                                  const std::vector<SgUctMoveInfo>& moves,
+                                  unsigned int contexts[]);
+
     /** The minimum value allowed by this predictor */
     SgUctValue Minimum() const;
 
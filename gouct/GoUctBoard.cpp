@@ -23,6 +23,45 @@ namespace {
     time. */
 const bool CONSISTENCY = false;
 
+/** Branch-free part of GoUctBoard::Ownership().
+    A separate function with non-aliasing pointer arguments, processing
+    blocks of 4 points with only integer arithmetic, such that compilers
+    vectorize the inner loop already at the default optimization level.
+    @param color Color array
+    @param nuBlack Number of black neighbors
+    @param nuWhite Number of white neighbors
+    @param[out] ownership Ownership array
+    @param first First point
+    @param nuBlocks Number of blocks of 4 points starting at first */
+int SimpleOwnership(const int* SG_RESTRICT color,
+                    const int* SG_RESTRICT nuBlack,
+                    const int* SG_RESTRICT nuWhite,
+                    int* SG_RESTRICT ownership, int first, int nuBlocks)
+{
+    BOOST_STATIC_ASSERT(SG_BLACK == 0);
+    BOOST_STATIC_ASSERT(SG_WHITE == 1);
+    BOOST_STATIC_ASSERT(SG_EMPTY == 2);
+    BOOST_STATIC_ASSERT(SG_BORDER == 3);
+    int sum[4] = { 0, 0, 0, 0 };
+    for (int p = first; p < first + 4 * nuBlocks; p += 4)
+        for (int i = 0; i < 4; ++i)
+        {
+            const int c = color[p + i];
+            // All bits set for stones, zero for empty and border points
+            const int stoneMask = (c >> 1) - 1;
+            // 1 for empty points, 0 otherwise
+            const int isEmpty = (c >> 1) & ~c & 1;
+            // (n + 7) >> 3 is 1 for 0 < n <= 4 and 0 for n == 0
+            const int emptyValue = ((nuBlack[p + i] + 7) >> 3)
+                                 - ((nuWhite[p + i] + 7) >> 3);
+            const int o =
+                ((1 - 2 * c) & stoneMask) + (emptyValue & -isEmpty);
+            ownership[p + i] = o;
+            sum[i] += o;
+        }
+    return sum[0] + sum[1] + sum[2] + sum[3];
+}
+
 } // namespace
 
 //----------------------------------------------------------------------------
@@ -65,8 +104,14 @@ void GoUctBoard::CheckConsistency() const
         if (c == SG_BLACK || c == SG_WHITE)
             CheckConsistencyBlock(p);
         if (c == SG_EMPTY)
+        {
             SG_ASSERT(m_block[p] == 0);
+            SG_ASSERTRANGE(m_emptyIndex[p], 0, m_nuEmpty - 1);
+            SG_ASSERT(m_empty[m_emptyIndex[p]] == p);
+        }
     }
+    for (int i = 0; i < m_nuEmpty; ++i)
+        SG_ASSERT(IsEmpty(m_empty[i]));
 }
 
 void GoUctBoard::CheckConsistencyBlock(SgPoint point) const
@@ -246,6 +291,7 @@ void GoUctBoard::Init(const GoBoard& bd)
     m_lastMove = bd.GetLastMove();
     m_secondLastMove = bd.Get2ndLastMove();
     m_toPlay = bd.ToPlay();
+    m_nuEmpty = 0;
     for (GoBoard::Iterator it(bd); it; ++it)
     {
         SgPoint p = *it;
@@ -255,7 +301,10 @@ void GoUctBoard::Init(const GoBoard& bd)
         m_nuNeighbors[SG_WHITE][p] = bd.NumNeighbors(p, SG_WHITE);
         m_nuNeighborsEmpty[p] = bd.NumEmptyNeighbors(p);
         if (bd.IsEmpty(p))
+        {
             m_block[p] = 0;
+            AddEmpty(p);
+        }
         else if (bd.Anchor(p) == p)
         {
             SgBoardColor c = m_color[p];
@@ -320,6 +369,7 @@ void GoUctBoard::AddStone(SgPoint p, SgBlackWhite c)
     SG_ASSERT(IsEmpty(p));
     SG_ASSERT_BW(c);
     m_color[p] = c;
+    RemoveEmpty(p);
     --m_nuNeighborsEmpty[p - SG_NS];
     --m_nuNeighborsEmpty[p - SG_WE];
     --m_nuNeighborsEmpty[p + SG_WE];
@@ -398,6 +448,7 @@ void GoUctBoard::KillBlock(const Block* block)
         SgPoint p = *it;
         AddLibToAdjBlocks(p, opp);
         m_color[p] = SG_EMPTY;
+        AddEmpty(p);
         ++m_nuNeighborsEmpty[p - SG_NS];
         ++m_nuNeighborsEmpty[p - SG_WE];
         ++m_nuNeighborsEmpty[p + SG_WE];
@@ -417,6 +468,54 @@ void GoUctBoard::KillBlock(const Block* block)
         m_koPoint = block->m_anchor;
 }
 
+int GoUctBoard::Ownership(SgArray<int,SG_MAXPOINT>& ownership,
+                          bool floodFill) const
+{
+    int* own = &ownership[0];
+    // Round the number of points up to a multiple of 4. The extra points
+    // are border points, which get ownership 0.
+    const int first = FirstBoardPoint();
+    const int nuBlocks = (LastBoardPoint() - first + 4) / 4;
+    SG_ASSERT(first + 4 * nuBlocks <= SG_MAXPOINT);
+    int sum = SimpleOwnership(&m_color[0], &m_nuNeighbors[SG_BLACK][0],
+                              &m_nuNeighbors[SG_WHITE][0], own, first,
+                              nuBlocks);
+    if (! floodFill)
+        return sum;
+    // Points in empty regions with more than one point are rare at the end
+    // of playouts; find them with the list of empty points
+    SgReserveMarker reserve(m_marker);
+    m_marker.Clear();
+    for (int i = 0; i < m_nuEmpty; ++i)
+    {
+        const SgPoint p = m_empty[i];
+        if (m_nuNeighborsEmpty[p] == 0 || ! m_marker.NewMark(p))
+            continue;
+        SgStack<SgPoint,SG_MAXPOINT> stack;
+        GoPointList region;
+        stack.Push(p);
+        bool isBlackAdjacent = false;
+        bool isWhiteAdjacent = false;
+        while (! stack.IsEmpty())
+        {
+            const SgPoint p2 = stack.Pop();
+            region.PushBack(p2);
+            isBlackAdjacent |= (m_nuNeighbors[SG_BLACK][p2] > 0);
+            isWhiteAdjacent |= (m_nuNeighbors[SG_WHITE][p2] > 0);
+            for (SgNb4Iterator it(p2); it; ++it)
+                if (m_color[*it] == SG_EMPTY && m_marker.NewMark(*it))
+                    stack.Push(*it);
+        }
+        const int o = int(isBlackAdjacent) - int(isWhiteAdjacent);
+        for (GoPointList::Iterator it(region); it; ++it)
+        {
+            sum += o - own[*it];
+            own[*it] = o;
+        }
+    }
+    return sum;
+}
+
 void GoUctBoard::Play(SgPoint p)
 {
     SG_ASSERT(p >= 0); // No special move, see SgMove
@@ -149,6 +149,50 @@ public:
     /** See SgBoardConst::FirstBoardPoint */
     int LastBoardPoint() const;
 
+    /** @name Empty points
+        The board keeps an index-addressable set of the empty points, which
+        is updated incrementally in Play(). It allows to select a random
+        empty point in constant time without a loop over the board. */
+    // @{
+
+    /** Return the number of empty points on the board. */
+    int NumEmpty() const;
+
+    /** Return an empty point by index.
+        The order of the points is arbitrary and changes with Play() and
+        SwapEmpty().
+        @param i The index
+        @pre i >= 0 && i < NumEmpty() */
+    SgPoint EmptyPoint(int i) const;
+
+    /** Exchange two entries in the list of empty points.
+        Changes only the order of the list, not the board position. This
+        allows random move generators to sample the empty points without
+        replacement by moving rejected points to the end of the range
+        they select from.
+        @pre i, j >= 0 && i, j < NumEmpty() */
+    void SwapEmpty(int i, int j) const;
+
+    // @} // @name
+
+    /** Compute the area ownership of all points for scoring.
+        Black stones and empty points owned by Black get 1, White stones and
+        empty points owned by White get -1, dame points get 0. Border
+        points from FirstBoardPoint() up to three points after
+        LastBoardPoint() also get 0.
+        The points are evaluated with a branch-free loop over the point
+        arrays, which the compiler can vectorize. An empty point is owned by
+        a color, if all its adjacent stones have that color.
+        @param[out] ownership
+        @param floodFill If false, every empty point is evaluated on its own
+        as in GoBoardUtil::ScoreSimpleEndPosition(), which is correct at the
+        end of a playout with only single point eyes left. If true, empty
+        regions with more than one point are flood-filled and owned by a
+        color if only that color is adjacent to the region, as in
+        GoBoardUtil::TrompTaylorScore().
+        @return The sum of the ownership values (area score without komi) */
+    int Ownership(SgArray<int,SG_MAXPOINT>& ownership, bool floodFill) const;
+
     /** Play a move for the current player.
         @see Play(SgPoint,SgBlackWhite); */
     void Play(SgPoint p);
@@ -191,6 +235,10 @@ public:
         Conditions similar to GetLastMove(). */
     SgPoint Get2ndLastMove() const;
 
+    /** Point which is currently illegal due to the simple ko rule.
+        @return The ko point or SG_NULLPOINT, if none exists. */
+    SgPoint KoPoint() const;
+
     /** Return the number of stones in the block at 'p'.
         Not defined for empty or border points. */
     int NumStones(SgPoint p) const;
@@ -353,6 +401,17 @@ private:
 
     SgArray<bool,SG_MAXPOINT> m_isBorder;
 
+    /** Number of empty points, see NumEmpty() */
+    int m_nuEmpty;
+
+    /** Empty points, see EmptyPoint().
+        Mutable, because SwapEmpty() does not change the position. */
+    mutable SgArray<SgPoint,SG_MAX_ONBOARD> m_empty;
+
+    /** Index of each empty point in m_empty.
+        Undefined for occupied points. */
+    mutable SgArray<int,SG_MAXPOINT> m_emptyIndex;
+
     /** Not implemented. */
     GoUctBoard(const GoUctBoard&);
 
@@ -383,6 +442,10 @@ private:
 
     void AddStone(SgPoint p, SgBlackWhite c);
 
+    void AddEmpty(SgPoint p);
+
+    void RemoveEmpty(SgPoint p);
+
     void KillBlock(const Block* block);
 
     bool HasLiberties(SgPoint p) const;
@@ -601,6 +664,20 @@ inline bool GoUctBoard::CapturingMove() const
     return ! m_capturedStones.IsEmpty();
 }
 
+inline void GoUctBoard::AddEmpty(SgPoint p)
+{
+    m_empty[m_nuEmpty] = p;
+    m_emptyIndex[p] = m_nuEmpty;
+    ++m_nuEmpty;
+}
+
+inline SgPoint GoUctBoard::EmptyPoint(int i) const
+{
+    SG_ASSERTRANGE(i, 0, m_nuEmpty - 1);
+    SG_ASSERT(IsEmpty(m_empty[i]));
+    return m_empty[i];
+}
+
 inline int GoUctBoard::FirstBoardPoint() const
 {
     return m_const.FirstBoardPoint();
@@ -626,6 +703,11 @@ inline SgPoint GoUctBoard::GetLastMove() const
     return m_lastMove;
 }
 
+inline SgPoint GoUctBoard::KoPoint() const
+{
+    return m_koPoint;
+}
+
 inline SgBlackWhite GoUctBoard::GetStone(SgPoint p) const
 {
     SG_ASSERT(Occupied(p));
@@ -848,6 +930,11 @@ inline int GoUctBoard::NumEmptyNeighbors(SgPoint p) const
     return m_nuNeighborsEmpty[p];
 }
 
+inline int GoUctBoard::NumEmpty() const
+{
+    return m_nuEmpty;
+}
+
 inline int GoUctBoard::NumLiberties(SgPoint p) const
 {
     SG_ASSERT(IsValidPoint(p));
@@ -902,11 +989,33 @@ inline int GoUctBoard::Side(SgPoint p, int index) const
     return m_const.Side(p, index);
 }
 
+inline void GoUctBoard::RemoveEmpty(SgPoint p)
+{
+    SG_ASSERT(m_nuEmpty > 0);
+    const int i = m_emptyIndex[p];
+    SG_ASSERT(m_empty[i] == p);
+    const SgPoint last = m_empty[--m_nuEmpty];
+    m_empty[i] = last;
+    m_emptyIndex[last] = i;
+}
+
 inline SgGrid GoUctBoard::Size() const
 {
     return m_size;
 }
 
+inline void GoUctBoard::SwapEmpty(int i, int j) const
+{
+    SG_ASSERTRANGE(i, 0, m_nuEmpty - 1);
+    SG_ASSERTRANGE(j, 0, m_nuEmpty - 1);
+    const SgPoint p = m_empty[i];
+    const SgPoint q = m_empty[j];
+    m_empty[i] = q;
+    m_empty[j] = p;
+    m_emptyIndex[q] = i;
+    m_emptyIndex[p] = j;
+}
+
 inline SgPoint GoUctBoard::TheLiberty(SgPoint p) const
 {
     SG_ASSERT(Occupied(p));
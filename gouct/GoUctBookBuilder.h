@@ -18,7 +18,11 @@
 //----------------------------------------------------------------------------
 
 /** Expands a Book using the given player to evaluate game positions.
-    Supports multithreaded evaluation of children.
+    Supports multithreaded evaluation of children. With
+    SgBookBuilder::ExpandBatchSize() larger than one, the move generation
+    and the evaluation of the children of several leaves are distributed
+    over the workers, which keeps them busy if the number of new children
+    of a single leaf is not a multiple of NumWorkers().
     @todo Copy settings from passed player to other players. */
 template<class PLAYER>
 class GoUctBookBuilder : public SgBookBuilder
@@ -106,14 +110,23 @@ protected:
 
     void EvaluateChildren(const std::vector<SgMove>& childrenToDo,
                           std::vector<std::pair<SgMove, float> >& scores);
+
+    void GenerateMovesForStates(
+                           const std::vector< std::vector<SgMove> >& lines,
+                           std::size_t count,
+                           std::vector< std::vector<SgMove> >& moves,
+                           std::vector<bool>& determined,
+                           std::vector<float>& values);
+
+    void EvaluateStates(const std::vector< std::vector<SgMove> >& lines,
+                        std::vector<float>& values);
+
     void Init();
 
     void StartIteration();
 
     void EndIteration();
 
-    void BeforeEvaluateChildren();
-
     void AfterEvaluateChildren();
 
     void Fini();
@@ -125,13 +138,42 @@ protected:
     bool HasBeenVisited();
         
 private:
+    /** Search done by a worker. */
+    struct Job
+    {
+        /** Index of the job in the jobs passed to SgThreadedWorker. */
+        std::size_t m_index;
+
+        /** Moves from the current state to the searched state. */
+        std::vector<SgMove> m_line;
+
+        /** Number of games of the search. */
+        SgUctValue m_numGames;
+
+        /** Return the legal moves ordered by the count of the search. */
+        bool m_orderMoves;
+
+        Job(std::size_t index, const std::vector<SgMove>& line,
+            SgUctValue numGames, bool orderMoves);
+    };
+
+    /** Result of a Job. */
+    struct JobResult
+    {
+        /** Value of the searched state for the color to play. */
+        float m_value;
+
+        /** See Job::m_orderMoves */
+        std::vector<SgMove> m_moves;
+    };
+
     /** Copyable worker. */
     class Worker
     {
     public:
         Worker(std::size_t id, PLAYER& player);
 
-        float operator()(const SgMove& move);
+        JobResult operator()(const Job& job);
 
     private:
         std::size_t m_id;
@@ -183,10 +225,13 @@ private:
     /** Workers for each thread. */
     std::vector<Worker> m_workers;
 
-    SgThreadedWorker<SgMove,float,Worker>* m_threadedWorker;
+    SgThreadedWorker<Job,JobResult,Worker>* m_threadedWorker;
 
     void CreateWorkers();
 
+    void DoJobs(const std::vector<Job>& jobs,
+                std::vector<JobResult>& results);
+
     void DestroyWorkers();
 };
 
@@ -301,7 +346,7 @@ void GoUctBookBuilder<PLAYER>::CreateWorkers()
         m_workers.push_back(Worker(i, *m_players[i]));
     }
     m_threadedWorker 
-        = new SgThreadedWorker<SgMove,float,Worker>(m_workers);
+        = new SgThreadedWorker<Job,JobResult,Worker>(m_workers);
 }
 
 /** Destroys copied players, boards, and threads. */
@@ -330,6 +375,16 @@ void GoUctBookBuilder<PLAYER>::Fini()
 
 //----------------------------------------------------------------------------
 
+template<class PLAYER>
+GoUctBookBuilder<PLAYER>::Job::Job(std::size_t index,
+                                   const std::vector<SgMove>& line,
+                                   SgUctValue numGames, bool orderMoves)
+    : m_index(index),
+      m_line(line),
+      m_numGames(numGames),
+      m_orderMoves(orderMoves)
+{ }
+
 template<class PLAYER>
 GoUctBookBuilder<PLAYER>::Worker::Worker(std::size_t id, PLAYER& player)
 
@@ -338,16 +393,56 @@ GoUctBookBuilder<PLAYER>::Worker::Worker(std::size_t id, PLAYER& player)
 { }
 
 template<class PLAYER>
-float GoUctBookBuilder<PLAYER>::Worker::operator()(const SgMove& move)
+typename GoUctBookBuilder<PLAYER>::JobResult
+GoUctBookBuilder<PLAYER>::Worker::operator()(const Job& job)
 {
     m_player->UpdateSubscriber();
-    if (move >= 0)
-        m_player->Board().Play(move);
-    m_player->GenMove(SgTimeRecord(true, 9999), m_player->Board().ToPlay());
+    GoBoard& bd = m_player->Board();
+    for (std::size_t i = 0; i < job.m_line.size(); ++i)
+        bd.Play(job.m_line[i]);
+    m_player->SetMaxGames(job.m_numGames);
+    m_player->GenMove(SgTimeRecord(true, 9999), bd.ToPlay());
     GoUctSearch& search 
         = dynamic_cast<GoUctSearch&>(m_player->Search());
-    float score = static_cast<float>(search.Tree().Root().Mean());
-    return score;
+    JobResult result;
+    result.m_value = static_cast<float>(search.Tree().Root().Mean());
+    if (job.m_orderMoves)
+    {
+        std::vector<std::pair<SgUctValue, SgMove> > ordered;
+        // Store counts for each move in vector.
+        const SgUctTree& tree = search.Tree();
+        const SgUctNode& root = tree.Root();
+        for (GoBoard::Iterator it(bd); it; ++it)
+            if (bd.IsLegal(*it))
+            {
+                SgMove move = *it;
+                const SgUctNode* node = 
+                    SgUctTreeUtil::FindChildWithMove(tree, root, move);
+                if (node && node->PosCount() > 0)
+                    ordered.push_back(std::make_pair(-node->PosCount(),
+                                                     move));
+            }
+        // Sort moves based on count of this search. 
+        std::stable_sort(ordered.begin(), ordered.end());
+        for (std::size_t i = 0; i < ordered.size(); ++i)
+            result.m_moves.push_back(ordered[i].second);
+    }
+    return result;
+}
+
+/** Runs jobs in the worker threads.
+    @param jobs The jobs, Job::m_index must be the index in the vector.
+    @param[out] results The results in the same order as the jobs. */
+template<class PLAYER>
+void GoUctBookBuilder<PLAYER>::DoJobs(const std::vector<Job>& jobs,
+                                      std::vector<JobResult>& results)
+{
+    std::vector<std::pair<Job, JobResult> > output;
+    m_threadedWorker->DoWork(jobs, output);
+    SG_ASSERT(output.size() == jobs.size());
+    results.resize(jobs.size());
+    for (std::size_t i = 0; i < output.size(); ++i)
+        results[output[i].first.m_index] = output[i].second;
 }
 
 //----------------------------------------------------------------------------
@@ -442,10 +537,10 @@ void GoUctBookBuilder<PLAYER>::EnsureRootExists()
     SgBookNode root;
     if (! GetNode(root))
     {
-        BeforeEvaluateChildren();
         PrintMessage("Creating root node...\n");
-        float value = m_workers[0](SG_NULLMOVE);
-        WriteNode(SgBookNode(value));
+        const Job job(0, std::vector<SgMove>(), m_numGamesPerEvaluation,
+                      false);
+        WriteNode(SgBookNode(m_workers[0](job).m_value));
     }
 }
 
@@ -460,38 +555,34 @@ bool GoUctBookBuilder<PLAYER>::GenerateMoves(std::size_t count,
 
     // Search for a few seconds.
     SgDebug() << m_state.Board() << '\n';
-    m_players[0]->SetMaxGames(m_numGamesPerSort);
-    m_workers[0](SG_NULLMOVE);
-    std::vector<std::pair<SgUctValue, SgMove> > ordered;
-    // Store counts for each move in vector.
-    {
-        const SgUctTree& tree = m_players[0]->Search().Tree();
-        const SgUctNode& root = tree.Root();
-        for (GoBoard::Iterator it(m_state.Board()); it; ++it)
-            if (m_state.Board().IsLegal(*it))
-            {
-                SgMove move = *it;
-                const SgUctNode* node = 
-                    SgUctTreeUtil::FindChildWithMove(tree, root, move);
-                if (node && node->PosCount() > 0)
-                {
-                    ordered.push_back(std::make_pair(-node->PosCount(), move));
-                }
-            }
-    }
-    // Sort moves based on count of this search. 
-    std::stable_sort(ordered.begin(), ordered.end());
-    for (std::size_t i = 0; i < ordered.size(); ++i)
-        moves.push_back(ordered[i].second);
+    const Job job(0, std::vector<SgMove>(), m_numGamesPerSort, true);
+    moves = m_workers[0](job).m_moves;
     SgDebug() << '\n';
     return false;
 }
 
+/** Computes the ordered moves of several states in parallel.
+    Same as GenerateMoves() for each state. */
 template<class PLAYER>
-void GoUctBookBuilder<PLAYER>::BeforeEvaluateChildren()
+void GoUctBookBuilder<PLAYER>::GenerateMovesForStates(
+                           const std::vector< std::vector<SgMove> >& lines,
+                           std::size_t count,
+                           std::vector< std::vector<SgMove> >& moves,
+                           std::vector<bool>& determined,
+                           std::vector<float>& values)
 {
-    for (std::size_t i = 0; i < m_numWorkers; ++i)
-        m_players[i]->SetMaxGames(m_numGamesPerEvaluation);
+    SG_UNUSED(count);
+    SgDebug() << "Generating moves of " << lines.size() << " states\n";
+    std::vector<Job> jobs;
+    for (std::size_t i = 0; i < lines.size(); ++i)
+        jobs.push_back(Job(i, lines[i], m_numGamesPerSort, true));
+    std::vector<JobResult> results;
+    DoJobs(jobs, results);
+    moves.resize(lines.size());
+    for (std::size_t i = 0; i < lines.size(); ++i)
+        moves[i] = results[i].m_moves;
+    determined.assign(lines.size(), false);
+    values.assign(lines.size(), 0);
 }
 
 template<class PLAYER>
@@ -503,7 +594,34 @@ void GoUctBookBuilder<PLAYER>
     for (std::size_t i = 0; i < childrenToDo.size(); ++i)
         SgDebug() << ' ' << SgWritePoint(childrenToDo[i]);
     SgDebug() << '\n';
-    m_threadedWorker->DoWork(childrenToDo, scores);
+    std::vector<Job> jobs;
+    for (std::size_t i = 0; i < childrenToDo.size(); ++i)
+        jobs.push_back(Job(i, std::vector<SgMove>(1, childrenToDo[i]),
+                           m_numGamesPerEvaluation, false));
+    std::vector<JobResult> results;
+    DoJobs(jobs, results);
+    for (std::size_t i = 0; i < childrenToDo.size(); ++i)
+        scores.push_back(std::make_pair(childrenToDo[i],
+                                        results[i].m_value));
+}
+
+/** Evaluates the states in parallel.
+    Same as EvaluateChildren(), but the states can be children of
+    different states. */
+template<class PLAYER>
+void GoUctBookBuilder<PLAYER>
+::EvaluateStates(const std::vector< std::vector<SgMove> >& lines,
+                 std::vector<float>& values)
+{
+    SgDebug() << "Evaluating " << lines.size() << " states\n";
+    std::vector<Job> jobs;
+    for (std::size_t i = 0; i < lines.size(); ++i)
+        jobs.push_back(Job(i, lines[i], m_numGamesPerEvaluation, false));
+    std::vector<JobResult> results;
+    DoJobs(jobs, results);
+    values.resize(lines.size());
+    for (std::size_t i = 0; i < lines.size(); ++i)
+        values[i] = results[i].m_value;
 }
 
 template<class PLAYER>
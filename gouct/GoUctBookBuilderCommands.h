@@ -12,7 +12,7 @@
 #include "GoUctGlobalSearch.h"
 #include "GoUctPlayer.h"
 #include "GoUctBookBuilder.h"
-#include "SgGameReader.h"
+#include "SgGameStreamReader.h"
 
 class GoBoard;
 class GoPlayer;
@@ -42,6 +42,8 @@ public:
         - @link CmdOpen() @c autobook_open @endlink
         - @link CmdClose() @c autobook_close @endlink
         - @link CmdSave() @c autobook_save @endlink
+        - @link CmdCompact() @c autobook_compact @endlink
+        - @link CmdSaveBinary() @c autobook_save_binary @endlink
         - @link CmdExpand() @c autobook_expand @endlink
         - @link CmdCover() @c autobook_cover @endlink
         - @link CmdAdditiveCover() @c autobook_additive_cover @endlink
@@ -56,6 +58,7 @@ public:
         - @link CmdLoadDisabled() @c autobook_load_disabled_lines @endlink
         - @link CmdLoadForced() @c autobook_load_forced_lines @endlink
         - @link CmdTruncateByDepth() @c autobook_truncate_by_depth @endlink
+        - @link CmdUpgrade() @c autobook_upgrade @endlink
         - @link CmdImport() @c autobook_import @endlink
         - @link CmdExport() @c autobook_export @endlink
         - @link CmdMainLine() @c autobook_mainline @endlink */
@@ -64,6 +67,8 @@ public:
     void CmdOpen(GtpCommand& cmd);
     void CmdClose(GtpCommand& cmd);
     void CmdSave(GtpCommand& cmd);
+    void CmdCompact(GtpCommand& cmd);
+    void CmdSaveBinary(GtpCommand& cmd);
     void CmdExpand(GtpCommand& cmd);
     void CmdCover(GtpCommand& cmd);
     void CmdAdditiveCover(GtpCommand& cmd);
@@ -78,6 +83,7 @@ public:
     void CmdLoadDisabled(GtpCommand& cmd);
     void CmdLoadForced(GtpCommand& cmd);
     void CmdTruncateByDepth(GtpCommand& cmd);
+    void CmdUpgrade(GtpCommand& cmd);
     void CmdImport(GtpCommand& cmd);
     void CmdExport(GtpCommand& cmd);
     void CmdMainLine(GtpCommand& cmd);
@@ -86,6 +92,28 @@ public:
     void Register(GtpEngine& engine);
 
 private:
+    /** Collects the moves of the main line of a game. */
+    class MainLineHandler
+        : public SgGameStreamHandler
+    {
+    public:
+        std::vector<SgMove> m_moves;
+
+        MainLineHandler(std::size_t maxMoves)
+            : m_maxMoves(maxMoves)
+        { }
+
+        void Move(SgBlackWhite color, SgPoint move)
+        {
+            SG_UNUSED(color);
+            if (m_moves.size() < m_maxMoves)
+                m_moves.push_back(move);
+        }
+
+    private:
+        std::size_t m_maxMoves;
+    };
+
     const GoBoard& m_bd;
 
     GoPlayer*& m_player;
@@ -98,6 +126,8 @@ private:
     
     PLAYER& Player();
 
+    void CheckWritable() const;
+
     void Register(GtpEngine& e, const std::string& command,
                 typename GtpCallback<GoUctBookBuilderCommands>::Method method);
 
@@ -129,15 +159,18 @@ void GoUctBookBuilderCommands<PLAYER>::AddGoGuiAnalyzeCommands(GtpCommand& cmd)
         "none/AutoBook Additive Cover/autobook_additive_cover %s\n"
         "none/AutoBook Additive Cover Sgf/autobook_additive_cover_sgf %s\n"
         "none/AutoBook Close/autobook_close\n"
+        "none/AutoBook Compact/autobook_compact\n"
         "none/AutoBook Cover/autobook_cover %s\n"
         "none/AutoBook Expand/autobook_expand %s\n"
         "none/AutoBook Open/autobook_open %r\n"
         "none/AutoBook Save/autobook_save\n"
+        "none/AutoBook Save Binary/autobook_save_binary %w\n"
         "none/AutoBook Refresh/autobook_refresh\n"
         "none/AutoBook Merge/autobook_merge %r\n"
         "none/AutoBook Load Disabled Lines/autobook_load_disabled_lines %r\n"
         "none/AutoBook Load Forced Lines/autobook_load_forced_lines %r\n"
         "none/AutoBook Truncate By Depth/autobook_truncate_by_depth %s\n"
+        "none/AutoBook Upgrade/autobook_upgrade %r %w\n"
         "none/AutoBook Import/autobook_import %r\n"
         "none/AutoBook Export/autobook_export %w\n"
         "param/AutoBook Param/autobook_param\n"
@@ -152,6 +185,8 @@ template<class PLAYER>
 void GoUctBookBuilderCommands<PLAYER>::Register(GtpEngine& e)
 {
     Register(e, "autobook_close", &GoUctBookBuilderCommands<PLAYER>::CmdClose);
+    Register(e, "autobook_compact",
+             &GoUctBookBuilderCommands<PLAYER>::CmdCompact);
     Register(e, "autobook_counts", 
              &GoUctBookBuilderCommands<PLAYER>::CmdCounts);
     Register(e, "autobook_cover",
@@ -182,12 +217,16 @@ void GoUctBookBuilderCommands<PLAYER>::Register(GtpEngine& e)
              &GoUctBookBuilderCommands<PLAYER>::CmdRefresh);
     Register(e, "autobook_save",
              &GoUctBookBuilderCommands<PLAYER>::CmdSave);
+    Register(e, "autobook_save_binary",
+             &GoUctBookBuilderCommands<PLAYER>::CmdSaveBinary);
     Register(e, "autobook_scores", 
              &GoUctBookBuilderCommands<PLAYER>::CmdScores);
     Register(e, "autobook_state_info", 
              &GoUctBookBuilderCommands<PLAYER>::CmdStateInfo);
     Register(e, "autobook_truncate_by_depth", 
              &GoUctBookBuilderCommands<PLAYER>::CmdTruncateByDepth);
+    Register(e, "autobook_upgrade",
+             &GoUctBookBuilderCommands<PLAYER>::CmdUpgrade);
 }
 
 template<class PLAYER>
@@ -199,6 +238,13 @@ Register(GtpEngine& engine, const std::string& command,
                     new GtpCallback<GoUctBookBuilderCommands>(this, method));
 }
 
+template<class PLAYER>
+void GoUctBookBuilderCommands<PLAYER>::CheckWritable() const
+{
+    if (m_book->IsBinary())
+        throw GtpFailure("binary autobook is read-only");
+}
+
 template<class PLAYER>
 PLAYER& GoUctBookBuilderCommands<PLAYER>::Player()
 {
@@ -272,11 +318,19 @@ void GoUctBookBuilderCommands<PLAYER>::ShowInfluence(GtpCommand& cmd,
 //----------------------------------------------------------------------------
 
 /** Opens a autobook.
-    Closes any previously opened book. */
+    Closes any previously opened book. A binary book (see
+    autobook_save_binary) is opened read-only. */
 template<class PLAYER>
 void GoUctBookBuilderCommands<PLAYER>::CmdOpen(GtpCommand& cmd)
 {
-    m_book.reset(new GoAutoBook(cmd.Arg(), m_param));
+    try
+    {
+        m_book.reset(new GoAutoBook(cmd.Arg(), m_param));
+    }
+    catch (const SgException& e)
+    {
+        throw GtpFailure() << "opening autobook failed: " << e.what();
+    }
 }
 
 /** Closes the current autobook. */
@@ -287,14 +341,62 @@ void GoUctBookBuilderCommands<PLAYER>::CmdClose(GtpCommand& cmd)
     m_book.reset(0);
 }
 
-/** Saves the current book to its file. */
+/** Saves the changes of the current book to its journal.
+    See GoAutoBook::Flush(). */
 template<class PLAYER>
 void GoUctBookBuilderCommands<PLAYER>::CmdSave(GtpCommand& cmd)
 {
     if (m_book.get() == 0)
         throw GtpFailure() << "No opened autobook!\n";
+    CheckWritable();
     cmd.CheckArgNone();
-    m_book->Flush();
+    try
+    {
+        m_book->Flush();
+    }
+    catch (const SgException& e)
+    {
+        throw GtpFailure(e.what());
+    }
+}
+
+/** Writes the entire current book to its file and removes the journal.
+    See GoAutoBook::Compact(). */
+template<class PLAYER>
+void GoUctBookBuilderCommands<PLAYER>::CmdCompact(GtpCommand& cmd)
+{
+    if (m_book.get() == 0)
+        throw GtpFailure() << "No opened autobook!\n";
+    CheckWritable();
+    cmd.CheckArgNone();
+    try
+    {
+        m_book->Compact();
+    }
+    catch (const SgException& e)
+    {
+        throw GtpFailure(e.what());
+    }
+}
+
+/** Converts the current book to a binary book.
+    See GoBinaryBook. The binary book can then be opened with autobook_open
+    and used by the player, but not expanded.
+    Arguments: file name */
+template<class PLAYER>
+void GoUctBookBuilderCommands<PLAYER>::CmdSaveBinary(GtpCommand& cmd)
+{
+    if (m_book.get() == 0)
+        throw GtpFailure() << "No opened autobook!\n";
+    CheckWritable();
+    try
+    {
+        m_book->SaveBinary(cmd.Arg());
+    }
+    catch (const SgException& e)
+    {
+        throw GtpFailure(e.what());
+    }
 }
 
 /** Returns info on current state. */
@@ -312,17 +414,29 @@ void GoUctBookBuilderCommands<PLAYER>::CmdStateInfo(GtpCommand& cmd)
     cmd << node;
 }
 
-/** Expands book from current state using the current player.  */
+/** Expands book from current state using the current player.
+    Returns the number of expanded leaves, the time and the throughput in
+    leaves per hour. The progress is written to the debug stream. */
 template<class PLAYER>
 void GoUctBookBuilderCommands<PLAYER>::CmdExpand(GtpCommand& cmd)
 {
     if (m_book.get() == 0)
         throw GtpFailure() << "No opened autobook!\n";
+    CheckWritable();
     cmd.CheckNuArg(1);
     int numExpansions = cmd.ArgMin<int>(0, 1);
     m_bookBuilder.SetPlayer(Player());
     m_bookBuilder.SetState(*m_book);
     m_bookBuilder.Expand(numExpansions);
+    const double time = m_bookBuilder.ExpandTime();
+    const std::size_t num = m_bookBuilder.NumLeavesExpanded();
+    cmd << "Leaves " << num << '\n'
+        << "Time " << std::fixed << std::setprecision(1) << time << '\n'
+        << "LeavesPerHour ";
+    if (time > 0)
+        cmd << (3600 * double(num) / time);
+    else
+        cmd << '-';
 }
 
 /** Covers the given set of lines in the current book.
@@ -332,6 +446,7 @@ void GoUctBookBuilderCommands<PLAYER>::CmdCover(GtpCommand& cmd)
 {
     if (m_book.get() == 0)
         throw GtpFailure() << "No opened autobook!\n";
+    CheckWritable();
     cmd.CheckNuArg(2);
     std::vector< std::vector<SgMove> > workList;
     {
@@ -356,6 +471,7 @@ void GoUctBookBuilderCommands<PLAYER>::CmdAdditiveCover(GtpCommand& cmd)
 {
     if (m_book.get() == 0)
         throw GtpFailure() << "No opened autobook!\n";
+    CheckWritable();
     cmd.CheckNuArg(2);
     std::vector< std::vector<SgMove> > workList;
     {
@@ -380,46 +496,28 @@ void GoUctBookBuilderCommands<PLAYER>::CmdAdditiveCoverSgf(GtpCommand& cmd)
 {
     if (m_book.get() == 0)
         throw GtpFailure() << "No opened autobook!\n";
+    CheckWritable();
     cmd.CheckNuArgLessEqual(3);
     int expansionsRequired = cmd.ArgMin<int>(0, 1);
     std::string fileName = cmd.Arg(1);
-    int moveNumber = -1;
+    std::size_t moveNumber = std::numeric_limits<std::size_t>::max();
     if (cmd.NuArg() == 3)
-        moveNumber = cmd.ArgMin<int>(2, 1);
+        moveNumber = cmd.ArgMin<std::size_t>(2, 1);
     std::ifstream in(fileName.c_str());
     if (! in)
         throw GtpFailure("could not open file");
-    SgGameReader reader(in);
-    SgNode* root = reader.ReadGame();
-    if (root == 0)
+    SgGameStreamReader reader(in);
+    reader.SetMainLineOnly(true);
+    MainLineHandler handler(moveNumber);
+    if (! reader.ReadGame(handler))
         throw GtpFailure("no games in file");
     if (reader.GetWarnings().any())
     {
         SgWarning() << fileName << ":\n";
         reader.PrintWarnings(SgDebug());
     }
-    if (moveNumber == -1)
-        moveNumber = std::numeric_limits<int>::max();
-    std::vector<SgMove> gameLine;
-    SgNode* cur = root;
-    for (int i = 0; i < moveNumber;)
-    {
-        if (cur->HasProp(SG_PROP_MOVE))
-        {
-            SgPropMove* prop = static_cast<SgPropMove*>(cur->Get(SG_PROP_MOVE));
-            SG_ASSERT(prop);
-            gameLine.push_back(prop->Value());
-            ++i;
-        }
-        if (! cur->NodeInDirection(SgNode::NEXT))
-            break;
-        SgNode* next = cur->NodeInDirection(SgNode::NEXT);
-        if (next == cur)
-            break;
-        cur = next;
-    }
     std::vector< std::vector<SgMove> > workList;
-    workList.push_back(gameLine);
+    workList.push_back(handler.m_moves);
     m_bookBuilder.SetPlayer(Player());
     m_bookBuilder.SetState(*m_book);
     m_bookBuilder.Cover(expansionsRequired, true, workList);
@@ -432,6 +530,7 @@ void GoUctBookBuilderCommands<PLAYER>::CmdRefresh(GtpCommand& cmd)
 {
     if (m_book.get() == 0)
         throw GtpFailure() << "No opened autobook!\n";
+    CheckWritable();
     cmd.CheckArgNone();
     m_bookBuilder.SetPlayer(Player());
     m_bookBuilder.SetState(*m_book);
@@ -445,7 +544,10 @@ void GoUctBookBuilderCommands<PLAYER>::CmdMerge(GtpCommand& cmd)
 {
     if (m_book.get() == 0)
         throw GtpFailure() << "No opened autobook!\n";
+    CheckWritable();
     GoAutoBook other(cmd.Arg(), m_param);
+    if (other.IsBinary())
+        throw GtpFailure("cannot merge binary autobook");
     m_book->Merge(other);
 }
 
@@ -456,6 +558,7 @@ void GoUctBookBuilderCommands<PLAYER>::CmdImport(GtpCommand& cmd)
 {
     if (m_book.get() == 0)
         throw GtpFailure() << "No opened autobook!\n";
+    CheckWritable();
     std::string filename = cmd.Arg();
     std::ifstream in(filename.c_str());
     if (! in)
@@ -488,12 +591,33 @@ void GoUctBookBuilderCommands<PLAYER>::CmdTruncateByDepth(GtpCommand& cmd)
     cmd.CheckNuArg(2);
     int depth = cmd.ArgMin<int>(0, 0);
     GoAutoBook other(cmd.Arg(1), m_param);
+    if (other.IsBinary())
+        throw GtpFailure("binary autobook is read-only");
     GoAutoBookState state(m_bd);
     state.Synchronize();
     m_book->TruncateByDepth(depth, state, other);
     other.Flush();
 }
 
+/** Converts an autobook written by an earlier version.
+    Arguments: old file, new file <br>
+    Returns: number of converted nodes <br>
+    The current position must be the position the book was built from.
+    See GoAutoBook::Upgrade(). */
+template<class PLAYER>
+void GoUctBookBuilderCommands<PLAYER>::CmdUpgrade(GtpCommand& cmd)
+{
+    cmd.CheckNuArg(2);
+    try
+    {
+        cmd << GoAutoBook::Upgrade(cmd.Arg(0), cmd.Arg(1), m_bd);
+    }
+    catch (const SgException& e)
+    {
+        throw GtpFailure() << "upgrading autobook failed: " << e.what();
+    }
+}
+
 template<class PLAYER>
 void GoUctBookBuilderCommands<PLAYER>::CmdParam(GtpCommand& cmd)
 {
@@ -504,6 +628,10 @@ void GoUctBookBuilderCommands<PLAYER>::CmdParam(GtpCommand& cmd)
             << "[string] expand_width " << m_bookBuilder.ExpandWidth() << '\n'
             << "[string] expand_threshold " 
             << m_bookBuilder.ExpandThreshold() << '\n'
+            << "[string] expand_batch_size "
+            << m_bookBuilder.ExpandBatchSize() << '\n'
+            << "[string] flush_iterations "
+            << m_bookBuilder.FlushIterations() << '\n'
             << "[string] max_memory " << m_bookBuilder.MaxMemory() << '\n'
             << "[string] num_workers " << m_bookBuilder.NumWorkers() << '\n'
             << "[string] num_threads_per_worker " << m_bookBuilder.NumThreadsPerWorker() << '\n'
@@ -536,6 +664,10 @@ void GoUctBookBuilderCommands<PLAYER>::CmdParam(GtpCommand& cmd)
             m_bookBuilder.SetExpandWidth(cmd.ArgMin<int>(1, 1));
         else if (name == "expand_threshold")
             m_bookBuilder.SetExpandThreshold(cmd.ArgMin<int>(1, 1));
+        else if (name == "expand_batch_size")
+            m_bookBuilder.SetExpandBatchSize(cmd.ArgMin<int>(1, 1));
+        else if (name == "flush_iterations")
+            m_bookBuilder.SetFlushIterations(cmd.ArgMin<int>(1, 1));
         else if (name == "usage_count")
             m_param.m_usageCountThreshold = cmd.ArgMin<size_t>(1, 0);
         else if (name == "move_select")
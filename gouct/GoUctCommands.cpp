@@ -12,19 +12,23 @@
 #include "GoGtpCommandUtil.h"
 #include "GoBoardUtil.h"
 #include "GoSafetySolver.h"
+#include "GoUctAdditiveKnowledgeGreenpeep.h"
 #include "GoUctDefaultPriorKnowledge.h"
 #include "GoUctDefaultMoveFilter.h"
 #include "GoUctEstimatorStat.h"
 #include "GoUctGlobalSearch.h"
 #include "GoUctLadderKnowledge.h"
+#include "GoUctPatternGammaTable.h"
 #include "GoUctPatterns.h"
 #include "GoUctPlayer.h"
 #include "GoUctPlayoutPolicy.h"
 #include "GoUctUtil.h"
 #include "GoUtil.h"
 #include "SgException.h"
+#include "SgGtpCommands.h"
 #include "SgPointSetUtil.h"
 #include "SgRestorer.h"
+#include "SgTime.h"
 #include "SgUctTreeUtil.h"
 #include "SgWrite.h"
 
@@ -322,6 +326,7 @@ void GoUctCommands::AddGoGuiAnalyzeCommands(GtpCommand& cmd)
         "none/Uct Stat Player Clear/uct_stat_player_clear\n"
         "hstring/Uct Stat Policy/uct_stat_policy\n"
         "none/Uct Stat Policy Clear/uct_stat_policy_clear\n"
+        "hstring/Uct Stat Policy Profile/uct_stat_policy_profile\n"
         "hstring/Uct Stat Search/uct_stat_search\n"
         "dboard/Uct Stat Territory/uct_stat_territory\n";
 }
@@ -332,6 +337,73 @@ void GoUctCommands::CmdAdditiveKnowledge(GtpCommand& cmd)
 	DisplayKnowledge(cmd, true);
 }
 
+/** Measure the cost of the knowledge computed when a node is expanded.
+    Arguments: [number] @n
+    Expands the current position @c number times (default 1000) as the
+    search does and returns the number of moves and the time per call in
+    microseconds of:
+    - @c expand: GoUctGlobalSearchState::GenerateAllMoves() with prior
+      and additive knowledge
+    - @c additive: only the additive knowledge (see uct_param_policy
+      knowledge_type), if any
+    - @c greenpeep_contexts_batch and @c greenpeep_contexts_pointwise: the
+      pattern contexts of GoUctAdditiveKnowledgeGreenpeep, computed for
+      the whole board and point by point */
+void GoUctCommands::CmdBenchmarkKnowledge(GtpCommand& cmd)
+{
+    cmd.CheckNuArgLessEqual(1);
+    int n = 1000;
+    if (cmd.NuArg() == 1)
+        n = cmd.ArgMin<int>(0, 1);
+    GoUctGlobalSearchState<GoUctPlayoutPolicy<GoUctBoard> >& state
+        = ThreadState(0);
+    state.StartSearch(); // Updates thread state board
+    vector<SgUctMoveInfo> moves;
+    SgUctProvenType ignoreProvenType;
+    // Not timed, the first call can initialize tables
+    state.GenerateAllMoves(0, moves, ignoreProvenType);
+    double startTime = SgTime::Get(SG_TIME_REAL);
+    for (int i = 0; i < n; ++i)
+        state.GenerateAllMoves(0, moves, ignoreProvenType);
+    const double timeExpand = SgTime::Get(SG_TIME_REAL) - startTime;
+    const double usPerCall = 1e6 / n;
+    cmd << std::fixed << std::setprecision(2)
+        << "moves " << moves.size() << '\n'
+        << "expand " << timeExpand * usPerCall << '\n';
+    GoUctAdditiveKnowledge* knowledge = state.GetAdditiveKnowledge();
+    if (knowledge != 0)
+    {
+        startTime = SgTime::Get(SG_TIME_REAL);
+        for (int i = 0; i < n; ++i)
+            knowledge->ProcessPosition(moves);
+        const double timeAdditive = SgTime::Get(SG_TIME_REAL) - startTime;
+        cmd << "additive " << timeAdditive * usPerCall << '\n';
+    }
+    unsigned int contexts[SG_MAX_ONBOARD + 1];
+    unsigned int sum = 0;
+    startTime = SgTime::Get(SG_TIME_REAL);
+    for (int i = 0; i < n; ++i)
+    {
+        GoUctAdditiveKnowledgeGreenpeep::ComputeContextsBatch(m_bd, moves,
+                                                              contexts);
+        sum += contexts[0];
+    }
+    const double timeContexts = SgTime::Get(SG_TIME_REAL) - startTime;
+    startTime = SgTime::Get(SG_TIME_REAL);
+    for (int i = 0; i < n; ++i)
+    {
+        GoUctAdditiveKnowledgeGreenpeep::ComputeContextsPointwise(m_bd, moves,
+                                                                  contexts);
+        sum += contexts[0];
+    }
+    const double timePointwise = SgTime::Get(SG_TIME_REAL) - startTime;
+    cmd << "greenpeep_contexts_batch " << timeContexts * usPerCall << '\n'
+        << "greenpeep_contexts_pointwise " << timePointwise * usPerCall;
+    // Avoid that the loops are optimized away
+    SgDebug() << "GoUctCommands::CmdBenchmarkKnowledge: checksum " << sum
+              << '\n';
+}
+
 /** Show UCT bounds of moves in root node.
     This command is compatible with the GoGui analyze command type "gfx".
     Move bounds are shown as labels on the board, the pass move bound is
@@ -383,6 +455,7 @@ void GoUctCommands::CmdDefaultPolicy(GtpCommand& cmd)
 void GoUctCommands::CmdDeterministicMode(GtpCommand& cmd)
 {
     cmd.CheckArgNone();
+    SgGtpCommands::CheckRandomSettingsUnlocked();
     GoUctSearch& s = Search();
     GoUctPlayerType& p = Player();
     SgDeterministic::SetDeterministicMode(true); 
@@ -392,13 +465,17 @@ void GoUctCommands::CmdDeterministicMode(GtpCommand& cmd)
     "uct_param_player ignore_clock true\n"
     "uct_param_player reuse_subtree false\n"
     "uct_param_search number_threads 1\n"
-    "uct_param_search max_nodes 5000000\n";
+    "uct_param_search max_nodes 5000000\n"
+    "sg_param random_engine mt19937\n";
     if ( p.MaxGames() == std::numeric_limits<SgUctValue>::max())
         SgWarning() << "Set Uct Param Player-> Max Games to finite "
                        "value in deterministic mode\n";
     p.SetIgnoreClock(true);
     p.SetReuseSubtree(false);
     s.SetNumberThreads(1);
+    // The regression tests of the deterministic mode were generated with the
+    // Mersenne Twister
+    SgRandom::SetEngine(SG_RANDOM_MT19937);
     SgRandom::SetSeed(1);
     s.SetCheckTimeInterval(SgUctValue(1500));
     s.SetMaxNodes(std::size_t(5000000));
@@ -512,6 +589,42 @@ void GoUctCommands::CmdLadderKnowledge(GtpCommand& cmd)
     DisplayMoveInfo(cmd, moves, false);
 }
 
+/** Load a gamma table for the playout patterns.
+    Replaces the compiled gamma table of the given type by a table written
+    by GoUctPatternTrainer. Without file argument, the compiled table is used
+    again. Regenerates the search states, such that the playout policies use
+    the new table.
+    Arguments: local|global [file]
+    @see GoUctPatternGammaTable */
+void GoUctCommands::CmdLoadPatternGammas(GtpCommand& cmd)
+{
+    cmd.CheckNuArgLessEqual(2);
+    const string type = cmd.Arg(0);
+    GoUctPatternGammaTable::TableType tableType;
+    if (type == "local")
+        tableType = GoUctPatternGammaTable::TABLE_LOCAL;
+    else if (type == "global")
+        tableType = GoUctPatternGammaTable::TABLE_GLOBAL;
+    else
+        throw GtpFailure() << "unknown table type: " << type;
+    boost::shared_ptr<GoUctPatternGammaTable> table;
+    if (cmd.NuArg() == 2)
+    {
+        table.reset(new GoUctPatternGammaTable());
+        try
+        {
+            table->Read(cmd.Arg(1));
+        }
+        catch (const SgException& e)
+        {
+            throw GtpFailure(e.what());
+        }
+        cmd << table->NuPatterns();
+    }
+    GoUctPatternGammaTable::SetLoaded(tableType, table);
+    Search().CreateThreads(); // need to regenerate all search states
+}
+
 /** Computes the maximum number of nodes in search tree given the
     maximum allowed memory for the tree. Assumes two trees. Returns
     current memory usage if no arguments.
@@ -549,6 +662,9 @@ void GoUctCommands::CmdMoves(GtpCommand& cmd)
     This command is compatible with the GoGui analyze command type "param".
 
     Parameters:
+    @arg @c early_cutoff See GoUctGlobalSearchStateParam::m_earlyCutoff
+    @arg @c early_cutoff_margin See
+        GoUctGlobalSearchStateParam::m_earlyCutoffMargin
     @arg @c live_gfx See GoUctGlobalSearch::GlobalSearchLiveGfx
     @arg @c mercy_rule See GoUctGlobalSearchStateParam::m_mercyRule
     @arg @c territory_statistics See
@@ -568,11 +684,13 @@ void GoUctCommands::CmdParamGlobalSearch(GtpCommand& cmd)
     {
         // Boolean parameters first for better layout of GoGui parameter
         // dialog, alphabetically otherwise
-        cmd << "[bool] live_gfx " << s.GlobalSearchLiveGfx() << '\n'
+        cmd << "[bool] early_cutoff " << p.m_earlyCutoff << '\n'
+            << "[bool] live_gfx " << s.GlobalSearchLiveGfx() << '\n'
             << "[bool] mercy_rule " << p.m_mercyRule << '\n'
             << "[bool] territory_statistics " << p.m_territoryStatistics
             << '\n'
             << "[bool] use_tree_filter " << p.m_useTreeFilter << '\n'
+            << "[int] early_cutoff_margin " << p.m_earlyCutoffMargin << '\n'
             << "[string] length_modification " << p.m_lengthModification
             << '\n'
             << "[string] score_modification " << p.m_scoreModification
@@ -581,7 +699,11 @@ void GoUctCommands::CmdParamGlobalSearch(GtpCommand& cmd)
     else if (cmd.NuArg() == 2)
     {
         string name = cmd.Arg(0);
-        if (name == "live_gfx")
+        if (name == "early_cutoff")
+            p.m_earlyCutoff = cmd.Arg<bool>(1);
+        else if (name == "early_cutoff_margin")
+            p.m_earlyCutoffMargin = cmd.ArgMin<int>(1, 0);
+        else if (name == "live_gfx")
             s.SetGlobalSearchLiveGfx(cmd.Arg<bool>(1));
         else if (name == "mercy_rule")
             p.m_mercyRule = cmd.Arg<bool>(1);
@@ -689,10 +811,18 @@ void GoUctCommands::CmdParamPlayer(GtpCommand& cmd)
     Parameters:
     @arg @c statistics_enabled
         See GoUctPlayoutPolicyParam::m_statisticsEnabled
+    @arg @c generate_point_cache
+        See GoUctPlayoutPolicyParam::m_useGeneratePointCache
     @arg @c nakade_heuristic
         See GoUctPlayoutPolicyParam::m_useNakadeHeuristic
     @arg @c fillboard_tries
-        See GoUctPlayoutPolicyParam::m_fillboardTries */
+        See GoUctPlayoutPolicyParam::m_fillboardTries
+    @arg @c profile_interval
+        See GoUctPlayoutPolicyParam::m_profileInterval
+    @arg @c tactical_reader
+        See GoUctPlayoutPolicyParam::m_useTacticalReader
+    @arg @c tactical_reader_max_nodes
+        See GoUctPlayoutPolicyParam::m_tacticalReaderMaxNodes */
 void GoUctCommands::CmdParamPolicy(GtpCommand& cmd)
 {
     cmd.CheckNuArgLessEqual(2);
@@ -701,8 +831,11 @@ void GoUctCommands::CmdParamPolicy(GtpCommand& cmd)
     {
         // Boolean parameters first for better layout of GoGui parameter
         // dialog, alphabetically otherwise
-        cmd << "[bool] nakade_heuristic " << p.m_useNakadeHeuristic << '\n'
+        cmd << "[bool] generate_point_cache "
+            << p.m_useGeneratePointCache << '\n'
+            << "[bool] nakade_heuristic " << p.m_useNakadeHeuristic << '\n'
             << "[bool] statistics_enabled " << p.m_statisticsEnabled << '\n'
+            << "[bool] tactical_reader " << p.m_useTacticalReader << '\n'
             << "[bool] use_patterns_in_playout " 
             << p.m_usePatternsInPlayout << '\n'
             << "[bool] use_patterns_in_prior_knowledge " 
@@ -712,17 +845,24 @@ void GoUctCommands::CmdParamPolicy(GtpCommand& cmd)
             << KnowledgeTypeToString(p.m_knowledgeType) << '\n'
             << "[list/multiply/geometric_mean/add/average/max] combination_type "
             << CombinationTypeToString(p.m_combinationType) << '\n'
+            << "[int] profile_interval " << p.m_profileInterval << '\n'
             << "[float] pattern_gamma_threshold "
             << p.m_patternGammaThreshold << '\n'
+            << "[int] tactical_reader_max_nodes "
+            << p.m_tacticalReaderMaxNodes << '\n'
             ;
     }
     else if (cmd.NuArg() == 2)
     {
         string name = cmd.Arg(0);
-        if (name == "nakade_heuristic")
+        if (name == "generate_point_cache")
+            p.m_useGeneratePointCache = cmd.Arg<bool>(1);
+        else if (name == "nakade_heuristic")
             p.m_useNakadeHeuristic = cmd.Arg<bool>(1);
         else if (name == "statistics_enabled")
             p.m_statisticsEnabled = cmd.Arg<bool>(1);
+        else if (name == "tactical_reader")
+            p.m_useTacticalReader = cmd.Arg<bool>(1);
         else if (name == "use_patterns_in_playout")
             p.m_usePatternsInPlayout = cmd.Arg<bool>(1);
         else if (name == "use_patterns_in_prior_knowledge")
@@ -741,6 +881,10 @@ void GoUctCommands::CmdParamPolicy(GtpCommand& cmd)
         }
         else if (name == "pattern_gamma_threshold")
             p.m_patternGammaThreshold = cmd.Arg<float>(1);
+        else if (name == "profile_interval")
+            p.m_profileInterval = cmd.ArgMin<int>(1, 0);
+        else if (name == "tactical_reader_max_nodes")
+            p.m_tacticalReaderMaxNodes = cmd.ArgMin<int>(1, 1);
         else
             throw GtpFailure() << "unknown parameter: " << name;
     }
@@ -1191,12 +1335,33 @@ void GoUctCommands::CmdStatPolicy(GtpCommand& cmd)
 
 /** Clear statistics of GoUctPlayoutPolicy
     Arguments: none <br>
-    Only the statistics of the first thread's policy used.
-    @see GoUctPlayoutPolicyStat */
+    Clears the statistics and profiles of the policies of all threads.
+    @see GoUctPlayoutPolicyStat, GoUctPlayoutPolicyProfile */
 void GoUctCommands::CmdStatPolicyClear(GtpCommand& cmd)
 {
     cmd.CheckArgNone();
-    Policy(0).ClearStatistics();
+    for (unsigned int i = 0; i < Search().NumberThreads(); ++i)
+        Policy(i).ClearStatistics();
+}
+
+/** Write timing profile of the stages of the playout policy.
+    Arguments: none <br>
+    Needs enabling the profiling with
+    <code>uct_param_policy profile_interval</code>
+    The profiles of the policies of all threads are merged. Times are in
+    ticks of SgTime::Ticks(). Use uct_stat_policy_clear to clear the
+    profiles.
+    @see GoUctPlayoutPolicyProfile */
+void GoUctCommands::CmdStatPolicyProfile(GtpCommand& cmd)
+{
+    cmd.CheckArgNone();
+    if (Player().m_playoutPolicyParam.m_profileInterval <= 0)
+        SgWarning() << "profiling not enabled in policy parameters\n";
+    GoUctPlayoutPolicyProfile profile;
+    profile.Clear();
+    for (unsigned int i = 0; i < Search().NumberThreads(); ++i)
+        profile.Add(Policy(i).Profile());
+    profile.Write(cmd);
 }
 
 /** Write statistics of search and tree.
@@ -1253,7 +1418,7 @@ SgUctValue GoUctCommands::DisplayTerritory(GtpCommand& cmd,
 {
     cmd.CheckArgNone();
     SgPointArray<SgUctStatistics> territoryStatistics
-        = ThreadState(0).m_territoryStatistics;
+        = ThreadState(0).TerritoryStatistics();
     SgPointArray<SgUctValue> array;
     SgUctValue sum = SgUctValue(0);
     for (GoBoard::Iterator it(m_bd); it; ++it)
@@ -1274,7 +1439,7 @@ SgUctValue GoUctCommands::DisplayTerritory(GtpCommand& cmd,
  Statistics are only collected, if enabled with
  <code>uct_param_global_search territory_statistics 1</code>. <br>
  Arguments: none
- @see GoUctGlobalSearchState::m_territoryStatistics */
+ @see GoUctGlobalSearchState::TerritoryStatistics */
 void GoUctCommands::CmdStatTerritory(GtpCommand& cmd)
 {
     DisplayTerritory(cmd, MapMeanToTerritoryEstimate);
@@ -1440,7 +1605,7 @@ SgPointSet GoUctCommands::DoFinalStatusSearch()
     m_player->UpdateSubscriber();
 
     SgPointArray<SgUctStatistics> territoryStatistics =
-        ThreadState(0).m_territoryStatistics;
+        ThreadState(0).TerritoryStatistics();
     GoSafetySolver safetySolver(bd);
     SgBWSet safe;
     safetySolver.FindSafePoints(&safe);
@@ -1516,11 +1681,15 @@ void GoUctCommands::Register(GtpEngine& e)
              &GoUctCommands::CmdIsPolicyMove);
     Register(e, "uct_additive_knowledge",
              &GoUctCommands::CmdAdditiveKnowledge);
+    Register(e, "uct_benchmark_knowledge",
+             &GoUctCommands::CmdBenchmarkKnowledge);
     Register(e, "uct_bounds", &GoUctCommands::CmdBounds);
     Register(e, "uct_default_policy", &GoUctCommands::CmdDefaultPolicy);
     Register(e, "uct_estimator_stat", &GoUctCommands::CmdEstimatorStat);
     Register(e, "uct_gfx", &GoUctCommands::CmdGfx);
     Register(e, "uct_ladder_knowledge", &GoUctCommands::CmdLadderKnowledge);
+    Register(e, "uct_load_pattern_gammas",
+             &GoUctCommands::CmdLoadPatternGammas);
     Register(e, "uct_max_memory", &GoUctCommands::CmdMaxMemory);
     Register(e, "uct_moves", &GoUctCommands::CmdMoves);
     Register(e, "uct_param_globalsearch",
@@ -1545,6 +1714,8 @@ void GoUctCommands::Register(GtpEngine& e)
     Register(e, "uct_stat_player_clear", &GoUctCommands::CmdStatPlayerClear);
     Register(e, "uct_stat_policy", &GoUctCommands::CmdStatPolicy);
     Register(e, "uct_stat_policy_clear", &GoUctCommands::CmdStatPolicyClear);
+    Register(e, "uct_stat_policy_profile",
+             &GoUctCommands::CmdStatPolicyProfile);
     Register(e, "uct_stat_search", &GoUctCommands::CmdStatSearch);
     Register(e, "uct_stat_territory", &GoUctCommands::CmdStatTerritory);
     Register(e, "uct_value", &GoUctCommands::CmdValue);
@@ -53,6 +53,7 @@ public:
         - @link CmdFinalScore() @c final_score @endlink
         - @link CmdFinalStatusList() @c final_status_list @endlink
         - @link CmdAdditiveKnowledge() @c uct_additive_knowledge @endlink
+        - @link CmdBenchmarkKnowledge() @c uct_benchmark_knowledge @endlink
         - @link CmdBounds() @c uct_bounds @endlink
         - @link CmdDefaultPolicy() @c uct_default_policy @endlink
         - @link CmdDeterministicMode() @c deterministic_mode @endlink
@@ -61,6 +62,7 @@ public:
         - @link CmdIsPolicyCorrectedMove() @c is_policy_corrected_move
           @endlink
         - @link CmdLadderKnowledge() @c uct_ladder_knowledge @endlink
+        - @link CmdLoadPatternGammas() @c uct_load_pattern_gammas @endlink
         - @link CmdMaxMemory() @c uct_max_memory @endlink
         - @link CmdMoves() @c uct_moves @endlink
         - @link CmdParamGlobalSearch() @c uct_param_globalsearch @endlink
@@ -84,6 +86,7 @@ public:
         - @link CmdStatPlayerClear() @c uct_stat_player_clear @endlink
         - @link CmdStatPolicy() @c uct_stat_policy @endlink
         - @link CmdStatPolicyClear() @c uct_stat_policy_clear @endlink
+        - @link CmdStatPolicyProfile() @c uct_stat_policy_profile @endlink
         - @link CmdStatSearch() @c uct_stat_search @endlink
         - @link CmdStatTerritory() @c uct_stat_territory @endlink
         - @link CmdValue() @c uct_value @endlink
@@ -93,6 +96,7 @@ public:
     // The callback functions are documented in the cpp file
     void CmdAdditiveKnowledge(GtpCommand& cmd);
     void CmdApproximateTerritory(GtpCommand& cmd);
+    void CmdBenchmarkKnowledge(GtpCommand& cmd);
     void CmdBounds(GtpCommand& cmd);
     void CmdDefaultPolicy(GtpCommand& cmd);
     void CmdDeterministicMode(GtpCommand&);
@@ -103,6 +107,7 @@ public:
     void CmdIsPolicyCorrectedMove(GtpCommand& cmd);
     void CmdIsPolicyMove(GtpCommand& cmd);
     void CmdLadderKnowledge(GtpCommand& cmd);
+    void CmdLoadPatternGammas(GtpCommand& cmd);
     void CmdMaxMemory(GtpCommand& cmd);
     void CmdMoves(GtpCommand& cmd);
     void CmdParamGlobalSearch(GtpCommand& cmd);
@@ -125,6 +130,7 @@ public:
     void CmdStatPlayerClear(GtpCommand& cmd);
     void CmdStatPolicy(GtpCommand& cmd);
     void CmdStatPolicyClear(GtpCommand& cmd);
+    void CmdStatPolicyProfile(GtpCommand& cmd);
     void CmdStatSearch(GtpCommand& cmd);
     void CmdStatTerritory(GtpCommand& cmd);
     void CmdValue(GtpCommand& cmd);
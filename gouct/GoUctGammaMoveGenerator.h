@@ -7,6 +7,7 @@
 
 #include <iostream>
 #include "GoBoardUtil.h"
+#include "GoUctGeneratePointCache.h"
 #include "GoUctPatterns.h"
 #include "GoUctUtil.h"
 #include "SgWrite.h"
@@ -18,7 +19,8 @@ public:
     GoUctGammaMoveGenerator(const BOARD& bd,
             float patternGammaThreshold,
             GoUctPatterns<BOARD>& patterns,
-            SgRandom& randomGenerator);
+            SgRandom& randomGenerator,
+            GoUctGeneratePointCache<BOARD>& generatePointCache);
 
     /** Generate move with probability according to gamma values */
     SgPoint GenerateBiasedPatternMove();
@@ -53,6 +55,8 @@ private:
     GoPointList m_moves; 
     
     SgRandom& m_random;
+
+    GoUctGeneratePointCache<BOARD>& m_generatePointCache;
     
     /** gamma values for each pattern move */
     SgArrayList<float, SG_MAX_ONBOARD + 1> m_gammas; 
@@ -61,7 +65,7 @@ private:
         m_gammasSums[i] = sum(m_gammas[0....i]) */
     SgArrayList<float,SG_MAX_ONBOARD + 1> m_gammaSums; 
     
-    /** subset of m_moves, filtered by GoUctUtil::GeneratePoint */
+    /** subset of m_moves, filtered by GoUctGeneratePointCache::GeneratePoint */
     GoPointList m_movesGammas; 
 };
 
@@ -96,11 +100,13 @@ GoUctGammaMoveGenerator<BOARD>::GoUctGammaMoveGenerator(
                                     const BOARD& bd,
                                     float patternGammaThreshold,
                                     GoUctPatterns<BOARD>& patterns, 
-                                    SgRandom& random) 
+                                    SgRandom& random,
+                          GoUctGeneratePointCache<BOARD>& generatePointCache)
 	: m_bd(bd),
         m_patternGammaThreshold(patternGammaThreshold),
       m_patterns(patterns),
-      m_random(random)
+      m_random(random),
+      m_generatePointCache(generatePointCache)
 { }
 
 template<class BOARD>
@@ -138,7 +144,7 @@ bool GoUctGammaMoveGenerator<BOARD>::GenerateAllPatternMoves()
     for (int i = 0; i < m_moves.Length(); ++i)
     {
         const SgPoint p = m_moves[i];
-        if (! GoUctUtil::GeneratePoint(m_bd, p, m_bd.ToPlay()))
+        if (! m_generatePointCache.GeneratePoint(p))
             continue;
         m_movesGammas.PushBack(p);
         if (m_gammas[i] > m_patternGammaThreshold)
@@ -159,7 +165,7 @@ inline void GoUctGammaMoveGenerator<BOARD>::GeneratePatternMove(SgPoint p)
     float gamma = 0;
     if (  m_bd.IsEmpty(p)
        && m_patterns.MatchAny(p, gamma)
-       && ! GoBoardUtil::SelfAtari(m_bd, p)
+       && ! m_generatePointCache.SelfAtari(p)
        )
     {
         m_moves.PushBack(p);
@@ -175,7 +181,7 @@ inline void GoUctGammaMoveGenerator<BOARD>::GeneratePatternMove2(SgPoint p,
     if (  m_bd.IsEmpty(p)
        && ! SgPointUtil::In8Neighborhood(lastMove, p)
        && m_patterns.MatchAny(p, gamma)
-       && ! GoBoardUtil::SelfAtari(m_bd, p)
+       && ! m_generatePointCache.SelfAtari(p)
        )
     {
         m_moves.PushBack(p);
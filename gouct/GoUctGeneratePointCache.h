@@ -0,0 +1,208 @@
+//----------------------------------------------------------------------------
+/** @file GoUctGeneratePointCache.h */
+//----------------------------------------------------------------------------
+
+#ifndef GOUCT_GENERATEPOINTCACHE_H
+#define GOUCT_GENERATEPOINTCACHE_H
+
+#include "GoBoardUtil.h"
+#include "GoUctUtil.h"
+#include "SgArray.h"
+
+//----------------------------------------------------------------------------
+
+/** Cache for the results of GoUctUtil::GeneratePoint() and
+    GoBoardUtil::SelfAtari() in the playout policy.
+    The playout policy tests the same candidate points repeatedly: pattern
+    moves are checked for self-atari and again with GeneratePoint(), and the
+    pure random generator retests the same rejected points (eyes,
+    self-ataris) at each move. The cache stores the results per point and
+    color and keeps them valid across moves of a playout.
+
+    The results for an empty point only depend on the colors of its
+    neighbors, on the stones and liberties of its neighbor blocks, and on
+    the ko point. OnPlay() therefore invalidates the liberties of the block
+    of the last move, of the opponent blocks adjacent to it, and of the
+    blocks adjacent to captured stones, as well as the captured stones and
+    the previous ko point. All other entries stay valid.
+
+    Results are only valid for the color to play on the board. OnPlay() must
+    be called after each move played on the board, otherwise Start() must be
+    called before the next query. */
+template<class BOARD>
+class GoUctGeneratePointCache
+{
+public:
+    GoUctGeneratePointCache(const BOARD& bd);
+
+    /** Enable or disable the cache.
+        If disabled, all queries are computed on the board. Default is
+        enabled. */
+    void SetEnabled(bool enable);
+
+    /** Invalidate all entries. */
+    void Start();
+
+    /** Update the cache after a move was played on the board. */
+    void OnPlay();
+
+    /** Cached version of GoUctUtil::GeneratePoint() for the color to play.
+        @param p An empty point. */
+    bool GeneratePoint(SgPoint p);
+
+    /** Cached version of GoBoardUtil::SelfAtari() for the color to play.
+        @param p An empty point. */
+    bool SelfAtari(SgPoint p);
+
+private:
+    /** Bits of an entry for Black; the bits for White are shifted by
+        WHITE_SHIFT. */
+    enum
+    {
+        KNOWN_GENERATE = 1,
+
+        GENERATE = 2,
+
+        KNOWN_SELF_ATARI = 4,
+
+        SELF_ATARI = 8,
+
+        WHITE_SHIFT = 4
+    };
+
+    const BOARD& m_bd;
+
+    bool m_enabled;
+
+    /** Single captured stone of the last move.
+        Potential ko point, the legality of which changes with the next
+        move. */
+    SgPoint m_koCandidate;
+
+    SgArray<unsigned char, SG_MAXPOINT> m_entry;
+
+    /** Blocks whose liberties are invalidated in OnPlay().
+        Member to avoid a large array on the stack. */
+    GoPointList m_anchors;
+
+    void InvalidateLiberties(SgPoint block);
+
+    static int Shift(SgBlackWhite c);
+};
+
+template<class BOARD>
+GoUctGeneratePointCache<BOARD>::GoUctGeneratePointCache(const BOARD& bd)
+    : m_bd(bd),
+      m_enabled(true),
+      m_koCandidate(SG_NULLPOINT)
+{
+    m_entry.Fill(0);
+}
+
+template<class BOARD>
+bool GoUctGeneratePointCache<BOARD>::GeneratePoint(SgPoint p)
+{
+    const SgBlackWhite toPlay = m_bd.ToPlay();
+    if (! m_enabled)
+        return GoUctUtil::GeneratePoint(m_bd, p, toPlay);
+    const int shift = Shift(toPlay);
+    unsigned char& entry = m_entry[p];
+    if ((entry & (KNOWN_GENERATE << shift)) == 0)
+    {
+        if (GoUctUtil::GeneratePoint(m_bd, p, toPlay))
+            entry |= static_cast<unsigned char>(
+                                     (KNOWN_GENERATE | GENERATE) << shift);
+        else
+            entry |= static_cast<unsigned char>(KNOWN_GENERATE << shift);
+    }
+    SG_ASSERT(  ((entry & (GENERATE << shift)) != 0)
+             == GoUctUtil::GeneratePoint(m_bd, p, toPlay));
+    return (entry & (GENERATE << shift)) != 0;
+}
+
+template<class BOARD>
+void GoUctGeneratePointCache<BOARD>::InvalidateLiberties(SgPoint block)
+{
+    for (typename BOARD::LibertyIterator it(m_bd, block); it; ++it)
+        m_entry[*it] = 0;
+}
+
+template<class BOARD>
+void GoUctGeneratePointCache<BOARD>::OnPlay()
+{
+    if (! m_enabled)
+        return;
+    if (m_koCandidate != SG_NULLPOINT)
+    {
+        m_entry[m_koCandidate] = 0;
+        m_koCandidate = SG_NULLPOINT;
+    }
+    const SgPoint lastMove = m_bd.GetLastMove();
+    if (SgIsSpecialMove(lastMove))
+        return;
+    const SgBlackWhite color = m_bd.GetStone(lastMove);
+    m_anchors.Clear();
+    m_anchors.PushBack(m_bd.Anchor(lastMove));
+    for (GoNb4Iterator<BOARD> it(m_bd, lastMove); it; ++it)
+        if (m_bd.IsColor(*it, SgOppBW(color)))
+            m_anchors.Include(m_bd.Anchor(*it));
+    const GoPointList& captured = m_bd.CapturedStones();
+    if (! captured.IsEmpty())
+    {
+        for (GoPointList::Iterator it(captured); it; ++it)
+        {
+            m_entry[*it] = 0;
+            for (GoNb4Iterator<BOARD> it2(m_bd, *it); it2; ++it2)
+                if (m_bd.IsColor(*it2, color))
+                    m_anchors.Include(m_bd.Anchor(*it2));
+        }
+        if (captured.Length() == 1)
+            m_koCandidate = captured[0];
+    }
+    for (GoPointList::Iterator it(m_anchors); it; ++it)
+        InvalidateLiberties(*it);
+}
+
+template<class BOARD>
+bool GoUctGeneratePointCache<BOARD>::SelfAtari(SgPoint p)
+{
+    if (! m_enabled)
+        return GoBoardUtil::SelfAtari(m_bd, p);
+    const int shift = Shift(m_bd.ToPlay());
+    unsigned char& entry = m_entry[p];
+    if ((entry & (KNOWN_SELF_ATARI << shift)) == 0)
+    {
+        if (GoBoardUtil::SelfAtari(m_bd, p))
+            entry |= static_cast<unsigned char>(
+                                   (KNOWN_SELF_ATARI | SELF_ATARI) << shift);
+        else
+            entry |= static_cast<unsigned char>(KNOWN_SELF_ATARI << shift);
+    }
+    SG_ASSERT(  ((entry & (SELF_ATARI << shift)) != 0)
+             == GoBoardUtil::SelfAtari(m_bd, p));
+    return (entry & (SELF_ATARI << shift)) != 0;
+}
+
+template<class BOARD>
+void GoUctGeneratePointCache<BOARD>::SetEnabled(bool enable)
+{
+    m_enabled = enable;
+    Start();
+}
+
+template<class BOARD>
+inline int GoUctGeneratePointCache<BOARD>::Shift(SgBlackWhite c)
+{
+    return c == SG_BLACK ? 0 : WHITE_SHIFT;
+}
+
+template<class BOARD>
+void GoUctGeneratePointCache<BOARD>::Start()
+{
+    m_entry.Fill(0);
+    m_koCandidate = SG_NULLPOINT;
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GOUCT_GENERATEPOINTCACHE_H
@@ -9,6 +9,8 @@
 
 GoUctGlobalSearchStateParam::GoUctGlobalSearchStateParam()
     : m_mercyRule(true),
+      m_earlyCutoff(false),
+      m_earlyCutoffMargin(5),
       m_territoryStatistics(false),
       m_lengthModification(0),
       m_scoreModification(0.02f),
@@ -47,6 +47,24 @@ struct GoUctGlobalSearchStateParam
         exceeds a threshold of 30% of the total number of points on board. */
     bool m_mercyRule;
 
+    /** Stop playouts early, if a static estimate decides the result.
+        The estimate is an area count of stones and of empty points that
+        have only neighbors of one color (mainly single point eyes). Stones
+        in blocks with less than three liberties and the points next to them
+        are counted as undecided. The playout is stopped, if the absolute
+        estimated score (including komi) exceeds the number of undecided
+        points plus m_earlyCutoffMargin, and the estimated score is used as
+        the result of the playout. The estimate is only computed after every
+        fourth move and if at most 25% of the points on board are empty.
+        Not used if m_territoryStatistics is enabled, because territory
+        statistics need complete playouts. Default is false. */
+    bool m_earlyCutoff;
+
+    /** Safety margin in points for m_earlyCutoff.
+        Accounts for blocks that could still be captured, because the
+        estimate does not check if blocks are alive. Default is 5. */
+    int m_earlyCutoffMargin;
+
     /** Compute probabilities of territory in terminal positions. */
     bool m_territoryStatistics;
 
@@ -120,10 +138,6 @@ public:
 
     const SgPointArray<bool>& m_allSafe;
 
-    /** Probabilities that a point belongs to Black in a terminal position.
-        Only computed if GoUctGlobalSearchStateParam::m_territoryStatistics. */
-    SgPointArray<SgUctStatistics> m_territoryStatistics;
-
     /** Constructor.
         @param threadId The number of the thread. Needed for passing to
         constructor of SgUctThreadState.
@@ -181,6 +195,11 @@ public:
 
     void ClearTerritoryStatistics();
 
+    /** Probabilities that a point belongs to Black in a terminal position.
+        Only computed if GoUctGlobalSearchStateParam::m_territoryStatistics.
+        Points that are not on the board have a count of zero. */
+    SgPointArray<SgUctStatistics> TerritoryStatistics() const;
+
 private:
     const GoUctGlobalSearchStateParam& m_param;
 
@@ -201,6 +220,34 @@ private:
         Black counts positive. */
     int m_stoneDiff;
 
+    /** See GoUctGlobalSearchStateParam::m_earlyCutoff */
+    bool m_earlyCutoffTriggered;
+
+    /** Difference of stones on board including the stones played in the
+        playout phase.
+        Black counts positive. Unlike m_stoneDiff, which only counts
+        captures during the playout, this is the exact difference needed by
+        CheckEarlyCutoff(). */
+    int m_boardStoneDiff;
+
+    /** Estimated score from Black's view if m_earlyCutoffTriggered. */
+    float m_earlyCutoffScore;
+
+    /** Komi as returned by GetKomi() at the start of the search. */
+    float m_komi;
+
+    /** CheckEarlyCutoff() is only used if the number of empty points is
+        not larger than this value. */
+    int m_earlyCutoffMaxEmpty;
+
+    /** Number of the current call of CheckEarlyCutoff().
+        Used for marking blocks in m_weakBlockMark without clearing it. */
+    unsigned int m_earlyCutoffMark;
+
+    /** Anchors of blocks already counted by CheckEarlyCutoff() have the
+        value of m_earlyCutoffMark. */
+    SgPointArray<unsigned int> m_weakBlockMark;
+
     /** Board move number at root node of search. */
     int m_initialMoveNumber;
 
@@ -214,6 +261,18 @@ private:
         size. */
     SgUctValue m_invMaxScore;
 
+    /** Ownership of the points in the last evaluated terminal position.
+        See GoUctBoard::Ownership() */
+    SgArray<int,SG_MAXPOINT> m_ownership;
+
+    /** Sum of m_ownership + 1 over all terminal positions.
+        Kept as integers instead of SgUctStatistics to allow a vectorized
+        update. See TerritoryStatistics() */
+    SgArray<int,SG_MAXPOINT> m_territorySum;
+
+    /** Number of terminal positions added to m_territorySum. */
+    int m_nuTerritorySamples;
+
     SgRandom m_random;
 
     GoUctDefaultPriorKnowledge m_priorKnowledge;
@@ -236,9 +295,23 @@ private:
 
     bool CheckMercyRule();
 
+    /** See GoUctGlobalSearchStateParam::m_earlyCutoff */
+    bool CheckEarlyCutoff();
+
+    /** Add m_ownership to the territory statistics. */
+    void AddTerritoryStatistics(int boardSize);
+
     template<class BOARD>
     SgUctValue EvaluateBoard(const BOARD& bd, float komi);
 
+    /** Score a terminal position of the in-tree phase.
+        Also adds to the territory statistics, if enabled. */
+    float Score(const GoBoard& bd, float komi);
+
+    /** Score a terminal position of the playout phase.
+        Also adds to the territory statistics, if enabled. */
+    float Score(const GoUctBoard& bd, float komi);
+
     float GetKomi() const;
 };
 
@@ -255,11 +328,14 @@ GoUctGlobalSearchState<POLICY>::GoUctGlobalSearchState(unsigned int threadId,
       m_param(param),
       m_policyParam(policyParam),
       m_treeFilterParam(treeFilterParam),
+      m_earlyCutoffMark(0),
+      m_weakBlockMark(0),
       m_priorKnowledge(Board(), m_policyParam),
       m_additivePredictor(0),
       m_policy(policy),
       m_treeFilter(Board(), m_treeFilterParam)
 {
+    m_ownership.Fill(0);
     ClearTerritoryStatistics();
 }
 
@@ -291,6 +367,63 @@ bool GoUctGlobalSearchState<POLICY>::CheckMercyRule()
     return m_mercyRuleTriggered;
 }
 
+template<class POLICY>
+bool GoUctGlobalSearchState<POLICY>::CheckEarlyCutoff()
+{
+    SG_ASSERT(m_param.m_earlyCutoff);
+    SG_ASSERT(IsInPlayout());
+    const GoUctBoard& bd = UctBoard();
+    const int nuEmpty = bd.NumEmpty();
+    // The estimate is too expensive to compute after every move
+    if (nuEmpty > m_earlyCutoffMaxEmpty || GameLength() % 4 != 0)
+        return false;
+    // Blocks with less than three liberties are often captured before the
+    // end of a playout. Their stones and the empty points next to them are
+    // counted as undecided. Each block has a liberty, so all such blocks
+    // are found by looking at the neighbors of empty points.
+    int stoneDiff = m_boardStoneDiff;
+    int nuUndecided = 0;
+    ++m_earlyCutoffMark;
+    for (int i = 0; i < nuEmpty; ++i)
+    {
+        const SgPoint p = bd.EmptyPoint(i);
+        bool isOwned =
+            (  bd.NumEmptyNeighbors(p) == 0
+            && (  bd.NumNeighbors(p, SG_BLACK) == 0
+               || bd.NumNeighbors(p, SG_WHITE) == 0
+               )
+            );
+        for (GoNb4Iterator<GoUctBoard> it(bd, p); it; ++it)
+            if (bd.Occupied(*it) && bd.NumLiberties(*it) <= 2)
+            {
+                isOwned = false;
+                const SgPoint anchor = bd.Anchor(*it);
+                if (m_weakBlockMark[anchor] != m_earlyCutoffMark)
+                {
+                    m_weakBlockMark[anchor] = m_earlyCutoffMark;
+                    const int nuStones = bd.NumStones(anchor);
+                    nuUndecided += nuStones;
+                    if (bd.GetColor(anchor) == SG_BLACK)
+                        stoneDiff -= nuStones;
+                    else
+                        stoneDiff += nuStones;
+                }
+            }
+        if (! isOwned)
+            ++nuUndecided;
+        else if (bd.NumNeighbors(p, SG_WHITE) == 0)
+            ++stoneDiff;
+        else
+            --stoneDiff;
+    }
+    const float score = float(stoneDiff) - m_komi;
+    if (std::abs(score) <= float(nuUndecided + m_param.m_earlyCutoffMargin))
+        return false;
+    m_earlyCutoffTriggered = true;
+    m_earlyCutoffScore = score;
+    return true;
+}
+
 template<class POLICY>
 void GoUctGlobalSearchState<POLICY>::ApplyFilter(std::vector<SgUctMoveInfo>& moves)
 {
@@ -309,12 +442,29 @@ void GoUctGlobalSearchState<POLICY>::ApplyFilter(std::vector<SgUctMoveInfo>& mov
     }
 }
 
+template<class POLICY>
+void GoUctGlobalSearchState<POLICY>::AddTerritoryStatistics(int boardSize)
+{
+    // Blocks of 4 points with a fixed-size inner loop, such that compilers
+    // vectorize it without a scalar epilogue. Values added at points not on
+    // the board are ignored in TerritoryStatistics().
+    const int first = SgPointUtil::Pt(1, 1);
+    const int nuBlocks =
+        (SgPointUtil::Pt(boardSize, boardSize) - first + 4) / 4;
+    SG_ASSERT(first + 4 * nuBlocks <= SG_MAXPOINT);
+    const int* SG_RESTRICT ownership = &m_ownership[0];
+    int* SG_RESTRICT sum = &m_territorySum[0];
+    for (int p = first; p < first + 4 * nuBlocks; p += 4)
+        for (int i = 0; i < 4; ++i)
+            sum[p + i] += ownership[p + i] + 1;
+    ++m_nuTerritorySamples;
+}
+
 template<class POLICY>
 void GoUctGlobalSearchState<POLICY>::ClearTerritoryStatistics()
 {
-    for (SgPointArray<SgUctStatistics>::NonConstIterator
-             it(m_territoryStatistics); it; ++it)
-        (*it).Clear();
+    m_territorySum.Fill(0);
+    m_nuTerritorySamples = 0;
 }
 
 template<class POLICY>
@@ -340,39 +490,15 @@ SgUctValue GoUctGlobalSearchState<POLICY>::EvaluateBoard(const BOARD& bd,
                                                          float komi)
 {
     SgUctValue score;
-    SgPointArray<SgEmptyBlackWhite> scoreBoard;
-    SgPointArray<SgEmptyBlackWhite>* scoreBoardPtr;
-    if (m_param.m_territoryStatistics)
-        scoreBoardPtr = &scoreBoard;
-    else
-        scoreBoardPtr = 0;
     if (m_param.m_mercyRule && m_mercyRuleTriggered)
         return m_mercyRuleResult;
-    else if (m_passMovesPlayoutPhase < 2)
-        // Two passes not in playout phase, see comment in GenerateAllMoves()
-        score = SgUctValue(
-                    GoBoardUtil::TrompTaylorScore(bd, komi, scoreBoardPtr));
-    else
+    else if (m_earlyCutoffTriggered)
     {
-        score = SgUctValue(
-                    GoBoardUtil::ScoreSimpleEndPosition(bd, komi, m_safe,
-                                                        false,
-                                                        scoreBoardPtr));
+        SG_ASSERT(! m_param.m_territoryStatistics);
+        score = SgUctValue(m_earlyCutoffScore);
     }
-    if (m_param.m_territoryStatistics)
-        for (typename BOARD::Iterator it(bd); it; ++it)
-            switch (scoreBoard[*it])
-            {
-            case SG_BLACK:
-                m_territoryStatistics[*it].Add(1);
-                break;
-            case SG_WHITE:
-                m_territoryStatistics[*it].Add(0);
-                break;
-            case SG_EMPTY:
-                m_territoryStatistics[*it].Add(0.5);
-                break;
-            }
+    else
+        score = SgUctValue(Score(bd, komi));
     if (bd.ToPlay() != SG_BLACK)
         score *= -1;
     SgUctValue lengthMod =
@@ -394,15 +520,83 @@ SgUctValue GoUctGlobalSearchState<POLICY>::EvaluateBoard(const BOARD& bd,
         return 0.5;
 }
 
+template<class POLICY>
+float GoUctGlobalSearchState<POLICY>::Score(const GoBoard& bd, float komi)
+{
+    SgPointArray<SgEmptyBlackWhite> scoreBoard;
+    SgPointArray<SgEmptyBlackWhite>* scoreBoardPtr;
+    if (m_param.m_territoryStatistics)
+        scoreBoardPtr = &scoreBoard;
+    else
+        scoreBoardPtr = 0;
+    float score;
+    if (m_passMovesPlayoutPhase < 2)
+        // Two passes not in playout phase, see comment in GenerateAllMoves()
+        score = GoBoardUtil::TrompTaylorScore(bd, komi, scoreBoardPtr);
+    else
+        score = GoBoardUtil::ScoreSimpleEndPosition(bd, komi, m_safe, false,
+                                                    scoreBoardPtr);
+    if (m_param.m_territoryStatistics)
+    {
+        m_ownership.Fill(0);
+        for (GoBoard::Iterator it(bd); it; ++it)
+            switch (scoreBoard[*it])
+            {
+            case SG_BLACK:
+                m_ownership[*it] = 1;
+                break;
+            case SG_WHITE:
+                m_ownership[*it] = -1;
+                break;
+            }
+        AddTerritoryStatistics(bd.Size());
+    }
+    return score;
+}
+
+template<class POLICY>
+float GoUctGlobalSearchState<POLICY>::Score(const GoUctBoard& bd, float komi)
+{
+    // Two passes in the playout phase guarantee that only single point
+    // eyes are left, see GeneratePlayoutMove()
+    const bool floodFill = (m_passMovesPlayoutPhase < 2);
+    int score = bd.Ownership(m_ownership, floodFill);
+    if (! floodFill)
+        for (SgBWIterator itColor; itColor; ++itColor)
+        {
+            const SgBlackWhite c = *itColor;
+            const int value = (c == SG_BLACK ? 1 : -1);
+            if (! m_safe[c].IsEmpty())
+                for (SgSetIterator it(m_safe[c]); it; ++it)
+                {
+                    score += value - m_ownership[*it];
+                    m_ownership[*it] = value;
+                }
+        }
+    if (m_param.m_territoryStatistics)
+        AddTerritoryStatistics(bd.Size());
+    return float(score) - komi;
+}
+
 template<class POLICY>
 void GoUctGlobalSearchState<POLICY>::ExecutePlayout(SgMove move)
 {
     GoUctState::ExecutePlayout(move);
     const GoUctBoard& bd = UctBoard();
     if (bd.ToPlay() == SG_BLACK)
+    {
         m_stoneDiff -= bd.NuCapturedStones();
+        m_boardStoneDiff -= bd.NuCapturedStones();
+        if (move != SG_PASS)
+            --m_boardStoneDiff;
+    }
     else
+    {
         m_stoneDiff += bd.NuCapturedStones();
+        m_boardStoneDiff += bd.NuCapturedStones();
+        if (move != SG_PASS)
+            ++m_boardStoneDiff;
+    }
     m_policy->OnPlay();
 }
 
@@ -412,6 +606,7 @@ void GoUctGlobalSearchState<POLICY>::GameStart()
     GoUctState::GameStart();
     m_passMovesPlayoutPhase = 0;
     m_mercyRuleTriggered = false;
+    m_earlyCutoffTriggered = false;
 }
 
 template<class POLICY>
@@ -530,6 +725,11 @@ SgMove GoUctGlobalSearchState<POLICY>::GeneratePlayoutMove(
     SG_ASSERT(IsInPlayout());
     if (m_param.m_mercyRule && CheckMercyRule())
         return SG_NULLMOVE;
+    if (  m_param.m_earlyCutoff
+       && ! m_param.m_territoryStatistics
+       && CheckEarlyCutoff()
+       )
+        return SG_NULLMOVE;
     SgPoint move = m_policy->GenerateMove();
     SG_ASSERT(move != SG_NULLMOVE);
 #ifndef NDEBUG
@@ -576,6 +776,20 @@ float GoUctGlobalSearchState<POLICY>::GetKomi() const
     return komi;
 }
 
+template<class POLICY>
+SgPointArray<SgUctStatistics>
+GoUctGlobalSearchState<POLICY>::TerritoryStatistics() const
+{
+    SgPointArray<SgUctStatistics> result;
+    if (m_nuTerritorySamples == 0)
+        return result;
+    const SgUctValue count = SgUctValue(m_nuTerritorySamples);
+    for (GoBoard::Iterator it(Board()); it; ++it)
+        result[*it].Initialize(SgUctValue(m_territorySum[*it]) / (2 * count),
+                               count);
+    return result;
+}
+
 template<class POLICY>
 inline POLICY* GoUctGlobalSearchState<POLICY>::Policy()
 {
@@ -594,8 +808,10 @@ void GoUctGlobalSearchState<POLICY>::StartPlayout()
     GoUctState::StartPlayout();
     m_passMovesPlayoutPhase = 0;
     m_mercyRuleTriggered = false;
+    m_earlyCutoffTriggered = false;
     const GoBoard& bd = Board();
     m_stoneDiff = bd.All(SG_BLACK).Size() - bd.All(SG_WHITE).Size();
+    m_boardStoneDiff = m_stoneDiff;
     m_policy->StartPlayout();
 }
 
@@ -613,8 +829,10 @@ void GoUctGlobalSearchState<POLICY>::StartSearch()
     const int size = bd.Size();
     const float maxScore = float(size * size) + std::abs(GetKomi());
     m_invMaxScore = SgUctValue(1 / maxScore);
+    m_komi = GetKomi();
     m_initialMoveNumber = bd.MoveNumber();
     m_mercyRuleThreshold = static_cast<int>(0.3 * size * size);
+    m_earlyCutoffMaxEmpty = static_cast<int>(0.25 * size * size);
     ClearTerritoryStatistics();
 }
 
@@ -804,7 +1022,7 @@ void GoUctGlobalSearch<POLICY,FACTORY>::DisplayGfx()
             dynamic_cast<GoUctGlobalSearchState<POLICY>&>(ThreadState(0));
         SgDebug() << "gogui-gfx:\n";
         GoUctUtil::GfxBestMove(*this, ToPlay(), SgDebug());
-        GoUctUtil::GfxTerritoryStatistics(state.m_territoryStatistics,
+        GoUctUtil::GfxTerritoryStatistics(state.TerritoryStatistics(),
                                           Board(), SgDebug());
         GoUctUtil::GfxStatus(*this, SgDebug());
         SgDebug() << '\n';
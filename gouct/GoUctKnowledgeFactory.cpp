@@ -7,29 +7,42 @@
 #include "SgSystem.h"
 #include "GoUctKnowledgeFactory.h"
 
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 #include "GoUctAdditiveKnowledge.h"
 #include "GoUctAdditiveKnowledgeFuego.h"
 #include "GoUctAdditiveKnowledgeGreenpeep.h"
 #include "GoUctAdditiveKnowledgeMultiple.h"
 
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Protects the creation of s_greenpeepParam.
+    Engines can be created in several threads at the same time. */
+boost::mutex s_greenpeepMutex;
+
+boost::scoped_ptr<const GoUctAdditiveKnowledgeParamGreenpeep>
+    s_greenpeepParam;
+
+} // namespace
+
 //----------------------------------------------------------------------------
 GoUctKnowledgeFactory::GoUctKnowledgeFactory(
     const GoUctPlayoutPolicyParam& param) :
-    m_greenpeepParam(0),
     m_param(param)
 { }
 
 GoUctKnowledgeFactory::~GoUctKnowledgeFactory()
-{
-	if (m_greenpeepParam)
-    	delete m_greenpeepParam;
-}
+{ }
 
-GoUctAdditiveKnowledgeParamGreenpeep& GoUctKnowledgeFactory::GreenpeepParam()
+const GoUctAdditiveKnowledgeParamGreenpeep&
+GoUctKnowledgeFactory::GreenpeepParam()
 {
-	if (! m_greenpeepParam)
-    	m_greenpeepParam = new GoUctAdditiveKnowledgeParamGreenpeep();
-    return *m_greenpeepParam;
+    boost::mutex::scoped_lock lock(s_greenpeepMutex);
+    if (! s_greenpeepParam)
+        s_greenpeepParam.reset(new GoUctAdditiveKnowledgeParamGreenpeep());
+    return *s_greenpeepParam;
 }
 
 GoUctAdditiveKnowledge* GoUctKnowledgeFactory::Create(const GoBoard& bd)
@@ -19,11 +19,14 @@ public:
 
     GoUctAdditiveKnowledge* Create(const GoBoard& bd);
 
-    GoUctAdditiveKnowledgeParamGreenpeep& GreenpeepParam();
+    /** The Greenpeep pattern values.
+        The tables are large (160 MB) and only depend on
+        GoUctPatternDatabase::Global(), so they are created once at the
+        first call and shared by all factories of the process, for example
+        by the players of several games in the server mode of Fuego. */
+    static const GoUctAdditiveKnowledgeParamGreenpeep& GreenpeepParam();
 
 private:
-    GoUctAdditiveKnowledgeParamGreenpeep* m_greenpeepParam; 
-
     /** The param used for additive knowledge */
     const GoUctPlayoutPolicyParam& m_param;
 };
@@ -0,0 +1,54 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPatternData.cpp
+    See GoUctPatternData.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoUctPatternData.h"
+
+#ifndef DISABLE_BUILTIN_PATTERNS
+#include "GoUctGlobalPatternData.h"
+#include "GoUctLocalPatternData.h"
+#endif
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+#ifdef DISABLE_BUILTIN_PATTERNS
+
+const GoUctPatternData::PatternTable EMPTY_TABLE = { 0, 0 };
+
+const GoUctPatternData::BWTable EMPTY_BW_TABLE(EMPTY_TABLE, EMPTY_TABLE);
+
+const GoUctPatternData::PatternData EMPTY_DATA =
+{
+    EMPTY_BW_TABLE,
+    EMPTY_BW_TABLE
+};
+
+#endif
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+const GoUctPatternData::PatternData& GoUctPatternData::BuiltinGlobalData()
+{
+#ifdef DISABLE_BUILTIN_PATTERNS
+    return EMPTY_DATA;
+#else
+    return GoUctGlobalPatternData::gData;
+#endif
+}
+
+const GoUctPatternData::PatternData& GoUctPatternData::BuiltinLocalData()
+{
+#ifdef DISABLE_BUILTIN_PATTERNS
+    return EMPTY_DATA;
+#else
+    return GoUctLocalPatternData::gData;
+#endif
+}
+
+//----------------------------------------------------------------------------
@@ -31,6 +31,16 @@ typedef struct
 	BWTable m_centerPatterns;
 } PatternData;
 
+/** Gamma values of the local patterns compiled into the program.
+    Defined in GoUctPatternData.cpp, such that the machine-generated data in
+    GoUctLocalPatternData.h is compiled only once. Empty, if the program was
+    configured with --disable-builtin-patterns. */
+const PatternData& BuiltinLocalData();
+
+/** Gamma values of the global patterns compiled into the program.
+    See BuiltinLocalData() */
+const PatternData& BuiltinGlobalData();
+
 } // namespace GoUctPatternData
 
 #endif // GOUCT_PATTERNDATA_H
@@ -0,0 +1,394 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPatternDatabase.cpp
+    See GoUctPatternDatabase.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoUctPatternDatabase.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <boost/crc.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "GoUctAdditiveKnowledgeGreenpeep.h"
+#include "SgException.h"
+
+using boost::uint16_t;
+using boost::uint32_t;
+using boost::interprocess::file_mapping;
+using boost::interprocess::interprocess_exception;
+using boost::interprocess::mapped_region;
+using boost::interprocess::read_only;
+using GoUctPatternData::PatternTable;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+const char MAGIC[4] = { 'F', 'P', 'D', 'B' };
+
+const uint32_t FORMAT_VERSION = 1;
+
+const std::size_t HEADER_SIZE = 16;
+
+const std::size_t DIRECTORY_ENTRY_SIZE = 16;
+
+/** Number of tables in a gamma section. */
+const int NU_GAMMA_TABLES = 4;
+
+bool IsLittleEndian()
+{
+    const uint32_t one = 1;
+    unsigned char firstByte;
+    std::memcpy(&firstByte, &one, 1);
+    return firstByte == 1;
+}
+
+uint32_t Crc32(const unsigned char* data, std::size_t size)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(data, size);
+    return crc.checksum();
+}
+
+uint32_t GetUInt32(const unsigned char* data)
+{
+    return   uint32_t(data[0])
+          | (uint32_t(data[1]) << 8)
+          | (uint32_t(data[2]) << 16)
+          | (uint32_t(data[3]) << 24);
+}
+
+void PutUInt16(std::string& buffer, uint16_t value)
+{
+    buffer += static_cast<char>(value & 0xff);
+    buffer += static_cast<char>(value >> 8);
+}
+
+void PutUInt32(std::string& buffer, uint32_t value)
+{
+    buffer += static_cast<char>(value & 0xff);
+    buffer += static_cast<char>((value >> 8) & 0xff);
+    buffer += static_cast<char>((value >> 16) & 0xff);
+    buffer += static_cast<char>(value >> 24);
+}
+
+/** Size of a section in bytes. */
+std::size_t SectionSize(GoUctPatternDatabase::SectionType type,
+                        std::size_t nuEntries)
+{
+    switch (type)
+    {
+    case GoUctPatternDatabase::SECTION_GREENPEEP_9:
+    case GoUctPatternDatabase::SECTION_GREENPEEP_19:
+        return nuEntries * (sizeof(uint32_t) + sizeof(uint16_t));
+    default:
+        return NU_GAMMA_TABLES * sizeof(uint32_t) + nuEntries * 8;
+    }
+}
+
+/** Number of valid entries of a pattern table.
+    The compiled tables can contain entries with code -1, which are
+    ignored by GoUctPatterns. */
+int NuValidEntries(const PatternTable& table)
+{
+    int n = 0;
+    for (int i = 0; i < table.m_nuPatterns; ++i)
+        if (table.m_patternArray[i].m_code >= 0)
+            ++n;
+    return n;
+}
+
+void AppendGammaTable(std::string& buffer, const PatternTable& table)
+{
+    PutUInt32(buffer, NuValidEntries(table));
+    for (int i = 0; i < table.m_nuPatterns; ++i)
+    {
+        const GoUctPatternData::PatternTableEntry& entry =
+            table.m_patternArray[i];
+        if (entry.m_code < 0)
+            continue;
+        PutUInt32(buffer, entry.m_code);
+        uint32_t bits;
+        std::memcpy(&bits, &entry.m_value, sizeof(bits));
+        PutUInt32(buffer, bits);
+    }
+}
+
+/** Append a gamma section to a buffer.
+    @return The number of entries. */
+std::size_t AppendGammas(std::string& buffer,
+                         const GoUctPatternData::PatternData& data)
+{
+    AppendGammaTable(buffer, data.m_edgePatterns[SG_BLACK]);
+    AppendGammaTable(buffer, data.m_edgePatterns[SG_WHITE]);
+    AppendGammaTable(buffer, data.m_centerPatterns[SG_BLACK]);
+    AppendGammaTable(buffer, data.m_centerPatterns[SG_WHITE]);
+    return NuValidEntries(data.m_edgePatterns[SG_BLACK])
+        + NuValidEntries(data.m_edgePatterns[SG_WHITE])
+        + NuValidEntries(data.m_centerPatterns[SG_BLACK])
+        + NuValidEntries(data.m_centerPatterns[SG_WHITE]);
+}
+
+bool ContextLess(const GoUctPatternDatabase::GreenpeepEntry& entry1,
+                 const GoUctPatternDatabase::GreenpeepEntry& entry2)
+{
+    return entry1.m_context < entry2.m_context;
+}
+
+void AppendGreenpeep(std::string& buffer,
+          std::vector<GoUctPatternDatabase::GreenpeepEntry> entries)
+{
+    std::sort(entries.begin(), entries.end(), ContextLess);
+    for (std::size_t i = 0; i < entries.size(); ++i)
+        PutUInt32(buffer, entries[i].m_context);
+    for (std::size_t i = 0; i < entries.size(); ++i)
+        PutUInt16(buffer, entries[i].m_value);
+}
+
+int NuGammaPatterns(const GoUctPatternData::PatternData& data)
+{
+    return data.m_edgePatterns[SG_BLACK].m_nuPatterns
+        + data.m_edgePatterns[SG_WHITE].m_nuPatterns
+        + data.m_centerPatterns[SG_BLACK].m_nuPatterns
+        + data.m_centerPatterns[SG_WHITE].m_nuPatterns;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+GoUctPatternDatabase::GoUctPatternDatabase()
+{
+    Close();
+}
+
+GoUctPatternDatabase::~GoUctPatternDatabase()
+{ }
+
+void GoUctPatternDatabase::Close()
+{
+    m_fileName.clear();
+    m_region.reset();
+    m_greenpeep9.m_nuEntries = 0;
+    m_greenpeep9.m_contexts = 0;
+    m_greenpeep9.m_values = 0;
+    m_greenpeep19 = m_greenpeep9;
+    for (int i = 0; i < _NU_SECTION_TYPE; ++i)
+        m_hasSection[i] = false;
+    m_gammas[GoUctPatternGammaTable::TABLE_GLOBAL].Clear();
+    m_gammas[GoUctPatternGammaTable::TABLE_LOCAL].Clear();
+}
+
+const GoUctPatternGammaTable*
+GoUctPatternDatabase::Gammas(GoUctPatternGammaTable::TableType type) const
+{
+    const SectionType section = (type == GoUctPatternGammaTable::TABLE_LOCAL ?
+                                 SECTION_GAMMA_LOCAL : SECTION_GAMMA_GLOBAL);
+    return m_hasSection[section] ? &m_gammas[type] : 0;
+}
+
+GoUctPatternDatabase& GoUctPatternDatabase::Global()
+{
+    static GoUctPatternDatabase s_database;
+    return s_database;
+}
+
+const GoUctPatternDatabase::GreenpeepTable*
+GoUctPatternDatabase::Greenpeep(int boardSize) const
+{
+    if (boardSize < 15)
+        return m_hasSection[SECTION_GREENPEEP_9] ? &m_greenpeep9 : 0;
+    return m_hasSection[SECTION_GREENPEEP_19] ? &m_greenpeep19 : 0;
+}
+
+void GoUctPatternDatabase::Open(const std::string& fileName)
+{
+    Close();
+    if (! IsLittleEndian())
+        throw SgException("pattern database requires little-endian host");
+    try
+    {
+        file_mapping file(fileName.c_str(), read_only);
+        m_region.reset(new mapped_region(file, read_only));
+    }
+    catch (const interprocess_exception& e)
+    {
+        throw SgException("could not map " + fileName + ": " + e.what());
+    }
+    try
+    {
+        const unsigned char* data =
+            static_cast<const unsigned char*>(m_region->get_address());
+        const std::size_t size = m_region->get_size();
+        if (  size < HEADER_SIZE
+           || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0
+           )
+            throw SgException("not a pattern database");
+        if (GetUInt32(data + 4) != FORMAT_VERSION)
+            throw SgException("unknown pattern database version");
+        const std::size_t nuSections = GetUInt32(data + 8);
+        if (  nuSections > _NU_SECTION_TYPE
+           || HEADER_SIZE + nuSections * DIRECTORY_ENTRY_SIZE > size
+           )
+            throw SgException("invalid pattern database directory");
+        const unsigned char* directory = data + HEADER_SIZE;
+        if (  Crc32(directory, nuSections * DIRECTORY_ENTRY_SIZE)
+           != GetUInt32(data + 12)
+           )
+            throw SgException("pattern database directory checksum error");
+        for (std::size_t i = 0; i < nuSections; ++i)
+        {
+            const unsigned char* entry = directory + i * DIRECTORY_ENTRY_SIZE;
+            const uint32_t type = GetUInt32(entry);
+            const std::size_t nuEntries = GetUInt32(entry + 4);
+            const std::size_t offset = GetUInt32(entry + 8);
+            if (type >= _NU_SECTION_TYPE || m_hasSection[type])
+                throw SgException("invalid pattern database section");
+            const SectionType sectionType = static_cast<SectionType>(type);
+            const std::size_t sectionSize =
+                SectionSize(sectionType, nuEntries);
+            if (  offset % 4 != 0
+               || offset > size
+               || sectionSize > size - offset
+               )
+                throw SgException("truncated pattern database");
+            if (Crc32(data + offset, sectionSize) != GetUInt32(entry + 12))
+                throw SgException("pattern database checksum error");
+            ReadSection(sectionType, nuEntries, data + offset);
+            m_hasSection[type] = true;
+        }
+    }
+    catch (const SgException& e)
+    {
+        Close();
+        throw SgException(fileName + ": " + e.what());
+    }
+    m_fileName = fileName;
+}
+
+void GoUctPatternDatabase::ReadSection(SectionType type,
+                                       std::size_t nuEntries,
+                                       const unsigned char* data)
+{
+    if (type == SECTION_GREENPEEP_9 || type == SECTION_GREENPEEP_19)
+    {
+        GreenpeepTable& table =
+            (type == SECTION_GREENPEEP_9 ? m_greenpeep9 : m_greenpeep19);
+        const uint32_t maxContext = (type == SECTION_GREENPEEP_9 ?
+                                     NUMPATTERNS9X9 : NUMPATTERNS19X19);
+        // Section offsets are multiples of 4, so the arrays are aligned
+        table.m_nuEntries = nuEntries;
+        table.m_contexts = reinterpret_cast<const uint32_t*>(data);
+        table.m_values =
+            reinterpret_cast<const uint16_t*>(data + 4 * nuEntries);
+        for (std::size_t i = 0; i < nuEntries; ++i)
+            if (  table.m_contexts[i] >= maxContext
+               || (i > 0 && table.m_contexts[i] <= table.m_contexts[i - 1])
+               )
+                throw SgException("invalid Greenpeep context");
+        return;
+    }
+    GoUctPatternGammaTable& table =
+        m_gammas[type == SECTION_GAMMA_LOCAL ?
+                 GoUctPatternGammaTable::TABLE_LOCAL :
+                 GoUctPatternGammaTable::TABLE_GLOBAL];
+    table.Clear();
+    std::size_t nuRead = 0;
+    for (int i = 0; i < NU_GAMMA_TABLES; ++i)
+    {
+        const SgBlackWhite toPlay = (i % 2 == 0 ? SG_BLACK : SG_WHITE);
+        const bool isEdge = (i < 2);
+        const std::size_t n = GetUInt32(data);
+        data += 4;
+        if (n > nuEntries - nuRead)
+            throw SgException("invalid gamma table size");
+        for (std::size_t j = 0; j < n; ++j, data += 8)
+        {
+            const uint32_t code = GetUInt32(data);
+            const uint32_t bits = GetUInt32(data + 4);
+            float gamma;
+            std::memcpy(&gamma, &bits, sizeof(gamma));
+            if (  code >= uint32_t(isEdge ?
+                                   GoUctPatternGammaTable::NU_EDGE_CODES :
+                                   GoUctPatternGammaTable::NU_CENTER_CODES)
+               || ! (gamma >= 0) // Also catches NaN
+               )
+                throw SgException("invalid gamma table entry");
+            if (isEdge)
+                table.AddEdgePattern(toPlay, int(code), gamma);
+            else
+                table.AddCenterPattern(toPlay, int(code), gamma);
+        }
+        nuRead += n;
+    }
+    if (nuRead != nuEntries)
+        throw SgException("invalid gamma table size");
+}
+
+void GoUctPatternDatabase::Write(std::ostream& out,
+                         const std::vector<GreenpeepEntry>& greenpeep9,
+                         const std::vector<GreenpeepEntry>& greenpeep19,
+                         const GoUctPatternData::PatternData& gammaGlobal,
+                         const GoUctPatternData::PatternData& gammaLocal)
+{
+    std::vector<SectionType> types;
+    std::vector<std::size_t> nuEntries;
+    std::vector<std::string> sections;
+    if (! greenpeep9.empty())
+    {
+        types.push_back(SECTION_GREENPEEP_9);
+        nuEntries.push_back(greenpeep9.size());
+        sections.push_back(std::string());
+        AppendGreenpeep(sections.back(), greenpeep9);
+    }
+    if (! greenpeep19.empty())
+    {
+        types.push_back(SECTION_GREENPEEP_19);
+        nuEntries.push_back(greenpeep19.size());
+        sections.push_back(std::string());
+        AppendGreenpeep(sections.back(), greenpeep19);
+    }
+    if (NuGammaPatterns(gammaGlobal) > 0)
+    {
+        types.push_back(SECTION_GAMMA_GLOBAL);
+        sections.push_back(std::string());
+        nuEntries.push_back(AppendGammas(sections.back(), gammaGlobal));
+    }
+    if (NuGammaPatterns(gammaLocal) > 0)
+    {
+        types.push_back(SECTION_GAMMA_LOCAL);
+        sections.push_back(std::string());
+        nuEntries.push_back(AppendGammas(sections.back(), gammaLocal));
+    }
+    std::string directory;
+    std::size_t offset = HEADER_SIZE + sections.size() * DIRECTORY_ENTRY_SIZE;
+    for (std::size_t i = 0; i < sections.size(); ++i)
+    {
+        SG_ASSERT(sections[i].size() == SectionSize(types[i], nuEntries[i]));
+        // Pad sections to a multiple of 4 bytes to keep the arrays aligned
+        while (sections[i].size() % 4 != 0)
+            sections[i] += '\0';
+        PutUInt32(directory, types[i]);
+        PutUInt32(directory, uint32_t(nuEntries[i]));
+        PutUInt32(directory, uint32_t(offset));
+        PutUInt32(directory, Crc32(
+            reinterpret_cast<const unsigned char*>(sections[i].data()),
+            SectionSize(types[i], nuEntries[i])));
+        offset += sections[i].size();
+    }
+    std::string header(MAGIC, sizeof(MAGIC));
+    PutUInt32(header, FORMAT_VERSION);
+    PutUInt32(header, uint32_t(sections.size()));
+    PutUInt32(header, Crc32(
+        reinterpret_cast<const unsigned char*>(directory.data()),
+        directory.size()));
+    out << header << directory;
+    for (std::size_t i = 0; i < sections.size(); ++i)
+        out << sections[i];
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,181 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPatternDatabase.h */
+//----------------------------------------------------------------------------
+
+#ifndef GOUCT_PATTERNDATABASE_H
+#define GOUCT_PATTERNDATABASE_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/scoped_ptr.hpp>
+#include "GoUctPatternData.h"
+#include "GoUctPatternGammaTable.h"
+
+namespace boost {
+namespace interprocess {
+    class mapped_region;
+}
+}
+
+//----------------------------------------------------------------------------
+
+/** Pattern values of the Greenpeep knowledge and the playout patterns in a
+    memory-mapped binary file.
+    Alternative to the pattern tables compiled into the program
+    (GoUctGreenpeepPatterns19.h, GoUctLocalPatternData.h,
+    GoUctGlobalPatternData.h). If a database is opened with Global().Open(),
+    GoUctAdditiveKnowledgeParamGreenpeep and GoUctPatterns use its tables
+    instead of the compiled ones. If the program is configured with
+    --disable-builtin-patterns, the compiled tables are empty and the
+    database is the only source of pattern values.
+
+    The file is mapped read-only, such that the operating system reads only
+    the pages that are used and can share them between processes. Each
+    section has a CRC-32 checksum, which is verified by Open().
+
+    File format (all numbers 32-bit little-endian unless noted):
+    @verbatim
+    "FPDB"                          magic
+    version                         currently 1
+    n                               number of sections
+    crc                             checksum of the section directory
+    n * (type, nuEntries, offset, crc)
+                                    section directory, type is a
+                                    SectionType, offset is relative to the
+                                    start of the file and a multiple of 4
+    @endverbatim
+    Greenpeep sections contain nuEntries context indices in increasing
+    order, followed by nuEntries 16-bit values. Gamma sections contain four
+    tables (edge patterns Black and White to play, center patterns Black
+    and White to play), each consisting of the number of entries and the
+    entries as pairs of code and IEEE 754 single precision gamma. */
+class GoUctPatternDatabase
+{
+public:
+    enum SectionType
+    {
+        /** Greenpeep patterns for board sizes smaller than 15. */
+        SECTION_GREENPEEP_9,
+
+        /** Greenpeep patterns for board sizes 15 and larger. */
+        SECTION_GREENPEEP_19,
+
+        SECTION_GAMMA_GLOBAL,
+
+        SECTION_GAMMA_LOCAL,
+
+        _NU_SECTION_TYPE
+    };
+
+    /** Entry of a Greenpeep pattern table. */
+    struct GreenpeepEntry
+    {
+        boost::uint32_t m_context;
+
+        boost::uint16_t m_value;
+    };
+
+    /** Greenpeep pattern table in a database. */
+    struct GreenpeepTable
+    {
+        std::size_t m_nuEntries;
+
+        /** Context of each entry, in increasing order. */
+        const boost::uint32_t* m_contexts;
+
+        /** Value of each entry. */
+        const boost::uint16_t* m_values;
+    };
+
+    GoUctPatternDatabase();
+
+    ~GoUctPatternDatabase();
+
+    /** Map a database file.
+        Closes the current database first.
+        @throws SgException if the file cannot be mapped, has an invalid
+        format or a wrong checksum. */
+    void Open(const std::string& fileName);
+
+    void Close();
+
+    bool IsOpen() const;
+
+    /** Name of the database file or an empty string, if not open. */
+    const std::string& FileName() const;
+
+    /** Check if the database contains a section. */
+    bool HasSection(SectionType type) const;
+
+    /** Greenpeep table for a board size.
+        @return The table or 0, if the database has no table for the board
+        size. */
+    const GreenpeepTable* Greenpeep(int boardSize) const;
+
+    /** Gamma table of the playout patterns.
+        @return The table or 0, if the database has no table of this type. */
+    const GoUctPatternGammaTable*
+    Gammas(GoUctPatternGammaTable::TableType type) const;
+
+    /** Write a database.
+        Tables with no entries are omitted. The Greenpeep entries are sorted
+        by context, they must not contain a context twice. */
+    static void Write(std::ostream& out,
+                      const std::vector<GreenpeepEntry>& greenpeep9,
+                      const std::vector<GreenpeepEntry>& greenpeep19,
+                      const GoUctPatternData::PatternData& gammaGlobal,
+                      const GoUctPatternData::PatternData& gammaLocal);
+
+    /** Database used by GoUctAdditiveKnowledgeParamGreenpeep and
+        GoUctPatterns.
+        Must be opened before the first GoUctPlayer is created, it is not
+        thread-safe to open it during a search. */
+    static GoUctPatternDatabase& Global();
+
+private:
+    std::string m_fileName;
+
+    boost::scoped_ptr<boost::interprocess::mapped_region> m_region;
+
+    GreenpeepTable m_greenpeep9;
+
+    GreenpeepTable m_greenpeep19;
+
+    bool m_hasSection[_NU_SECTION_TYPE];
+
+    /** Gamma tables, copied from the file, because GoUctPatterns expects
+        an array of PatternTableEntry. Indexed by
+        GoUctPatternGammaTable::TableType. */
+    GoUctPatternGammaTable m_gammas[2];
+
+    /** Not implemented */
+    GoUctPatternDatabase(const GoUctPatternDatabase&);
+
+    /** Not implemented */
+    GoUctPatternDatabase& operator=(const GoUctPatternDatabase&);
+
+    void ReadSection(SectionType type, std::size_t nuEntries,
+                     const unsigned char* data);
+};
+
+inline const std::string& GoUctPatternDatabase::FileName() const
+{
+    return m_fileName;
+}
+
+inline bool GoUctPatternDatabase::HasSection(SectionType type) const
+{
+    return m_hasSection[type];
+}
+
+inline bool GoUctPatternDatabase::IsOpen() const
+{
+    return m_region.get() != 0;
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GOUCT_PATTERNDATABASE_H
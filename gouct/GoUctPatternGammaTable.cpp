@@ -0,0 +1,216 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPatternGammaTable.cpp
+    See GoUctPatternGammaTable.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoUctPatternGammaTable.h"
+
+#include <cstring>
+#include <fstream>
+#include <boost/cstdint.hpp>
+#include "SgException.h"
+
+using boost::shared_ptr;
+using boost::uint32_t;
+using GoUctPatternData::PatternTableEntry;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+const char MAGIC[4] = { 'F', 'G', 'A', 'M' };
+
+const int FORMAT_VERSION = 1;
+
+/** Tables set with GoUctPatternGammaTable::SetLoaded(), indexed by
+    GoUctPatternGammaTable::TableType. */
+shared_ptr<GoUctPatternGammaTable>& LoadedTable(
+                                     GoUctPatternGammaTable::TableType type)
+{
+    static shared_ptr<GoUctPatternGammaTable> s_tables[2];
+    return s_tables[type];
+}
+
+uint32_t ReadUInt32(std::istream& in)
+{
+    unsigned char bytes[4];
+    if (! in.read(reinterpret_cast<char*>(bytes), 4))
+        throw SgException("GoUctPatternGammaTable: unexpected end of file");
+    return   uint32_t(bytes[0])
+          | (uint32_t(bytes[1]) << 8)
+          | (uint32_t(bytes[2]) << 16)
+          | (uint32_t(bytes[3]) << 24);
+}
+
+void WriteUInt32(std::ostream& out, uint32_t value)
+{
+    unsigned char bytes[4];
+    bytes[0] = static_cast<unsigned char>(value);
+    bytes[1] = static_cast<unsigned char>(value >> 8);
+    bytes[2] = static_cast<unsigned char>(value >> 16);
+    bytes[3] = static_cast<unsigned char>(value >> 24);
+    out.write(reinterpret_cast<const char*>(bytes), 4);
+}
+
+void ReadPatterns(std::istream& in, int nuCodes,
+                  std::vector<PatternTableEntry>& patterns)
+{
+    const uint32_t nuPatterns = ReadUInt32(in);
+    if (nuPatterns > uint32_t(nuCodes))
+        throw SgException("GoUctPatternGammaTable: too many patterns");
+    patterns.resize(nuPatterns);
+    for (uint32_t i = 0; i < nuPatterns; ++i)
+    {
+        const uint32_t code = ReadUInt32(in);
+        if (code >= uint32_t(nuCodes))
+            throw SgException("GoUctPatternGammaTable: invalid code");
+        const uint32_t bits = ReadUInt32(in);
+        float gamma;
+        std::memcpy(&gamma, &bits, sizeof(gamma));
+        if (! (gamma >= 0)) // Also catches NaN
+            throw SgException("GoUctPatternGammaTable: invalid gamma");
+        patterns[i].m_code = int(code);
+        patterns[i].m_value = gamma;
+    }
+}
+
+void WritePatterns(std::ostream& out,
+                   const std::vector<PatternTableEntry>& patterns)
+{
+    WriteUInt32(out, uint32_t(patterns.size()));
+    for (std::vector<PatternTableEntry>::const_iterator it = patterns.begin();
+         it != patterns.end(); ++it)
+    {
+        WriteUInt32(out, uint32_t(it->m_code));
+        uint32_t bits;
+        std::memcpy(&bits, &it->m_value, sizeof(bits));
+        WriteUInt32(out, bits);
+    }
+}
+
+void SetTable(GoUctPatternData::PatternTable& table,
+              const std::vector<PatternTableEntry>& patterns)
+{
+    table.m_nuPatterns = int(patterns.size());
+    table.m_patternArray = patterns.empty() ? 0 : &patterns[0];
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+GoUctPatternGammaTable::GoUctPatternGammaTable()
+{ }
+
+void GoUctPatternGammaTable::AddCenterPattern(SgBlackWhite toPlay, int code,
+                                              float gamma)
+{
+    SG_ASSERT(code >= 0 && code < NU_CENTER_CODES);
+    PatternTableEntry entry;
+    entry.m_code = code;
+    entry.m_value = gamma;
+    m_centerPatterns[toPlay].push_back(entry);
+}
+
+void GoUctPatternGammaTable::AddEdgePattern(SgBlackWhite toPlay, int code,
+                                            float gamma)
+{
+    SG_ASSERT(code >= 0 && code < NU_EDGE_CODES);
+    PatternTableEntry entry;
+    entry.m_code = code;
+    entry.m_value = gamma;
+    m_edgePatterns[toPlay].push_back(entry);
+}
+
+void GoUctPatternGammaTable::Clear()
+{
+    for (SgBWIterator it; it; ++it)
+    {
+        m_edgePatterns[*it].clear();
+        m_centerPatterns[*it].clear();
+    }
+}
+
+const GoUctPatternData::PatternData& GoUctPatternGammaTable::Data() const
+{
+    for (SgBWIterator it; it; ++it)
+    {
+        SetTable(m_data.m_edgePatterns[*it], m_edgePatterns[*it]);
+        SetTable(m_data.m_centerPatterns[*it], m_centerPatterns[*it]);
+    }
+    return m_data;
+}
+
+const GoUctPatternGammaTable*
+GoUctPatternGammaTable::Loaded(TableType type)
+{
+    return LoadedTable(type).get();
+}
+
+int GoUctPatternGammaTable::NuPatterns() const
+{
+    int n = 0;
+    for (SgBWIterator it; it; ++it)
+        n += int(m_edgePatterns[*it].size() + m_centerPatterns[*it].size());
+    return n;
+}
+
+void GoUctPatternGammaTable::Read(std::istream& in)
+{
+    char magic[4];
+    if (  ! in.read(magic, 4)
+       || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0
+       )
+        throw SgException("GoUctPatternGammaTable: not a gamma table");
+    if (ReadUInt32(in) != uint32_t(FORMAT_VERSION))
+        throw SgException("GoUctPatternGammaTable: unknown version");
+    SgBWArray<std::vector<PatternTableEntry> > edgePatterns;
+    SgBWArray<std::vector<PatternTableEntry> > centerPatterns;
+    for (SgBWIterator it; it; ++it)
+        ReadPatterns(in, NU_EDGE_CODES, edgePatterns[*it]);
+    for (SgBWIterator it; it; ++it)
+        ReadPatterns(in, NU_CENTER_CODES, centerPatterns[*it]);
+    for (SgBWIterator it; it; ++it)
+    {
+        m_edgePatterns[*it].swap(edgePatterns[*it]);
+        m_centerPatterns[*it].swap(centerPatterns[*it]);
+    }
+}
+
+void GoUctPatternGammaTable::Read(const std::string& fileName)
+{
+    std::ifstream in(fileName.c_str(), std::ios::binary);
+    if (! in)
+        throw SgException("could not open " + fileName);
+    Read(in);
+}
+
+void GoUctPatternGammaTable::SetLoaded(TableType type,
+                          const shared_ptr<GoUctPatternGammaTable>& table)
+{
+    LoadedTable(type) = table;
+}
+
+void GoUctPatternGammaTable::Write(std::ostream& out) const
+{
+    out.write(MAGIC, sizeof(MAGIC));
+    WriteUInt32(out, uint32_t(FORMAT_VERSION));
+    for (SgBWIterator it; it; ++it)
+        WritePatterns(out, m_edgePatterns[*it]);
+    for (SgBWIterator it; it; ++it)
+        WritePatterns(out, m_centerPatterns[*it]);
+}
+
+void GoUctPatternGammaTable::Write(const std::string& fileName) const
+{
+    std::ofstream out(fileName.c_str(), std::ios::binary);
+    if (! out)
+        throw SgException("could not open " + fileName);
+    Write(out);
+    out.close();
+    if (! out)
+        throw SgException("could not write " + fileName);
+}
+
+//----------------------------------------------------------------------------
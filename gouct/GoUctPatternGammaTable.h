@@ -0,0 +1,114 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPatternGammaTable.h */
+//----------------------------------------------------------------------------
+
+#ifndef GOUCT_PATTERNGAMMATABLE_H
+#define GOUCT_PATTERNGAMMATABLE_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "GoUctPatternData.h"
+#include "SgBlackWhite.h"
+#include "SgBWArray.h"
+
+//----------------------------------------------------------------------------
+
+/** Gamma values of the 3x3 patterns used by GoUctPatterns, stored in a
+    binary file.
+    Runtime alternative to the machine-generated tables in
+    GoUctLocalPatternData.h and GoUctGlobalPatternData.h. A table can be
+    written by GoUctPatternTrainer and loaded with SetLoaded(), after which
+    newly constructed GoUctPatterns objects use it instead of the compiled
+    table.
+
+    The codes are the ones of GoUctPatterns::CodeOf8Neighbors() for center
+    points and GoUctPatterns::CodeOfEdgeNeighbors() for edge points, indexed
+    by the color to play.
+
+    File format (all numbers are 32-bit little-endian, floats in IEEE 754
+    single precision):
+    @verbatim
+    "FGAM"                      magic
+    version                     currently 1
+    n, n * (code, gamma)        edge patterns, Black to play
+    n, n * (code, gamma)        edge patterns, White to play
+    n, n * (code, gamma)        center patterns, Black to play
+    n, n * (code, gamma)        center patterns, White to play
+    @endverbatim */
+class GoUctPatternGammaTable
+{
+public:
+    /** Table types, same as GoUctPatterns::PatternType. */
+    enum TableType
+    {
+        TABLE_GLOBAL,
+
+        TABLE_LOCAL
+    };
+
+    /** 3^5 = number of edge pattern codes. */
+    static const int NU_EDGE_CODES = 3 * 3 * 3 * 3 * 3;
+
+    /** 3^8 = number of center pattern codes. */
+    static const int NU_CENTER_CODES = 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3;
+
+    GoUctPatternGammaTable();
+
+    void Clear();
+
+    void AddEdgePattern(SgBlackWhite toPlay, int code, float gamma);
+
+    void AddCenterPattern(SgBlackWhite toPlay, int code, float gamma);
+
+    /** Pattern data referring to the entries of this table.
+        Valid until the table is modified or destroyed. */
+    const GoUctPatternData::PatternData& Data() const;
+
+    int NuPatterns() const;
+
+    /** Read a table.
+        @throws SgException on read errors or invalid data. */
+    void Read(std::istream& in);
+
+    /** Read a table from a file.
+        @throws SgException if the file cannot be read. */
+    void Read(const std::string& fileName);
+
+    void Write(std::ostream& out) const;
+
+    /** Write a table to a file.
+        @throws SgException if the file cannot be written. */
+    void Write(const std::string& fileName) const;
+
+    /** Table used by GoUctPatterns instead of the compiled table of the
+        given type.
+        @return The table or 0, if the compiled table is used. */
+    static const GoUctPatternGammaTable* Loaded(TableType type);
+
+    /** Set the table used instead of the compiled table of the given type.
+        Only affects GoUctPatterns objects constructed afterwards. Not
+        thread-safe; must not be called during a search.
+        @param type
+        @param table The table or an empty pointer to use the compiled
+        table again. */
+    static void SetLoaded(TableType type,
+                     const boost::shared_ptr<GoUctPatternGammaTable>& table);
+
+private:
+    SgBWArray<std::vector<GoUctPatternData::PatternTableEntry> >
+        m_edgePatterns;
+
+    SgBWArray<std::vector<GoUctPatternData::PatternTableEntry> >
+        m_centerPatterns;
+
+    /** See Data().
+        Updated in Data(), because the entries can move when patterns are
+        added. */
+    mutable GoUctPatternData::PatternData m_data;
+};
+
+//----------------------------------------------------------------------------
+
+#endif // GOUCT_PATTERNGAMMATABLE_H
@@ -0,0 +1,390 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPatternTrainer.cpp
+    See GoUctPatternTrainer.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoUctPatternTrainer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <boost/filesystem.hpp>
+#include "GoUctPatterns.h"
+#include "SgDebug.h"
+#include "SgException.h"
+#include "SgGameReader.h"
+#include "SgNode.h"
+#include "SgNodeArena.h"
+#include "SgProp.h"
+
+using boost::uint16_t;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+const int NU_CENTER_CODES = GoUctPatternGammaTable::NU_CENTER_CODES;
+
+const int NU_EDGE_CODES = GoUctPatternGammaTable::NU_EDGE_CODES;
+
+/** Get the digits of a pattern code, most significant first. */
+void Digits(int code, int nuDigits, int digits[])
+{
+    for (int i = nuDigits - 1; i >= 0; --i)
+    {
+        digits[i] = code % 3;
+        code /= 3;
+    }
+}
+
+int Code(const int digits[], int nuDigits)
+{
+    int code = 0;
+    for (int i = 0; i < nuDigits; ++i)
+        code = code * 3 + digits[i];
+    return code;
+}
+
+/** Exchange black and white in the digits of a code. */
+void SwapColors(int digits[], int nuDigits)
+{
+    for (int i = 0; i < nuDigits; ++i)
+        if (digits[i] != SG_EMPTY)
+            digits[i] = SgOppBW(digits[i]);
+}
+
+/** Smallest code of the center codes equivalent by symmetry.
+    The digits of GoUctPatterns::CodeOf8Neighbors() are the points at the
+    offsets (row, column) given by OFFSET. */
+int CanonicalCenterCode(int code)
+{
+    static const int OFFSET[8][2] = {
+        { -1, -1 }, { -1, 0 }, { -1, 1 }, { 0, -1 },
+        { 0, 1 }, { 1, -1 }, { 1, 0 }, { 1, 1 }
+    };
+    int digits[8];
+    Digits(code, 8, digits);
+    int minCode = code;
+    for (int sym = 0; sym < 8; ++sym)
+    {
+        int transformed[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            int row = OFFSET[i][0];
+            int col = OFFSET[i][1];
+            if (sym & 1)
+                row = -row;
+            if (sym & 2)
+                col = -col;
+            if (sym & 4)
+                std::swap(row, col);
+            for (int j = 0; j < 8; ++j)
+                if (OFFSET[j][0] == row && OFFSET[j][1] == col)
+                    transformed[j] = digits[i];
+        }
+        minCode = std::min(minCode, Code(transformed, 8));
+    }
+    return minCode;
+}
+
+/** Smallest code of the edge codes equivalent by mirroring along the edge
+    direction.
+    See GoUctPatterns::CodeOfEdgeNeighbors() for the order of the digits. */
+int CanonicalEdgeCode(int code)
+{
+    int digits[5];
+    Digits(code, 5, digits);
+    std::swap(digits[0], digits[4]);
+    std::swap(digits[1], digits[3]);
+    return std::min(code, Code(digits, 5));
+}
+
+/** Number features of canonical codes.
+    @param nuDigits
+    @param canonical Function computing the canonical code
+    @param[in,out] nuFeatures The next feature number
+    @param[out] feature The feature by color to play for each code */
+void NumberFeatures(int nuDigits, int (*canonical)(int), int& nuFeatures,
+                    SgBWArray<std::vector<int> >& feature)
+{
+    int nuCodes = 1;
+    for (int i = 0; i < nuDigits; ++i)
+        nuCodes *= 3;
+    std::vector<int> canonicalFeature(nuCodes, -1);
+    feature[SG_BLACK].assign(nuCodes, -1);
+    feature[SG_WHITE].assign(nuCodes, -1);
+    for (int code = 0; code < nuCodes; ++code)
+    {
+        const int c = canonical(code);
+        if (canonicalFeature[c] < 0)
+            canonicalFeature[c] = nuFeatures++;
+        feature[SG_BLACK][code] = canonicalFeature[c];
+    }
+    for (int code = 0; code < nuCodes; ++code)
+    {
+        int digits[8];
+        Digits(code, nuDigits, digits);
+        SwapColors(digits, nuDigits);
+        feature[SG_WHITE][code] = feature[SG_BLACK][Code(digits, nuDigits)];
+    }
+}
+
+bool IsSgfFile(const boost::filesystem::path& path)
+{
+    return boost::filesystem::is_regular_file(path)
+        && path.extension() == ".sgf";
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+GoUctPatternTrainer::GoUctPatternTrainer()
+    : m_type(GoUctPatternGammaTable::TABLE_GLOBAL),
+      m_nuFeatures(0)
+{
+    GoRules rules = m_bd.Rules();
+    rules.SetKoRule(GoRules::SIMPLEKO);
+    m_bd.Init(m_bd.Size(), rules);
+    InitFeatures();
+    Clear();
+}
+
+void GoUctPatternTrainer::AddCandidate(SgPoint p)
+{
+    const int feature = Feature(p, m_bd.ToPlay());
+    if (m_count[feature]++ == 0)
+        m_features.push_back(feature);
+}
+
+void GoUctPatternTrainer::AddCompetition(SgPoint move)
+{
+    const SgBlackWhite toPlay = m_bd.ToPlay();
+    SG_ASSERT(m_features.empty());
+    if (m_type == GoUctPatternGammaTable::TABLE_LOCAL)
+    {
+        GoPointList candidates;
+        const SgPoint lastMove = m_bd.GetLastMove();
+        const SgPoint lastMove2 = m_bd.Get2ndLastMove();
+        for (int i = 0; i < 2; ++i)
+        {
+            const SgPoint p = (i == 0 ? lastMove : lastMove2);
+            if (SgIsSpecialMove(p))
+                continue;
+            for (int dx = -1; dx <= 1; ++dx)
+                for (int dy = -1; dy <= 1; ++dy)
+                {
+                    const SgPoint nb = p + dx * SG_WE + dy * SG_NS;
+                    if (IsCandidate(nb, toPlay))
+                        candidates.Include(nb);
+                }
+        }
+        if (! candidates.Contains(move))
+            return;
+        for (GoPointList::Iterator it(candidates); it; ++it)
+            AddCandidate(*it);
+    }
+    else
+    {
+        if (! IsCandidate(move, toPlay))
+            return;
+        for (GoBoard::Iterator it(m_bd); it; ++it)
+            if (IsCandidate(*it, toPlay))
+                AddCandidate(*it);
+    }
+    for (std::vector<int>::const_iterator it = m_features.begin();
+         it != m_features.end(); ++it)
+    {
+        Entry entry;
+        entry.m_feature = static_cast<uint16_t>(*it);
+        entry.m_count = static_cast<uint16_t>(m_count[*it]);
+        m_entries.push_back(entry);
+        m_count[*it] = 0;
+    }
+    m_features.clear();
+    m_begin.push_back(static_cast<int>(m_entries.size()));
+    const int winner = Feature(move, toPlay);
+    m_winner.push_back(static_cast<uint16_t>(winner));
+    ++m_wins[winner];
+}
+
+int GoUctPatternTrainer::AddDirectory(const std::string& path)
+{
+    using namespace boost::filesystem;
+    int nuGames = 0;
+    try
+    {
+        for (recursive_directory_iterator it(path), end; it != end; ++it)
+            if (IsSgfFile(it->path()))
+                nuGames += AddFile(it->path().string());
+    }
+    catch (const filesystem_error& e)
+    {
+        throw SgException(e.what());
+    }
+    return nuGames;
+}
+
+int GoUctPatternTrainer::AddFile(const std::string& fileName)
+{
+    std::ifstream in(fileName.c_str());
+    if (! in)
+        throw SgException("could not open " + fileName);
+    // Each game is deleted before the next one is read, so the nodes of
+    // all games can use the same block of memory
+    SgNodeArena arena;
+    SgNodeArena::Scope scope(arena);
+    SgGameReader reader(in);
+    int nuGames = 0;
+    while (SgNode* root = reader.ReadGame())
+    {
+        AddGame(*root);
+        root->DeleteTree();
+        arena.Clear();
+        ++nuGames;
+    }
+    return nuGames;
+}
+
+int GoUctPatternTrainer::AddGame(const SgNode& root)
+{
+    const int oldNuCompetitions = NuCompetitions();
+    for (const SgNode* node = &root; node != 0; node = node->LeftMostSon())
+    {
+        if (  node == &root
+           || node->HasProp(SG_PROP_ADD_BLACK)
+           || node->HasProp(SG_PROP_ADD_WHITE)
+           || node->HasProp(SG_PROP_ADD_EMPTY)
+           )
+            // Handles board size and setup stones
+            m_updater.Update(node, m_bd);
+        else if (node->HasProp(SG_PROP_MOVE))
+        {
+            const SgPropMove* prop =
+                static_cast<const SgPropMove*>(node->Get(SG_PROP_MOVE));
+            const SgPoint move = prop->Value();
+            const SgBlackWhite player = prop->Player();
+            if (move != SG_PASS && ! m_bd.IsLegal(move, player))
+                break;
+            m_bd.SetToPlay(player);
+            if (move != SG_PASS)
+                AddCompetition(move);
+            m_bd.Play(move);
+        }
+    }
+    return NuCompetitions() - oldNuCompetitions;
+}
+
+void GoUctPatternTrainer::Clear()
+{
+    m_entries.clear();
+    m_begin.assign(1, 0);
+    m_winner.clear();
+    m_wins.assign(m_nuFeatures, 0);
+    m_count.assign(m_nuFeatures, 0);
+    m_features.clear();
+    m_gamma.assign(m_nuFeatures, 1.);
+}
+
+int GoUctPatternTrainer::Feature(SgPoint p, SgBlackWhite toPlay) const
+{
+    if (m_bd.Line(p) > 1)
+        return m_centerFeature[toPlay][
+                          GoUctPatterns<GoBoard>::CodeOf8Neighbors(m_bd, p)];
+    SG_ASSERT(m_bd.Pos(p) > 1);
+    return m_edgeFeature[toPlay][
+                       GoUctPatterns<GoBoard>::CodeOfEdgeNeighbors(m_bd, p)];
+}
+
+void GoUctPatternTrainer::GetTable(GoUctPatternGammaTable& table) const
+{
+    // Normalize by the geometric mean of the gammas of occurring features
+    std::vector<bool> occurs(m_nuFeatures, false);
+    for (std::vector<Entry>::const_iterator it = m_entries.begin();
+         it != m_entries.end(); ++it)
+        occurs[it->m_feature] = true;
+    double sumLog = 0;
+    int n = 0;
+    for (int i = 0; i < m_nuFeatures; ++i)
+        if (occurs[i])
+        {
+            sumLog += std::log(m_gamma[i]);
+            ++n;
+        }
+    const double scale = (n > 0 ? std::exp(-sumLog / n) : 1.);
+    table.Clear();
+    for (SgBWIterator it; it; ++it)
+    {
+        for (int code = 0; code < NU_EDGE_CODES; ++code)
+            table.AddEdgePattern(*it, code,
+                  float(scale * m_gamma[m_edgeFeature[*it][code]]));
+        for (int code = 0; code < NU_CENTER_CODES; ++code)
+            table.AddCenterPattern(*it, code,
+                  float(scale * m_gamma[m_centerFeature[*it][code]]));
+    }
+}
+
+void GoUctPatternTrainer::InitFeatures()
+{
+    m_nuFeatures = 0;
+    NumberFeatures(8, CanonicalCenterCode, m_nuFeatures, m_centerFeature);
+    NumberFeatures(5, CanonicalEdgeCode, m_nuFeatures, m_edgeFeature);
+    SG_ASSERT(m_nuFeatures <= std::numeric_limits<uint16_t>::max());
+}
+
+bool GoUctPatternTrainer::IsCandidate(SgPoint p, SgBlackWhite toPlay) const
+{
+    return m_bd.IsEmpty(p)
+        && (m_bd.Line(p) > 1 || m_bd.Pos(p) > 1)
+        && m_bd.IsLegal(p, toPlay);
+}
+
+int GoUctPatternTrainer::NuCompetitions() const
+{
+    return static_cast<int>(m_winner.size());
+}
+
+void GoUctPatternTrainer::SetTableType(GoUctPatternGammaTable::TableType type)
+{
+    m_type = type;
+    Clear();
+}
+
+double GoUctPatternTrainer::Train(int nuIterations)
+{
+    const int nuCompetitions = NuCompetitions();
+    double logLikelihood = 0;
+    std::vector<double> sumInverseStrength(m_nuFeatures);
+    for (int i = 0; i < nuIterations; ++i)
+    {
+        // Minorization-maximization update of all gammas (one team member
+        // per competition), with a prior of one win and one loss against a
+        // virtual opponent of gamma 1
+        logLikelihood = 0;
+        sumInverseStrength.assign(m_nuFeatures, 0.);
+        for (int j = 0; j < nuCompetitions; ++j)
+        {
+            double strength = 0;
+            for (int k = m_begin[j]; k < m_begin[j + 1]; ++k)
+                strength += m_entries[k].m_count
+                            * m_gamma[m_entries[k].m_feature];
+            logLikelihood += std::log(m_gamma[m_winner[j]] / strength);
+            const double inverseStrength = 1. / strength;
+            for (int k = m_begin[j]; k < m_begin[j + 1]; ++k)
+                sumInverseStrength[m_entries[k].m_feature] +=
+                    m_entries[k].m_count * inverseStrength;
+        }
+        for (int f = 0; f < m_nuFeatures; ++f)
+            m_gamma[f] = (m_wins[f] + 1.)
+                / (sumInverseStrength[f] + 2. / (m_gamma[f] + 1.));
+        if (nuCompetitions > 0)
+            logLikelihood /= nuCompetitions;
+        SgDebug() << "GoUctPatternTrainer: iteration " << (i + 1)
+                  << " log-likelihood " << logLikelihood << '\n';
+    }
+    return logLikelihood;
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,154 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPatternTrainer.h */
+//----------------------------------------------------------------------------
+
+#ifndef GOUCT_PATTERNTRAINER_H
+#define GOUCT_PATTERNTRAINER_H
+
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include "GoBoard.h"
+#include "GoBoardUpdater.h"
+#include "GoUctPatternGammaTable.h"
+#include "SgBWArray.h"
+
+class SgNode;
+
+//----------------------------------------------------------------------------
+
+/** Learns gamma values of the 3x3 patterns of GoUctPatterns from game
+    records.
+    Uses the minorization-maximization algorithm for the generalized
+    Bradley-Terry model (R. Coulom: Computing Elo Ratings of Move Patterns in
+    the Game of Go, 2007) with single-pattern teams. Each move of a game is a
+    competition between the candidate points for the player to move, which
+    the pattern of the played move won.
+
+    The candidates depend on the table type. For TABLE_GLOBAL, all legal
+    points on the board are candidates. For TABLE_LOCAL, only the legal
+    points in the 8-neighborhood of the last two moves are candidates, as in
+    GoUctGammaMoveGenerator, and moves outside of this neighborhood are not
+    used.
+
+    Patterns that are equivalent by symmetry or by exchanging the colors of
+    the stones and the player share the same gamma. Corner points are
+    ignored, because GoUctPatterns has no patterns for them. A prior of one
+    virtual win and one virtual loss against a pattern of gamma 1 keeps the
+    gammas of rare patterns finite.
+
+    The result is normalized such that the geometric mean of the gammas of
+    all patterns occurring in the training data is 1. Note that
+    GoUctGammaMoveGenerator treats gammas below
+    GoUctPlayoutPolicyParam::m_patternGammaThreshold as 1, which needs to be
+    adjusted to the scale of a trained table. */
+class GoUctPatternTrainer
+{
+public:
+    GoUctPatternTrainer();
+
+    /** Set the table type the candidates are generated for.
+        Clears all data. Default is TABLE_GLOBAL. */
+    void SetTableType(GoUctPatternGammaTable::TableType type);
+
+    GoUctPatternGammaTable::TableType TableType() const;
+
+    /** Remove all data and reset the gammas. */
+    void Clear();
+
+    /** Add the moves of the main variation of a game.
+        Stops at the first illegal move.
+        @return The number of competitions added. */
+    int AddGame(const SgNode& root);
+
+    /** Add all games in an SGF file.
+        @return The number of games.
+        @throws SgException if the file cannot be opened. */
+    int AddFile(const std::string& fileName);
+
+    /** Add all SGF files (extension .sgf) in a directory and its
+        subdirectories.
+        @return The number of games.
+        @throws SgException if the directory cannot be read. */
+    int AddDirectory(const std::string& path);
+
+    int NuCompetitions() const;
+
+    /** Run iterations of the MM algorithm.
+        Can be called repeatedly to continue the training.
+        @return The average log-likelihood of the training data before the
+        last iteration. */
+    double Train(int nuIterations);
+
+    /** Get the current gammas.
+        The table contains all pattern codes for both colors. */
+    void GetTable(GoUctPatternGammaTable& table) const;
+
+private:
+    /** Entry of a competition: number of candidates with a feature. */
+    struct Entry
+    {
+        boost::uint16_t m_feature;
+
+        boost::uint16_t m_count;
+    };
+
+    GoUctPatternGammaTable::TableType m_type;
+
+    GoBoard m_bd;
+
+    GoBoardUpdater m_updater;
+
+    /** Feature of each center code by color to play.
+        Codes equivalent by symmetry or color exchange have the same
+        feature. */
+    SgBWArray<std::vector<int> > m_centerFeature;
+
+    /** Feature of each edge code by color to play.
+        Edge features are numbered after the center features. */
+    SgBWArray<std::vector<int> > m_edgeFeature;
+
+    int m_nuFeatures;
+
+    /** Entries of all competitions. */
+    std::vector<Entry> m_entries;
+
+    /** Index of the first entry of each competition in m_entries.
+        Contains an additional element with the end index. */
+    std::vector<int> m_begin;
+
+    /** Winning feature of each competition. */
+    std::vector<boost::uint16_t> m_winner;
+
+    /** Number of wins of each feature. */
+    std::vector<int> m_wins;
+
+    /** Number of candidates with a feature in the competition under
+        construction. */
+    std::vector<int> m_count;
+
+    /** Features with nonzero m_count. */
+    std::vector<int> m_features;
+
+    std::vector<double> m_gamma;
+
+    void AddCandidate(SgPoint p);
+
+    void AddCompetition(SgPoint move);
+
+    int Feature(SgPoint p, SgBlackWhite toPlay) const;
+
+    void InitFeatures();
+
+    bool IsCandidate(SgPoint p, SgBlackWhite toPlay) const;
+};
+
+inline GoUctPatternGammaTable::TableType GoUctPatternTrainer::TableType()
+    const
+{
+    return m_type;
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GOUCT_PATTERNTRAINER_H
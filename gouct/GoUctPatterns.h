@@ -7,9 +7,9 @@
 
 #include "GoBoard.h"
 #include "GoBoardUtil.h"
-#include "GoUctGlobalPatternData.h"
-#include "GoUctLocalPatternData.h"
 #include "GoUctPatternData.h"
+#include "GoUctPatternDatabase.h"
+#include "GoUctPatternGammaTable.h"
 #include "SgBoardColor.h"
 #include "SgBWArray.h"
 #include "SgPoint.h"
@@ -134,8 +134,20 @@ public:
 	float GetPatternGamma(const BOARD& bd, const SgPoint p,
 			const SgBlackWhite toPlay) const;
 
-	/** provide interface of other gamma patterns*/
+	/** provide interface of other gamma patterns.
+        Uses the table set with GoUctPatternGammaTable::SetLoaded(), if
+        any, otherwise the table of GoUctPatternDatabase::Global(), if any,
+        otherwise the compiled table. */
 	void InitializeGammaPatternFromProcessedData(PatternType patternType);
+
+    /** Code of the 8-neighborhood of a point not on the edge.
+        Index into the center pattern tables. */
+    static int CodeOf8Neighbors(const BOARD& bd, SgPoint p);
+
+    /** Code of the neighborhood of a point on the edge, excluding corners.
+        Index into the edge pattern tables. */
+    static int CodeOfEdgeNeighbors(const BOARD& bd, SgPoint p);
+
 private:
 	/** Match any of the center patterns, and return gamma */
 	float MatchAnyCenterForGamma(SgPoint p, const SgBlackWhite toPlay) const;
@@ -176,10 +188,6 @@ private:
     static bool CheckHane1(const GoBoard& bd, SgPoint p, SgBlackWhite c,
                            SgBlackWhite opp, int cDir, int otherDir);
 
-    static int CodeOf8Neighbors(const BOARD& bd, SgPoint p);
-
-    static int CodeOfEdgeNeighbors(const BOARD& bd, SgPoint p);
-
     static int EdgeDirection(GoBoard& bd, SgPoint p, int index);
 
     static int EBWCodeOfPoint(const BOARD& bd, SgPoint p);
@@ -727,9 +735,17 @@ void GoUctPatterns<BOARD>
     m_edgeTable[SG_BLACK].Fill(PatternInfo());
     m_edgeTable[SG_WHITE].Fill(PatternInfo());
 
-    const GoUctPatternData::PatternData& pt = patternType == PATTERN_LOCAL ?
-                                              GoUctLocalPatternData::gData :
-                                              GoUctGlobalPatternData::gData;
+    const GoUctPatternGammaTable::TableType type =
+        patternType == PATTERN_LOCAL ? GoUctPatternGammaTable::TABLE_LOCAL :
+                                       GoUctPatternGammaTable::TABLE_GLOBAL;
+    const GoUctPatternGammaTable* loaded =
+        GoUctPatternGammaTable::Loaded(type);
+    if (loaded == 0)
+        loaded = GoUctPatternDatabase::Global().Gammas(type);
+    const GoUctPatternData::PatternData& pt =
+        loaded != 0 ? loaded->Data() :
+        patternType == PATTERN_LOCAL ? GoUctPatternData::BuiltinLocalData() :
+                                       GoUctPatternData::BuiltinGlobalData();
     SetGammaValues(pt.m_edgePatterns, m_edgeTable);
     SetGammaValues(pt.m_centerPatterns, m_table);
 }
@@ -17,6 +17,7 @@
 #include "GoUctObjectWithSearch.h"
 #include "GoUctPlayoutPolicy.h"
 #include "GoUctMoveFilter.h"
+#include "GoUctUtil.h"
 #include "SgArrayList.h"
 #include "SgDebug.h"
 #include "SgNbIterator.h"
@@ -103,6 +104,13 @@ public:
 
     void Ponder();
 
+    /** Search the position and write the moves at the root with
+        GoUctUtil::WriteAnalyzeInfo() every interval seconds.
+        Unlike Ponder(), does not need reuse_subtree or ponder enabled. The
+        search is limited by MaxGames() and MaxPonderTime(), the final
+        state of the search is written when it ends. */
+    void Analyze(SgBlackWhite toPlay, double interval, std::ostream& out);
+
     // @} // @name
 
 
@@ -702,7 +710,7 @@ bool GoUctPlayer<SEARCH, THREAD>::DoEarlyPassSearch(SgUctValue maxGames,
     }
     move = SG_PASS;
     THREAD& threadState = dynamic_cast<THREAD&>(m_search.ThreadState(0));
-    const TerrArray territory = threadState.m_territoryStatistics;
+    const TerrArray territory = threadState.TerritoryStatistics();
     if (earlyPassPossible && ! HasStatsForAllMoves(bd, territory))
     {
         earlyPassPossible = false;
@@ -1038,6 +1046,29 @@ void GoUctPlayer<SEARCH, THREAD>::OnBoardChange()
     }
 }
 
+template <class SEARCH, class THREAD>
+void GoUctPlayer<SEARCH, THREAD>::Analyze(SgBlackWhite toPlay,
+                                          double interval, std::ostream& out)
+{
+    if (m_searchMode != GOUCT_SEARCHMODE_UCT)
+        return;
+    SgDebug() << "GoUctPlayer::Analyze: start\n";
+    m_search.SetAnalyzeStream(&out);
+    m_search.SetAnalyzeInterval(interval);
+    try
+    {
+        DoSearch(toPlay, m_maxPonderTime, true);
+    }
+    catch (...)
+    {
+        m_search.SetAnalyzeStream(0);
+        throw;
+    }
+    m_search.SetAnalyzeStream(0);
+    GoUctUtil::WriteAnalyzeInfo(m_search, out);
+    SgDebug() << "GoUctPlayer::Analyze: end\n";
+}
+
 template <class SEARCH, class THREAD>
 void GoUctPlayer<SEARCH, THREAD>::Ponder()
 {
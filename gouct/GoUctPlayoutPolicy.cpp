@@ -6,19 +6,24 @@
 #include "GoUctPlayoutPolicy.h"
 
 #include <algorithm>
+#include <iomanip>
 #include <boost/io/ios_state.hpp>
 
 //----------------------------------------------------------------------------
 
 GoUctPlayoutPolicyParam::GoUctPlayoutPolicyParam()
     : m_statisticsEnabled(false),
+      m_useGeneratePointCache(false),
       m_useNakadeHeuristic(false),
       m_usePatternsInPlayout(true),
       m_usePatternsInPriorKnowledge(true),
       m_fillboardTries(0),
       m_patternGammaThreshold(50.f),
       m_knowledgeType(KNOWLEDGE_GREENPEEP),
-      m_combinationType(COMBINE_MULTIPLY)
+      m_combinationType(COMBINE_MULTIPLY),
+      m_useTacticalReader(false),
+      m_tacticalReaderMaxNodes(200),
+      m_profileInterval(0)
 { }
 
 //----------------------------------------------------------------------------
@@ -67,6 +72,9 @@ void GoUctPlayoutPolicyStat::Clear()
     m_nonRandLen.Clear();
     m_moveListLen.Clear();
     std::fill(m_nuMoveType.begin(), m_nuMoveType.end(), 0);
+    m_nuRandomDraws = 0;
+    m_nuTacticalLookups = 0;
+    m_nuTacticalHits = 0;
 }
 
 void GoUctPlayoutPolicyStat::Write(std::ostream& out) const
@@ -86,7 +94,71 @@ void GoUctPlayoutPolicyStat::Write(std::ostream& out) const
     out << '\n'
         << SgWriteLabel("MoveListLen");
     m_moveListLen.Write(out);
-    out << '\n';
+    out << '\n'
+        << SgWriteLabel("RandomPerMove")
+        << (m_nuMoves > 0 ? double(m_nuRandomDraws) / m_nuMoves : 0) << '\n'
+        << SgWriteLabel("TacticalLookups") << m_nuTacticalLookups << '\n'
+        << SgWriteLabel("TacticalHits")
+        << (m_nuTacticalLookups > 0 ?
+            m_nuTacticalHits * 100.0 / m_nuTacticalLookups : 0) << "%\n";
+}
+
+//----------------------------------------------------------------------------
+
+void GoUctPlayoutPolicyProfile::Add(const GoUctPlayoutPolicyProfile& profile)
+{
+    m_nuSamples += profile.m_nuSamples;
+    m_ticks += profile.m_ticks;
+    for (int i = 0; i < _GOUCT_NU_DEFAULT_PLAYOUT_TYPE; ++i)
+    {
+        m_nuCalls[i] += profile.m_nuCalls[i];
+        m_nuHits[i] += profile.m_nuHits[i];
+        m_stageTicks[i] += profile.m_stageTicks[i];
+    }
+}
+
+void GoUctPlayoutPolicyProfile::Clear()
+{
+    m_nuSamples = 0;
+    m_ticks = 0;
+    std::fill(m_nuCalls.begin(), m_nuCalls.end(), 0);
+    std::fill(m_nuHits.begin(), m_nuHits.end(), 0);
+    std::fill(m_stageTicks.begin(), m_stageTicks.end(), 0);
+}
+
+void GoUctPlayoutPolicyProfile::Write(std::ostream& out) const
+{
+    boost::io::ios_all_saver saver(out);
+    out << std::fixed << std::setprecision(1)
+        << SgWriteLabel("Samples") << m_nuSamples << '\n'
+        << SgWriteLabel("TicksPerMove")
+        << (m_nuSamples > 0 ? double(m_ticks) / m_nuSamples : 0) << '\n'
+        << std::setw(16) << std::left << "Stage" << std::right
+        << std::setw(8) << "Calls%" << std::setw(8) << "Hit%"
+        << std::setw(10) << "Ticks" << std::setw(8) << "Time%" << '\n';
+    uint64_t stageTicks = 0;
+    for (int i = 0; i < _GOUCT_NU_DEFAULT_PLAYOUT_TYPE; ++i)
+    {
+        stageTicks += m_stageTicks[i];
+        const size_t nuCalls = m_nuCalls[i];
+        if (nuCalls == 0)
+            continue;
+        GoUctPlayoutPolicyType type = static_cast<GoUctPlayoutPolicyType>(i);
+        out << std::setw(16) << std::left << GoUctPlayoutPolicyTypeStr(type)
+            << std::right
+            << std::setw(8) << nuCalls * 100.0 / m_nuSamples
+            << std::setw(8) << m_nuHits[i] * 100.0 / nuCalls
+            << std::setw(10) << double(m_stageTicks[i]) / nuCalls
+            << std::setw(8)
+            << (m_ticks > 0 ? m_stageTicks[i] * 100.0 / m_ticks : 0) << '\n';
+    }
+    const uint64_t otherTicks = m_ticks - stageTicks;
+    out << std::setw(16) << std::left << "Other" << std::right
+        << std::setw(8) << "-" << std::setw(8) << "-"
+        << std::setw(10)
+        << (m_nuSamples > 0 ? double(otherTicks) / m_nuSamples : 0)
+        << std::setw(8)
+        << (m_ticks > 0 ? otherTicks * 100.0 / m_ticks : 0) << '\n';
 }
 
 //----------------------------------------------------------------------------
@@ -9,9 +9,12 @@
 #include <boost/array.hpp>
 #include "GoBoardUtil.h"
 #include "GoEyeUtil.h"
+#include "GoUctGeneratePointCache.h"
 #include "GoUctPatterns.h"
 #include "GoUctPureRandomGenerator.h"
 #include "GoUctGammaMoveGenerator.h"
+#include "GoUctTacticalReader.h"
+#include "SgTime.h"
 
 //----------------------------------------------------------------------------
 
@@ -49,6 +52,14 @@ public:
         Has a negative impact on performance. Default is false. */
     bool m_statisticsEnabled;
 
+    /** Cache the results of GoUctUtil::GeneratePoint() and
+        GoBoardUtil::SelfAtari() for candidate moves during a playout.
+        See GoUctGeneratePointCache. Does not change the generated moves.
+        Only few candidates are tested repeatedly with the current policy,
+        so the cost of updating the cache usually outweighs the savings.
+        Default is false. */
+    bool m_useGeneratePointCache;
+
     /** Use Nakade heuristic.
         See section 6.2 of: Chaslot, Chatriot, Fiter, Gelly, Hoock, 
         Perez, Rimmel and Teytaud:
@@ -81,6 +92,21 @@ public:
     /** How to combine multiple additive knowledge */
     GoUctKnowledgeCombinationType m_combinationType;
 
+    /** Use GoUctTacticalReader for blocks with one or two liberties.
+        Adds the atari that captures the block of the last move in a ladder
+        to the low liberty moves, and removes escapes from atari that run
+        into a ladder from the atari defense moves. Default is false */
+    bool m_useTacticalReader;
+
+    /** Maximum number of nodes per call of GoUctTacticalReader.
+        Default is 200 */
+    int m_tacticalReaderMaxNodes;
+
+    /** Profile every n'th call of GoUctPlayoutPolicy::GenerateMove.
+        See GoUctPlayoutPolicyProfile. 0 disables profiling.
+        Default is 0 */
+    int m_profileInterval;
+
     GoUctPlayoutPolicyParam();
 };
 
@@ -138,6 +164,18 @@ struct GoUctPlayoutPolicyStat
     /** Number of moves of a certain type. */
     boost::array<std::size_t,_GOUCT_NU_DEFAULT_PLAYOUT_TYPE> m_nuMoveType;
 
+    /** Number of random numbers drawn for generating the moves.
+        See SgRandom::NuDraws() */
+    uint64_t m_nuRandomDraws;
+
+    /** Number of calls of GoUctTacticalReader.
+        See GoUctTacticalReader::NuLookups() */
+    std::size_t m_nuTacticalLookups;
+
+    /** Number of calls of GoUctTacticalReader that used a cached result.
+        See GoUctTacticalReader::NuHits() */
+    std::size_t m_nuTacticalHits;
+
     void Clear();
 
     void Write(std::ostream& out) const;
@@ -145,6 +183,53 @@ struct GoUctPlayoutPolicyStat
 
 //----------------------------------------------------------------------------
 
+/** Sampled timing profile of the stages of GoUctPlayoutPolicy::GenerateMove.
+    A stage is identified by the move type it generates, the move corrections
+    by the move type they assign. Times are measured with SgTime::Ticks().
+    Only every n'th call of GenerateMove is measured to keep the overhead low
+    (see GoUctPlayoutPolicyParam::m_profileInterval). */
+struct GoUctPlayoutPolicyProfile
+{
+    /** Number of profiled calls of GenerateMove. */
+    std::size_t m_nuSamples;
+
+    /** Total ticks spent in profiled calls of GenerateMove. */
+    uint64_t m_ticks;
+
+    /** Number of profiled calls in which a stage was executed. */
+    boost::array<std::size_t,_GOUCT_NU_DEFAULT_PLAYOUT_TYPE> m_nuCalls;
+
+    /** Number of executed stages that generated a move.
+        For move corrections, the number of times the move was replaced. */
+    boost::array<std::size_t,_GOUCT_NU_DEFAULT_PLAYOUT_TYPE> m_nuHits;
+
+    /** Ticks spent in a stage. */
+    boost::array<uint64_t,_GOUCT_NU_DEFAULT_PLAYOUT_TYPE> m_stageTicks;
+
+    void Add(GoUctPlayoutPolicyType type, bool hit, uint64_t ticks);
+
+    /** Merge with profile of another policy (e.g. of another thread). */
+    void Add(const GoUctPlayoutPolicyProfile& profile);
+
+    void Clear();
+
+    /** Write table with the calls, hit rate, average ticks per call and
+        share of the total time for each stage.
+        The row "Other" contains the time not attributed to any stage. */
+    void Write(std::ostream& out) const;
+};
+
+inline void GoUctPlayoutPolicyProfile::Add(GoUctPlayoutPolicyType type,
+                                           bool hit, uint64_t ticks)
+{
+    ++m_nuCalls[type];
+    if (hit)
+        ++m_nuHits[type];
+    m_stageTicks[type] += ticks;
+}
+
+//----------------------------------------------------------------------------
+
 /** Default playout policy for usage in GoUctGlobalSearch.
     Parameterized by the board class to make it usable with both GoBoard
     and GoUctBoard.
@@ -197,6 +282,11 @@ public:
 
     void ClearStatistics();
 
+    /** Return the timing profile.
+        Only collected, if GoUctPlayoutPolicyParam::m_profileInterval is
+        greater than zero. Cleared by ClearStatistics(). */
+    const GoUctPlayoutPolicyProfile& Profile() const;
+
     // @} // @name
 
     /** Return the list of equivalent best moves from last move generation.
@@ -291,6 +381,17 @@ private:
     /** See GoUctPlayoutPolicyStat::m_nonRandLen. */
     std::size_t m_nonRandLen;
 
+    /** Value of SgRandom::NuDraws() after the last UpdateStatistics(). */
+    uint64_t m_nuRandomDraws;
+
+    /** Value of GoUctTacticalReader::NuLookups() after the last
+        UpdateStatistics(). */
+    std::size_t m_nuTacticalLookups;
+
+    /** Value of GoUctTacticalReader::NuHits() after the last
+        UpdateStatistics(). */
+    std::size_t m_nuTacticalHits;
+
     /** Last move.
         Stored in member variable to avoid multiple calls to
         GoBoard::GetLastMove during GenerateMove. */
@@ -305,20 +406,36 @@ private:
 
     SgRandom m_random;
 
+    GoUctGeneratePointCache<BOARD> m_generatePointCache;
+
     GoUctGammaMoveGenerator<BOARD> m_gammaGenerator;
 
     CaptureGenerator m_captureGenerator;
 
     GoUctPureRandomGenerator<BOARD> m_pureRandomGenerator;
 
+    GoUctTacticalReader<BOARD> m_tacticalReader;
+
     SgBWArray<GoUctPlayoutPolicyStat> m_statistics;
 
+    GoUctPlayoutPolicyProfile m_profile;
+
+    /** Number of calls of GenerateMove since the last profiled call. */
+    int m_profileCounter;
+
+    /** Value of SgTime::Ticks() at the end of the last profiled stage. */
+    uint64_t m_profileTicks;
+
     /** Captures if last move was self-atari */
     bool GenerateAtariCaptureMove();
 
     /** Generate escapes if last move was atari. */
     bool GenerateAtariDefenseMove();
 
+    /** Remove escapes from atari that run into a ladder from m_moves.
+        See GoUctPlayoutPolicyParam::m_useTacticalReader */
+    void RemoveLadderEscapes();
+
     /** Generate low lib moves around lastMove */
     bool GenerateLowLibMove(SgPoint lastMove);
 
@@ -347,6 +464,13 @@ private:
 
     /** Add statistics for most recently generated move. */
     void UpdateStatistics();
+
+    /** Decide if the current call of GenerateMove is profiled.
+        Starts the time measurement, if yes. */
+    bool StartProfile();
+
+    /** Attribute the time since the end of the last stage to a stage. */
+    void ProfileStage(GoUctPlayoutPolicyType type, bool hit);
 };
 
 template<class BOARD>
@@ -427,10 +551,17 @@ GoUctPlayoutPolicy<BOARD>::GoUctPlayoutPolicy(const BOARD& bd,
       m_patterns(bd, GoUctPatterns<BOARD>::PATTERN_LOCAL),
       m_globalPatterns(bd, GoUctPatterns<BOARD>::PATTERN_GLOBAL),
       m_checked(false),
+      m_nuRandomDraws(0),
+      m_nuTacticalLookups(0),
+      m_nuTacticalHits(0),
+      m_generatePointCache(bd),
       m_gammaGenerator(bd, param.m_patternGammaThreshold,
-                       m_patterns, m_random),
+                       m_patterns, m_random, m_generatePointCache),
       m_captureGenerator(bd),
-      m_pureRandomGenerator(bd, m_random)
+      m_pureRandomGenerator(bd, m_random, m_generatePointCache),
+      m_tacticalReader(bd),
+      m_profileCounter(0),
+      m_profileTicks(0)
 {
     ClearStatistics();
 }
@@ -440,6 +571,7 @@ void GoUctPlayoutPolicy<BOARD>::ClearStatistics()
 {
     m_statistics[SG_BLACK].Clear();
     m_statistics[SG_WHITE].Clear();
+    m_profile.Clear();
 }
 
 template<class BOARD>
@@ -485,7 +617,11 @@ bool GoUctPlayoutPolicy<BOARD>::GenerateAtariCaptureMove()
 template<class BOARD>
 bool GoUctPlayoutPolicy<BOARD>::GenerateAtariDefenseMove()
 {
-    return GoBoardUtil::AtariDefenseMoves(m_bd, m_lastMove, m_moves);
+    if (! GoBoardUtil::AtariDefenseMoves(m_bd, m_lastMove, m_moves))
+        return false;
+    if (m_param.m_useTacticalReader)
+        RemoveLadderEscapes();
+    return ! m_moves.IsEmpty();
 }
 
 template<class BOARD>
@@ -495,11 +631,32 @@ void GoUctPlayoutPolicy<BOARD>::PlayGoodLiberties(SgPoint block)
     if (! GoBoardUtil::IsSimpleChain(m_bd, block, ignoreOther))
         for (typename BOARD::LibertyIterator it(m_bd, block); it; ++it)
             if (  GoUctUtil::GainsLiberties(m_bd, block, *it)
-               && ! GoBoardUtil::SelfAtari(m_bd, *it)
+               && ! m_generatePointCache.SelfAtari(*it)
                )
                 m_moves.PushBack(*it);
 }
 
+template<class BOARD>
+void GoUctPlayoutPolicy<BOARD>::RemoveLadderEscapes()
+{
+    const SgBlackWhite toPlay = m_bd.ToPlay();
+    GoPointList useless;
+    GoPointList useful;
+    for (GoNb4Iterator<BOARD> it(m_bd, m_lastMove); it; ++it)
+        if (m_bd.GetColor(*it) == toPlay && m_bd.InAtari(*it))
+        {
+            const SgPoint liberty = m_bd.TheLiberty(*it);
+            if (m_tacticalReader.CanEscape(*it))
+                useful.Include(liberty);
+            else
+                useless.Include(liberty);
+        }
+    for (GoPointList::Iterator it(useless); it; ++it)
+        if (! useful.Contains(*it))
+            while (m_moves.Exclude(*it))
+                ;
+}
+
 template<class BOARD>
 bool GoUctPlayoutPolicy<BOARD>::GenerateLowLibMove(SgPoint lastMove)
 {
@@ -513,7 +670,13 @@ bool GoUctPlayoutPolicy<BOARD>::GenerateLowLibMove(SgPoint lastMove)
     if (m_bd.NumLiberties(lastMove) == 2)
     {
         const SgPoint anchor = m_bd.Anchor(lastMove);
-        PlayGoodLiberties(anchor);
+        SgPoint ladderMove;
+        if (  m_param.m_useTacticalReader
+           && m_tacticalReader.CanCapture(anchor, ladderMove)
+           )
+            m_moves.PushBack(ladderMove);
+        else
+            PlayGoodLiberties(anchor);
     }
 
     if (m_bd.NumNeighbors(lastMove, toPlay) != 0)
@@ -544,12 +707,15 @@ SG_ATTR_FLATTEN SgPoint GoUctPlayoutPolicy<BOARD>::GenerateMove()
     m_moves.Clear();
     m_checked = false;
     SgPoint mv = SG_NULLMOVE;
+    const bool profile = StartProfile();
 
     if (m_param.m_fillboardTries > 0)
     {
         m_moveType = GOUCT_FILLBOARD;
         mv = m_pureRandomGenerator.
              GenerateFillboardMove(m_param.m_fillboardTries);
+        if (profile)
+            ProfileStage(GOUCT_FILLBOARD, mv != SG_NULLMOVE);
     }
 
     m_lastMove = m_bd.GetLastMove();
@@ -559,25 +725,45 @@ SG_ATTR_FLATTEN SgPoint GoUctPlayoutPolicy<BOARD>::GenerateMove()
        && ! m_bd.IsEmpty(m_lastMove) // skip if move was suicide
        )
     {
-        if (m_param.m_useNakadeHeuristic && GenerateNakadeMove())
+        if (m_param.m_useNakadeHeuristic)
         {
-            m_moveType = GOUCT_NAKADE;
-            mv = SelectRandom();
+            if (GenerateNakadeMove())
+            {
+                m_moveType = GOUCT_NAKADE;
+                mv = SelectRandom();
+            }
+            if (profile)
+                ProfileStage(GOUCT_NAKADE, mv != SG_NULLMOVE);
         }
-        if (mv == SG_NULLMOVE && GenerateAtariCaptureMove())
+        if (mv == SG_NULLMOVE)
         {
-            m_moveType = GOUCT_ATARI_CAPTURE;
-            mv = SelectRandom();
+            if (GenerateAtariCaptureMove())
+            {
+                m_moveType = GOUCT_ATARI_CAPTURE;
+                mv = SelectRandom();
+            }
+            if (profile)
+                ProfileStage(GOUCT_ATARI_CAPTURE, mv != SG_NULLMOVE);
         }
-        if (mv == SG_NULLMOVE && GenerateAtariDefenseMove())
+        if (mv == SG_NULLMOVE)
         {
-            m_moveType = GOUCT_ATARI_DEFEND;
-            mv = SelectRandom();
+            if (GenerateAtariDefenseMove())
+            {
+                m_moveType = GOUCT_ATARI_DEFEND;
+                mv = SelectRandom();
+            }
+            if (profile)
+                ProfileStage(GOUCT_ATARI_DEFEND, mv != SG_NULLMOVE);
         }
-        if (mv == SG_NULLMOVE && GenerateLowLibMove(m_lastMove))
+        if (mv == SG_NULLMOVE)
         {
-            m_moveType = GOUCT_LOWLIB;
-            mv = SelectRandom();
+            if (GenerateLowLibMove(m_lastMove))
+            {
+                m_moveType = GOUCT_LOWLIB;
+                mv = SelectRandom();
+            }
+            if (profile)
+                ProfileStage(GOUCT_LOWLIB, mv != SG_NULLMOVE);
         }
         if (mv == SG_NULLMOVE)
         {
@@ -585,28 +771,44 @@ SG_ATTR_FLATTEN SgPoint GoUctPlayoutPolicy<BOARD>::GenerateMove()
             {
                 m_moveType = GOUCT_GAMMA_PATTERN;
                 mv = m_gammaGenerator.GenerateBiasedPatternMove();
+                if (profile)
+                    ProfileStage(GOUCT_GAMMA_PATTERN, mv != SG_NULLMOVE);
             }
-            else if (GeneratePatternMove())
+            else
             {
-                m_moveType = GOUCT_PATTERN;
-                mv = SelectRandom();
+                if (GeneratePatternMove())
+                {
+                    m_moveType = GOUCT_PATTERN;
+                    mv = SelectRandom();
+                }
+                if (profile)
+                    ProfileStage(GOUCT_PATTERN, mv != SG_NULLMOVE);
             }
         }
     }
 
     if (mv != SG_NULLMOVE)
-        CorrectMove(GoUctUtil::DoFalseEyeToCaptureCorrection, mv,
+    {
+        const bool corrected =
+            CorrectMove(GoUctUtil::DoFalseEyeToCaptureCorrection, mv,
                         GOUCT_REPLACE_CAPTURE);
+        if (profile)
+            ProfileStage(GOUCT_REPLACE_CAPTURE, corrected);
+    }
     if (mv == SG_NULLMOVE)
     {
         m_moveType = GOUCT_CAPTURE;
         m_captureGenerator.Generate(m_moves);
         mv = SelectRandom();
+        if (profile)
+            ProfileStage(GOUCT_CAPTURE, mv != SG_NULLMOVE);
     }
     if (mv == SG_NULLMOVE)
     {
         m_moveType = GOUCT_RANDOM;
         mv = m_pureRandomGenerator.Generate();
+        if (profile)
+            ProfileStage(GOUCT_RANDOM, mv != SG_NULLMOVE);
     }
     if (mv == SG_NULLMOVE)
     {
@@ -619,9 +821,16 @@ SG_ATTR_FLATTEN SgPoint GoUctPlayoutPolicy<BOARD>::GenerateMove()
         SG_ASSERT(m_bd.IsLegal(mv));
         m_checked = CorrectMove(GoUctUtil::DoSelfAtariCorrection, mv,
                                 GOUCT_SELFATARI_CORRECTION);
+        if (profile)
+            ProfileStage(GOUCT_SELFATARI_CORRECTION, m_checked);
         if (USE_CLUMP_CORRECTION && ! m_checked)
-            CorrectMove(GoUctUtil::DoClumpCorrection, mv,
-                        GOUCT_CLUMP_CORRECTION);
+        {
+            const bool corrected =
+                CorrectMove(GoUctUtil::DoClumpCorrection, mv,
+                            GOUCT_CLUMP_CORRECTION);
+            if (profile)
+                ProfileStage(GOUCT_CLUMP_CORRECTION, corrected);
+        }
     }
     SG_ASSERT(m_bd.IsLegal(mv));
     SG_ASSERT(mv == SG_PASS || ! m_bd.IsSuicide(mv));
@@ -629,6 +838,9 @@ SG_ATTR_FLATTEN SgPoint GoUctPlayoutPolicy<BOARD>::GenerateMove()
     if (m_param.m_statisticsEnabled)
         UpdateStatistics();
 
+    if (profile)
+        m_profile.m_ticks += SgTime::Ticks() - m_profileTicks;
+
     return mv;
 }
 
@@ -734,7 +946,7 @@ inline void GoUctPlayoutPolicy<BOARD>::GeneratePatternMove(SgPoint p)
 {
     if (m_bd.IsEmpty(p)
         && m_patterns.MatchAny(p)
-        && ! GoBoardUtil::SelfAtari(m_bd, p))
+        && ! m_generatePointCache.SelfAtari(p))
         m_moves.PushBack(p);
 }
 
@@ -745,7 +957,7 @@ inline void GoUctPlayoutPolicy<BOARD>::GeneratePatternMove2(SgPoint p,
     if (m_bd.IsEmpty(p)
         && ! SgPointUtil::In8Neighborhood(lastMove, p)
         && m_patterns.MatchAny(p)
-        && ! GoBoardUtil::SelfAtari(m_bd, p))
+        && ! m_generatePointCache.SelfAtari(p))
         m_moves.PushBack(p);
 }
 
@@ -800,6 +1012,7 @@ void GoUctPlayoutPolicy<BOARD>::OnPlay()
 {
     m_captureGenerator.OnPlay();
     m_pureRandomGenerator.OnPlay();
+    m_generatePointCache.OnPlay();
 }
 
 template<class BOARD>
@@ -829,6 +1042,35 @@ inline SgPoint GoUctPlayoutPolicy<BOARD>::SelectRandom()
     return GoUctUtil::SelectRandom(m_bd, m_bd.ToPlay(), m_moves, m_random);
 }
 
+template<class BOARD>
+const GoUctPlayoutPolicyProfile& GoUctPlayoutPolicy<BOARD>::Profile() const
+{
+    return m_profile;
+}
+
+template<class BOARD>
+inline void GoUctPlayoutPolicy<BOARD>::ProfileStage(
+                                   GoUctPlayoutPolicyType type, bool hit)
+{
+    const uint64_t ticks = SgTime::Ticks();
+    m_profile.Add(type, hit, ticks - m_profileTicks);
+    m_profile.m_ticks += ticks - m_profileTicks;
+    m_profileTicks = ticks;
+}
+
+template<class BOARD>
+inline bool GoUctPlayoutPolicy<BOARD>::StartProfile()
+{
+    if (  m_param.m_profileInterval <= 0
+       || ++m_profileCounter < m_param.m_profileInterval
+       )
+        return false;
+    m_profileCounter = 0;
+    ++m_profile.m_nuSamples;
+    m_profileTicks = SgTime::Ticks();
+    return true;
+}
+
 template<class BOARD>
 const GoUctPlayoutPolicyStat&
 GoUctPlayoutPolicy<BOARD>::Statistics(SgBlackWhite color) const
@@ -841,6 +1083,9 @@ void GoUctPlayoutPolicy<BOARD>::StartPlayout()
 {
     m_captureGenerator.StartPlayout();
     m_pureRandomGenerator.Start();
+    m_generatePointCache.SetEnabled(m_param.m_useGeneratePointCache);
+    if (m_param.m_useTacticalReader)
+        m_tacticalReader.SetMaxNodes(m_param.m_tacticalReaderMaxNodes);
     m_nonRandLen = 0;
 }
 
@@ -850,6 +1095,15 @@ void GoUctPlayoutPolicy<BOARD>::UpdateStatistics()
     GoUctPlayoutPolicyStat& statistics = m_statistics[m_bd.ToPlay()];
     ++statistics.m_nuMoves;
     ++statistics.m_nuMoveType[m_moveType];
+    const uint64_t nuRandomDraws = m_random.NuDraws();
+    statistics.m_nuRandomDraws += nuRandomDraws - m_nuRandomDraws;
+    m_nuRandomDraws = nuRandomDraws;
+    const std::size_t nuTacticalLookups = m_tacticalReader.NuLookups();
+    statistics.m_nuTacticalLookups += nuTacticalLookups - m_nuTacticalLookups;
+    m_nuTacticalLookups = nuTacticalLookups;
+    const std::size_t nuTacticalHits = m_tacticalReader.NuHits();
+    statistics.m_nuTacticalHits += nuTacticalHits - m_nuTacticalHits;
+    m_nuTacticalHits = nuTacticalHits;
     if (m_moveType == GOUCT_RANDOM)
     {
         if (m_nonRandLen > 0)
@@ -7,6 +7,7 @@
 
 #include <vector>
 #include "GoBoard.h"
+#include "GoUctGeneratePointCache.h"
 #include "GoUctUtil.h"
 #include "SgWrite.h"
 
@@ -24,29 +25,29 @@
     fully uniform distribution outweighs its benfits, e.g. GoUctPlayoutPolicy
     does not filter duplicate points in the move lists generated by
     patterns). Even a constant time algorithm for removing points from the
-    list is slower than the current implementation. */
+    list is slower than the current implementation.
+
+    With GoUctBoard, the generator does not keep its own list, but selects
+    random points from the set of empty points maintained by the board
+    (GoUctBoard::EmptyPoint()), which avoids rebuilding and shuffling a list
+    at the start of each playout and needs no lazy removal of occupied
+    points. */
 template<class BOARD>
 class GoUctPureRandomGenerator
 {
 public:
-    GoUctPureRandomGenerator(const BOARD& bd, SgRandom& random);
+    GoUctPureRandomGenerator(const BOARD& bd, SgRandom& random,
+                          GoUctGeneratePointCache<BOARD>& generatePointCache);
 
-    /** Finds and shuffles the empty points currently on the board. */
+    /** Finds and shuffles the empty points currently on the board.
+        With GoUctBoard, only initializes the constants for the board
+        size. */
     void Start();
 
     /** Update state.
         Must be called after each play on the board. */
     void OnPlay();
 
-    /** Return a list of points that are currently potentially empty.
-        As a side-benefit, the generator can be used to get the list of empty
-        points on the board to speed up full-board loops over empty points
-        or to get a shuffled list of the empty points (e.g. for finding
-        legal moves when expanding a node in the in-tree-phase of UCT).
-        Points in the list are candidates, they still have to be tested, if
-        they are really empty. */
-    const std::vector<SgPoint>& Candidates() const;
-
     /** Generate a pure random move.
         Randomly select an empty point on the board that fulfills
         GoUctUtil::GeneratePoint() for the color currently to play on the
@@ -78,6 +79,8 @@ private:
 
     SgRandom& m_random;
 
+    GoUctGeneratePointCache<BOARD>& m_generatePointCache;
+
     /** Points that are potentially empty. */
     std::vector<SgPoint> m_candidates;
 
@@ -90,21 +93,15 @@ private:
 
 template<class BOARD>
 GoUctPureRandomGenerator<BOARD>::GoUctPureRandomGenerator(const BOARD& bd,
-                                                          SgRandom& random)
+                          SgRandom& random,
+                          GoUctGeneratePointCache<BOARD>& generatePointCache)
     : m_bd(bd),
-      m_random(random)
+      m_random(random),
+      m_generatePointCache(generatePointCache)
 {
     m_candidates.reserve(GO_MAX_NUM_MOVES);
 }
 
-template<class BOARD>
-inline const std::vector<SgPoint>&
-GoUctPureRandomGenerator<BOARD>::Candidates()
-    const
-{
-    return m_candidates;
-}
-
 template<class BOARD>
 inline void GoUctPureRandomGenerator<BOARD>::CheckConsistency() const
 {
@@ -150,7 +147,6 @@ template<class BOARD>
 inline SgPoint GoUctPureRandomGenerator<BOARD>::Generate()
 {
     CheckConsistency();
-    SgBlackWhite toPlay = m_bd.ToPlay();
     size_t i = m_candidates.size();
     while (true)
     {
@@ -164,7 +160,7 @@ inline SgPoint GoUctPureRandomGenerator<BOARD>::Generate()
             m_candidates.pop_back();
             continue;
         }
-        if (GoUctUtil::GeneratePoint(m_bd, p, toPlay))
+        if (m_generatePointCache.GeneratePoint(p))
         {
             CheckConsistency();
             return p;
@@ -270,4 +266,69 @@ inline void GoUctPureRandomGenerator<BOARD>::Start()
 
 //----------------------------------------------------------------------------
 
+/** Generate a pure random move on a GoUctBoard.
+    Samples the empty points of the board without replacement. Points for
+    which GoUctUtil::GeneratePoint() fails are moved behind the range of
+    remaining candidates with GoUctBoard::SwapEmpty(). */
+template<>
+inline SgPoint GoUctPureRandomGenerator<GoUctBoard>::Generate()
+{
+    int n = m_bd.NumEmpty();
+    while (n > 0)
+    {
+        const int i = m_random.SmallInt(n);
+        const SgPoint p = m_bd.EmptyPoint(i);
+        if (m_generatePointCache.GeneratePoint(p))
+            return p;
+        --n;
+        m_bd.SwapEmpty(i, n);
+    }
+    return SG_NULLMOVE;
+}
+
+template<>
+inline SgPoint GoUctPureRandomGenerator<GoUctBoard>::GenerateFillboardMove(
+                                                              int numberTries)
+{
+    const int nuEmpty = m_bd.NumEmpty();
+    if (nuEmpty == 0)
+        return SG_NULLMOVE;
+    float effectiveTries = float(numberTries) * float(nuEmpty) * m_invNuPoints;
+    while (effectiveTries > 1.f)
+    {
+        SgPoint p = m_bd.EmptyPoint(m_random.SmallInt(nuEmpty));
+        if (Empty3x3(p))
+            return p;
+        effectiveTries -= 1.f;
+    }
+    // Remaining fractional number of tries
+    if (m_random.SmallInt(100) > 100 * effectiveTries)
+        return SG_NULLMOVE;
+    SgPoint p = m_bd.EmptyPoint(m_random.SmallInt(nuEmpty));
+    if (Empty3x3(p))
+        return p;
+    return SG_NULLMOVE;
+}
+
+template<>
+inline SgPoint GoUctPureRandomGenerator<GoUctBoard>::GenerateRawPoint() const
+{
+    const int nuEmpty = m_bd.NumEmpty();
+    if (nuEmpty == 0)
+        return SG_NULLMOVE;
+    return m_bd.EmptyPoint(nuEmpty - 1);
+}
+
+template<>
+inline void GoUctPureRandomGenerator<GoUctBoard>::OnPlay()
+{ }
+
+template<>
+inline void GoUctPureRandomGenerator<GoUctBoard>::Start()
+{
+    m_invNuPoints = 1.f / float(m_bd.Size() * m_bd.Size());
+}
+
+//----------------------------------------------------------------------------
+
 #endif // GOUCT_PURERANDOMGENERATOR_H
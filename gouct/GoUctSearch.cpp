@@ -170,6 +170,9 @@ GoUctSearch::GoUctSearch(GoBoard& bd, SgUctThreadStateFactory* factory)
     : SgUctSearch(factory, MOVERANGE),
       m_keepGames(false),
       m_liveGfxInterval(5000),
+      m_analyzeStream(0),
+      m_analyzeInterval(1),
+      m_nextAnalyze(0),
       m_toPlay(SG_BLACK),
       m_bd(bd),
       m_root(0),
@@ -211,6 +214,15 @@ void GoUctSearch::OnSearchIteration(SgUctValue gameNumber,
     {
         DisplayGfx();
     }
+    if (m_analyzeStream != 0 && threadId == 0)
+    {
+        double time = m_analyzeTimer.GetTime();
+        if (time >= m_nextAnalyze)
+        {
+            m_nextAnalyze = time + m_analyzeInterval;
+            GoUctUtil::WriteAnalyzeInfo(*this, *m_analyzeStream);
+        }
+    }
     if (! LockFree() && m_root != 0)
         AppendGame(m_root, gameNumber, threadId, m_toPlay, info);
 }
@@ -265,6 +277,8 @@ void GoUctSearch::OnStartSearch()
     m_boardHistory.SetFromBoard(m_bd);
 
     m_nextLiveGfx = m_liveGfxInterval;
+    m_nextAnalyze = m_analyzeInterval;
+    m_analyzeTimer.Start();
 }
 
 void GoUctSearch::SaveGames(const std::string& fileName) const
@@ -13,6 +13,7 @@
 #include "SgUctSearch.h"
 #include "SgBlackWhite.h"
 #include "SgStatistics.h"
+#include "SgTimer.h"
 
 class SgNode;
 
@@ -235,6 +236,25 @@ public:
     /** See LiveGfxInterval() */
     void SetLiveGfxInterval(SgUctValue interval);
 
+    /** Stream for analysis output during the search.
+        If not null, the moves at the root are written to the stream with
+        GoUctUtil::WriteAnalyzeInfo() every AnalyzeInterval() seconds
+        during the search. Like the live graphics, the output is written by
+        the first search thread. Default is null.
+        @see GoUctPlayer::Analyze() */
+    std::ostream* AnalyzeStream() const;
+
+    /** See AnalyzeStream() */
+    void SetAnalyzeStream(std::ostream* out);
+
+    /** Interval in seconds for the analysis output.
+        Default is 1.
+        @see AnalyzeStream() */
+    double AnalyzeInterval() const;
+
+    /** See AnalyzeInterval() */
+    void SetAnalyzeInterval(double interval);
+
     // @} // @name
 
 protected:
@@ -249,6 +269,18 @@ private:
 
     volatile SgUctValue m_nextLiveGfx;
 
+    /** See SetAnalyzeStream() */
+    std::ostream* m_analyzeStream;
+
+    /** See SetAnalyzeInterval() */
+    double m_analyzeInterval;
+
+    /** Time of the next analysis output. */
+    double m_nextAnalyze;
+
+    /** Measures the time for the analysis output since the search start. */
+    SgTimer m_analyzeTimer;
+
     /** Color to play.
         Does not use GoBoard::ToPlay(), because the color to play at the
         root node of the search could be needed after the board has
@@ -277,6 +309,16 @@ private:
     GoUctSearch& operator=(const GoUctSearch& search);
 };
 
+inline double GoUctSearch::AnalyzeInterval() const
+{
+    return m_analyzeInterval;
+}
+
+inline std::ostream* GoUctSearch::AnalyzeStream() const
+{
+    return m_analyzeStream;
+}
+
 inline GoBoard& GoUctSearch::Board()
 {
     return m_bd;
@@ -307,6 +349,17 @@ inline SgUctValue GoUctSearch::LiveGfxInterval() const
     return m_liveGfxInterval;
 }
 
+inline void GoUctSearch::SetAnalyzeInterval(double interval)
+{
+    SG_ASSERT(interval > 0);
+    m_analyzeInterval = interval;
+}
+
+inline void GoUctSearch::SetAnalyzeStream(std::ostream* out)
+{
+    m_analyzeStream = out;
+}
+
 inline void GoUctSearch::SetKeepGames(bool enable)
 {
     m_keepGames = enable;
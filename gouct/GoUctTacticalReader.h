@@ -0,0 +1,597 @@
+//----------------------------------------------------------------------------
+/** @file GoUctTacticalReader.h */
+//----------------------------------------------------------------------------
+
+#ifndef GOUCT_TACTICALREADER_H
+#define GOUCT_TACTICALREADER_H
+
+#include "GoBoard.h"
+#include "SgArray.h"
+#include "SgArrayList.h"
+#include "SgHash.h"
+#include "SgPoint.h"
+#include "SgRect.h"
+
+//----------------------------------------------------------------------------
+
+/** Bounded reader for blocks with one or two liberties, fast enough for
+    use in playouts.
+    Reads the sequence in which the attacker always plays atari on one of the
+    two liberties of the block and the block always extends on its last
+    liberty. This covers ladders and nets that consist of ataris.
+    The block escapes, if it gets three or more liberties, if it can capture
+    an adjacent attacker block in atari, or if the reading exceeds the depth
+    or node limit. Captures by the attacker during the sequence are not
+    considered.
+
+    The reader does not play moves on the board, because GoUctBoard has no
+    undo. Moves of the sequence are stored in a local overlay of the board
+    colors, and liberties are counted by flood fill on the overlay.
+
+    Results are stored in a small direct-mapped cache keyed by the block
+    anchor and its liberties. Each entry also stores the read area, the
+    rectangle of all points whose color was looked at during the reading,
+    and a hash code of the stones inside it. An entry is only used, if the
+    stones in its read area are unchanged. So the cache stays valid when
+    moves are played or the board is set up again, e.g. in the next
+    playout, and a move inside the read area, like a new ladder breaker,
+    invalidates the entry.
+    Instances are not thread-safe, each playout policy has its own reader. */
+template<class BOARD>
+class GoUctTacticalReader
+{
+public:
+    /** Maximum number of moves in a sequence.
+        Enough for a ladder across the board. */
+    static const int MAX_DEPTH = 4 * SG_MAX_SIZE;
+
+    GoUctTacticalReader(const BOARD& bd);
+
+    /** Set the maximum number of nodes searched per call.
+        Default is 200, which is enough for a ladder across the board.
+        Clears the cache, if the value changes. */
+    void SetMaxNodes(int maxNodes);
+
+    /** Invalidate the cache.
+        Takes constant time. Never needed for correct results, the cache is
+        also cleared automatically if the board size or the maximum number
+        of nodes (see SetMaxNodes()) changes. */
+    void Clear();
+
+    /** Number of calls of CanCapture() and CanEscape(). */
+    std::size_t NuLookups() const;
+
+    /** Number of calls of CanCapture() and CanEscape() that used a result
+        from the cache. */
+    std::size_t NuHits() const;
+
+    /** Can the opponent of a block capture it, moving first?
+        @param block A stone of the block
+        @param[out] move The first move of the capturing sequence, if the
+        block can be captured.
+        @return @c true, if the block has at most two liberties and is
+        captured by the sequence of ataris described in the class
+        documentation. */
+    bool CanCapture(SgPoint block, SgPoint& move);
+
+    /** Can a block in atari escape, its owner moving first?
+        @param block A stone of the block
+        @return @c false, if extending on the last liberty gets the block
+        captured by CanCapture() and the block cannot capture an adjacent
+        block in atari */
+    bool CanEscape(SgPoint block);
+
+private:
+    /** Entry in the result cache. */
+    struct CacheEntry
+    {
+        /** Value of m_cacheId when the entry was stored. */
+        unsigned int m_id;
+
+        SgPoint m_anchor;
+
+        SgPoint m_lib1;
+
+        SgPoint m_lib2;
+
+        /** True for CanCapture(), false for CanEscape(). */
+        bool m_attackerToPlay;
+
+        /** Result of the reading, @c true if the block is captured. */
+        bool m_isCaptured;
+
+        SgPoint m_move;
+
+        /** Read area of the reading. Empty, if no reading was needed. */
+        SgRect m_area;
+
+        /** Hash code of the stones in m_area. */
+        SgHashCode m_hash;
+    };
+
+    /** Number of entries in the cache. Must be a power of two. */
+    static const int CACHE_SIZE = 64;
+
+    const BOARD& m_bd;
+
+    int m_maxNodes;
+
+    /** Number of nodes searched in the current call. */
+    int m_nuNodes;
+
+    /** Color of the block that is read. */
+    SgBlackWhite m_preyColor;
+
+    /** A stone of the block that is read. */
+    SgPoint m_prey;
+
+    /** Points of the moves in the current sequence. */
+    SgArrayList<SgPoint,MAX_DEPTH> m_sequence;
+
+    /** Colors of the points in m_sequence. */
+    SgArray<int,SG_MAXPOINT> m_overlayColor;
+
+    /** Marks points in m_sequence. */
+    SgArray<bool,SG_MAXPOINT> m_isOverlay;
+
+    /** Marks points visited in the current flood fill, if equal to
+        m_visitId. */
+    SgArray<unsigned int,SG_MAXPOINT> m_visited;
+
+    unsigned int m_visitId;
+
+    /** Stones of the opponent adjacent to a block, possibly several stones
+        of the same block. See Liberties() */
+    SgArrayList<SgPoint,4 * SG_MAX_ONBOARD> m_adjacent;
+
+    SgArray<CacheEntry,CACHE_SIZE> m_cache;
+
+    /** Entries with a different id are invalid, see Clear(). */
+    unsigned int m_cacheId;
+
+    /** Board size of the entries in the cache. */
+    SgGrid m_size;
+
+    /** Read area of the current reading, see CacheEntry::m_area. */
+    SgRect m_area;
+
+    /** See NuLookups() */
+    std::size_t m_nuLookups;
+
+    /** See NuHits() */
+    std::size_t m_nuHits;
+
+    /** Hash code of the stones in a rectangle on the board. */
+    SgHashCode AreaHash(const SgRect& area) const;
+
+    /** Color of a point on the overlay board.
+        Adds the point to the read area. */
+    int Color(SgPoint p);
+
+    void Play(SgPoint p, SgBlackWhite c);
+
+    void Undo();
+
+    void StartVisit();
+
+    /** Count the liberties of the block at p on the overlay board.
+        @param p A stone of the block
+        @param maxLibs Stop counting after maxLibs liberties
+        @param[out] libs The liberties found
+        @param findAdjacent Also find the stones of the opponent adjacent to
+        the block and store them in m_adjacent.
+        @return The number of liberties, at most maxLibs */
+    int Liberties(SgPoint p, int maxLibs, SgArrayList<SgPoint,3>& libs,
+                  bool findAdjacent = false);
+
+    /** Is the block at p in atari on the overlay board? */
+    bool InAtari(SgPoint p);
+
+    /** Number of empty neighbors of a point on the overlay board. */
+    int NumEmptyNeighbors(SgPoint p);
+
+    /** Reading with the prey block in atari and the prey to play.
+        @param extension The liberty of the prey
+        @return @c true, if the prey is captured */
+    bool PreyToPlay(SgPoint extension);
+
+    /** Reading with the prey block having two liberties and the attacker
+        to play.
+        @param libs The liberties of the prey
+        @param[out] move The atari that captures the prey
+        @return @c true, if the prey is captured */
+    bool AttackerToPlay(const SgArrayList<SgPoint,3>& libs, SgPoint& move);
+
+    /** Start a new reading and look up the cache.
+        @return The cache entry for the block */
+    CacheEntry& Start(SgPoint block, bool attackerToPlay, bool& found);
+
+    /** Store the read area of the finished reading in the cache entry. */
+    void Store(CacheEntry& entry);
+};
+
+template<class BOARD>
+GoUctTacticalReader<BOARD>::GoUctTacticalReader(const BOARD& bd)
+    : m_bd(bd),
+      m_maxNodes(200),
+      m_nuNodes(0),
+      m_preyColor(SG_BLACK),
+      m_prey(SG_NULLPOINT),
+      m_overlayColor(SG_EMPTY),
+      m_isOverlay(false),
+      m_visited(0),
+      m_visitId(0),
+      m_cacheId(1),
+      m_size(0),
+      m_nuLookups(0),
+      m_nuHits(0)
+{
+    for (int i = 0; i < CACHE_SIZE; ++i)
+        m_cache[i].m_id = 0;
+}
+
+template<class BOARD>
+SgHashCode GoUctTacticalReader<BOARD>::AreaHash(const SgRect& area) const
+{
+    SgHashCode hash;
+    if (area.IsEmpty())
+        return hash;
+    const SgHashZobristTable& table = SgHashZobristTable::GetTable();
+    for (SgRectIterator it(area); it; ++it)
+    {
+        const SgBoardColor c = m_bd.GetColor(*it);
+        if (c == SG_BLACK)
+            hash.Xor(table.Get(*it));
+        else if (c == SG_WHITE)
+            hash.Xor(table.Get(SG_MAXPOINT + *it));
+    }
+    return hash;
+}
+
+template<class BOARD>
+bool GoUctTacticalReader<BOARD>::AttackerToPlay(
+                                        const SgArrayList<SgPoint,3>& libs,
+                                        SgPoint& move)
+{
+    SG_ASSERT(libs.Length() == 2);
+    if (++m_nuNodes > m_maxNodes || m_sequence.Length() + 2 > MAX_DEPTH)
+        return false;
+    const SgBlackWhite attacker = SgOppBW(m_preyColor);
+    for (int i = 0; i < 2; ++i)
+    {
+        const SgPoint atari = libs[i];
+        const SgPoint extension = libs[1 - i];
+        // Skip the atari, if the extension gets at least three liberties
+        int extensionLibs = NumEmptyNeighbors(extension);
+        if (SgPointUtil::AreAdjacent(atari, extension))
+            --extensionLibs;
+        if (extensionLibs >= 3)
+            continue;
+        Play(atari, attacker);
+        SgArrayList<SgPoint,3> atariLibs;
+        // Suicide is illegal
+        const bool isCaptured =
+            (  (  NumEmptyNeighbors(atari) > 0
+               || Liberties(atari, 1, atariLibs) > 0
+               )
+            && PreyToPlay(extension)
+            );
+        Undo();
+        if (isCaptured)
+        {
+            move = atari;
+            return true;
+        }
+    }
+    return false;
+}
+
+template<class BOARD>
+bool GoUctTacticalReader<BOARD>::CanCapture(SgPoint block, SgPoint& move)
+{
+    bool found;
+    CacheEntry& entry = Start(block, true, found);
+    if (! found)
+    {
+        entry.m_move = SG_NULLMOVE;
+        if (entry.m_lib2 == SG_NULLPOINT)
+        {
+            entry.m_isCaptured = (entry.m_lib1 != SG_NULLPOINT);
+            entry.m_move = entry.m_lib1;
+        }
+        else
+        {
+            SgArrayList<SgPoint,3> libs;
+            libs.PushBack(entry.m_lib1);
+            libs.PushBack(entry.m_lib2);
+            entry.m_isCaptured = AttackerToPlay(libs, entry.m_move);
+            Store(entry);
+        }
+    }
+    move = entry.m_move;
+    return entry.m_isCaptured;
+}
+
+template<class BOARD>
+bool GoUctTacticalReader<BOARD>::CanEscape(SgPoint block)
+{
+    SG_ASSERT(m_bd.InAtari(block));
+    bool found;
+    CacheEntry& entry = Start(block, false, found);
+    if (! found)
+    {
+        entry.m_isCaptured = PreyToPlay(entry.m_lib1);
+        Store(entry);
+    }
+    return ! entry.m_isCaptured;
+}
+
+template<class BOARD>
+void GoUctTacticalReader<BOARD>::Clear()
+{
+    if (++m_cacheId == 0)
+    {
+        for (int i = 0; i < CACHE_SIZE; ++i)
+            m_cache[i].m_id = 0;
+        m_cacheId = 1;
+    }
+}
+
+template<class BOARD>
+inline int GoUctTacticalReader<BOARD>::Color(SgPoint p)
+{
+    m_area.Include(p);
+    return m_isOverlay[p] ? m_overlayColor[p] : m_bd.GetColor(p);
+}
+
+template<class BOARD>
+bool GoUctTacticalReader<BOARD>::InAtari(SgPoint p)
+{
+    if (! m_isOverlay[p])
+    {
+        // Stones of the sequence can remove liberties of the block on the
+        // real board or add liberties by merging with it
+        int nuLibs = 0;
+        for (typename BOARD::LibertyIterator it(m_bd, p); it; ++it)
+            if (! m_isOverlay[*it])
+            {
+                m_area.Include(*it);
+                if (++nuLibs >= 2)
+                    return false;
+            }
+    }
+    SgArrayList<SgPoint,3> libs;
+    return Liberties(p, 2, libs) == 1;
+}
+
+template<class BOARD>
+int GoUctTacticalReader<BOARD>::Liberties(SgPoint p, int maxLibs,
+                                          SgArrayList<SgPoint,3>& libs,
+                                          bool findAdjacent)
+{
+    SG_ASSERT(maxLibs <= 3);
+    const int c = Color(p);
+    SG_ASSERT(c == SG_BLACK || c == SG_WHITE);
+    const int opp = SgOppBW(c);
+    StartVisit();
+    libs.Clear();
+    if (findAdjacent)
+        m_adjacent.Clear();
+    SgArrayList<SgPoint,SG_MAX_ONBOARD> stack;
+    stack.PushBack(p);
+    m_visited[p] = m_visitId;
+    while (! stack.IsEmpty())
+    {
+        const SgPoint stone = stack.Last();
+        stack.PopBack();
+        for (SgNb4Iterator it(stone); it; ++it)
+        {
+            const SgPoint nb = *it;
+            if (m_visited[nb] == m_visitId)
+                continue;
+            const int nbColor = Color(nb);
+            if (nbColor == c)
+            {
+                m_visited[nb] = m_visitId;
+                stack.PushBack(nb);
+            }
+            else if (nbColor == SG_EMPTY)
+            {
+                m_visited[nb] = m_visitId;
+                if (libs.Length() < maxLibs)
+                    libs.PushBack(nb);
+                if (libs.Length() == maxLibs && ! findAdjacent)
+                    return maxLibs;
+            }
+            else if (nbColor == opp && findAdjacent)
+                m_adjacent.PushBack(nb);
+        }
+    }
+    return libs.Length();
+}
+
+template<class BOARD>
+inline std::size_t GoUctTacticalReader<BOARD>::NuHits() const
+{
+    return m_nuHits;
+}
+
+template<class BOARD>
+inline std::size_t GoUctTacticalReader<BOARD>::NuLookups() const
+{
+    return m_nuLookups;
+}
+
+template<class BOARD>
+inline int GoUctTacticalReader<BOARD>::NumEmptyNeighbors(SgPoint p)
+{
+    return int(Color(p + SG_NS) == SG_EMPTY)
+         + int(Color(p - SG_NS) == SG_EMPTY)
+         + int(Color(p + SG_WE) == SG_EMPTY)
+         + int(Color(p - SG_WE) == SG_EMPTY);
+}
+
+template<class BOARD>
+void GoUctTacticalReader<BOARD>::Play(SgPoint p, SgBlackWhite c)
+{
+    SG_ASSERT(Color(p) == SG_EMPTY);
+    m_sequence.PushBack(p);
+    m_overlayColor[p] = c;
+    m_isOverlay[p] = true;
+}
+
+template<class BOARD>
+bool GoUctTacticalReader<BOARD>::PreyToPlay(SgPoint extension)
+{
+    if (++m_nuNodes > m_maxNodes || m_sequence.Length() + 1 > MAX_DEPTH)
+        return false;
+    // The extension gets at least three liberties
+    if (NumEmptyNeighbors(extension) >= 3)
+        return false;
+    SgArrayList<SgPoint,3> libs;
+    Liberties(m_prey, 1, libs, true);
+    SG_ASSERT(libs.Length() == 1 && libs[0] == extension);
+    // Stones of the prey are still marked as visited by Liberties()
+    bool isMerged = false;
+    for (SgNb4Iterator it(extension); it; ++it)
+        if (Color(*it) == m_preyColor && m_visited[*it] != m_visitId)
+            isMerged = true;
+    // Capture an adjacent block in atari. InAtari() does not use m_adjacent
+    SgPoint lastAnchor = SG_NULLPOINT;
+    for (SgArrayList<SgPoint,4 * SG_MAX_ONBOARD>::Iterator it(m_adjacent);
+         it; ++it)
+    {
+        // Avoid checking the same block on the real board repeatedly in the
+        // common case of consecutive stones of the same block
+        if (! m_isOverlay[*it])
+        {
+            const SgPoint anchor = m_bd.Anchor(*it);
+            if (anchor == lastAnchor)
+                continue;
+            lastAnchor = anchor;
+        }
+        if (InAtari(*it))
+            return false;
+    }
+    // Capture another block by the extension
+    const SgBlackWhite attacker = SgOppBW(m_preyColor);
+    for (SgNb4Iterator it(extension); it; ++it)
+        if (Color(*it) == attacker && InAtari(*it))
+            return false;
+    Play(extension, m_preyColor);
+    if (isMerged)
+        Liberties(m_prey, 3, libs);
+    else
+    {
+        // The only liberties are the empty neighbors of the extension
+        libs.Clear();
+        for (SgNb4Iterator it(extension); it; ++it)
+            if (Color(*it) == SG_EMPTY)
+                libs.PushBack(*it);
+    }
+    bool isCaptured;
+    if (libs.Length() == 2)
+    {
+        SgPoint ignoreMove;
+        isCaptured = AttackerToPlay(libs, ignoreMove);
+    }
+    else
+        isCaptured = (libs.Length() < 2);
+    Undo();
+    return isCaptured;
+}
+
+template<class BOARD>
+void GoUctTacticalReader<BOARD>::SetMaxNodes(int maxNodes)
+{
+    if (maxNodes != m_maxNodes)
+        Clear();
+    m_maxNodes = maxNodes;
+}
+
+template<class BOARD>
+typename GoUctTacticalReader<BOARD>::CacheEntry&
+GoUctTacticalReader<BOARD>::Start(SgPoint block, bool attackerToPlay,
+                                  bool& found)
+{
+    SG_ASSERT(m_sequence.IsEmpty());
+    ++m_nuLookups;
+    if (m_bd.Size() != m_size)
+    {
+        Clear();
+        m_size = m_bd.Size();
+    }
+    const SgPoint anchor = m_bd.Anchor(block);
+    SgPoint lib1 = SG_NULLPOINT;
+    SgPoint lib2 = SG_NULLPOINT;
+    if (m_bd.NumLiberties(anchor) <= 2)
+    {
+        for (typename BOARD::LibertyIterator it(m_bd, anchor); it; ++it)
+        {
+            if (lib1 == SG_NULLPOINT)
+                lib1 = *it;
+            else
+                lib2 = *it;
+        }
+    }
+    if (lib2 != SG_NULLPOINT && lib2 < lib1)
+        std::swap(lib1, lib2);
+    const int index = (anchor * 31 + lib1 * 7 + lib2 + int(attackerToPlay))
+                      & (CACHE_SIZE - 1);
+    CacheEntry& entry = m_cache[index];
+    found = (entry.m_id == m_cacheId
+             && entry.m_anchor == anchor
+             && entry.m_lib1 == lib1
+             && entry.m_lib2 == lib2
+             && entry.m_attackerToPlay == attackerToPlay
+             && AreaHash(entry.m_area) == entry.m_hash);
+    if (found)
+        ++m_nuHits;
+    else
+    {
+        entry.m_id = m_cacheId;
+        entry.m_anchor = anchor;
+        entry.m_lib1 = lib1;
+        entry.m_lib2 = lib2;
+        entry.m_attackerToPlay = attackerToPlay;
+        entry.m_isCaptured = false;
+        entry.m_area = SgRect();
+        entry.m_hash.Clear();
+        m_nuNodes = 0;
+        m_preyColor = m_bd.GetStone(anchor);
+        m_prey = anchor;
+        m_area = SgRect();
+    }
+    return entry;
+}
+
+template<class BOARD>
+void GoUctTacticalReader<BOARD>::Store(CacheEntry& entry)
+{
+    SG_ASSERT(m_sequence.IsEmpty());
+    // The border points in the read area never change
+    m_area.Intersect(SgRect(1, m_bd.Size(), 1, m_bd.Size()));
+    entry.m_area = m_area;
+    entry.m_hash = AreaHash(m_area);
+}
+
+template<class BOARD>
+inline void GoUctTacticalReader<BOARD>::StartVisit()
+{
+    if (++m_visitId == 0)
+    {
+        m_visited.Fill(0);
+        m_visitId = 1;
+    }
+}
+
+template<class BOARD>
+void GoUctTacticalReader<BOARD>::Undo()
+{
+    m_isOverlay[m_sequence.Last()] = false;
+    m_sequence.PopBack();
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GOUCT_TACTICALREADER_H
@@ -5,8 +5,10 @@
 #include "SgSystem.h"
 #include "GoUctUtil.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <boost/io/ios_state.hpp>
 #include <boost/format.hpp>
 #include "SgBWSet.h"
@@ -244,6 +246,12 @@ bool IsMeanLess(const SgUctNode* lhs, const SgUctNode* rhs)
     return (lhs->Mean() < rhs->Mean());
 }
 
+/** Assist to sort nodes in GoUctUtil::WriteAnalyzeInfo */
+bool IsMoveCountGreater(const SgUctNode* lhs, const SgUctNode* rhs)
+{
+    return (lhs->MoveCount() > rhs->MoveCount());
+}
+
 } // namespace
 
 std::string GoUctUtil::ChildrenStatistics(const SgUctSearch& search,
@@ -269,4 +277,42 @@ std::string GoUctUtil::ChildrenStatistics(const SgUctSearch& search,
     return out.str();
 }
 
+void GoUctUtil::WriteAnalyzeInfo(const SgUctSearch& search, ostream& out)
+{
+    const SgUctTree& tree = search.Tree();
+    const SgUctNode& root = tree.Root();
+    if (! root.HasChildren())
+        return;
+    vector<const SgUctNode*> children;
+    for (SgUctChildIterator it(tree, root); it; ++it)
+        if ((*it).HasMean() && (*it).MoveCount() > 0)
+            children.push_back(&(*it));
+    if (children.empty())
+        return;
+    stable_sort(children.begin(), children.end(), IsMoveCountGreater);
+    std::ostringstream buffer;
+    for (size_t i = 0; i < children.size(); ++i)
+    {
+        const SgUctNode* node = children[i];
+        SgUctValue value = SgUctSearch::InverseEval(node->Mean());
+        if (i > 0)
+            buffer << ' ';
+        buffer << "info move " << SgWritePoint(node->Move())
+               << " visits " << static_cast<long>(node->MoveCount())
+               << " winrate " << static_cast<int>(value * 10000 + 0.5f)
+               << " order " << i << " pv";
+        while (true)
+        {
+            buffer << ' ' << SgWritePoint(node->Move());
+            if (! node->HasChildren())
+                break;
+            node = search.FindBestChild(*node);
+            if (node == 0)
+                break;
+        }
+    }
+    buffer << '\n';
+    out << buffer.str() << std::flush;
+}
+
 //----------------------------------------------------------------------------
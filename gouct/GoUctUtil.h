@@ -172,6 +172,20 @@ namespace GoUctUtil
             const SgPointArray<SgUctStatistics>& territoryStatistics,
             const GoBoard& bd, std::ostream& out);
 
+    /** Print the moves at the root of the search in the format of the
+        lz-analyze command of Leela Zero.
+        Writes one line with an entry for each move with a count, ordered by
+        the counts:
+        <tt>info move D4 visits 120 winrate 5510 order 0 pv D4 Q16 ...</tt>
+        The win rate is the value of the move for the color to play at the
+        root in units of 0.01 percent. The principal variation is the best
+        sequence starting with the move. Writes nothing, if no move has a
+        count yet, and flushes the stream otherwise.
+        Can be used during the search like the live graphics.
+        @param search The search containing the tree
+        @param out The stream to write the line to */
+    void WriteAnalyzeInfo(const SgUctSearch& search, std::ostream& out);
+
     /** selfatari of a larger number of stones and also atari on opponent. */
     template<class BOARD>
     bool IsMutualAtari(const BOARD& bd, SgPoint p, SgBlackWhite toPlay);
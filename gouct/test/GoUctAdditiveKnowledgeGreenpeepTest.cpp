@@ -0,0 +1,119 @@
+//----------------------------------------------------------------------------
+/** @file GoUctAdditiveKnowledgeGreenpeepTest.cpp
+    Unit tests for GoUctAdditiveKnowledgeGreenpeep. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <vector>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoUctAdditiveKnowledgeGreenpeep.h"
+#include "SgRandom.h"
+
+using std::vector;
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Compare the contexts of all legal moves computed by
+    GoUctAdditiveKnowledgeGreenpeep::ComputeContextsBatch() and
+    GoUctAdditiveKnowledgeGreenpeep::ComputeContextsPointwise(). */
+void CheckContexts(const GoBoard& bd)
+{
+    vector<SgUctMoveInfo> moves;
+    for (GoBoard::Iterator it(bd); it; ++it)
+        if (bd.IsLegal(*it))
+            moves.push_back(SgUctMoveInfo(*it));
+    moves.push_back(SgUctMoveInfo(SG_PASS));
+    unsigned int contexts[SG_MAX_ONBOARD + 1];
+    unsigned int expectedContexts[SG_MAX_ONBOARD + 1];
+    GoUctAdditiveKnowledgeGreenpeep::ComputeContextsBatch(bd, moves,
+                                                          contexts);
+    GoUctAdditiveKnowledgeGreenpeep::ComputeContextsPointwise(bd, moves,
+                                                      expectedContexts);
+    for (std::size_t i = 0; i < moves.size(); ++i)
+        BOOST_REQUIRE_EQUAL(contexts[i], expectedContexts[i]);
+}
+
+/** Compare the contexts in random games, which contain many captures,
+    kos and blocks with few liberties. */
+void CheckRandomGames(int size, int nuGames)
+{
+    GoBoard bd(size);
+    SgRandom random;
+    for (int i = 0; i < nuGames; ++i)
+    {
+        bd.Init(size);
+        for (int j = 0; j < 2 * size * size; ++j)
+        {
+            CheckContexts(bd);
+            vector<SgPoint> legalMoves;
+            for (GoBoard::Iterator it(bd); it; ++it)
+                if (bd.IsLegal(*it))
+                    legalMoves.push_back(*it);
+            if (legalMoves.empty())
+                break;
+            bd.Play(legalMoves[random.SmallInt(int(legalMoves.size()))]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GoUctAdditiveKnowledgeGreenpeepTest_ContextsEmpty)
+{
+    GoBoard bd(9);
+    CheckContexts(bd);
+    vector<SgUctMoveInfo> moves;
+    moves.push_back(SgUctMoveInfo(Pt(5, 5)));
+    moves.push_back(SgUctMoveInfo(Pt(1, 1)));
+    moves.push_back(SgUctMoveInfo(SG_PASS));
+    unsigned int contexts[3];
+    GoUctAdditiveKnowledgeGreenpeep::ComputeContextsBatch(bd, moves,
+                                                          contexts);
+    // Empty neighborhood and empty points two steps away
+    BOOST_CHECK_EQUAL(contexts[0], 0u);
+    // Border points are of both colors and mark the extended context
+    BOOST_CHECK_EQUAL(contexts[1], 0x2f2f0fu);
+    BOOST_CHECK_EQUAL(contexts[2], 0xffffffffu);
+}
+
+BOOST_AUTO_TEST_CASE(GoUctAdditiveKnowledgeGreenpeepTest_ContextsRandom)
+{
+    CheckRandomGames(9, 10);
+    CheckRandomGames(13, 2);
+    CheckRandomGames(19, 2);
+}
+
+BOOST_AUTO_TEST_CASE(GoUctAdditiveKnowledgeGreenpeepTest_Predictor)
+{
+    GoUctGreenpeepPredictor predictor;
+    unsigned short value;
+    BOOST_CHECK(! predictor.Find(0, value));
+    // Several entries in one bucket and entries in the first and last
+    // bucket
+    const boost::uint32_t contexts[] = { 0, 7, 8, 9, 1000, 1023 };
+    const boost::uint16_t values[] = { 1, 2, 3, 4, 5, 6 };
+    GoUctPatternDatabase::GreenpeepTable table;
+    table.m_nuEntries = 6;
+    table.m_contexts = contexts;
+    table.m_values = values;
+    predictor.Init(table, 1024);
+    for (std::size_t i = 0; i < table.m_nuEntries; ++i)
+    {
+        BOOST_CHECK(predictor.Find(contexts[i], value));
+        BOOST_CHECK_EQUAL(value, values[i]);
+    }
+    BOOST_CHECK(! predictor.Find(1, value));
+    BOOST_CHECK(! predictor.Find(10, value));
+    BOOST_CHECK(! predictor.Find(999, value));
+    BOOST_CHECK(! predictor.Find(1022, value));
+    table.m_nuEntries = 0;
+    predictor.Init(table, 1024);
+    BOOST_CHECK(! predictor.Find(7, value));
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
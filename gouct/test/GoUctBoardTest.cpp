@@ -7,6 +7,10 @@
 
 #include <boost/test/auto_unit_test.hpp>
 #include "GoUctBoard.h"
+#include "GoBensonBitboard.h"
+#include "GoBoardUtil.h"
+#include "GoLightLadder.h"
+#include "GoSetup.h"
 
 using SgPointUtil::Pt;
 
@@ -50,6 +54,168 @@ BOOST_AUTO_TEST_CASE(GoUctBoardTest_IsLibertyOfBlock)
     BOOST_CHECK(! bd.IsLibertyOfBlock(Pt(2, 3), bd.Anchor(Pt(1, 2))));
 }
 
+/** Check that the set of empty points is updated after captures. */
+BOOST_AUTO_TEST_CASE(GoUctBoardTest_EmptyPoints)
+{
+    GoSetup setup;
+    setup.AddWhite(Pt(1, 1));
+    setup.AddBlack(Pt(1, 2));
+    setup.AddBlack(Pt(3, 3));
+    setup.m_player = SG_BLACK;
+    GoBoard board(9, setup);
+    GoUctBoard bd(board);
+    BOOST_CHECK_EQUAL(bd.NumEmpty(), 81 - 3);
+    bd.Play(Pt(2, 1));
+    BOOST_CHECK_EQUAL(bd.NumEmpty(), 81 - 3);
+    SgPointSet empty;
+    for (int i = 0; i < bd.NumEmpty(); ++i)
+    {
+        SgPoint p = bd.EmptyPoint(i);
+        BOOST_CHECK(bd.IsEmpty(p));
+        empty.Include(p);
+    }
+    BOOST_CHECK(empty.Contains(Pt(1, 1)));
+    BOOST_CHECK(! empty.Contains(Pt(2, 1)));
+    BOOST_CHECK_EQUAL(empty.Size(), bd.NumEmpty());
+    bd.SwapEmpty(0, bd.NumEmpty() - 1);
+    for (int i = 0; i < bd.NumEmpty(); ++i)
+        BOOST_CHECK(empty.Contains(bd.EmptyPoint(i)));
+}
+
+/** Check that Ownership() agrees with the scoring functions in
+    GoBoardUtil. */
+BOOST_AUTO_TEST_CASE(GoUctBoardTest_Ownership)
+{
+    // Black wall on column 3, white wall on column 6, a white stone left
+    // of the black wall and a black stone right of the white wall.
+    GoSetup setup;
+    for (int y = 1; y <= 9; ++y)
+    {
+        setup.AddBlack(Pt(3, y));
+        setup.AddWhite(Pt(6, y));
+    }
+    setup.AddWhite(Pt(1, 5));
+    setup.AddBlack(Pt(8, 8));
+    GoBoard board(9, setup);
+    GoUctBoard bd(board);
+    SgArray<int,SG_MAXPOINT> ownership;
+
+    // Flood fill: all three empty regions touch both colors and are dame
+    int score = bd.Ownership(ownership, true);
+    BOOST_CHECK_EQUAL(float(score), GoBoardUtil::TrompTaylorScore(board, 0));
+    BOOST_CHECK_EQUAL(ownership[Pt(3, 1)], 1);
+    BOOST_CHECK_EQUAL(ownership[Pt(6, 1)], -1);
+    BOOST_CHECK_EQUAL(ownership[Pt(1, 5)], -1);
+    BOOST_CHECK_EQUAL(ownership[Pt(1, 1)], 0);
+    BOOST_CHECK_EQUAL(ownership[Pt(4, 5)], 0);
+    BOOST_CHECK_EQUAL(ownership[Pt(9, 9)], 0);
+
+    // Single point evaluation: empty points with adjacent stones of one
+    // color only are owned by that color
+    score = bd.Ownership(ownership, false);
+    int expectedScore = 0;
+    for (GoBoard::Iterator it(board); it; ++it)
+    {
+        const SgPoint p = *it;
+        int expected;
+        if (board.IsColor(p, SG_BLACK))
+            expected = 1;
+        else if (board.IsColor(p, SG_WHITE))
+            expected = -1;
+        else
+            expected = int(board.HasNeighbors(p, SG_BLACK))
+                     - int(board.HasNeighbors(p, SG_WHITE));
+        BOOST_CHECK_EQUAL(ownership[p], expected);
+        expectedScore += expected;
+    }
+    BOOST_CHECK_EQUAL(score, expectedScore);
+    BOOST_CHECK_EQUAL(ownership[Pt(2, 5)], 0);
+    BOOST_CHECK_EQUAL(ownership[Pt(4, 1)], 1);
+    BOOST_CHECK_EQUAL(ownership[Pt(5, 1)], -1);
+}
+
+/** Check Ownership() on a position with only single point eyes and dame
+    left, as at the end of a playout. */
+BOOST_AUTO_TEST_CASE(GoUctBoardTest_OwnershipEndPosition)
+{
+    GoSetup setup;
+    for (int x = 1; x <= 9; ++x)
+        for (int y = 1; y <= 9; ++y)
+        {
+            const bool isEye = ((x <= 3 || x >= 7) && (x + y) % 4 == 0);
+            if (isEye)
+                continue;
+            if (x <= 4)
+                setup.AddBlack(Pt(x, y));
+            else if (x >= 6)
+                setup.AddWhite(Pt(x, y));
+        }
+    GoBoard board(9, setup);
+    GoUctBoard bd(board);
+    SgArray<int,SG_MAXPOINT> ownership;
+    const float score = GoBoardUtil::TrompTaylorScore(board, 0);
+    BOOST_CHECK_EQUAL(float(bd.Ownership(ownership, false)), score);
+    BOOST_CHECK_EQUAL(float(bd.Ownership(ownership, true)), score);
+    BOOST_CHECK_EQUAL(ownership[Pt(1, 3)], 1);
+    BOOST_CHECK_EQUAL(ownership[Pt(7, 1)], -1);
+    BOOST_CHECK_EQUAL(ownership[Pt(5, 5)], 0);
+}
+
+/** Check that GoBensonBitboard finds the same safe points on a GoUctBoard
+    as on a GoBoard. */
+BOOST_AUTO_TEST_CASE(GoUctBoardTest_BensonBitboard)
+{
+    GoSetup setup;
+    for (int x = 1; x <= 9; ++x)
+        for (int y = 1; y <= 9; ++y)
+        {
+            const bool isEye = ((x <= 3 || x >= 7) && (x + y) % 4 == 0);
+            if (isEye)
+                continue;
+            if (x <= 4)
+                setup.AddBlack(Pt(x, y));
+            else if (x >= 7)
+                setup.AddWhite(Pt(x, y));
+        }
+    GoBoard board(9, setup);
+    GoUctBoard bd(board);
+    GoBensonBitboard benson;
+    SgBWSet safe;
+    benson.FindSafePoints(bd, &safe);
+    SgBWSet expectedSafe;
+    benson.FindSafePoints(board, &expectedSafe);
+    BOOST_CHECK(safe == expectedSafe);
+    BOOST_CHECK(safe[SG_BLACK].Contains(Pt(1, 3)));
+    BOOST_CHECK(safe[SG_WHITE].Contains(Pt(9, 3)));
+    BOOST_CHECK(! safe.Both().Contains(Pt(5, 5)));
+}
+
+/** Check that GoLightLadder can be initialized from a GoUctBoard and
+    takes the ko point into account. */
+BOOST_AUTO_TEST_CASE(GoUctBoardTest_LightLadder)
+{
+    GoSetup setup;
+    setup.AddBlack(Pt(1, 1));
+    setup.AddBlack(Pt(2, 2));
+    setup.AddWhite(Pt(2, 1));
+    setup.AddWhite(Pt(3, 2));
+    setup.AddWhite(Pt(4, 1));
+    setup.m_player = SG_BLACK;
+    GoBoard board(9, setup);
+    GoUctBoard bd(board);
+    BOOST_CHECK_EQUAL(bd.KoPoint(), SG_NULLPOINT);
+    // Capture B1, A1 is left with the liberties A2 and the ko point B1
+    bd.Play(Pt(3, 1));
+    board.Play(Pt(3, 1), SG_BLACK);
+    BOOST_CHECK_EQUAL(bd.KoPoint(), Pt(2, 1));
+    BOOST_CHECK_EQUAL(bd.KoPoint(), board.KoPoint());
+    GoLightLadder ladder;
+    ladder.Init(bd);
+    BOOST_CHECK(! ladder.IsLadderCaptureMove(Pt(1, 1), Pt(2, 1)));
+    BOOST_CHECK_EQUAL(ladder.LadderStatus(Pt(1, 1)),
+                      GoLadderUtil::LadderStatus(board, Pt(1, 1)));
+}
+
 } // namespace
 
 //----------------------------------------------------------------------------
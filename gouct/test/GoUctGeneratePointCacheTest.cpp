@@ -0,0 +1,106 @@
+//----------------------------------------------------------------------------
+/** @file GoUctGeneratePointCacheTest.cpp
+    Unit tests for GoUctGeneratePointCache. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoUctBoard.h"
+#include "GoUctGeneratePointCache.h"
+#include "GoUctPlayoutPolicy.h"
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Play a random legal move, including eye-filling moves and self-ataris
+    to get many captures and kos. Pass if no legal move is found in a
+    limited number of tries. */
+SgPoint RandomLegalMove(const GoUctBoard& bd, SgRandom& random)
+{
+    const int nuEmpty = bd.NumEmpty();
+    for (int i = 0; nuEmpty > 0 && i < 20; ++i)
+    {
+        const SgPoint p = bd.EmptyPoint(random.SmallInt(nuEmpty));
+        if (bd.IsLegal(p))
+            return p;
+    }
+    return SG_PASS;
+}
+
+/** Compare all cached values with the values computed on the board in
+    random games. */
+void CheckRandomGames(int size, int nuGames)
+{
+    GoBoard bd(size);
+    GoUctBoard uctBd(bd);
+    GoUctGeneratePointCache<GoUctBoard> cache(uctBd);
+    SgRandom random;
+    for (int i = 0; i < nuGames; ++i)
+    {
+        uctBd.Init(bd);
+        cache.Start();
+        for (int j = 0; j < 4 * size * size; ++j)
+        {
+            for (GoUctBoard::Iterator it(uctBd); it; ++it)
+                if (uctBd.IsEmpty(*it))
+                {
+                    const SgBlackWhite toPlay = uctBd.ToPlay();
+                    BOOST_REQUIRE_EQUAL(cache.GeneratePoint(*it),
+                           GoUctUtil::GeneratePoint(uctBd, *it, toPlay));
+                    BOOST_REQUIRE_EQUAL(cache.SelfAtari(*it),
+                                        GoBoardUtil::SelfAtari(uctBd, *it));
+                }
+            uctBd.Play(RandomLegalMove(uctBd, random));
+            cache.OnPlay();
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GoUctGeneratePointCacheTest_RandomGames)
+{
+    CheckRandomGames(9, 20);
+    CheckRandomGames(19, 2);
+}
+
+/** Test that the playout policy generates the same moves with and without
+    the cache. */
+BOOST_AUTO_TEST_CASE(GoUctGeneratePointCacheTest_PlayoutPolicy)
+{
+    GoBoard bd(9);
+    GoUctBoard uctBd1(bd);
+    GoUctBoard uctBd2(bd);
+    GoUctPlayoutPolicyParam param1;
+    param1.m_useGeneratePointCache = true;
+    GoUctPlayoutPolicyParam param2;
+    param2.m_useGeneratePointCache = false;
+    GoUctPlayoutPolicy<GoUctBoard> policy1(uctBd1, param1);
+    GoUctPlayoutPolicy<GoUctBoard> policy2(uctBd2, param2);
+    for (int i = 0; i < 50; ++i)
+    {
+        uctBd1.Init(bd);
+        uctBd2.Init(bd);
+        policy1.StartPlayout();
+        policy2.StartPlayout();
+        int nuPass = 0;
+        for (int j = 0; j < 400 && nuPass < 2; ++j)
+        {
+            const SgPoint move = policy1.GenerateMove();
+            BOOST_REQUIRE_EQUAL(move, policy2.GenerateMove());
+            BOOST_REQUIRE(policy1.MoveType() == policy2.MoveType());
+            nuPass = (move == SG_PASS ? nuPass + 1 : 0);
+            uctBd1.Play(move);
+            uctBd2.Play(move);
+            policy1.OnPlay();
+            policy2.OnPlay();
+        }
+        policy1.EndPlayout();
+        policy2.EndPlayout();
+    }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,184 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPatternDatabaseTest.cpp
+    Unit tests for GoUctPatternDatabase. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoUctAdditiveKnowledgeGreenpeep.h"
+#include "GoUctPatternDatabase.h"
+#include "GoUctPatterns.h"
+#include "SgException.h"
+
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+const char* const FILE_NAME = "GoUctPatternDatabaseTest.tmp";
+
+/** Writes a small database and removes the file at the end of the test. */
+struct DatabaseFixture
+{
+    std::vector<GoUctPatternDatabase::GreenpeepEntry> m_greenpeep9;
+
+    GoUctPatternGammaTable m_local;
+
+    DatabaseFixture();
+
+    ~DatabaseFixture();
+
+    void Write(const std::string& data);
+
+    std::string WriteToString();
+};
+
+DatabaseFixture::DatabaseFixture()
+{
+    GoUctPatternDatabase::GreenpeepEntry entry;
+    entry.m_context = 7;
+    entry.m_value = 1234;
+    m_greenpeep9.push_back(entry);
+    entry.m_context = 100000;
+    entry.m_value = 5;
+    m_greenpeep9.push_back(entry);
+    m_local.AddEdgePattern(SG_WHITE, 17, 3.f);
+    m_local.AddCenterPattern(SG_BLACK, 6560, 0.5f);
+    m_local.AddCenterPattern(SG_WHITE, 1234, 200.f);
+}
+
+DatabaseFixture::~DatabaseFixture()
+{
+    GoUctPatternDatabase::Global().Close();
+    std::remove(FILE_NAME);
+}
+
+void DatabaseFixture::Write(const std::string& data)
+{
+    std::ofstream out(FILE_NAME, std::ios::binary);
+    out << data;
+}
+
+std::string DatabaseFixture::WriteToString()
+{
+    std::ostringstream out;
+    GoUctPatternGammaTable empty;
+    GoUctPatternDatabase::Write(out, m_greenpeep9,
+                                std::vector<GoUctPatternDatabase::
+                                            GreenpeepEntry>(),
+                                empty.Data(), m_local.Data());
+    return out.str();
+}
+
+BOOST_FIXTURE_TEST_CASE(GoUctPatternDatabaseTest_ReadWrite, DatabaseFixture)
+{
+    Write(WriteToString());
+    GoUctPatternDatabase db;
+    BOOST_CHECK(! db.IsOpen());
+    db.Open(FILE_NAME);
+    BOOST_CHECK(db.IsOpen());
+    BOOST_CHECK_EQUAL(db.FileName(), FILE_NAME);
+    BOOST_CHECK(db.HasSection(GoUctPatternDatabase::SECTION_GREENPEEP_9));
+    BOOST_CHECK(! db.HasSection(GoUctPatternDatabase::SECTION_GREENPEEP_19));
+    BOOST_CHECK(! db.HasSection(GoUctPatternDatabase::SECTION_GAMMA_GLOBAL));
+    BOOST_CHECK(db.HasSection(GoUctPatternDatabase::SECTION_GAMMA_LOCAL));
+    BOOST_CHECK(db.Greenpeep(19) == 0);
+    const GoUctPatternDatabase::GreenpeepTable* table = db.Greenpeep(9);
+    BOOST_REQUIRE(table != 0);
+    BOOST_REQUIRE_EQUAL(table->m_nuEntries, 2u);
+    BOOST_CHECK_EQUAL(table->m_contexts[0], 7u);
+    BOOST_CHECK_EQUAL(table->m_values[0], 1234u);
+    BOOST_CHECK_EQUAL(table->m_contexts[1], 100000u);
+    BOOST_CHECK_EQUAL(table->m_values[1], 5u);
+    BOOST_CHECK(db.Gammas(GoUctPatternGammaTable::TABLE_GLOBAL) == 0);
+    const GoUctPatternGammaTable* gammas =
+        db.Gammas(GoUctPatternGammaTable::TABLE_LOCAL);
+    BOOST_REQUIRE(gammas != 0);
+    BOOST_CHECK_EQUAL(gammas->NuPatterns(), 3);
+    const GoUctPatternData::PatternData& data = gammas->Data();
+    BOOST_REQUIRE_EQUAL(data.m_centerPatterns[SG_WHITE].m_nuPatterns, 1);
+    BOOST_CHECK_EQUAL(
+                  data.m_centerPatterns[SG_WHITE].m_patternArray[0].m_code,
+                  1234);
+    BOOST_CHECK_EQUAL(
+                  data.m_centerPatterns[SG_WHITE].m_patternArray[0].m_value,
+                  200.f);
+    db.Close();
+    BOOST_CHECK(! db.IsOpen());
+    BOOST_CHECK(db.Greenpeep(9) == 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(GoUctPatternDatabaseTest_Invalid, DatabaseFixture)
+{
+    GoUctPatternDatabase db;
+    BOOST_CHECK_THROW(db.Open(FILE_NAME), SgException);
+    const std::string data = WriteToString();
+    Write(data.substr(0, data.size() - 4));
+    BOOST_CHECK_THROW(db.Open(FILE_NAME), SgException);
+    BOOST_CHECK(! db.IsOpen());
+    std::string corrupted = data;
+    corrupted[corrupted.size() - 1] ^= 1;
+    Write(corrupted);
+    BOOST_CHECK_THROW(db.Open(FILE_NAME), SgException);
+    BOOST_CHECK(! db.IsOpen());
+    Write("FPDX" + data.substr(4));
+    BOOST_CHECK_THROW(db.Open(FILE_NAME), SgException);
+    m_greenpeep9[0].m_context = NUMPATTERNS9X9;
+    Write(WriteToString());
+    BOOST_CHECK_THROW(db.Open(FILE_NAME), SgException);
+    m_greenpeep9[0].m_context = m_greenpeep9[1].m_context;
+    Write(WriteToString());
+    BOOST_CHECK_THROW(db.Open(FILE_NAME), SgException);
+}
+
+/** Test that Write sorts the Greenpeep entries by context. */
+BOOST_FIXTURE_TEST_CASE(GoUctPatternDatabaseTest_Sorted, DatabaseFixture)
+{
+    GoUctPatternDatabase::GreenpeepEntry entry;
+    entry.m_context = 50;
+    entry.m_value = 77;
+    m_greenpeep9.push_back(entry);
+    Write(WriteToString());
+    GoUctPatternDatabase db;
+    db.Open(FILE_NAME);
+    const GoUctPatternDatabase::GreenpeepTable* table = db.Greenpeep(9);
+    BOOST_REQUIRE(table != 0);
+    BOOST_REQUIRE_EQUAL(table->m_nuEntries, 3u);
+    BOOST_CHECK_EQUAL(table->m_contexts[0], 7u);
+    BOOST_CHECK_EQUAL(table->m_contexts[1], 50u);
+    BOOST_CHECK_EQUAL(table->m_contexts[2], 100000u);
+    BOOST_CHECK_EQUAL(table->m_values[1], 77u);
+    BOOST_CHECK_EQUAL(table->m_values[2], 5u);
+}
+
+/** Test that GoUctPatterns uses the gammas of the global database. */
+BOOST_FIXTURE_TEST_CASE(GoUctPatternDatabaseTest_Global, DatabaseFixture)
+{
+    GoBoard bd(9);
+    bd.Play(Pt(5, 5), SG_BLACK);
+    const SgPoint p = Pt(5, 4);
+    const int code = GoUctPatterns<GoBoard>::CodeOf8Neighbors(bd, p);
+    m_local.AddCenterPattern(SG_WHITE, code, 42.f);
+    Write(WriteToString());
+    GoUctPatternDatabase::Global().Open(FILE_NAME);
+    {
+        GoUctPatterns<GoBoard> patterns(bd,
+                                        GoUctPatterns<GoBoard>::PATTERN_LOCAL);
+        BOOST_CHECK_EQUAL(patterns.GetPatternGamma(bd, p, SG_WHITE), 42.f);
+        BOOST_CHECK_EQUAL(patterns.GetPatternGamma(bd, p, SG_BLACK), 0.f);
+    }
+    GoUctPatternDatabase::Global().Close();
+    GoUctPatterns<GoBoard> patterns(bd, GoUctPatterns<GoBoard>::PATTERN_LOCAL);
+    BOOST_CHECK(patterns.GetPatternGamma(bd, p, SG_WHITE) != 42.f);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,103 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPatternGammaTableTest.cpp
+    Unit tests for GoUctPatternGammaTable. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <sstream>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoUctPatternGammaTable.h"
+#include "GoUctPatterns.h"
+#include "SgException.h"
+
+using boost::shared_ptr;
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+void CheckEqual(const GoUctPatternData::PatternTable& table1,
+                const GoUctPatternData::PatternTable& table2)
+{
+    BOOST_REQUIRE_EQUAL(table1.m_nuPatterns, table2.m_nuPatterns);
+    for (int i = 0; i < table1.m_nuPatterns; ++i)
+    {
+        BOOST_CHECK_EQUAL(table1.m_patternArray[i].m_code,
+                          table2.m_patternArray[i].m_code);
+        BOOST_CHECK_EQUAL(table1.m_patternArray[i].m_value,
+                          table2.m_patternArray[i].m_value);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GoUctPatternGammaTableTest_ReadWrite)
+{
+    GoUctPatternGammaTable table;
+    table.AddEdgePattern(SG_BLACK, 0, 1.5f);
+    table.AddEdgePattern(SG_BLACK, 242, 0.25f);
+    table.AddEdgePattern(SG_WHITE, 17, 3.f);
+    table.AddCenterPattern(SG_BLACK, 6560, 1e-3f);
+    table.AddCenterPattern(SG_WHITE, 1234, 200.f);
+    BOOST_CHECK_EQUAL(table.NuPatterns(), 5);
+    std::ostringstream out;
+    table.Write(out);
+    std::istringstream in(out.str());
+    GoUctPatternGammaTable table2;
+    table2.AddCenterPattern(SG_BLACK, 1, 1.f); // Replaced by Read()
+    table2.Read(in);
+    BOOST_CHECK_EQUAL(table2.NuPatterns(), 5);
+    const GoUctPatternData::PatternData& data = table.Data();
+    const GoUctPatternData::PatternData& data2 = table2.Data();
+    for (SgBWIterator it; it; ++it)
+    {
+        CheckEqual(data.m_edgePatterns[*it], data2.m_edgePatterns[*it]);
+        CheckEqual(data.m_centerPatterns[*it], data2.m_centerPatterns[*it]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GoUctPatternGammaTableTest_ReadInvalid)
+{
+    GoUctPatternGammaTable table;
+    std::istringstream in1("FGAX");
+    BOOST_CHECK_THROW(table.Read(in1), SgException);
+    std::ostringstream out;
+    table.Write(out);
+    std::istringstream in2(out.str().substr(0, out.str().size() - 1));
+    BOOST_CHECK_THROW(table.Read(in2), SgException);
+    table.AddCenterPattern(SG_BLACK, 0, -1.f);
+    std::ostringstream out2;
+    table.Write(out2);
+    std::istringstream in3(out2.str());
+    BOOST_CHECK_THROW(table.Read(in3), SgException);
+}
+
+/** Test that GoUctPatterns uses a loaded table. */
+BOOST_AUTO_TEST_CASE(GoUctPatternGammaTableTest_Loaded)
+{
+    GoBoard bd(9);
+    bd.Play(Pt(5, 5), SG_BLACK);
+    const SgPoint p = Pt(5, 4);
+    const int code = GoUctPatterns<GoBoard>::CodeOf8Neighbors(bd, p);
+    shared_ptr<GoUctPatternGammaTable> table(new GoUctPatternGammaTable());
+    table->AddCenterPattern(SG_WHITE, code, 42.f);
+    BOOST_CHECK(GoUctPatternGammaTable::Loaded(
+                           GoUctPatternGammaTable::TABLE_LOCAL) == 0);
+    GoUctPatternGammaTable::SetLoaded(GoUctPatternGammaTable::TABLE_LOCAL,
+                                      table);
+    {
+        GoUctPatterns<GoBoard> patterns(bd,
+                                        GoUctPatterns<GoBoard>::PATTERN_LOCAL);
+        BOOST_CHECK_EQUAL(patterns.GetPatternGamma(bd, p, SG_WHITE), 42.f);
+        BOOST_CHECK_EQUAL(patterns.GetPatternGamma(bd, p, SG_BLACK), 0.f);
+    }
+    GoUctPatternGammaTable::SetLoaded(GoUctPatternGammaTable::TABLE_LOCAL,
+                                      shared_ptr<GoUctPatternGammaTable>());
+    GoUctPatterns<GoBoard> patterns(bd, GoUctPatterns<GoBoard>::PATTERN_LOCAL);
+    BOOST_CHECK(patterns.GetPatternGamma(bd, p, SG_WHITE) != 42.f);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,90 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPatternTrainerTest.cpp
+    Unit tests for GoUctPatternTrainer. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <sstream>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoUctPatterns.h"
+#include "GoUctPatternTrainer.h"
+#include "SgGameReader.h"
+#include "SgNode.h"
+
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Game with all moves in contact with the previous moves. */
+const char* CONTACT_GAME =
+    "(;SZ[9];B[ee];W[ef];B[df];W[de];B[dd];W[ed];B[fd];W[fe];B[ff];W[fg]"
+    ";B[eg];W[dg])";
+
+void AddGame(GoUctPatternTrainer& trainer, const char* sgf)
+{
+    std::istringstream in(sgf);
+    SgGameReader reader(in);
+    SgNode* root = reader.ReadGame();
+    BOOST_REQUIRE(root != 0);
+    trainer.AddGame(*root);
+    root->DeleteTree();
+}
+
+float CenterGamma(const GoUctPatternGammaTable& table, const GoBoard& bd,
+                  SgPoint p)
+{
+    const int code = GoUctPatterns<GoBoard>::CodeOf8Neighbors(bd, p);
+    const GoUctPatternData::PatternTable& t =
+        table.Data().m_centerPatterns[bd.ToPlay()];
+    for (int i = 0; i < t.m_nuPatterns; ++i)
+        if (t.m_patternArray[i].m_code == code)
+            return t.m_patternArray[i].m_value;
+    BOOST_FAIL("code not found");
+    return 0;
+}
+
+/** Test that contact moves get a larger gamma than moves without adjacent
+    stones, if all moves in the training data are contact moves. */
+BOOST_AUTO_TEST_CASE(GoUctPatternTrainerTest_Contact)
+{
+    GoUctPatternTrainer trainer;
+    AddGame(trainer, CONTACT_GAME);
+    BOOST_CHECK_EQUAL(trainer.NuCompetitions(), 12);
+    trainer.Train(20);
+    GoUctPatternGammaTable table;
+    trainer.GetTable(table);
+    BOOST_CHECK_EQUAL(table.NuPatterns(),
+                      2 * (GoUctPatternGammaTable::NU_EDGE_CODES
+                           + GoUctPatternGammaTable::NU_CENTER_CODES));
+    GoBoard bd(9);
+    bd.Play(Pt(5, 5), SG_BLACK);
+    const float contactGamma = CenterGamma(table, bd, Pt(5, 4));
+    BOOST_CHECK_GT(contactGamma, 2 * CenterGamma(table, bd, Pt(3, 3)));
+    // Symmetric positions and positions with exchanged colors share gammas
+    BOOST_CHECK_EQUAL(CenterGamma(table, bd, Pt(4, 5)), contactGamma);
+    GoBoard bd2(9);
+    bd2.Play(Pt(5, 5), SG_WHITE);
+    BOOST_CHECK_EQUAL(CenterGamma(table, bd2, Pt(5, 6)), contactGamma);
+}
+
+/** Test that only moves near the last two moves are used for the local
+    table. */
+BOOST_AUTO_TEST_CASE(GoUctPatternTrainerTest_Local)
+{
+    GoUctPatternTrainer trainer;
+    trainer.SetTableType(GoUctPatternGammaTable::TABLE_LOCAL);
+    AddGame(trainer, "(;SZ[9];B[ee];W[ef];B[cc];W[gg])");
+    // B[ee] has no previous move, B[cc] and W[gg] are not in the
+    // neighborhood of the last two moves
+    BOOST_CHECK_EQUAL(trainer.NuCompetitions(), 1);
+    trainer.Clear();
+    BOOST_CHECK_EQUAL(trainer.NuCompetitions(), 0);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
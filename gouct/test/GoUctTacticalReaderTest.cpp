@@ -0,0 +1,153 @@
+//----------------------------------------------------------------------------
+/** @file GoUctTacticalReaderTest.cpp
+    Unit tests for GoUctTacticalReader. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoSetupUtil.h"
+#include "GoUctBoard.h"
+#include "GoUctTacticalReader.h"
+
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Ladder from GoUctLadderKnowledgeTest, optionally with the ladder breaker
+    at F3 and with the white block already extended to C5. */
+GoSetup LadderSetup(bool withBreaker, bool extended, int& boardSize)
+{
+    std::string s(".........\n"
+                  ".........\n"
+                  "..X......\n"
+                  ".XOX.....\n"
+                  ".X.......\n"
+                  ".........\n"
+                  ".........\n"
+                  ".........\n"
+                  ".........");
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(s, boardSize);
+    if (withBreaker)
+        setup.AddWhite(Pt(6, 3));
+    if (extended)
+    {
+        setup.AddWhite(Pt(3, 5));
+        setup.m_player = SG_BLACK;
+    }
+    else
+        setup.m_player = SG_WHITE;
+    return setup;
+}
+
+BOOST_AUTO_TEST_CASE(GoUctTacticalReaderTest_CanCapture)
+{
+    int boardSize;
+    GoBoard bd(9);
+    bd.Init(9, LadderSetup(false, true, boardSize));
+    GoUctTacticalReader<GoBoard> reader(bd);
+    SgPoint move;
+    BOOST_CHECK(reader.CanCapture(Pt(3, 6), move));
+    BOOST_CHECK_EQUAL(move, Pt(3, 4));
+    // Cached result
+    move = SG_NULLMOVE;
+    BOOST_CHECK(reader.CanCapture(Pt(3, 5), move));
+    BOOST_CHECK_EQUAL(move, Pt(3, 4));
+    // Black blocks have more than two liberties
+    BOOST_CHECK(! reader.CanCapture(Pt(3, 7), move));
+}
+
+BOOST_AUTO_TEST_CASE(GoUctTacticalReaderTest_CanCapture_LadderBreaker)
+{
+    int boardSize;
+    GoBoard bd(9);
+    bd.Init(9, LadderSetup(true, true, boardSize));
+    GoUctTacticalReader<GoBoard> reader(bd);
+    SgPoint move;
+    BOOST_CHECK(! reader.CanCapture(Pt(3, 6), move));
+}
+
+/** A ladder breaker played away from the block changes the result without
+    clearing the cache, because it is in the read area. */
+BOOST_AUTO_TEST_CASE(GoUctTacticalReaderTest_LadderBreakerAfterMove)
+{
+    int boardSize;
+    GoBoard bd(9);
+    bd.Init(9, LadderSetup(false, true, boardSize));
+    GoUctTacticalReader<GoBoard> reader(bd);
+    SgPoint move;
+    BOOST_CHECK(reader.CanCapture(Pt(3, 6), move));
+    bd.Play(Pt(6, 3), SG_WHITE);
+    BOOST_CHECK(! reader.CanCapture(Pt(3, 6), move));
+    BOOST_CHECK_EQUAL(reader.NuLookups(), 2u);
+    BOOST_CHECK_EQUAL(reader.NuHits(), 0u);
+    bd.Undo();
+    BOOST_CHECK(reader.CanCapture(Pt(3, 6), move));
+    BOOST_CHECK_EQUAL(move, Pt(3, 4));
+}
+
+BOOST_AUTO_TEST_CASE(GoUctTacticalReaderTest_CanEscape)
+{
+    int boardSize;
+    GoBoard bd(9);
+    bd.Init(9, LadderSetup(false, false, boardSize));
+    GoUctBoard uctBd(bd);
+    GoUctTacticalReader<GoUctBoard> reader(uctBd);
+    BOOST_CHECK(! reader.CanEscape(Pt(3, 6)));
+
+    bd.Init(9, LadderSetup(true, false, boardSize));
+    GoUctBoard uctBd2(bd);
+    GoUctTacticalReader<GoUctBoard> reader2(uctBd2);
+    BOOST_CHECK(reader2.CanEscape(Pt(3, 6)));
+}
+
+/** Test that a block in atari escapes by capturing an adjacent block. */
+BOOST_AUTO_TEST_CASE(GoUctTacticalReaderTest_CanEscape_Capture)
+{
+    std::string s(".........\n"
+                  ".........\n"
+                  "..X......\n"
+                  ".XOX.....\n"
+                  ".XO......\n"
+                  "..X......\n"
+                  ".........\n"
+                  ".........\n"
+                  ".........");
+    int boardSize;
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(s, boardSize);
+    // Black stone at D6 in atari
+    setup.AddWhite(Pt(5, 6));
+    setup.AddWhite(Pt(4, 7));
+    setup.m_player = SG_WHITE;
+    GoBoard bd(boardSize, setup);
+    GoUctTacticalReader<GoBoard> reader(bd);
+    BOOST_CHECK(bd.InAtari(Pt(3, 6)));
+    BOOST_CHECK(reader.CanEscape(Pt(3, 6)));
+}
+
+/** Test that the cache is kept after a move outside the read area and
+    invalidated by Clear(). */
+BOOST_AUTO_TEST_CASE(GoUctTacticalReaderTest_Clear)
+{
+    int boardSize;
+    GoBoard bd(9);
+    bd.Init(9, LadderSetup(false, true, boardSize));
+    GoUctTacticalReader<GoBoard> reader(bd);
+    SgPoint move;
+    BOOST_CHECK(reader.CanCapture(Pt(3, 6), move));
+    // The ladder runs from C5 towards the lower right corner
+    bd.Play(Pt(9, 9), SG_WHITE);
+    BOOST_CHECK(reader.CanCapture(Pt(3, 6), move));
+    BOOST_CHECK_EQUAL(reader.NuHits(), 1u);
+    reader.Clear();
+    BOOST_CHECK(reader.CanCapture(Pt(3, 6), move));
+    BOOST_CHECK_EQUAL(reader.NuLookups(), 3u);
+    BOOST_CHECK_EQUAL(reader.NuHits(), 1u);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -133,16 +133,52 @@ void Notify(boost::mutex& aMutex, condition& aCondition)
 
 namespace {
 
+/** Stream buffer that writes to a GtpOutputStream when it is flushed.
+    Used for the output of GtpEngine::Analyze(). */
+class AnalyzeStreamBuf
+    : public std::stringbuf
+{
+public:
+    AnalyzeStreamBuf(GtpOutputStream& out);
+
+protected:
+    int sync();
+
+private:
+    GtpOutputStream& m_out;
+};
+
+AnalyzeStreamBuf::AnalyzeStreamBuf(GtpOutputStream& out)
+    : std::stringbuf(std::ios::out),
+      m_out(out)
+{ }
+
+int AnalyzeStreamBuf::sync()
+{
+    string text = str();
+    if (! text.empty())
+    {
+        m_out.Write(text);
+        m_out.Flush();
+        str("");
+    }
+    return 0;
+}
+
 /** Ponder thread used by GtpEngine::MainLoop().
     This thread calls GtpEngine::Ponder() while the engine is waiting for the
-    next command.
+    next command, or GtpEngine::Analyze(), if the last command called
+    GtpEngine::StartAnalyze().
     @see GtpEngine::Ponder() */
 class PonderThread
 {
 public:
-    PonderThread(GtpEngine& engine);
+    PonderThread(GtpEngine& engine, GtpOutputStream& out);
 
-    void StartPonder();
+    /** Start pondering or analyzing.
+        @param analyze Call GtpEngine::Analyze() instead of
+        GtpEngine::Ponder(). */
+    void StartPonder(bool analyze);
 
     void StopPonder();
 
@@ -164,6 +200,11 @@ private:
 
     GtpEngine& m_engine;
 
+    GtpOutputStream& m_out;
+
+    /** See StartPonder() */
+    bool m_analyze;
+
     barrier m_threadReady;
 
     boost::mutex m_startPonderMutex;
@@ -196,14 +237,24 @@ void PonderThread::Function::operator()()
         GtpEngine& engine = m_ponderThread.m_engine;
         if (engine.IsQuitSet())
             return;
-        engine.Ponder();
+        if (m_ponderThread.m_analyze)
+        {
+            AnalyzeStreamBuf buffer(m_ponderThread.m_out);
+            std::ostream out(&buffer);
+            engine.Analyze(out);
+            out.flush();
+        }
+        else
+            engine.Ponder();
         Notify(m_ponderThread.m_ponderFinishedMutex,
                m_ponderThread.m_ponderFinished);
     }
 }
 
-PonderThread::PonderThread(GtpEngine& engine)
+PonderThread::PonderThread(GtpEngine& engine, GtpOutputStream& out)
     : m_engine(engine),
+      m_out(out),
+      m_analyze(false),
       m_threadReady(2),
       m_ponderFinishedLock(m_ponderFinishedMutex),
       m_thread(Function(*this))
@@ -211,8 +262,9 @@ PonderThread::PonderThread(GtpEngine& engine)
     m_threadReady.wait();
 }
 
-void PonderThread::StartPonder()
+void PonderThread::StartPonder(bool analyze)
 {
+    m_analyze = analyze;
     m_engine.InitPonder();
     Notify(m_startPonderMutex, m_startPonder);
 }
@@ -617,6 +669,9 @@ GtpCallbackBase::~GtpCallbackBase() throw()
 
 GtpEngine::GtpEngine()
     : m_quit(false)
+#if GTPENGINE_PONDER
+    , m_analyze(false)
+#endif
 {
     Register("known_command", &GtpEngine::CmdKnownCommand, this);
     Register("list_commands", &GtpEngine::CmdListCommands, this);
@@ -701,6 +756,9 @@ string GtpEngine::ExecuteCommand(const string& cmdline, std::ostream& log)
     log << cmd.Line() << '\n';
     GtpOutputStream gtpLog(log);
     bool status = HandleCommand(cmd, gtpLog);
+#if GTPENGINE_PONDER
+    EndAnalyze(gtpLog);
+#endif
     string response = cmd.Response();
     if (! status)
         throw GtpFailure() << "Executing " << cmd.Line() << " failed";
@@ -723,6 +781,9 @@ void GtpEngine::ExecuteFile(const string& name, std::ostream& log)
         log << cmd.Line() << '\n';
 
         bool status = HandleCommand(cmd, gtpLog);
+#if GTPENGINE_PONDER
+        EndAnalyze(gtpLog);
+#endif
         if (! status)
             throw GtpFailure() << "Executing " << cmd.Line() << " failed";
     }
@@ -731,6 +792,9 @@ void GtpEngine::ExecuteFile(const string& name, std::ostream& log)
 bool GtpEngine::HandleCommand(GtpCommand& cmd, GtpOutputStream& out)
 {
     BeforeHandleCommand();
+#if GTPENGINE_PONDER
+    m_analyze = false;
+#endif
     bool status = true;
     string response;
     try
@@ -760,7 +824,14 @@ bool GtpEngine::HandleCommand(GtpCommand& cmd, GtpOutputStream& out)
     size_t size = response.size();
     if (size == 0 || response[size - 1] != '\n')
         ostr << '\n';
-    ostr << '\n' << std::flush;
+#if GTPENGINE_PONDER
+    if (! status)
+        m_analyze = false;
+    // The response of an analysis command is terminated in EndAnalyze()
+    if (! m_analyze)
+#endif
+    ostr << '\n';
+    ostr << std::flush;
     out.Write(ostr.str());
     out.Flush();
     return status;
@@ -775,7 +846,7 @@ void GtpEngine::MainLoop(GtpInputStream& in, GtpOutputStream& out)
 {
     m_quit = false;
 #if GTPENGINE_PONDER
-    PonderThread ponderThread(*this);
+    PonderThread ponderThread(*this, out);
 #endif
 #if GTPENGINE_INTERRUPT
     ReadThread readThread(in, *this);
@@ -784,7 +855,7 @@ void GtpEngine::MainLoop(GtpInputStream& in, GtpOutputStream& out)
     while (true)
     {
 #if GTPENGINE_PONDER
-        ponderThread.StartPonder();
+        ponderThread.StartPonder(m_analyze);
 #endif
 #if GTPENGINE_INTERRUPT
         bool isStreamGood = readThread.ReadCommand(cmd);
@@ -793,6 +864,7 @@ void GtpEngine::MainLoop(GtpInputStream& in, GtpOutputStream& out)
 #endif
 #if GTPENGINE_PONDER
         ponderThread.StopPonder();
+        EndAnalyze(out);
 #endif
         if (isStreamGood)
             HandleCommand(cmd, out);
@@ -838,6 +910,25 @@ bool GtpEngine::IsQuitSet() const
 
 #if GTPENGINE_PONDER
 
+void GtpEngine::Analyze(std::ostream&)
+{
+    // Default implementation does nothing
+#ifdef GTPENGINE_TEST
+    std::cerr << "GtpEngine::Analyze()\n";
+#endif
+}
+
+/** Terminate the response of an analysis command.
+    @see StartAnalyze() */
+void GtpEngine::EndAnalyze(GtpOutputStream& out)
+{
+    if (! m_analyze)
+        return;
+    m_analyze = false;
+    out.Write("\n");
+    out.Flush();
+}
+
 void GtpEngine::Ponder()
 {
     // Default implementation does nothing
@@ -862,6 +953,11 @@ void GtpEngine::InitPonder()
 #endif
 }
 
+void GtpEngine::StartAnalyze()
+{
+    m_analyze = true;
+}
+
 #endif // GTPENGINE_PONDER
 
 
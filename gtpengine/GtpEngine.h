@@ -707,6 +707,30 @@ public:
         @see Ponder()
         The default implementation does nothing. */
     virtual void StopPonder();
+
+    /** Analyze.
+        Called instead of Ponder() while the engine is waiting for the next
+        command, if the last command called StartAnalyze(). The output is
+        appended to the response of that command. Each flush of the stream
+        writes the output to the GTP output stream, so that a controller
+        receives it while the analysis is running. The output must not
+        contain empty lines, because an empty line terminates the response.
+        Like Ponder(), the function is called after InitPonder() and should
+        return immediately when StopPonder() is called.
+        The default implementation does nothing and returns immediately. */
+    virtual void Analyze(std::ostream& out);
+
+    /** Continue the response of the current command with analysis output.
+        Can be called by command handlers to implement analysis commands
+        like @c lz-analyze of Leela Zero. If the command succeeds, its
+        response is written without the terminating empty line, and
+        Analyze() is called in the ponder thread while MainLoop() waits for
+        the next command. When the next command is received, StopPonder()
+        is called and the response is terminated after Analyze() returned.
+        Commands executed with ExecuteCommand() or ExecuteFile() terminate
+        the response immediately.
+        @see Analyze() */
+    void StartAnalyze();
 #endif // GTPENGINE_PONDER
 
 #if GTPENGINE_INTERRUPT
@@ -734,6 +758,13 @@ private:
 
     bool m_quit;
 
+#if GTPENGINE_PONDER
+    /** The response of the last command is continued with the output of
+        Analyze().
+        @see StartAnalyze() */
+    bool m_analyze;
+#endif
+
     CallbackMap m_callbacks;
 
     /** Not to be implemented. */
@@ -743,6 +774,10 @@ private:
     GtpEngine& operator=(const GtpEngine& engine) const;
 
     bool HandleCommand(GtpCommand& cmd, GtpOutputStream& out);
+
+#if GTPENGINE_PONDER
+    void EndAnalyze(GtpOutputStream& out);
+#endif
 };
 
 template<class T>
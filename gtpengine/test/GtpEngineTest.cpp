@@ -235,6 +235,79 @@ BOOST_AUTO_TEST_CASE(GtpEngineTest_MainLoopEmptyLines2)
                       "\n");
 }
 
+#if GTPENGINE_PONDER
+
+/** GTP engine with an analysis command for testing
+    GtpEngine::StartAnalyze(). */
+class AnalyzeEngine
+    : public GtpEngine
+{
+public:
+    AnalyzeEngine();
+
+    void CmdAnalyze(GtpCommand& cmd);
+
+    void Analyze(std::ostream& out);
+};
+
+AnalyzeEngine::AnalyzeEngine()
+{
+    typedef GtpCallback<AnalyzeEngine> Callback;
+    Register("analyze", new Callback(this, &AnalyzeEngine::CmdAnalyze));
+}
+
+void AnalyzeEngine::Analyze(std::ostream& out)
+{
+    out << "info 1\n" << flush;
+    out << "info 2\n";
+}
+
+/** Fails if an argument is given. */
+void AnalyzeEngine::CmdAnalyze(GtpCommand& cmd)
+{
+    cmd.CheckArgNone();
+    StartAnalyze();
+}
+
+/** Check that the analysis output continues the response until the next
+    command is received. */
+BOOST_AUTO_TEST_CASE(GtpEngineTest_Analyze)
+{
+    istringstream in("1 analyze\n2 version\nanalyze\n");
+    ostringstream out;
+    GtpInputStream gin(in);
+    GtpOutputStream gout(out);
+    AnalyzeEngine engine;
+    engine.MainLoop(gin, gout);
+    BOOST_CHECK_EQUAL(out.str(),
+                      "=1 \ninfo 1\ninfo 2\n\n"
+                      "=2 \n\n"
+                      "= \ninfo 1\ninfo 2\n\n");
+}
+
+/** Check that no analysis is done if the command fails. */
+BOOST_AUTO_TEST_CASE(GtpEngineTest_AnalyzeFailure)
+{
+    istringstream in("analyze x\nversion\n");
+    ostringstream out;
+    GtpInputStream gin(in);
+    GtpOutputStream gout(out);
+    AnalyzeEngine engine;
+    engine.MainLoop(gin, gout);
+    BOOST_CHECK_EQUAL(out.str(), "? no arguments allowed\n\n= \n\n");
+}
+
+/** Check that ExecuteCommand() terminates the response immediately. */
+BOOST_AUTO_TEST_CASE(GtpEngineTest_AnalyzeExecuteCommand)
+{
+    ostringstream log;
+    AnalyzeEngine engine;
+    BOOST_CHECK_EQUAL(engine.ExecuteCommand("analyze", log), "");
+    BOOST_CHECK_EQUAL(log.str(), "analyze\n= \n\n");
+}
+
+#endif // GTPENGINE_PONDER
+
 BOOST_AUTO_TEST_CASE(GtpEngineTest_UnknownCommand)
 {
     istringstream in("unknowncommand\n");
@@ -1,5 +1,5 @@
 #-----------------------------------------------------------------------------
-# Tests for GoLadder and GoStaticLadder
+# Tests for GoLadder, GoLightLadder and GoStaticLadder
 #-----------------------------------------------------------------------------
 
 loadsgf sgf/ladder/long-ladder.sgf
@@ -7,21 +7,33 @@ loadsgf sgf/ladder/long-ladder.sgf
 10 go_ladder C4
 #? [unsettled]
 
+12 go_light_ladder C4
+#? [unsettled]
+
 loadsgf sgf/ladder/ladder-breaker.sgf
 
 20 go_ladder C4
 #? [escaped]
 
+22 go_light_ladder C4
+#? [escaped]
+
 loadsgf sgf/ladder/ladder-no-breaker.sgf
 
 30 go_ladder C17
 #? [unsettled]
 
+32 go_light_ladder C17
+#? [unsettled]
+
 loadsgf sgf/ladder/ladder-edge.sgf
 
 40 go_ladder C1
 #? [unsettled]
 
+42 go_light_ladder C1
+#? [unsettled]
+
 45 go_static_ladder C1
 #? [unsettled]
 
@@ -30,6 +42,9 @@ loadsgf sgf/ladder/ladder-edge-breaker.sgf
 50 go_ladder C1
 #? [escaped]
 
+52 go_light_ladder C1
+#? [escaped]
+
 55 go_static_ladder C1
 #? [escaped]
 
@@ -38,26 +53,41 @@ loadsgf sgf/ladder/long-ladder-captured.sgf
 60 go_ladder C4
 #? [captured]
 
+62 go_light_ladder C4
+#? [captured]
+
 loadsgf sgf/ladder/ladder-breaker-2.sgf
 
 70 go_ladder D16
 #? [unsettled]
 
+72 go_light_ladder D16
+#? [unsettled]
+
 loadsgf sgf/ladder/ladder-parallel.sgf
 
 80 go_ladder D16
 #? [captured]
 
+82 go_light_ladder D16
+#? [captured]
+
 loadsgf sgf/ladder/adjacent-blocks.sgf
 
 90 go_ladder T15
 #? [captured]
 
+92 go_light_ladder T15
+#? [captured]
+
 play b R19
 
 100 go_ladder T15
 #? [unsettled]
 
+102 go_light_ladder T15
+#? [unsettled]
+
 loadsgf sgf/ladder/ladder-triple-ko.sgf 28
 
 # The following test needs the rules to be simple ko.
@@ -68,3 +98,6 @@ go_param_rules ko_rule simple
 # Test for a bug that did not check if GO_MAX_NUM_MOVES was exceeded
 110 go_ladder J3
 #? [unsettled]
+
+112 go_light_ladder J3
+#? [unsettled]
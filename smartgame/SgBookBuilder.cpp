@@ -5,6 +5,7 @@
 #include "SgSystem.h"
 #include "SgBookBuilder.h"
 
+#include <queue>
 #include <sstream>
 #include <boost/numeric/conversion/bounds.hpp>
 #include "SgDebug.h"
@@ -13,6 +14,43 @@
 
 //----------------------------------------------------------------------------
 
+namespace {
+
+/** State in the selection of SgBookBuilder::SelectLeaves(). */
+struct Candidate
+{
+    /** Sum of the priorities along the line plus the priority of the
+        state. */
+    float m_key;
+
+    /** Sum of the priorities along the line. */
+    float m_cost;
+
+    /** Moves from the current state. */
+    std::vector<SgMove> m_line;
+
+    Candidate(float key, float cost, const std::vector<SgMove>& line);
+
+    /** Reversed order, such that std::priority_queue returns the
+        candidate with the smallest key. */
+    bool operator<(const Candidate& candidate) const;
+};
+
+Candidate::Candidate(float key, float cost, const std::vector<SgMove>& line)
+    : m_key(key),
+      m_cost(cost),
+      m_line(line)
+{ }
+
+bool Candidate::operator<(const Candidate& candidate) const
+{
+    return m_key > candidate.m_key;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
 const float SgBookNode::LEAF_PRIORITY = 0.0;
 
 bool SgBookNode::IsTerminal() const
@@ -58,7 +96,10 @@ SgBookBuilder::SgBookBuilder()
       m_useWidening(true),
       m_expandWidth(16),
       m_expandThreshold(1000),
-      m_flushIterations(100)
+      m_expandBatchSize(1),
+      m_flushIterations(100),
+      m_numLeavesExpanded(0),
+      m_expandTime(0)
 { }
 
 SgBookBuilder::~SgBookBuilder()
@@ -104,12 +145,14 @@ void SgBookBuilder::Expand(int numExpansions)
     SgTimer timer;
     Init();
     EnsureRootExists();
-    int num = 0;
-    for (; num < numExpansions; ++num) 
+    const std::size_t total = std::max(numExpansions, 0);
+    std::size_t num = 0;
+    std::size_t numAtFlush = 0;
+    for (int iteration = 0; num < total; ++iteration) 
     {
         {
             std::ostringstream os;
-            os << "\n--Iteration " << num << "--\n";
+            os << "\n--Iteration " << iteration << "--\n";
             PrintMessage(os.str());
         }
         {
@@ -122,24 +165,45 @@ void SgBookBuilder::Expand(int numExpansions)
             }
         }
         StartIteration();
-        std::vector<SgMove> pv;
-        DoExpansion(pv);
+        std::vector< std::vector<SgMove> > leaves;
+        if (m_expandBatchSize > 1)
+            SelectLeaves(std::min(m_expandBatchSize, total - num), leaves);
+        if (leaves.empty())
+        {
+            std::vector<SgMove> pv;
+            DoExpansion(pv);
+            ++num;
+        }
+        else
+        {
+            ExpandLeaves(leaves);
+            for (std::size_t i = 0; i < leaves.size(); ++i)
+                BackUp(leaves[i]);
+            num += leaves.size();
+        }
         EndIteration();
+        PrintProgress(num, total, timer.GetTime());
 
-        if (num && (num % m_flushIterations) == 0) 
+        if (num - numAtFlush >= m_flushIterations) 
+        {
             FlushBook();
+            numAtFlush = num;
+        }
     }
     FlushBook();
     Fini();
     timer.Stop();
     double elapsed = timer.GetTime();
+    m_numLeavesExpanded = num;
+    m_expandTime = elapsed;
     std::ostringstream os;
     os << '\n'
        << "Statistics\n"
        << "Total Time     " << elapsed << '\n'
        << "Expansions     " << num 
        << std::fixed << std::setprecision(2) 
-       << " (" << (num / elapsed) << "/s)\n"
+       << " (" << (num / elapsed) << "/s, "
+       << (3600 * num / elapsed) << "/h)\n"
        << "Evaluations    " << m_numEvals 
        << std::fixed << std::setprecision(2)
        << " (" << (double(m_numEvals) / elapsed) << "/s)\n"
@@ -347,6 +411,47 @@ bool SgBookBuilder::ExpandChildren(std::size_t count)
     return false;
 }
 
+void SgBookBuilder::GenerateMovesForStates(
+                               const std::vector< std::vector<SgMove> >& lines,
+                               std::size_t count,
+                               std::vector< std::vector<SgMove> >& moves,
+                               std::vector<bool>& determined,
+                               std::vector<float>& values)
+{
+    moves.assign(lines.size(), std::vector<SgMove>());
+    determined.assign(lines.size(), false);
+    values.assign(lines.size(), 0);
+    for (std::size_t i = 0; i < lines.size(); ++i)
+    {
+        PlayLine(lines[i]);
+        float value = 0;
+        determined[i] = GenerateMoves(count, moves[i], value);
+        values[i] = value;
+        UndoLine(lines[i]);
+    }
+}
+
+void SgBookBuilder::EvaluateStates(
+                               const std::vector< std::vector<SgMove> >& lines,
+                               std::vector<float>& values)
+{
+    values.assign(lines.size(), 0);
+    for (std::size_t i = 0; i < lines.size(); ++i)
+    {
+        const std::vector<SgMove>& line = lines[i];
+        SG_ASSERT(! line.empty());
+        for (std::size_t j = 0; j + 1 < line.size(); ++j)
+            PlayMove(line[j]);
+        std::vector<SgMove> children(1, line.back());
+        std::vector<std::pair<SgMove, float> > scores;
+        EvaluateChildren(children, scores);
+        SG_ASSERT(scores.size() == 1);
+        values[i] = scores[0].second;
+        for (std::size_t j = line.size() - 1; j > 0; --j)
+            UndoMove(line[j - 1]);
+    }
+}
+
 std::size_t SgBookBuilder::NumChildren(const std::vector<SgMove>& legal)
 {
     std::size_t num = 0;
@@ -502,6 +607,180 @@ void SgBookBuilder::DoExpansion(std::vector<SgMove>& pv)
     WriteNode(node);
 }
 
+/** Selects the most urgent leaves for a batch expansion.
+    Best-first search on the lines from the current state with the sum of
+    the priorities along the line as cost. The priority of a state is the
+    smallest cost of a line from the state to a leaf, so the leaves are
+    found in the order of their expansion priority.
+    Internal nodes are widened and updated like in DoExpansion() when they
+    are visited.
+    @ref bookbatch */
+void SgBookBuilder::SelectLeaves(std::size_t numLeaves,
+                                 std::vector< std::vector<SgMove> >& leaves)
+{
+    ClearAllVisited();
+    std::priority_queue<Candidate> queue;
+    {
+        SgBookNode root;
+        GetNode(root);
+        queue.push(Candidate(root.m_priority, 0, std::vector<SgMove>()));
+    }
+    while (! queue.empty() && leaves.size() < numLeaves)
+    {
+        const Candidate candidate = queue.top();
+        queue.pop();
+        PlayLine(candidate.m_line);
+        SgBookNode node;
+        if (! HasBeenVisited() && GetNode(node) && ! node.IsTerminal())
+        {
+            MarkAsVisited();
+            if (node.IsLeaf())
+                leaves.push_back(candidate.m_line);
+            else
+            {
+                if (m_useWidening && (node.m_count % m_expandThreshold == 0))
+                {
+                    std::size_t width = 
+                        (node.m_count / m_expandThreshold + 1)
+                        * m_expandWidth;
+                    ++m_numWidenings;
+                    ExpandChildren(width);
+                }
+                GetNode(node);
+                UpdateValue(node);
+                UpdatePriority(node);
+                WriteNode(node);
+                std::vector<SgMove> legal;
+                if (! node.IsTerminal())
+                    GetAllLegalMoves(legal);
+                for (std::size_t i = 0; i < legal.size(); ++i)
+                {
+                    PlayMove(legal[i]);
+                    SgBookNode child;
+                    if (GetNode(child))
+                    {
+                        const float cost = candidate.m_cost
+                            + ComputePriority(node, Value(child), 0);
+                        std::vector<SgMove> line(candidate.m_line);
+                        line.push_back(legal[i]);
+                        queue.push(Candidate(cost + child.m_priority, cost,
+                                             line));
+                    }
+                    UndoMove(legal[i]);
+                }
+            }
+        }
+        UndoLine(candidate.m_line);
+    }
+}
+
+/** Expands the leaves selected by SelectLeaves().
+    Same as ExpandChildren() for each leaf, but generates the moves of all
+    leaves and evaluates all their new children together. */
+void SgBookBuilder::ExpandLeaves(
+                             const std::vector< std::vector<SgMove> >& leaves)
+{
+    std::vector< std::vector<SgMove> > moves;
+    std::vector<bool> determined;
+    std::vector<float> values;
+    GenerateMovesForStates(leaves, m_expandWidth, moves, determined, values);
+    // Children that are not in the book yet; a child shared by several
+    // leaves is evaluated once
+    ClearAllVisited();
+    std::vector< std::vector<SgMove> > childrenToDo;
+    for (std::size_t i = 0; i < leaves.size(); ++i)
+    {
+        PlayLine(leaves[i]);
+        if (determined[i])
+        {
+            PrintMessage("ExpandChildren: State is determined!\n");
+            WriteNode(SgBookNode(values[i]));
+        }
+        else
+        {
+            const std::size_t limit = std::min(m_expandWidth,
+                                               moves[i].size());
+            for (std::size_t j = 0; j < limit; ++j)
+            {
+                PlayMove(moves[i][j]);
+                SgBookNode child;
+                if (! GetNode(child) && ! HasBeenVisited())
+                {
+                    MarkAsVisited();
+                    childrenToDo.push_back(leaves[i]);
+                    childrenToDo.back().push_back(moves[i][j]);
+                }
+                UndoMove(moves[i][j]);
+            }
+        }
+        UndoLine(leaves[i]);
+    }
+    {
+        std::ostringstream os;
+        os << "ExpandLeaves: " << leaves.size() << " leaves, "
+           << childrenToDo.size() << " children\n";
+        PrintMessage(os.str());
+    }
+    if (childrenToDo.empty())
+        return;
+    BeforeEvaluateChildren();
+    std::vector<float> scores;
+    EvaluateStates(childrenToDo, scores);
+    AfterEvaluateChildren();
+    for (std::size_t i = 0; i < childrenToDo.size(); ++i)
+    {
+        PlayLine(childrenToDo[i]);
+        WriteNode(SgBookNode(scores[i]));
+        UndoLine(childrenToDo[i]);
+    }
+    m_numEvals += childrenToDo.size();
+}
+
+/** Updates value, priority and count of the states on a line, starting
+    with the last state. Same as the updates after an expansion in
+    DoExpansion(). */
+void SgBookBuilder::BackUp(const std::vector<SgMove>& line)
+{
+    PlayLine(line);
+    for (std::size_t i = line.size(); ; --i)
+    {
+        SgBookNode node;
+        GetNode(node);
+        UpdateValue(node);
+        UpdatePriority(node);
+        node.IncrementCount();
+        WriteNode(node);
+        if (i == 0)
+            break;
+        UndoMove(line[i - 1]);
+    }
+}
+
+void SgBookBuilder::PlayLine(const std::vector<SgMove>& line)
+{
+    for (std::size_t i = 0; i < line.size(); ++i)
+        PlayMove(line[i]);
+}
+
+void SgBookBuilder::UndoLine(const std::vector<SgMove>& line)
+{
+    for (std::size_t i = line.size(); i > 0; --i)
+        UndoMove(line[i - 1]);
+}
+
+void SgBookBuilder::PrintProgress(std::size_t num, std::size_t numExpansions,
+                                  double elapsed)
+{
+    std::ostringstream os;
+    os << "Progress: " << num << '/' << numExpansions << " leaves, "
+       << std::fixed << std::setprecision(1) << elapsed << " s";
+    if (elapsed > 0)
+        os << ", " << (3600 * double(num) / elapsed) << " leaves/h, "
+           << (double(m_numEvals) / elapsed) << " evals/s";
+    os << '\n';
+    PrintMessage(os.str());
+}
+
 //----------------------------------------------------------------------------
 
 /** Refresh's each child of the given state. UpdateValue() and
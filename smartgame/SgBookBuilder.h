@@ -148,6 +148,29 @@ inline std::ostream& operator<<(std::ostream& os, const SgBookNode& node)
 
     A book refresh should be performed after this operation. */
 
+/** @page bookbatch Batch Expansion
+    @ingroup sgopeningbook
+
+    If SgBookBuilder::ExpandBatchSize() is larger than one, each iteration
+    of SgBookBuilder::Expand() selects several leaves and expands them
+    together, such that a derived class can evaluate all their children in
+    parallel.
+
+    The leaves are selected in the order of their expansion priority, the
+    sum of the priorities along the path from the current state to the
+    leaf. This is the order in which repeated single expansions would
+    select them, if expanding a leaf did not change the priorities of its
+    ancestors; it corresponds to a virtual loss that excludes a selected
+    leaf until the end of the iteration. Unlike a virtual loss stored in
+    the nodes, it does not modify the book. Each state is visited at most
+    once per iteration, so transpositions do not select a leaf twice.
+
+    The moves of all selected leaves are generated with
+    SgBookBuilder::GenerateMovesForStates() and their new children are
+    evaluated with one call of SgBookBuilder::EvaluateStates(). Then the
+    values, priorities and counts are updated along the path to each leaf,
+    as after a single expansion. */
+
 //----------------------------------------------------------------------------
 
 /** Base class for automated book building.
@@ -161,7 +184,10 @@ public:
 
     //---------------------------------------------------------------------
 
-    /** Expands the book by expanding numExpansions leaves. */
+    /** Expands the book by expanding numExpansions leaves.
+        Writes the progress after each iteration and statistics at the end
+        with PrintMessage().
+        @ref bookbatch. */
     void Expand(int numExpansions);
 
     /** Ensures each node in each line has at least the given number
@@ -214,6 +240,31 @@ public:
     /** See UseWidening() */
     void SetExpandThreshold(std::size_t threshold);
 
+    /** Number of leaves that are expanded together in each iteration of
+        Expand().
+        The default is one, which expands the most urgent leaf in each
+        iteration.
+        @ref bookbatch. */
+    std::size_t ExpandBatchSize() const;
+
+    /** See ExpandBatchSize() */
+    void SetExpandBatchSize(std::size_t size);
+
+    /** Number of expansions after which Expand() and Cover() call
+        FlushBook(). */
+    std::size_t FlushIterations() const;
+
+    /** See FlushIterations() */
+    void SetFlushIterations(std::size_t iterations);
+
+    //---------------------------------------------------------------------    
+
+    /** Number of leaves expanded by the last call of Expand(). */
+    std::size_t NumLeavesExpanded() const;
+
+    /** Time in seconds of the last call of Expand(). */
+    double ExpandTime() const;
+
     //---------------------------------------------------------------------    
 
     /** Computes the expansion priority for the child using Alpha(),
@@ -245,8 +296,11 @@ protected:
 
     /** See UseWidening() */
     std::size_t m_expandThreshold;
+
+    /** See ExpandBatchSize() */
+    std::size_t m_expandBatchSize;
     
-    /** Number of iterations after which the db is flushed to disk. */
+    /** See FlushIterations() */
     std::size_t m_flushIterations;
 
     //------------------------------------------------------------------------
@@ -290,6 +344,32 @@ protected:
     virtual void EvaluateChildren(const std::vector<SgMove>& childrenToDo,
                     std::vector<std::pair<SgMove, float> >& scores) = 0;
 
+    /** Generates the moves for several states.
+        Used by Expand() if ExpandBatchSize() is larger than one. Default
+        implementation plays each line and calls GenerateMoves().
+        @param lines Moves from the current state to each state.
+        @param count See GenerateMoves()
+        @param[out] moves The moves of each state.
+        @param[out] determined Whether each state is determined.
+        @param[out] values The value of each determined state. */
+    virtual void GenerateMovesForStates(
+                           const std::vector< std::vector<SgMove> >& lines,
+                           std::size_t count,
+                           std::vector< std::vector<SgMove> >& moves,
+                           std::vector<bool>& determined,
+                           std::vector<float>& values);
+
+    /** Evaluates several states.
+        Used by Expand() if ExpandBatchSize() is larger than one instead of
+        EvaluateChildren(). Default implementation plays all but the last
+        move of each line and calls EvaluateChildren() for the last move.
+        @param lines Moves from the current state to each state. Each line
+        contains at least one move.
+        @param[out] values The value of each state. */
+    virtual void EvaluateStates(
+                           const std::vector< std::vector<SgMove> >& lines,
+                           std::vector<float>& values);
+
     /** Hook function: called before any work is done. 
         Default implementation does nothing. */
     virtual void Init();
@@ -331,6 +411,12 @@ private:
 
     std::size_t m_terminalNodes;
 
+    /** See NumLeavesExpanded() */
+    std::size_t m_numLeavesExpanded;
+
+    /** See ExpandTime() */
+    double m_expandTime;
+
     //---------------------------------------------------------------------
 
     std::size_t NumChildren(const std::vector<SgMove>& legal);
@@ -343,6 +429,20 @@ private:
 
     void DoExpansion(std::vector<SgMove>& pv);
 
+    void SelectLeaves(std::size_t numLeaves,
+                      std::vector< std::vector<SgMove> >& leaves);
+
+    void ExpandLeaves(const std::vector< std::vector<SgMove> >& leaves);
+
+    void BackUp(const std::vector<SgMove>& line);
+
+    void PlayLine(const std::vector<SgMove>& line);
+
+    void UndoLine(const std::vector<SgMove>& line);
+
+    void PrintProgress(std::size_t num, std::size_t numExpansions,
+                       double elapsed);
+
     bool Refresh(bool root);
 
     void IncreaseWidth(bool root);
@@ -392,6 +492,38 @@ inline void SgBookBuilder::SetExpandThreshold(std::size_t threshold)
     m_expandThreshold = threshold;
 }
 
+inline std::size_t SgBookBuilder::ExpandBatchSize() const
+{
+    return m_expandBatchSize;
+}
+
+inline void SgBookBuilder::SetExpandBatchSize(std::size_t size)
+{
+    SG_ASSERT(size > 0);
+    m_expandBatchSize = size;
+}
+
+inline std::size_t SgBookBuilder::FlushIterations() const
+{
+    return m_flushIterations;
+}
+
+inline void SgBookBuilder::SetFlushIterations(std::size_t iterations)
+{
+    SG_ASSERT(iterations > 0);
+    m_flushIterations = iterations;
+}
+
+inline std::size_t SgBookBuilder::NumLeavesExpanded() const
+{
+    return m_numLeavesExpanded;
+}
+
+inline double SgBookBuilder::ExpandTime() const
+{
+    return m_expandTime;
+}
+
 //----------------------------------------------------------------------------
 
 #endif // SG_BOOKBUILDER_HPP
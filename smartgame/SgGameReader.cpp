@@ -89,7 +89,11 @@ void SgGameReader::HandleProperties(SgNode* node,
 
 void SgGameReader::PrintWarnings(ostream& out) const
 {
-    Warnings warnings = m_warnings;
+    PrintWarnings(out, m_warnings);
+}
+
+void SgGameReader::PrintWarnings(ostream& out, Warnings warnings)
+{
     // Print more severe warnings first, less severe warnings later
     PrintWarning(out, warnings, INVALID_BOARDSIZE, "Invalid board size");
     PrintWarning(out, warnings, PROPERTY_WITHOUT_VALUE,
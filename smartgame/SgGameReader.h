@@ -57,6 +57,11 @@ public:
         Prints the warnings as human readable text. */
     void PrintWarnings(std::ostream& out) const;
 
+    /** Print warnings to stream.
+        Used by readers that use the warnings of this class, like
+        SgGameStreamReader. */
+    static void PrintWarnings(std::ostream& out, Warnings warnings);
+
     /** Read next game tree from file.
         @return Root node or 0 if there is no next game. */
     SgNode* ReadGame();
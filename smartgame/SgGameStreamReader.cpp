@@ -0,0 +1,472 @@
+//----------------------------------------------------------------------------
+/** @file SgGameStreamReader.cpp
+    See SgGameStreamReader.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "SgGameStreamReader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio> // Defines EOF
+#include <fstream>
+#include <sstream>
+#include <boost/filesystem.hpp>
+#include "SgException.h"
+#include "SgRect.h"
+#include "SgThreadedWorker.h"
+
+using namespace std;
+namespace fs = boost::filesystem;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+bool GetIntValue(const vector<string>& values, int& value)
+{
+    istringstream in(values[0]);
+    in >> value;
+    return ! in.fail();
+}
+
+/** Result of reading a file in SgGameStreamReader::ReadFiles(). */
+struct FileResult
+{
+    int m_nuGames;
+
+    /** Error message, empty if the file was read successfully. */
+    string m_error;
+};
+
+/** Reads a file in a thread of SgGameStreamReader::ReadFiles(). */
+class FileWorker
+{
+public:
+    FileWorker(SgGameStreamHandler& handler, bool mainLineOnly,
+               int defaultSize);
+
+    FileResult operator()(const string& fileName);
+
+private:
+    SgGameStreamHandler* m_handler;
+
+    bool m_mainLineOnly;
+
+    int m_defaultSize;
+};
+
+FileWorker::FileWorker(SgGameStreamHandler& handler, bool mainLineOnly,
+                       int defaultSize)
+    : m_handler(&handler),
+      m_mainLineOnly(mainLineOnly),
+      m_defaultSize(defaultSize)
+{ }
+
+FileResult FileWorker::operator()(const string& fileName)
+{
+    FileResult result;
+    result.m_nuGames = 0;
+    try
+    {
+        ifstream in(fileName.c_str());
+        if (! in)
+            throw SgException("could not open file");
+        m_handler->BeginFile(fileName);
+        SgGameStreamReader reader(in, m_defaultSize);
+        reader.SetMainLineOnly(m_mainLineOnly);
+        result.m_nuGames = reader.ReadGames(*m_handler);
+    }
+    catch (const exception& e)
+    {
+        // Exceptions must not leave the thread
+        result.m_error = fileName + ": " + e.what();
+    }
+    return result;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+SgGameStreamHandler::~SgGameStreamHandler()
+{ }
+
+void SgGameStreamHandler::BeginFile(const string& fileName)
+{
+    SG_UNUSED(fileName);
+}
+
+void SgGameStreamHandler::BeginGame(int boardSize)
+{
+    SG_UNUSED(boardSize);
+}
+
+void SgGameStreamHandler::BeginNode()
+{ }
+
+void SgGameStreamHandler::BeginVariation()
+{ }
+
+void SgGameStreamHandler::EndGame()
+{ }
+
+void SgGameStreamHandler::EndVariation()
+{ }
+
+void SgGameStreamHandler::Move(SgBlackWhite color, SgPoint move)
+{
+    SG_UNUSED(color);
+    SG_UNUSED(move);
+}
+
+void SgGameStreamHandler::Property(const string& label,
+                                   const vector<string>& values)
+{
+    SG_UNUSED(label);
+    SG_UNUSED(values);
+}
+
+void SgGameStreamHandler::Setup(SgBoardColor color, SgPoint p)
+{
+    SG_UNUSED(color);
+    SG_UNUSED(p);
+}
+
+//----------------------------------------------------------------------------
+
+SgGameStreamReader::SgGameStreamReader(istream& in, int defaultSize)
+    : m_in(*in.rdbuf()),
+      m_defaultSize(defaultSize),
+      m_mainLineOnly(false),
+      m_boardSize(defaultSize),
+      m_fmt(SG_PROPPOINTFMT_GO),
+      m_nuProperties(0)
+{
+    SG_ASSERT(defaultSize >= SG_MIN_SIZE && defaultSize <= SG_MAX_SIZE);
+}
+
+void SgGameStreamReader::GetSgfFiles(const string& path,
+                                     vector<string>& files)
+{
+    files.clear();
+    try
+    {
+        if (! fs::is_directory(path))
+        {
+            files.push_back(path);
+            return;
+        }
+        for (fs::recursive_directory_iterator it(path);
+             it != fs::recursive_directory_iterator(); ++it)
+            if (  fs::is_regular_file(it->status())
+               && it->path().extension() == ".sgf"
+               )
+                files.push_back(it->path().string());
+    }
+    catch (const fs::filesystem_error& e)
+    {
+        throw SgException(e.what());
+    }
+    sort(files.begin(), files.end());
+}
+
+/** Pass the properties of the current node to the handler.
+    Handles SZ and GM first, because they are needed to parse the point
+    values of the other properties. */
+void SgGameStreamReader::HandleNode(SgGameStreamHandler& handler,
+                                    bool& isGameStarted)
+{
+    for (size_t i = 0; i < m_nuProperties; ++i)
+    {
+        const Property& prop = m_properties[i];
+        int value;
+        if (prop.m_values.empty())
+            m_warnings.set(SgGameReader::PROPERTY_WITHOUT_VALUE);
+        else if (prop.m_label == "SZ" && GetIntValue(prop.m_values, value))
+        {
+            if (value < SG_MIN_SIZE || value > SG_MAX_SIZE)
+                m_warnings.set(SgGameReader::INVALID_BOARDSIZE);
+            else
+                m_boardSize = value;
+        }
+        else if (prop.m_label == "GM" && GetIntValue(prop.m_values, value))
+            m_fmt = SgPropUtil::GetPointFmt(value);
+    }
+    if (! isGameStarted)
+    {
+        handler.BeginGame(m_boardSize);
+        isGameStarted = true;
+    }
+    handler.BeginNode();
+    for (size_t i = 0; i < m_nuProperties; ++i)
+    {
+        const Property& prop = m_properties[i];
+        const string& label = prop.m_label;
+        if (label == "B" || label == "W")
+        {
+            if (prop.m_values.empty())
+                continue;
+            const SgPoint p = SgPropUtil::SgfStringToPoint(prop.m_values[0],
+                                                           m_boardSize,
+                                                           m_fmt);
+            if (p != SG_NULLMOVE)
+                handler.Move(label == "B" ? SG_BLACK : SG_WHITE, p);
+        }
+        else if (label == "AB")
+            HandleSetup(handler, SG_BLACK, prop.m_values);
+        else if (label == "AW")
+            HandleSetup(handler, SG_WHITE, prop.m_values);
+        else if (label == "AE")
+            HandleSetup(handler, SG_EMPTY, prop.m_values);
+        else
+            handler.Property(label, prop.m_values);
+    }
+    m_nuProperties = 0;
+}
+
+/** Pass the points of a setup property to the handler.
+    Handles compressed point lists like SgPropPointList. Ignores the
+    property if a value is not a valid point. */
+void SgGameStreamReader::HandleSetup(SgGameStreamHandler& handler,
+                                     SgBoardColor color,
+                                     const vector<string>& values)
+{
+    m_points.clear();
+    for (vector<string>::const_iterator it = values.begin();
+         it != values.end(); ++it)
+    {
+        const string& s = *it;
+        if (s.size() == 5 && s[2] == ':')
+        {
+            // Compressed point list
+            const SgPoint p1 = SgPropUtil::SgfStringToPoint(s.substr(0, 2),
+                                                            m_boardSize,
+                                                            m_fmt);
+            const SgPoint p2 = SgPropUtil::SgfStringToPoint(s.substr(3, 2),
+                                                            m_boardSize,
+                                                            m_fmt);
+            if (  ! SgPointUtil::InBoardRange(p1)
+               || ! SgPointUtil::InBoardRange(p2)
+               )
+                return;
+            // The rows of SGF points are in the opposite direction of the
+            // rows of SgPoint, so the rectangle is constructed with
+            // Include()
+            SgRect rect;
+            rect.Include(p1);
+            rect.Include(p2);
+            for (SgRectIterator rectIt(rect); rectIt; ++rectIt)
+                m_points.push_back(*rectIt);
+        }
+        else
+        {
+            const SgPoint p =
+                SgPropUtil::SgfStringToPoint(s, m_boardSize, m_fmt);
+            if (SgPointUtil::InBoardRange(p))
+                m_points.push_back(p);
+            else if (p != SG_PASS)
+                return;
+        }
+    }
+    for (vector<SgPoint>::const_iterator it = m_points.begin();
+         it != m_points.end(); ++it)
+        handler.Setup(color, *it);
+}
+
+int SgGameStreamReader::ReadFiles(const vector<string>& files,
+                                  const vector<SgGameStreamHandler*>& handlers,
+                                  bool mainLineOnly, int defaultSize)
+{
+    SG_ASSERT(! handlers.empty());
+    vector<FileWorker> workers;
+    for (size_t i = 0; i < handlers.size(); ++i)
+        workers.push_back(FileWorker(*handlers[i], mainLineOnly,
+                                     defaultSize));
+    vector<pair<string,FileResult> > results;
+    {
+        SgThreadedWorker<string,FileResult,FileWorker> threadedWorker(workers);
+        threadedWorker.DoWork(files, results);
+    }
+    int nuGames = 0;
+    string error;
+    for (vector<pair<string,FileResult> >::const_iterator it =
+             results.begin(); it != results.end(); ++it)
+    {
+        nuGames += it->second.m_nuGames;
+        if (error.empty())
+            error = it->second.m_error;
+    }
+    if (! error.empty())
+        throw SgException(error);
+    return nuGames;
+}
+
+bool SgGameStreamReader::ReadGame(SgGameStreamHandler& handler,
+                                  bool resetWarnings)
+{
+    if (resetWarnings)
+        m_warnings.reset();
+    int c;
+    while ((c = m_in.sbumpc()) != EOF)
+        if (c == '(' && ReadGameTree(handler))
+            return true;
+    return false;
+}
+
+/** Read a game tree after its opening parenthesis.
+    @return false if the game tree has no nodes. */
+bool SgGameStreamReader::ReadGameTree(SgGameStreamHandler& handler)
+{
+    m_boardSize = m_defaultSize;
+    m_fmt = SG_PROPPOINTFMT_GO;
+    m_nuProperties = 0;
+    m_nuSubtrees.assign(1, 0);
+    bool isGameStarted = false;
+    bool isNodeOpen = false;
+    // Depth of the subtree that is skipped, 0 if none
+    size_t skipDepth = 0;
+    int c;
+    while ((c = m_in.sbumpc()) != EOF)
+    {
+        if ('A' <= c && c <= 'Z')
+            ReadProperty(c, isNodeOpen && skipDepth == 0);
+        else if (c == '[')
+            // Value without label
+            ReadValueText(m_buffer);
+        else if (c == ';' || c == '(' || c == ')')
+        {
+            if (isNodeOpen && skipDepth == 0)
+                HandleNode(handler, isGameStarted);
+            isNodeOpen = (c == ';');
+            const size_t depth = m_nuSubtrees.size();
+            if (c == '(')
+            {
+                if (skipDepth == 0)
+                {
+                    const int index = ++m_nuSubtrees.back();
+                    if (! m_mainLineOnly)
+                        handler.BeginVariation();
+                    else if (index > 1)
+                        skipDepth = depth + 1;
+                }
+                m_nuSubtrees.push_back(0);
+            }
+            else if (c == ')')
+            {
+                m_nuSubtrees.pop_back();
+                if (depth == 1)
+                    break;
+                if (depth == skipDepth)
+                    skipDepth = 0;
+                else if (skipDepth == 0 && ! m_mainLineOnly)
+                    handler.EndVariation();
+            }
+        }
+    }
+    // Nodes of a truncated file
+    if (isNodeOpen && skipDepth == 0)
+        HandleNode(handler, isGameStarted);
+    if (isGameStarted)
+        handler.EndGame();
+    return isGameStarted;
+}
+
+int SgGameStreamReader::ReadGames(SgGameStreamHandler& handler)
+{
+    m_warnings.reset();
+    int nuGames = 0;
+    while (ReadGame(handler, false))
+        ++nuGames;
+    return nuGames;
+}
+
+void SgGameStreamReader::ReadLabel(int c, string& label)
+{
+    // Precondition: Character 'c' is in range 'A'..'Z', to be interpreted
+    // as the first letter of a property label. Same characters as in
+    // SgGameReader::ReadLabel()
+    label.assign(1, static_cast<char>(c));
+    while ((c = m_in.sgetc()) != EOF
+           && (('A' <= c && c <= 'Z')
+               || ('a' <= c && c <= 'z')
+               || ('0' <= c && c <= '9')))
+    {
+        label += static_cast<char>(c);
+        m_in.sbumpc();
+    }
+}
+
+/** Read a property.
+    @param c The first character of the label
+    @param store Add the property to the properties of the current node,
+    otherwise it is skipped. */
+void SgGameStreamReader::ReadProperty(int c, bool store)
+{
+    if (! store)
+    {
+        ReadLabel(c, m_buffer);
+        while (ReadValue(m_buffer))
+        { }
+        return;
+    }
+    if (m_nuProperties == m_properties.size())
+        m_properties.push_back(Property());
+    Property& prop = m_properties[m_nuProperties++];
+    ReadLabel(c, prop.m_label);
+    vector<string>& values = prop.m_values;
+    size_t nuValues = 0;
+    while (true)
+    {
+        if (nuValues == values.size())
+            values.push_back(string());
+        if (! ReadValue(values[nuValues]))
+            break;
+        ++nuValues;
+    }
+    values.resize(nuValues);
+}
+
+/** Read a value including the brackets.
+    @return false if the next character (after white space) is not an
+    opening bracket. */
+bool SgGameStreamReader::ReadValue(string& value)
+{
+    if (SkipWhiteSpace() != '[')
+        return false;
+    m_in.sbumpc();
+    ReadValueText(value);
+    return true;
+}
+
+/** Read a value after the opening bracket.
+    Same handling of escaped characters and newlines as
+    SgGameReader::ReadValue(). */
+void SgGameStreamReader::ReadValueText(string& value)
+{
+    value.clear();
+    bool inEscape = false;
+    int c;
+    while ((c = m_in.sbumpc()) != EOF && (c != ']' || inEscape))
+    {
+        if (c != '\n')
+            value += static_cast<char>(c);
+        if (inEscape)
+            inEscape = false;
+        else if (c == '\\')
+            inEscape = true;
+    }
+}
+
+/** Skip white space.
+    @return The next character, which is not consumed. */
+int SgGameStreamReader::SkipWhiteSpace()
+{
+    int c;
+    while ((c = m_in.sgetc()) != EOF
+           && isspace(static_cast<unsigned char>(c)))
+        m_in.sbumpc();
+    return c;
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,236 @@
+//----------------------------------------------------------------------------
+/** @file SgGameStreamReader.h
+    Streaming reader for SGF files. */
+//----------------------------------------------------------------------------
+
+#ifndef SG_GAMESTREAMREADER_H
+#define SG_GAMESTREAMREADER_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "SgBlackWhite.h"
+#include "SgBoardColor.h"
+#include "SgGameReader.h"
+#include "SgPoint.h"
+#include "SgProp.h"
+
+//----------------------------------------------------------------------------
+
+/** Receives the contents of SGF files read by SgGameStreamReader.
+    The default implementations of all functions do nothing, subclasses
+    override the functions for the information they need. */
+class SgGameStreamHandler
+{
+public:
+    virtual ~SgGameStreamHandler();
+
+    /** Called by SgGameStreamReader::ReadFiles() before the games of a
+        file. */
+    virtual void BeginFile(const std::string& fileName);
+
+    /** Called after the properties of the root node of a game were read,
+        before any other function for the game.
+        @param boardSize The value of the SZ property of the root node or
+        the default size of the reader. */
+    virtual void BeginGame(int boardSize);
+
+    /** Called after the last node of a game. */
+    virtual void EndGame();
+
+    /** Called for each node, before the functions for its properties. */
+    virtual void BeginNode();
+
+    /** Called for a B or W property.
+        @param move The point or SG_PASS */
+    virtual void Move(SgBlackWhite color, SgPoint move);
+
+    /** Called for each point of an AB, AW or AE property.
+        @param color SG_BLACK, SG_WHITE or SG_EMPTY for AE */
+    virtual void Setup(SgBoardColor color, SgPoint p);
+
+    /** Called for all other properties.
+        @param label The property label
+        @param values The values as in the file, without the brackets. */
+    virtual void Property(const std::string& label,
+                          const std::vector<std::string>& values);
+
+    /** Called before the nodes of each subtree of a node with several
+        children. Not called if the reader reads only the main lines. */
+    virtual void BeginVariation();
+
+    /** Called after the nodes of a subtree, see BeginVariation(). */
+    virtual void EndVariation();
+};
+
+//----------------------------------------------------------------------------
+
+/** Streaming reader for SGF files.
+    Unlike SgGameReader, which creates an SgNode tree for each game, this
+    reader passes the nodes and properties of a game to an
+    SgGameStreamHandler while it parses the file. The buffers for labels
+    and values are reused, so reading a game does not allocate memory
+    after the first games. This makes it suitable for reading large
+    collections of games, for example for building opening books or
+    training patterns.
+
+    The properties of a node are read completely before they are passed to
+    the handler, and the SZ and GM properties are handled first, so they
+    can be anywhere in the node (see the bug of SgGameReader). Moves and
+    setup points with invalid values are ignored, like by SgGameReader.
+
+    The variations of the game tree are reported with
+    SgGameStreamHandler::BeginVariation() and
+    SgGameStreamHandler::EndVariation(). If SetMainLineOnly() is set, only
+    the nodes of the main line (the first child of each node, see
+    SgNode::LeftMostSon()) are reported. */
+class SgGameStreamReader
+{
+public:
+    /** Create reader from an input stream.
+        @param in The input stream.
+        @param defaultSize The (game-dependent) default board size, if the
+        file contains no SZ property. */
+    SgGameStreamReader(std::istream& in, int defaultSize = 19);
+
+    /** Report only the nodes of the main line of each game.
+        Default is false. */
+    void SetMainLineOnly(bool enable);
+
+    /** See SetMainLineOnly() */
+    bool MainLineOnly() const;
+
+    /** Get warnings of last ReadGame or ReadGames. */
+    SgGameReader::Warnings GetWarnings() const;
+
+    /** Print warnings of last ReadGame or ReadGames to stream.
+        See SgGameReader::PrintWarnings() */
+    void PrintWarnings(std::ostream& out) const;
+
+    /** Read next game tree from file.
+        @return false if there is no next game. */
+    bool ReadGame(SgGameStreamHandler& handler);
+
+    /** Read all game trees from this file.
+        @return The number of games. */
+    int ReadGames(SgGameStreamHandler& handler);
+
+    /** Read the games of several files in parallel.
+        Uses one thread for each handler. The games of a file are passed
+        to the handler of the thread that reads the file, in the order of
+        the file. Which thread reads which file, and therefore the order of
+        the files for each handler, is not determined.
+        @param files The file names
+        @param handlers The handlers. A handler is used only by its thread,
+        so it needs no locking, unless it shares data with other handlers.
+        @param mainLineOnly See SetMainLineOnly()
+        @param defaultSize See SgGameStreamReader()
+        @return The number of games.
+        @throws SgException if a file cannot be opened or a handler threw
+        an exception. Thrown after all threads finished. */
+    static int ReadFiles(const std::vector<std::string>& files,
+                         const std::vector<SgGameStreamHandler*>& handlers,
+                         bool mainLineOnly = false, int defaultSize = 19);
+
+    /** Find the SGF files in a directory tree.
+        @param path A directory or a file
+        @param[out] files The files with extension .sgf in the directory
+        tree in sorted order, or the file itself if path is a file.
+        @throws SgException if the directory cannot be read. */
+    static void GetSgfFiles(const std::string& path,
+                            std::vector<std::string>& files);
+
+private:
+    /** A property of the current node. */
+    struct Property
+    {
+        std::string m_label;
+
+        std::vector<std::string> m_values;
+    };
+
+    std::streambuf& m_in;
+
+    const int m_defaultSize;
+
+    bool m_mainLineOnly;
+
+    SgGameReader::Warnings m_warnings;
+
+    /** Board size of the current game. */
+    int m_boardSize;
+
+    /** Point format of the current game. */
+    SgPropPointFmt m_fmt;
+
+    /** Properties of the current node.
+        Only the first m_nuProperties elements are used, the others are
+        kept to reuse their buffers. */
+    std::vector<Property> m_properties;
+
+    std::size_t m_nuProperties;
+
+    /** Number of child subtrees read in each open subtree of the current
+        game tree. */
+    std::vector<int> m_nuSubtrees;
+
+    /** Buffer for the points of setup properties. */
+    std::vector<SgPoint> m_points;
+
+    /** Buffer for labels and values that are skipped. */
+    std::string m_buffer;
+
+    /** Not implemented. */
+    SgGameStreamReader(const SgGameStreamReader&);
+
+    /** Not implemented. */
+    SgGameStreamReader& operator=(const SgGameStreamReader&);
+
+    void HandleNode(SgGameStreamHandler& handler, bool& isGameStarted);
+
+    void HandleSetup(SgGameStreamHandler& handler, SgBoardColor color,
+                     const std::vector<std::string>& values);
+
+    bool ReadGame(SgGameStreamHandler& handler, bool resetWarnings);
+
+    bool ReadGameTree(SgGameStreamHandler& handler);
+
+    void ReadLabel(int c, std::string& label);
+
+    void ReadProperty(int c, bool store);
+
+    bool ReadValue(std::string& value);
+
+    void ReadValueText(std::string& value);
+
+    int SkipWhiteSpace();
+};
+
+inline SgGameReader::Warnings SgGameStreamReader::GetWarnings() const
+{
+    return m_warnings;
+}
+
+inline void SgGameStreamReader::PrintWarnings(std::ostream& out) const
+{
+    SgGameReader::PrintWarnings(out, m_warnings);
+}
+
+inline bool SgGameStreamReader::MainLineOnly() const
+{
+    return m_mainLineOnly;
+}
+
+inline bool SgGameStreamReader::ReadGame(SgGameStreamHandler& handler)
+{
+    return ReadGame(handler, true);
+}
+
+inline void SgGameStreamReader::SetMainLineOnly(bool enable)
+{
+    m_mainLineOnly = enable;
+}
+
+//----------------------------------------------------------------------------
+
+#endif // SG_GAMESTREAMREADER_H
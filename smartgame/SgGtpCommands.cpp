@@ -29,6 +29,30 @@ string ParseCpuTimeId(const GtpCommand& cmd)
     return "total";
 }
 
+SgRandomEngine RandomEngineArg(const GtpCommand& cmd, size_t number)
+{
+    string arg = cmd.ArgToLower(number);
+    if (arg == "mt19937")
+        return SG_RANDOM_MT19937;
+    if (arg == "xoshiro128")
+        return SG_RANDOM_XOSHIRO128;
+    throw GtpFailure() << "unknown random engine argument \"" << arg << '"';
+}
+
+string RandomEngineToString(SgRandomEngine engine)
+{
+    switch (engine)
+    {
+    case SG_RANDOM_MT19937:
+        return "mt19937";
+    case SG_RANDOM_XOSHIRO128:
+        return "xoshiro128";
+    default:
+        SG_ASSERT(false);
+        return "?";
+    }
+}
+
 SgTimeMode TimeModeArg(const GtpCommand& cmd, size_t number)
 {
     string arg = cmd.ArgToLower(number);
@@ -71,6 +95,13 @@ void SgGtpCommands::AddGoGuiAnalyzeCommands(GtpCommand& cmd)
         "param/SmartGame Param/sg_param\n";
 }
 
+void SgGtpCommands::CheckRandomSettingsUnlocked()
+{
+    if (SgRandom::SettingsLocked())
+        throw GtpFailure("random settings are shared with other engines"
+                         " and cannot be changed");
+}
+
 /** Run another GTP command and compare its response against a float value.
     Arguments: float command [arg...] <br>
     Returns: -1 if response is smaller than float; 1 otherwise. */
@@ -205,6 +236,7 @@ void SgGtpCommands::CmdGetRandomSeed(GtpCommand& cmd)
 
 /** Set global parameters used in module SmartGame.
     Parameters:
+    @arg @c random_engine mt19937|xoshiro128 See SgRandom::SetEngine
     @arg @c time_mode cpu|real See SgTime */
 void SgGtpCommands::CmdParam(GtpCommand& cmd)
 {
@@ -213,13 +245,20 @@ void SgGtpCommands::CmdParam(GtpCommand& cmd)
     {
         // Boolean parameters first for better layout of GoGui parameter
         // dialog, alphabetically otherwise
-        cmd << "[list/cpu/real] time_mode "
+        cmd << "[list/mt19937/xoshiro128] random_engine "
+            << RandomEngineToString(SgRandom::Engine()) << '\n'
+            << "[list/cpu/real] time_mode "
             << TimeModeToString(SgTime::DefaultMode()) << '\n';
     }
     else if (cmd.NuArg() >= 1 && cmd.NuArg() <= 2)
     {
         string name = cmd.Arg(0);
-        if (name == "time_mode")
+        if (name == "random_engine")
+        {
+            CheckRandomSettingsUnlocked();
+            SgRandom::SetEngine(RandomEngineArg(cmd, 1));
+        }
+        else if (name == "time_mode")
             SgTime::SetDefaultMode(TimeModeArg(cmd, 1));
         else
             throw GtpFailure() << "unknown parameter: " << name;
@@ -239,12 +278,62 @@ void SgGtpCommands::CmdPid(GtpCommand& cmd)
 #endif
 }
 
+/** Measure the speed of the random number engines.
+    Arguments: [number] <br>
+    Generates @c number (default 10000000) random numbers with Int(),
+    SmallInt() and Float_01() for each engine in SgRandomEngine and returns
+    the time per call in nanoseconds. Restores the current engine
+    afterwards. Multiply with the number of random numbers per move (see
+    uct_stat_policy) for the random number cost of a playout. */
+void SgGtpCommands::CmdRandomBenchmark(GtpCommand& cmd)
+{
+    cmd.CheckNuArgLessEqual(1);
+    CheckRandomSettingsUnlocked();
+    int n = 10000000;
+    if (cmd.NuArg() == 1)
+        n = cmd.ArgMin<int>(0, 1);
+    const SgRandomEngine oldEngine = SgRandom::Engine();
+    const SgRandomEngine engines[2] =
+        { SG_RANDOM_MT19937, SG_RANDOM_XOSHIRO128 };
+    cmd << fixed << setprecision(2);
+    unsigned int sum = 0;
+    for (int i = 0; i < 2; ++i)
+    {
+        SgRandom::SetEngine(engines[i]);
+        SgRandom random;
+        double startTime = SgTime::Get(SG_TIME_REAL);
+        for (int j = 0; j < n; ++j)
+            sum += random.Int();
+        double timeInt = SgTime::Get(SG_TIME_REAL) - startTime;
+        startTime = SgTime::Get(SG_TIME_REAL);
+        for (int j = 0; j < n; ++j)
+            sum += random.SmallInt(361);
+        double timeSmallInt = SgTime::Get(SG_TIME_REAL) - startTime;
+        float floatSum = 0;
+        startTime = SgTime::Get(SG_TIME_REAL);
+        for (int j = 0; j < n; ++j)
+            floatSum += random.Float_01();
+        double timeFloat = SgTime::Get(SG_TIME_REAL) - startTime;
+        sum += static_cast<unsigned int>(floatSum);
+        const double nsPerCall = 1e9 / n;
+        cmd << RandomEngineToString(engines[i])
+            << " Int " << timeInt * nsPerCall
+            << " SmallInt " << timeSmallInt * nsPerCall
+            << " Float_01 " << timeFloat * nsPerCall << '\n';
+    }
+    SgRandom::SetEngine(oldEngine);
+    // Avoid that the loops are optimized away
+    SgDebug() << "SgGtpCommands::CmdRandomBenchmark: checksum " << sum
+              << '\n';
+}
+
 /** Set and store random seed.
     Arguments: seed <br>
     See SgRandom::SetSeed(int) for the special meaning of zero and negative
-    values. */
+    values. Fails if the settings of SgRandom are locked. */
 void SgGtpCommands::CmdSetRandomSeed(GtpCommand& cmd)
 {
+    CheckRandomSettingsUnlocked();
     SgRandom::SetSeed(cmd.Arg<int>());
 }
 
@@ -266,6 +355,8 @@ void SgGtpCommands::Register(GtpEngine& engine)
     engine.Register("get_random_seed", &SgGtpCommands::CmdGetRandomSeed, this);
     engine.Register("pid", &SgGtpCommands::CmdPid, this);
     engine.Register("set_random_seed", &SgGtpCommands::CmdSetRandomSeed, this);
+    engine.Register("sg_benchmark_random", &SgGtpCommands::CmdRandomBenchmark,
+                    this);
     engine.Register("sg_debugger", &SgGtpCommands::CmdDebugger, this);
     engine.Register("sg_compare_float", &SgGtpCommands::CmdCompareFloat, this);
     engine.Register("sg_compare_int", &SgGtpCommands::CmdCompareInt, this);
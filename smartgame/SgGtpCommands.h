@@ -39,6 +39,7 @@ public:
         - @link CmdGetRandomSeed() @c get_random_seed @endlink
         - @link CmdPid() @c pid @endlink
         - @link CmdSetRandomSeed() @c set_random_seed @endlink
+        - @link CmdRandomBenchmark() @c sg_benchmark_random @endlink
         - @link CmdCompareFloat() @c sg_compare_float @endlink
         - @link CmdCompareInt() @c sg_compare_int @endlink
         - @link CmdDebugger() @c sg_debugger @endlink
@@ -58,12 +59,19 @@ public:
     virtual void CmdGetRandomSeed(GtpCommand&);
     virtual void CmdParam(GtpCommand&);
     virtual void CmdPid(GtpCommand&);
+    virtual void CmdRandomBenchmark(GtpCommand&);
     virtual void CmdSetRandomSeed(GtpCommand&);
     virtual void CmdQuiet(GtpCommand&);
     // @} // @name
 
     void AddGoGuiAnalyzeCommands(GtpCommand& cmd);
 
+    /** Throw GtpFailure if the seed and engine of SgRandom must not be
+        changed.
+        For commands that change them or reset all random generators.
+        @see SgRandom::LockSettings() */
+    static void CheckRandomSettingsUnlocked();
+
     /** Register commands at engine.
         Make sure that this object lives as long as the GtpEngine,
         for example by making it a member of the engine. */
@@ -15,6 +15,7 @@
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <boost/random/mersenne_twister.hpp>
 #include "SgArray.h"
 #include "SgException.h"
 #include "SgRandom.h"
@@ -71,6 +72,11 @@ public:
         @return A random hash code, which is not zero. */
     static SgHash Random();
 
+    /** Return a random hash code from the given generator.
+        Used for hash codes that must not depend on the engine and seed of
+        SgRandom, see SgHashZobrist. */
+    static SgHash Random(boost::mt19937& generator);
+
     /** Roll bits n places to the left */
     void RollLeft(int n);
 
@@ -227,6 +233,19 @@ SgHash<N> SgHash<N>::Random()
     return hashcode;
 }
 
+template<int N>
+SgHash<N> SgHash<N>::Random(boost::mt19937& generator)
+{
+    SgHash hashcode;
+    hashcode.m_code = generator();
+    for (int i = 1; i < (N / 32); ++i)
+    {
+        hashcode.m_code <<= 32;
+        hashcode.m_code |= generator();
+    }
+    return hashcode;
+}
+
 template<int N>
 void SgHash<N>::RollLeft(int n)
 {
@@ -283,7 +302,12 @@ std::istream& operator>>(std::istream& in, const SgHash<N>& hash)
 
 //----------------------------------------------------------------------------
 
-/** Provides random hash codes for Zobrist hashing. */
+/** Provides random hash codes for Zobrist hashing.
+    The codes are generated by a Mersenne Twister in its default state, not
+    by SgRandom, such that they do not depend on the random engine or seed.
+    They are the same as in earlier versions, which used the global SgRandom
+    with the Mersenne Twister, so opening books and other files that store
+    hash codes of positions stay valid. */
 template<int N>
 class SgHashZobrist
 {
@@ -321,8 +345,9 @@ SgHashZobrist<N> SgHashZobrist<N>::m_globalTable;
 template<int N>
 SgHashZobrist<N>::SgHashZobrist()
 {
+    boost::mt19937 generator;
     for (int i = 0; i < MAX_HASH_INDEX; ++i)
-        m_hash[i] = SgHash<N>::Random();
+        m_hash[i] = SgHash<N>::Random(generator);
 }
 
 template<int N>
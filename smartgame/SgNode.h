@@ -26,6 +26,7 @@
 #define SG_NODE_H
 
 #include <string>
+#include "SgNodeArena.h"
 #include "SgProp.h"
 #include "SgPointSet.h"
 #include "SgVector.h"
@@ -61,6 +62,12 @@ public:
 
     ~SgNode();
 
+    /** Allocates from the arena of the current thread, if one is
+        installed. See SgNodeArena. */
+    static void* operator new(std::size_t size);
+
+    static void operator delete(void* p);
+
     /** Return a newly allocated copy of this node and its subtree. */
     SgNode* CopyTree() const;
 
@@ -387,6 +394,16 @@ private:
 #endif
 };
 
+inline void* SgNode::operator new(std::size_t size)
+{
+    return SgNodeArena::Allocate(size);
+}
+
+inline void SgNode::operator delete(void* p)
+{
+    SgNodeArena::Free(p);
+}
+
 //----------------------------------------------------------------------------
 
 /** Iterator for iterating through all the sons of a SgNode */
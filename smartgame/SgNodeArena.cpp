@@ -0,0 +1,177 @@
+//----------------------------------------------------------------------------
+/** @file SgNodeArena.cpp
+    See SgNodeArena.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "SgNodeArena.h"
+
+#include <new>
+#ifndef SG_THREAD_LOCAL
+#include <boost/thread/tss.hpp>
+#endif
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+#ifdef SG_THREAD_LOCAL
+
+/** Arena of the current thread.
+    A compiler-supported thread-local variable is used if available,
+    because Current() is called for every allocation of a node or
+    property. */
+SG_THREAD_LOCAL SgNodeArena* s_current = 0;
+
+inline SgNodeArena* GetCurrent()
+{
+    return s_current;
+}
+
+inline void SetCurrent(SgNodeArena* arena)
+{
+    s_current = arena;
+}
+
+#else
+
+/** The arena is owned by the code that installed it. */
+void NoCleanup(SgNodeArena* arena)
+{
+    SG_UNUSED(arena);
+}
+
+/** Arena of the current thread.
+    A function-local static, such that it is constructed before the first
+    use. */
+boost::thread_specific_ptr<SgNodeArena>& CurrentArena()
+{
+    static boost::thread_specific_ptr<SgNodeArena> s_current(NoCleanup);
+    return s_current;
+}
+
+inline SgNodeArena* GetCurrent()
+{
+    return CurrentArena().get();
+}
+
+inline void SetCurrent(SgNodeArena* arena)
+{
+    CurrentArena().reset(arena);
+}
+
+#endif // SG_THREAD_LOCAL
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+SgNodeArena::Scope::Scope(SgNodeArena& arena)
+    : m_previous(Current())
+{
+    SetCurrent(&arena);
+}
+
+SgNodeArena::Scope::~Scope()
+{
+    SetCurrent(m_previous);
+}
+
+//----------------------------------------------------------------------------
+
+SgNodeArena::SgNodeArena(std::size_t blockSize)
+    : m_blockSize(blockSize),
+      m_nuObjects(0),
+      m_nuBytes(0),
+      m_free(0),
+      m_end(0)
+{
+    SG_ASSERT(blockSize >= 2 * sizeof(Header));
+}
+
+SgNodeArena::~SgNodeArena()
+{
+    SG_ASSERT(m_nuObjects == 0);
+    FreeBlocks(false);
+}
+
+void* SgNodeArena::Allocate(std::size_t size)
+{
+    SgNodeArena* arena = Current();
+    Header* header;
+    if (arena == 0)
+        header = static_cast<Header*>(::operator new(sizeof(Header) + size));
+    else
+        header = static_cast<Header*>(arena->AllocateFromArena(
+                                                     sizeof(Header) + size));
+    header->m_arena = arena;
+    return header + 1;
+}
+
+void* SgNodeArena::AllocateFromArena(std::size_t size)
+{
+    // Keep all objects aligned like the header
+    size = (size + sizeof(Header) - 1) / sizeof(Header) * sizeof(Header);
+    ++m_nuObjects;
+    if (size > m_blockSize / 2)
+    {
+        char* block = static_cast<char*>(::operator new(size));
+        m_largeBlocks.push_back(block);
+        m_nuBytes += size;
+        return block;
+    }
+    if (static_cast<std::size_t>(m_end - m_free) < size)
+    {
+        char* block = static_cast<char*>(::operator new(m_blockSize));
+        m_blocks.push_back(block);
+        m_nuBytes += m_blockSize;
+        m_free = block;
+        m_end = block + m_blockSize;
+    }
+    void* p = m_free;
+    m_free += size;
+    return p;
+}
+
+void SgNodeArena::Clear()
+{
+    SG_ASSERT(m_nuObjects == 0);
+    FreeBlocks(true);
+}
+
+SgNodeArena* SgNodeArena::Current()
+{
+    return GetCurrent();
+}
+
+void SgNodeArena::Free(void* p)
+{
+    if (p == 0)
+        return;
+    Header* header = static_cast<Header*>(p) - 1;
+    if (header->m_arena == 0)
+        ::operator delete(header);
+    else
+    {
+        SG_ASSERT(header->m_arena->m_nuObjects > 0);
+        --header->m_arena->m_nuObjects;
+    }
+}
+
+/** Release the blocks.
+    @param keepFirst Keep the first block and make it the current block. */
+void SgNodeArena::FreeBlocks(bool keepFirst)
+{
+    for (std::size_t i = 0; i < m_largeBlocks.size(); ++i)
+        ::operator delete(m_largeBlocks[i]);
+    m_largeBlocks.clear();
+    const std::size_t nuKeep = (keepFirst && ! m_blocks.empty() ? 1 : 0);
+    for (std::size_t i = nuKeep; i < m_blocks.size(); ++i)
+        ::operator delete(m_blocks[i]);
+    m_blocks.resize(nuKeep);
+    m_nuBytes = nuKeep * m_blockSize;
+    m_free = (nuKeep == 0 ? 0 : m_blocks[0]);
+    m_end = (nuKeep == 0 ? 0 : m_blocks[0] + m_blockSize);
+}
+
+//----------------------------------------------------------------------------
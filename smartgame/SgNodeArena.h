@@ -0,0 +1,148 @@
+//----------------------------------------------------------------------------
+/** @file SgNodeArena.h
+    Memory arena for the nodes and properties of game trees. */
+//----------------------------------------------------------------------------
+
+#ifndef SG_NODEARENA_H
+#define SG_NODEARENA_H
+
+#include <cstddef>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+/** Memory arena for the nodes and properties of game trees.
+    SgNode and SgProp allocate their objects with Allocate() and release
+    them with Free(). If an arena is installed for the current thread with
+    an SgNodeArena::Scope, the objects are allocated from large blocks of
+    the arena with a pointer increment, and Free() does not release the
+    memory. The memory of all objects is released at once with Clear() or
+    when the arena is destroyed. Otherwise the objects are allocated on the
+    heap as usual.
+
+    Objects remember where they were allocated, so trees can contain
+    objects from the heap and from an arena, and objects from an arena can
+    be deleted after the scope ended. All objects allocated from an arena
+    must be deleted (e.g. with SgNode::DeleteTree()) before the arena is
+    cleared or destroyed. Destructors still run, because properties own
+    memory on the heap (e.g. the values of SgPropText).
+
+    An arena is useful for code that reads many games and deletes each game
+    after processing it, like training or benchmark tools. Clearing the
+    arena after each game reuses its first block, so reading a game that
+    fits into the block allocates and releases no memory for nodes and
+    properties.
+
+    An arena is used only by the thread that installed it, objects created
+    in other threads are allocated on the heap. The arena is not
+    thread-safe, objects allocated from it must be deleted in the thread
+    that owns the arena. */
+class SgNodeArena
+{
+public:
+    /** Installs an arena for the current thread.
+        Scopes can be nested, the destructor restores the arena that was
+        installed before. */
+    class Scope
+    {
+    public:
+        explicit Scope(SgNodeArena& arena);
+
+        ~Scope();
+
+    private:
+        SgNodeArena* m_previous;
+
+        /** Not implemented. */
+        Scope(const Scope&);
+
+        /** Not implemented. */
+        Scope& operator=(const Scope&);
+    };
+
+    /** Constructor.
+        @param blockSize The size of the blocks in bytes. Objects larger
+        than half of the block size get their own block. */
+    explicit SgNodeArena(std::size_t blockSize = 64 * 1024);
+
+    /** Destructor.
+        @pre NuObjects() == 0 */
+    ~SgNodeArena();
+
+    /** Release the memory of all objects.
+        Keeps the first block for the objects allocated after the call.
+        @pre NuObjects() == 0 */
+    void Clear();
+
+    /** Number of objects that were allocated from the arena and not yet
+        freed. */
+    std::size_t NuObjects() const;
+
+    /** Number of bytes in the blocks of the arena. */
+    std::size_t NuBytes() const;
+
+    /** The arena installed for the current thread, 0 if none. */
+    static SgNodeArena* Current();
+
+    /** Allocate memory for an object.
+        Uses the arena installed for the current thread or the heap. */
+    static void* Allocate(std::size_t size);
+
+    /** Free memory allocated with Allocate().
+        Does not release memory that was allocated from an arena. */
+    static void Free(void* p);
+
+private:
+    /** Stored in front of each object. */
+    union Header
+    {
+        /** Arena that the object was allocated from, 0 for the heap. */
+        SgNodeArena* m_arena;
+
+        /** Not used, aligns the objects for all members of nodes and
+            properties. */
+        double m_align;
+    };
+
+    const std::size_t m_blockSize;
+
+    std::size_t m_nuObjects;
+
+    std::size_t m_nuBytes;
+
+    /** Pointer to the free memory in the current block. */
+    char* m_free;
+
+    /** End of the current block. */
+    char* m_end;
+
+    /** Blocks with the block size, the last one is the current block. */
+    std::vector<char*> m_blocks;
+
+    /** Blocks of objects larger than half of the block size. */
+    std::vector<char*> m_largeBlocks;
+
+    /** Not implemented. */
+    SgNodeArena(const SgNodeArena&);
+
+    /** Not implemented. */
+    SgNodeArena& operator=(const SgNodeArena&);
+
+    void* AllocateFromArena(std::size_t size);
+
+    void FreeBlocks(bool keepFirst);
+};
+
+inline std::size_t SgNodeArena::NuBytes() const
+{
+    return m_nuBytes;
+}
+
+inline std::size_t SgNodeArena::NuObjects() const
+{
+    return m_nuObjects;
+}
+
+//----------------------------------------------------------------------------
+
+#endif // SG_NODEARENA_H
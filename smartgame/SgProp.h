@@ -14,6 +14,7 @@
 #include <string>
 #include <vector>
 #include "SgBlackWhite.h"
+#include "SgNodeArena.h"
 #include "SgPoint.h"
 #include "SgVector.h"
 
@@ -262,6 +263,12 @@ public:
 
     virtual ~SgProp();
 
+    /** Allocates from the arena of the current thread, if one is
+        installed. See SgNodeArena. */
+    static void* operator new(std::size_t size);
+
+    static void operator delete(void* p);
+
     /** Override this function for each property class to return an exact
         duplicate of this property. */
     virtual SgProp* Duplicate() const = 0;
@@ -398,6 +405,16 @@ inline bool SgProp::Flag(SgPropFlags flags) const
     return (Flags() & flags) != 0;
 }
 
+inline void* SgProp::operator new(std::size_t size)
+{
+    return SgNodeArena::Allocate(size);
+}
+
+inline void SgProp::operator delete(void* p)
+{
+    SgNodeArena::Free(p);
+}
+
 //----------------------------------------------------------------------------
 
 /** Unknown property.
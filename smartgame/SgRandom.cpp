@@ -12,22 +12,59 @@
 
 //----------------------------------------------------------------------------
 
+namespace {
+
+/** Seed used if no random seed is set.
+    Same as the default seed of boost::mt19937. */
+const uint64_t DEFAULT_SEED = 5489u;
+
+/** SplitMix64 generator.
+    Used for expanding a seed into the xoshiro128** state, as recommended by
+    the authors of xoshiro. */
+uint64_t SplitMix64(uint64_t& x)
+{
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+inline uint32_t RotateLeft(uint32_t x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
 SgRandom::GlobalData::GlobalData()
 {
     m_seed = 0;
+    m_engine = SG_RANDOM_XOSHIRO128;
+    m_isLocked = false;
 }
 
 //----------------------------------------------------------------------------
 
-SgRandom::SgRandom() : m_floatGenerator(m_generator)
+SgRandom::SgRandom()
+    : m_engine(GetGlobalData().m_engine),
+      m_bufferIndex(BUFFER_SIZE),
+      m_nuFill(0),
+      m_floatGenerator(m_generator)
 {
+    SeedXoshiro(DEFAULT_SEED);
     SetSeed();
-    GetGlobalData().m_allGenerators.push_back(this);
+    GlobalData& data = GetGlobalData();
+    boost::mutex::scoped_lock lock(data.m_mutex);
+    data.m_allGenerators.push_back(this);
 }
 
 SgRandom::~SgRandom()
 {
-    GetGlobalData().m_allGenerators.remove(this);
+    GlobalData& data = GetGlobalData();
+    boost::mutex::scoped_lock lock(data.m_mutex);
+    data.m_allGenerators.remove(this);
 }
 
 SgRandom& SgRandom::Global()
@@ -42,36 +79,113 @@ SgRandom::GlobalData& SgRandom::GetGlobalData()
     return s_data;
 }
 
+SgRandomEngine SgRandom::Engine()
+{
+    return GetGlobalData().m_engine;
+}
+
+void SgRandom::LockSettings()
+{
+    GetGlobalData().m_isLocked = true;
+}
+
+bool SgRandom::SettingsLocked()
+{
+    return GetGlobalData().m_isLocked;
+}
+
+void SgRandom::FillBuffer()
+{
+    if (m_engine == SG_RANDOM_MT19937)
+        for (int i = 0; i < BUFFER_SIZE; ++i)
+            m_buffer[i] = m_generator();
+    else
+    {
+        uint32_t s0 = m_xoshiro[0];
+        uint32_t s1 = m_xoshiro[1];
+        uint32_t s2 = m_xoshiro[2];
+        uint32_t s3 = m_xoshiro[3];
+        for (int i = 0; i < BUFFER_SIZE; ++i)
+        {
+            m_buffer[i] = RotateLeft(s1 * 5, 7) * 9;
+            const uint32_t t = s1 << 9;
+            s2 ^= s0;
+            s3 ^= s1;
+            s1 ^= s2;
+            s0 ^= s3;
+            s2 ^= t;
+            s3 = RotateLeft(s3, 11);
+        }
+        m_xoshiro[0] = s0;
+        m_xoshiro[1] = s1;
+        m_xoshiro[2] = s2;
+        m_xoshiro[3] = s3;
+    }
+    m_bufferIndex = 0;
+    ++m_nuFill;
+}
+
 int SgRandom::Seed()
 {
     return GetGlobalData().m_seed;
 }
 
+void SgRandom::SeedXoshiro(uint64_t seed)
+{
+    uint64_t x = seed;
+    uint64_t z = SplitMix64(x);
+    m_xoshiro[0] = static_cast<uint32_t>(z);
+    m_xoshiro[1] = static_cast<uint32_t>(z >> 32);
+    z = SplitMix64(x);
+    m_xoshiro[2] = static_cast<uint32_t>(z);
+    m_xoshiro[3] = static_cast<uint32_t>(z >> 32);
+}
+
+void SgRandom::SetEngine(SgRandomEngine engine)
+{
+    GlobalData& data = GetGlobalData();
+    SG_ASSERT(! data.m_isLocked);
+    boost::mutex::scoped_lock lock(data.m_mutex);
+    data.m_engine = engine;
+    for (std::list<SgRandom*>::iterator it = data.m_allGenerators.begin();
+         it != data.m_allGenerators.end(); ++it)
+    {
+        SgRandom& random = **it;
+        random.m_engine = engine;
+        // Discard numbers already generated by the old engine
+        random.m_bufferIndex = BUFFER_SIZE;
+        random.SetSeed();
+    }
+}
+
 void SgRandom::SetSeed()
 {
+    m_bufferIndex = BUFFER_SIZE;
     boost::mt19937::result_type seed = GetGlobalData().m_seed;
     if (seed == 0)
         return;
     m_generator.seed(seed);
+    SeedXoshiro(seed);
 }
 
 void SgRandom::SetSeed(int seed)
 {
+    GlobalData& data = GetGlobalData();
+    SG_ASSERT(! data.m_isLocked);
+    boost::mutex::scoped_lock lock(data.m_mutex);
     if (seed < 0)
     {
-        GetGlobalData().m_seed = 0;
+        data.m_seed = 0;
         return;
     }
     if (seed == 0)
-        GetGlobalData().m_seed =
-            static_cast<boost::mt19937::result_type>(std::time(0));
+        data.m_seed = static_cast<boost::mt19937::result_type>(std::time(0));
     else
-        GetGlobalData().m_seed = seed;
-    SgDebug() << "SgRandom::SetSeed: " << GetGlobalData().m_seed << '\n';
-    for_each(GetGlobalData().m_allGenerators.begin(),
-             GetGlobalData().m_allGenerators.end(),
+        data.m_seed = seed;
+    SgDebug() << "SgRandom::SetSeed: " << data.m_seed << '\n';
+    for_each(data.m_allGenerators.begin(), data.m_allGenerators.end(),
              std::mem_fun(&SgRandom::SetSeed));
-    srand(GetGlobalData().m_seed);
+    srand(data.m_seed);
 }
 
 //----------------------------------------------------------------------------
@@ -8,21 +8,47 @@
 
 #include <algorithm>
 #include <list>
+#include <stdint.h>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/uniform_01.hpp>
+#include <boost/thread/mutex.hpp>
 #include "SgArray.h"
 
 //----------------------------------------------------------------------------
 
+/** Random number engines available in SgRandom.
+    @see SgRandom::SetEngine */
+enum SgRandomEngine
+{
+    /** Mersenne Twister (boost::mt19937).
+        Reproduces the random sequences of earlier versions exactly, which is
+        required for the regression tests of the deterministic mode. */
+    SG_RANDOM_MT19937,
+
+    /** xoshiro128** generator by Blackman and Vigna.
+        Only 16 bytes of state and a few instructions per number. Integers in
+        an interval are generated with Lemire's unbiased multiply-shift
+        method instead of a modulo operation. */
+    SG_RANDOM_XOSHIRO128
+};
+
+//----------------------------------------------------------------------------
+
 /** Random number generator.
-    Uses a Mersenne Twister, because this is faster than std::rand() and
-    game playing programs usually need faster random numbers more than
-    high quality ones. All random generators are internally registered to
-    make it possible to change the random seed for all of them.
-
-    SgRandom is thread-safe (w.r.t. different instances) after construction
-    (the constructor is not thread-safe, because it uses a global variable
-    for registration). */
+    Uses a fast small-state engine by default, because game playing programs
+    usually need faster random numbers more than high quality ones. The
+    Mersenne Twister of earlier versions can be selected with SetEngine(),
+    e.g. for reproducing old results. Random numbers are generated in blocks
+    into a buffer owned by each instance, so that the engine code runs in a
+    tight loop and the common case of a draw is a single load. All random
+    generators are internally registered to make it possible to change the
+    random seed and the engine for all of them.
+
+    SgRandom is thread-safe w.r.t. different instances. The registration in
+    the constructor and destructor is protected by a mutex, but changing the
+    seed or the engine of all instances is not thread-safe, because it
+    modifies instances that may be used by other threads (see
+    LockSettings()). */
 class SgRandom
 {
 public:
@@ -49,6 +75,27 @@ public:
         See SetSeed(int) for the special meaning of zero and negative values. */
     static int Seed();
 
+    /** Set the random engine for all existing and future instances.
+        Existing instances are reset to the current seed (or to the default
+        state of the engine, if no seed is set).
+        @note This function is not thread-safe. */
+    static void SetEngine(SgRandomEngine engine);
+
+    /** Get the random engine used by all instances.
+        Default is SG_RANDOM_XOSHIRO128. */
+    static SgRandomEngine Engine();
+
+    /** Disallow further changes of the seed and the engine.
+        Used if independent users run in several threads of one process,
+        like the games of the server mode of Fuego, because SetSeed(int) and
+        SetEngine() modify the instances used by all threads. Cannot be
+        undone. Commands that change the settings should check
+        SettingsLocked() and fail. */
+    static void LockSettings();
+
+    /** See LockSettings() */
+    static bool SettingsLocked();
+
     /** Generate a float number in [0,range). */
     float Float(float range);
 
@@ -56,9 +103,8 @@ public:
     float Float_01();
     
     /** Get a random integer.
-        Uses a fast random generator (the Mersenne Twister boost::mt19937),
-        because in games and Monte Carlo simulations, speed is more important
-        than quality. */
+        Uses a fast random generator (see SgRandomEngine), because in games
+        and Monte Carlo simulations, speed is more important than quality. */
     unsigned int Int();
 
     /** Get a random integer in an interval.
@@ -72,8 +118,9 @@ public:
     std::size_t Int(std::size_t range);
     
     /** Get a small random integer in an interval.
-        Uses only the lower 16 bits. Faster than SgRandom::Int(int) because it
-        avoids the expensive modulo operation.
+        With SG_RANDOM_MT19937, uses only the lower 16 bits and avoids the
+        expensive modulo operation. With SG_RANDOM_XOSHIRO128, identical to
+        SgRandom::Int(int), which does not use a modulo operation either.
         @param range The upper limit of the interval (exclusive)
         @pre range > 0
         @pre range <= (1 << 16)
@@ -97,15 +144,32 @@ public:
     /** return true if random number SgRandom() <= threshold */
     bool RandomEvent(unsigned int threshold);
 
+    /** Number of 32-bit random numbers drawn from this instance so far.
+        Includes numbers drawn by Float() and Float_01(), unless the engine
+        is SG_RANDOM_MT19937, which uses a separate generator for floats.
+        Can be used for measuring the random number cost of an algorithm. */
+    uint64_t NuDraws() const;
+
 private:
+    /** Number of random numbers generated in one block. */
+    static const int BUFFER_SIZE = 64;
+
     struct GlobalData
     {
         /** The random seed.
             Zero means not to set a random seed. */
         boost::mt19937::result_type m_seed;
 
+        SgRandomEngine m_engine;
+
         std::list<SgRandom*> m_allGenerators;
 
+        /** Protects m_allGenerators. */
+        boost::mutex m_mutex;
+
+        /** See LockSettings() */
+        bool m_isLocked;
+
         GlobalData();
     };
 
@@ -115,26 +179,54 @@ private:
         variables of other compilation units. */
     static GlobalData& GetGlobalData();
 
+    /** Local copy of the global engine to avoid access to global data. */
+    SgRandomEngine m_engine;
+
+    /** Index of the next unused number in m_buffer. */
+    int m_bufferIndex;
+
+    /** Number of calls to FillBuffer(), see NuDraws() */
+    uint64_t m_nuFill;
+
+    SgArray<uint32_t,BUFFER_SIZE> m_buffer;
+
+    /** State of the xoshiro128** engine. */
+    uint32_t m_xoshiro[4];
+
     boost::mt19937 m_generator;
 
-    /*	Random number generator for Float() and Float_01(). 
-    	Uses m_generator internally.
+    /*	Random number generator for Float() and Float_01() with
+        SG_RANDOM_MT19937.
+    	Initialized with a copy of m_generator in its default state, and
+        never reseeded. Kept to reproduce the old random sequences.
     	See http://www.boost.org/doc/libs/1_39_0/libs/random/
         random-distributions.html#uniform_01 
 	*/
     boost::uniform_01<boost::mt19937, float> m_floatGenerator;
 
+    void FillBuffer();
+
+    /** Lemire's method: multiply and use the upper 32 bits, reject the few
+        values that would make the result biased. */
+    uint32_t MultiplyShift(uint32_t range);
+
     void SetSeed();
+
+    void SeedXoshiro(uint64_t seed);
 };
 
 inline float SgRandom::Float_01()
 {
-    return m_floatGenerator();
+    if (m_engine == SG_RANDOM_MT19937)
+        return m_floatGenerator();
+    // Upper 24 bits fit exactly into the mantissa of a float, so the
+    // result is always smaller than 1
+    return float(Int() >> 8) * (1.f / 16777216.f);
 }
 
 inline float SgRandom::Float(float range)
 {
-    float v = m_floatGenerator() * range;
+    float v = Float_01() * range;
     SG_ASSERT(v <= range); 
     // @todo: should be < range? Worried about rounding issues.
     return v;
@@ -142,14 +234,20 @@ inline float SgRandom::Float(float range)
 
 inline unsigned int SgRandom::Int()
 {
-    return m_generator();
+    if (m_bufferIndex >= BUFFER_SIZE)
+        FillBuffer();
+    return m_buffer[m_bufferIndex++];
 }
 
 inline int SgRandom::Int(int range)
 {
     SG_ASSERT(range > 0);
     SG_ASSERT(static_cast<unsigned int>(range) <= SgRandom::Max());
-    int i = Int() % range;
+    int i;
+    if (m_engine == SG_RANDOM_MT19937)
+        i = Int() % range;
+    else
+        i = MultiplyShift(range);
     SG_ASSERTRANGE(i, 0, range - 1);
     return i;
 }
@@ -157,7 +255,11 @@ inline int SgRandom::Int(int range)
 inline std::size_t SgRandom::Int(std::size_t range)
 {
     SG_ASSERT(range <= SgRandom::Max());
-    std::size_t i = Int() % range;
+    std::size_t i;
+    if (m_engine == SG_RANDOM_MT19937)
+        i = Int() % range;
+    else
+        i = MultiplyShift(static_cast<uint32_t>(range));
     SG_ASSERT(i < range);
     return i;
 }
@@ -167,6 +269,28 @@ inline unsigned int SgRandom::Max()
     return m_generator.max();
 }
 
+inline uint32_t SgRandom::MultiplyShift(uint32_t range)
+{
+    uint64_t m = uint64_t(Int()) * range;
+    uint32_t low = static_cast<uint32_t>(m);
+    if (low < range)
+    {
+        // Rejection is needed with probability range / 2^32 at most
+        const uint32_t threshold = (0u - range) % range;
+        while (low < threshold)
+        {
+            m = uint64_t(Int()) * range;
+            low = static_cast<uint32_t>(m);
+        }
+    }
+    return static_cast<uint32_t>(m >> 32);
+}
+
+inline uint64_t SgRandom::NuDraws() const
+{
+    return m_nuFill * BUFFER_SIZE - (BUFFER_SIZE - m_bufferIndex);
+}
+
 inline unsigned int SgRandom::PercentageThreshold(int percentage)
 {
     return (m_generator.max() / 100) * percentage;
@@ -186,7 +310,11 @@ inline int SgRandom::SmallInt(int range)
 {
     SG_ASSERT(range > 0);
     SG_ASSERT(range <= (1 << 16));
-    int i = ((Int() & 0xffff) * range) >> 16;
+    int i;
+    if (m_engine == SG_RANDOM_MT19937)
+        i = ((Int() & 0xffff) * range) >> 16;
+    else
+        i = MultiplyShift(range);
     SG_ASSERTRANGE(i, 0, range - 1);
     return i;
 }
@@ -194,7 +322,11 @@ inline int SgRandom::SmallInt(int range)
 inline std::size_t SgRandom::SmallInt(std::size_t range)
 {
     SG_ASSERT(range <= (1 << 16));
-    std::size_t i = ((Int() & 0xffff) * range) >> 16;
+    std::size_t i;
+    if (m_engine == SG_RANDOM_MT19937)
+        i = ((Int() & 0xffff) * range) >> 16;
+    else
+        i = MultiplyShift(static_cast<uint32_t>(range));
     SG_ASSERT(i < range);
     return i;
 }
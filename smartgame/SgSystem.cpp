@@ -12,6 +12,9 @@
 #include <iostream>
 #include <limits>
 #include <list>
+#ifndef SG_THREAD_LOCAL
+#include <boost/thread/tss.hpp>
+#endif
 #include "SgTime.h"
 
 using namespace std;
@@ -38,6 +41,50 @@ namespace {
 
 volatile bool s_userAbort = false;
 
+#ifdef SG_THREAD_LOCAL
+
+/** User abort flag of the current thread, 0 for s_userAbort. */
+SG_THREAD_LOCAL volatile bool* s_userAbortFlag = 0;
+
+inline volatile bool* GetUserAbortFlag()
+{
+    return s_userAbortFlag;
+}
+
+inline void SetUserAbortFlag(volatile bool* flag)
+{
+    s_userAbortFlag = flag;
+}
+
+#else
+
+/** The flag is owned by the code that installed it. */
+void NoCleanup(volatile bool* flag)
+{
+    SG_UNUSED(flag);
+}
+
+/** User abort flag of the current thread, 0 for s_userAbort.
+    A function-local static, such that it is constructed before the first
+    use. */
+boost::thread_specific_ptr<volatile bool>& UserAbortFlag()
+{
+    static boost::thread_specific_ptr<volatile bool> s_flag(NoCleanup);
+    return s_flag;
+}
+
+inline volatile bool* GetUserAbortFlag()
+{
+    return UserAbortFlag().get();
+}
+
+inline void SetUserAbortFlag(volatile bool* flag)
+{
+    UserAbortFlag().reset(flag);
+}
+
+#endif // SG_THREAD_LOCAL
+
 /** Assertion handlers.
     Stored in a static function variable to ensure, that they exist at
     first usage, if this function is called from global variables in
@@ -86,12 +133,23 @@ void SgHandleAssertion(const char* expr, const char* file, int line)
 
 void SgSetUserAbort(bool aborted)
 {
-    s_userAbort = aborted;
+    *SgUserAbortFlag() = aborted;
+}
+
+void SgSetUserAbortFlag(volatile bool* flag)
+{
+    SetUserAbortFlag(flag);
 }
 
 bool SgUserAbort()
 {
-    return s_userAbort;
+    return *SgUserAbortFlag();
+}
+
+volatile bool* SgUserAbortFlag()
+{
+    volatile bool* flag = GetUserAbortFlag();
+    return (flag == 0 ? &s_userAbort : flag);
 }
 
 //----------------------------------------------------------------------------
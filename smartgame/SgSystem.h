@@ -53,6 +53,24 @@ inline void SG_UNUSED(const T&)
 #define SG_ATTR_FLATTEN
 #endif
 
+/** Qualifier for pointers that do not alias other pointers.
+    Allows the compiler to vectorize loops over arrays accessed through
+    such pointers without runtime overlap checks. */
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define SG_RESTRICT __restrict
+#else
+#define SG_RESTRICT
+#endif
+
+/** Storage class for variables with one instance per thread.
+    Only defined if supported by the compiler, only for variables of POD
+    types without dynamic initialization. */
+#if defined(__GNUC__)
+#define SG_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define SG_THREAD_LOCAL __declspec(thread)
+#endif
+
 //----------------------------------------------------------------------------
 /** Deterministic mode gives reproducible search results */
 namespace SgDeterministic
@@ -153,6 +171,21 @@ void SgSetUserAbort(bool aborted);
     @see SgSetUserAbort. */
 bool SgUserAbort();
 
+/** Use a different user abort flag in the current thread.
+    By default, all threads share one global flag. Programs that run
+    independent tasks in one process, like several games in the server
+    mode of Fuego, can give each task its own flag, such that aborting one
+    task does not abort the others. SgSetUserAbort() and SgUserAbort() use
+    the flag of the current thread, so the flag must be set in all threads
+    that work for the task. Code that hands work to other threads passes
+    them the flag with SgUserAbortFlag() (see SgUctSearch).
+    @param flag The flag, 0 for the global flag. */
+void SgSetUserAbortFlag(volatile bool* flag);
+
+/** The user abort flag of the current thread.
+    @see SgSetUserAbortFlag() */
+volatile bool* SgUserAbortFlag();
+
 //----------------------------------------------------------------------------
 
 inline void SgSynchronizeThreadMemory()
@@ -7,6 +7,12 @@
 #define SG_TIME_H
 
 #include <string>
+#include <stdint.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#include <x86intrin.h>
+#endif
 
 //----------------------------------------------------------------------------
 
@@ -47,6 +53,28 @@ namespace SgTime
     /** Get today's date in a format compatible with the DT property
         of the SGF standard. */
     std::string TodaysDate();
+
+    /** Read a fast hardware tick counter.
+        Uses the time stamp counter on x86 and the virtual counter on ARM64.
+        Intended for profiling short code sections with low overhead; only
+        differences between two calls on the same thread are meaningful, and
+        the tick frequency is platform-dependent. On other platforms, falls
+        back to Get(SG_TIME_REAL) in nanoseconds, which is much slower. */
+    uint64_t Ticks();
+}
+
+inline uint64_t SgTime::Ticks()
+{
+#if defined(_MSC_VER) || \
+    (defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)))
+    return __rdtsc();
+#elif defined(__GNUC__) && defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return static_cast<uint64_t>(Get(SG_TIME_REAL) * 1e9);
+#endif
 }
 
 //----------------------------------------------------------------------------
@@ -198,6 +198,7 @@ void SgUctSearch::Thread::operator()()
         m_startPlay.wait(lock);
         if (m_quit)
             break;
+        SgSetUserAbortFlag(m_search.m_userAbortFlag);
         m_search.SearchLoop(*m_state, &m_globalLock);
         Notify(m_playFinishedMutex, m_playFinished);
     }
@@ -253,6 +254,7 @@ SgUctSearch::SgUctSearch(SgUctThreadStateFactory* threadStateFactory,
       m_rave(false),
       m_knowledgeThreshold(),
       m_maxKnowledgeThreads(1024),
+      m_userAbortFlag(0),
       m_moveSelect(SG_UCTMOVESELECT_COUNT),
       m_raveCheckSame(false),
       m_randomizeRaveFrequency(20),
@@ -1094,6 +1096,7 @@ SgUctValue SgUctSearch::Search(SgUctValue maxGames, double maxTime,
 {
     m_timer.Start();
     m_rootFilter = rootFilter;
+    m_userAbortFlag = SgUserAbortFlag();
     if (m_logGames)
     {
         m_log.open(m_mpiSynchronizer->ToNodeFilename(m_logFileName).c_str());
@@ -981,6 +981,10 @@ private:
     
     volatile bool m_isTreeOutOfMemory;
 
+    /** User abort flag of the thread that called Search().
+        Used by the search threads, see SgSetUserAbortFlag(). */
+    volatile bool* m_userAbortFlag;
+
     std::auto_ptr<boost::barrier> m_searchLoopFinished;
 
     /** See SgUctEarlyAbortParam. */
@@ -0,0 +1,288 @@
+//----------------------------------------------------------------------------
+/** @file SgBookBuilderTest.cpp
+    Unit tests for SgBookBuilder. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <map>
+#include <set>
+#include <sstream>
+#include <vector>
+#include <boost/test/auto_unit_test.hpp>
+#include "SgBookBuilder.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Book builder for an artificial game.
+    Each state has NU_MOVES moves, the game ends after MAX_DEPTH moves. The
+    heuristic value of a state is a pseudo-random number computed from the
+    moves. */
+class TestBookBuilder
+    : public SgBookBuilder
+{
+public:
+    static const int NU_MOVES = 5;
+
+    static const size_t MAX_DEPTH = 8;
+
+    typedef map<vector<SgMove>,SgBookNode> Book;
+
+    Book m_book;
+
+    /** Number of states of each call of GenerateMovesForStates(). */
+    vector<size_t> m_batchSizes;
+
+    TestBookBuilder();
+
+    float InverseEval(float eval) const;
+
+    bool IsLoss(float eval) const;
+
+    float Value(const SgBookNode& node) const;
+
+protected:
+    string MoveString(SgMove move) const;
+
+    void PrintMessage(string msg);
+
+    void PlayMove(SgMove move);
+
+    void UndoMove(SgMove move);
+
+    bool GetNode(SgBookNode& node) const;
+
+    void WriteNode(const SgBookNode& node);
+
+    void FlushBook();
+
+    void EnsureRootExists();
+
+    bool GenerateMoves(size_t count, vector<SgMove>& moves, float& value);
+
+    void GetAllLegalMoves(vector<SgMove>& moves);
+
+    void EvaluateChildren(const vector<SgMove>& childrenToDo,
+                          vector<pair<SgMove, float> >& scores);
+
+    void GenerateMovesForStates(const vector< vector<SgMove> >& lines,
+                                size_t count,
+                                vector< vector<SgMove> >& moves,
+                                vector<bool>& determined,
+                                vector<float>& values);
+
+    void ClearAllVisited();
+
+    void MarkAsVisited();
+
+    bool HasBeenVisited();
+
+private:
+    vector<SgMove> m_line;
+
+    set< vector<SgMove> > m_visited;
+
+    static float Evaluate(const vector<SgMove>& line);
+};
+
+TestBookBuilder::TestBookBuilder()
+{
+    SetExpandWidth(3);
+    SetExpandThreshold(4);
+}
+
+float TestBookBuilder::Evaluate(const vector<SgMove>& line)
+{
+    unsigned int hash = 12345;
+    for (size_t i = 0; i < line.size(); ++i)
+        hash = (hash ^ static_cast<unsigned int>(line[i] + 7)) * 16777619u;
+    return float(hash % 10007) / 10007.f;
+}
+
+float TestBookBuilder::InverseEval(float eval) const
+{
+    return 1.f - eval;
+}
+
+bool TestBookBuilder::IsLoss(float eval) const
+{
+    return eval < -100;
+}
+
+float TestBookBuilder::Value(const SgBookNode& node) const
+{
+    return node.m_value;
+}
+
+string TestBookBuilder::MoveString(SgMove move) const
+{
+    ostringstream os;
+    os << move;
+    return os.str();
+}
+
+void TestBookBuilder::PrintMessage(string msg)
+{
+    SG_UNUSED(msg);
+}
+
+void TestBookBuilder::PlayMove(SgMove move)
+{
+    m_line.push_back(move);
+}
+
+void TestBookBuilder::UndoMove(SgMove move)
+{
+    SG_UNUSED(move);
+    m_line.pop_back();
+}
+
+bool TestBookBuilder::GetNode(SgBookNode& node) const
+{
+    Book::const_iterator it = m_book.find(m_line);
+    if (it == m_book.end())
+        return false;
+    node = it->second;
+    return true;
+}
+
+void TestBookBuilder::WriteNode(const SgBookNode& node)
+{
+    m_book[m_line] = node;
+}
+
+void TestBookBuilder::FlushBook()
+{ }
+
+void TestBookBuilder::EnsureRootExists()
+{
+    SgBookNode root;
+    if (! GetNode(root))
+        WriteNode(SgBookNode(Evaluate(m_line)));
+}
+
+bool TestBookBuilder::GenerateMoves(size_t count, vector<SgMove>& moves,
+                                    float& value)
+{
+    SG_UNUSED(count);
+    SG_UNUSED(value);
+    GetAllLegalMoves(moves);
+    return false;
+}
+
+void TestBookBuilder::GetAllLegalMoves(vector<SgMove>& moves)
+{
+    if (m_line.size() < MAX_DEPTH)
+        for (int i = 0; i < NU_MOVES; ++i)
+            moves.push_back(i);
+}
+
+void TestBookBuilder::EvaluateChildren(const vector<SgMove>& childrenToDo,
+                                       vector<pair<SgMove, float> >& scores)
+{
+    for (size_t i = 0; i < childrenToDo.size(); ++i)
+    {
+        PlayMove(childrenToDo[i]);
+        scores.push_back(make_pair(childrenToDo[i], Evaluate(m_line)));
+        UndoMove(childrenToDo[i]);
+    }
+}
+
+void TestBookBuilder::GenerateMovesForStates(
+                                        const vector< vector<SgMove> >& lines,
+                                        size_t count,
+                                        vector< vector<SgMove> >& moves,
+                                        vector<bool>& determined,
+                                        vector<float>& values)
+{
+    m_batchSizes.push_back(lines.size());
+    SgBookBuilder::GenerateMovesForStates(lines, count, moves, determined,
+                                          values);
+}
+
+void TestBookBuilder::ClearAllVisited()
+{
+    m_visited.clear();
+}
+
+void TestBookBuilder::MarkAsVisited()
+{
+    m_visited.insert(m_line);
+}
+
+bool TestBookBuilder::HasBeenVisited()
+{
+    return m_visited.count(m_line) == 1;
+}
+
+/** Batch expansion of a single leaf selects the same leaf as the
+    expansion without batches. */
+BOOST_AUTO_TEST_CASE(SgBookBuilderTest_BatchOfOne)
+{
+    TestBookBuilder builder;
+    builder.Expand(30);
+    TestBookBuilder batchBuilder;
+    batchBuilder.SetExpandBatchSize(4);
+    for (int i = 0; i < 30; ++i)
+        batchBuilder.Expand(1);
+    BOOST_CHECK_EQUAL(batchBuilder.m_batchSizes.size(), 30u);
+    BOOST_CHECK(batchBuilder.m_book.size() == builder.m_book.size());
+    TestBookBuilder::Book::const_iterator it = builder.m_book.begin();
+    TestBookBuilder::Book::const_iterator batchIt =
+        batchBuilder.m_book.begin();
+    for ( ; it != builder.m_book.end(); ++it, ++batchIt)
+    {
+        BOOST_REQUIRE(it->first == batchIt->first);
+        BOOST_CHECK_EQUAL(it->second.ToString(), batchIt->second.ToString());
+    }
+}
+
+/** Batch expansion expands several leaves in each iteration and leaves the
+    book in the same state as a refresh. */
+BOOST_AUTO_TEST_CASE(SgBookBuilderTest_Batch)
+{
+    TestBookBuilder builder;
+    builder.SetExpandBatchSize(4);
+    builder.Expand(40);
+    BOOST_CHECK_EQUAL(builder.NumLeavesExpanded(), 40u);
+    // The root is the only leaf in the first iteration, then it has three
+    // leaves
+    BOOST_REQUIRE(builder.m_batchSizes.size() >= 3);
+    BOOST_CHECK_EQUAL(builder.m_batchSizes[0], 1u);
+    BOOST_CHECK_EQUAL(builder.m_batchSizes[1], 3u);
+    BOOST_CHECK_EQUAL(builder.m_batchSizes[2], 4u);
+    size_t total = 0;
+    for (size_t i = 0; i < builder.m_batchSizes.size(); ++i)
+        total += builder.m_batchSizes[i];
+    BOOST_CHECK_EQUAL(total, 40u);
+    const SgBookNode& root = builder.m_book[vector<SgMove>()];
+    BOOST_CHECK_EQUAL(root.m_count, 40u);
+    // Each expanded leaf has children
+    size_t nuInternal = 0;
+    for (TestBookBuilder::Book::const_iterator it = builder.m_book.begin();
+         it != builder.m_book.end(); ++it)
+        if (! it->second.IsLeaf())
+        {
+            ++nuInternal;
+            vector<SgMove> child(it->first);
+            child.push_back(0);
+            BOOST_CHECK(builder.m_book.count(child) == 1);
+        }
+    BOOST_CHECK_EQUAL(nuInternal, 40u);
+    // No priorities or values changed by the selection remain
+    const TestBookBuilder::Book book = builder.m_book;
+    builder.Refresh();
+    BOOST_CHECK(book.size() == builder.m_book.size());
+    for (TestBookBuilder::Book::const_iterator it = book.begin();
+         it != book.end(); ++it)
+        BOOST_CHECK_EQUAL(it->second.ToString(),
+                          builder.m_book[it->first].ToString());
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
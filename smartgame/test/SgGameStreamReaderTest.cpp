@@ -0,0 +1,228 @@
+//----------------------------------------------------------------------------
+/** @file SgGameStreamReaderTest.cpp
+    Unit tests for SgGameStreamReader. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <boost/test/auto_unit_test.hpp>
+#include "SgException.h"
+#include "SgGameReader.h"
+#include "SgGameStreamReader.h"
+#include "SgNode.h"
+
+using namespace std;
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Writes the calls of the handler functions to a string. */
+class LogHandler
+    : public SgGameStreamHandler
+{
+public:
+    ostringstream m_log;
+
+    int m_nuMoves;
+
+    LogHandler();
+
+    void BeginFile(const string& fileName);
+
+    void BeginGame(int boardSize);
+
+    void EndGame();
+
+    void BeginNode();
+
+    void Move(SgBlackWhite color, SgPoint move);
+
+    void Setup(SgBoardColor color, SgPoint p);
+
+    void Property(const string& label, const vector<string>& values);
+
+    void BeginVariation();
+
+    void EndVariation();
+};
+
+LogHandler::LogHandler()
+    : m_nuMoves(0)
+{ }
+
+void LogHandler::BeginFile(const string& fileName)
+{
+    SG_UNUSED(fileName);
+    m_log << "file ";
+}
+
+void LogHandler::BeginGame(int boardSize)
+{
+    m_log << "game " << boardSize << ' ';
+}
+
+void LogHandler::EndGame()
+{
+    m_log << "end";
+}
+
+void LogHandler::BeginNode()
+{
+    m_log << "; ";
+}
+
+void LogHandler::Move(SgBlackWhite color, SgPoint move)
+{
+    ++m_nuMoves;
+    m_log << SgBW(color) << SgWritePoint(move) << ' ';
+}
+
+void LogHandler::Setup(SgBoardColor color, SgPoint p)
+{
+    m_log << "A" << SgEBW(color) << SgWritePoint(p) << ' ';
+}
+
+void LogHandler::Property(const string& label, const vector<string>& values)
+{
+    m_log << label;
+    for (vector<string>::const_iterator it = values.begin();
+         it != values.end(); ++it)
+        m_log << '[' << *it << ']';
+    m_log << ' ';
+}
+
+void LogHandler::BeginVariation()
+{
+    m_log << "( ";
+}
+
+void LogHandler::EndVariation()
+{
+    m_log << ") ";
+}
+
+const char* const TREE =
+    "(;FF[4]SZ[9];B[ee]C[a [\\] comment](;W[aa];B[tt])(;W[bb]\n(;B[])"
+    "(;B[cc])))";
+
+BOOST_AUTO_TEST_CASE(SgGameStreamReaderTest_Variations)
+{
+    istringstream in(TREE);
+    SgGameStreamReader reader(in);
+    LogHandler handler;
+    BOOST_CHECK(reader.ReadGame(handler));
+    BOOST_CHECK_EQUAL(handler.m_log.str(),
+                      "game 9 ; FF[4] SZ[9] ; BE5 C[a [\\] comment] "
+                      "( ; WA9 ; BPASS ) ( ; WB8 ( ; BPASS ) ( ; BC7 ) ) "
+                      "end");
+    BOOST_CHECK(reader.GetWarnings().none());
+    BOOST_CHECK(! reader.ReadGame(handler));
+}
+
+BOOST_AUTO_TEST_CASE(SgGameStreamReaderTest_MainLineOnly)
+{
+    istringstream in(TREE);
+    SgGameStreamReader reader(in);
+    reader.SetMainLineOnly(true);
+    LogHandler handler;
+    BOOST_CHECK(reader.ReadGame(handler));
+    BOOST_CHECK_EQUAL(handler.m_log.str(),
+                      "game 9 ; FF[4] SZ[9] ; BE5 C[a [\\] comment] "
+                      "; WA9 ; BPASS end");
+}
+
+/** Same moves as SgGameReader. */
+BOOST_AUTO_TEST_CASE(SgGameStreamReaderTest_SameAsGameReader)
+{
+    const string game =
+        "(;FF[4]CA[ISO8859_1]GN[no-warnings]SZ[9]KM[6.5]"
+        ";B[ee];W[ce];B[ec];W[dg];B[fg];W[gc];B[gb];W[fb];B[fc];W[hb]"
+        ";B[gd];W[hc];B[hd];W[dh];B[cd];W[bd];B[de];W[cf];B[eh];W[cc]"
+        ";B[aa];W[ae];B[df];W[cg];B[tt];W[tt])";
+    istringstream in(game);
+    SgGameReader reader(in);
+    SgNode* root = reader.ReadGame();
+    BOOST_REQUIRE(root != 0);
+    ostringstream expected;
+    for (const SgNode* node = root; node != 0; node = node->LeftMostSon())
+        if (node->HasNodeMove())
+            expected << SgBW(node->NodePlayer())
+                     << SgWritePoint(node->NodeMove()) << ' ';
+    root->DeleteTree();
+    istringstream streamIn(game);
+    SgGameStreamReader streamReader(streamIn);
+    LogHandler handler;
+    BOOST_CHECK(streamReader.ReadGame(handler));
+    BOOST_CHECK(streamReader.GetWarnings().none());
+    BOOST_CHECK_EQUAL(handler.m_nuMoves, 26);
+    string log = handler.m_log.str();
+    string moves;
+    istringstream logIn(log);
+    string token;
+    while (logIn >> token)
+        if (token[0] == 'B' || token[0] == 'W')
+            moves += token + ' ';
+    BOOST_CHECK_EQUAL(moves, expected.str());
+}
+
+/** Points are interpreted correctly if SZ comes after point values, unlike
+    SgGameReader. */
+BOOST_AUTO_TEST_CASE(SgGameStreamReaderTest_SizeAfterPoints)
+{
+    istringstream in("(;AB[aa][ab]AE[aa:bb]SZ[9])");
+    SgGameStreamReader reader(in);
+    LogHandler handler;
+    BOOST_CHECK(reader.ReadGame(handler));
+    BOOST_CHECK_EQUAL(handler.m_log.str(),
+                      "game 9 ; ABA9 ABA8 AEA8 AEB8 AEA9 AEB9 SZ[9] end");
+}
+
+BOOST_AUTO_TEST_CASE(SgGameStreamReaderTest_SeveralGames)
+{
+    istringstream in("junk ( ) (;SZ[999]C;B[aa]) x (;W[aa]AB[zz]");
+    SgGameStreamReader reader(in);
+    LogHandler handler;
+    BOOST_CHECK_EQUAL(reader.ReadGames(handler), 2);
+    BOOST_CHECK_EQUAL(handler.m_log.str(),
+                      "game 19 ; SZ[999] C ; BA19 endgame 19 ; WA19 end");
+    BOOST_CHECK(reader.GetWarnings().test(SgGameReader::INVALID_BOARDSIZE));
+    BOOST_CHECK(
+              reader.GetWarnings().test(SgGameReader::PROPERTY_WITHOUT_VALUE));
+}
+
+BOOST_AUTO_TEST_CASE(SgGameStreamReaderTest_ReadFiles)
+{
+    const char* fileNames[] = { "SgGameStreamReaderTest1.tmp",
+                                "SgGameStreamReaderTest2.tmp",
+                                "SgGameStreamReaderTest3.tmp" };
+    vector<string> files;
+    for (int i = 0; i < 3; ++i)
+    {
+        ofstream out(fileNames[i]);
+        for (int j = 0; j <= i; ++j)
+            out << "(;SZ[9];B[aa];W[bb](;B[cc])(;B[dd]))\n";
+        files.push_back(fileNames[i]);
+    }
+    LogHandler handler1;
+    LogHandler handler2;
+    vector<SgGameStreamHandler*> handlers;
+    handlers.push_back(&handler1);
+    handlers.push_back(&handler2);
+    BOOST_CHECK_EQUAL(SgGameStreamReader::ReadFiles(files, handlers, true),
+                      6);
+    BOOST_CHECK_EQUAL(handler1.m_nuMoves + handler2.m_nuMoves, 18);
+    files.push_back("SgGameStreamReaderTest_Missing.tmp");
+    BOOST_CHECK_THROW(SgGameStreamReader::ReadFiles(files, handlers),
+                      SgException);
+    for (int i = 0; i < 3; ++i)
+        remove(fileNames[i]);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,101 @@
+//----------------------------------------------------------------------------
+/** @file SgNodeArenaTest.cpp
+    Unit tests for SgNodeArena. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "SgNode.h"
+#include "SgNodeArena.h"
+#include "SgProp.h"
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+//----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(SgNodeArenaTest_Scope)
+{
+    BOOST_CHECK(SgNodeArena::Current() == 0);
+    SgNodeArena arena;
+    {
+        SgNodeArena::Scope scope(arena);
+        BOOST_CHECK_EQUAL(SgNodeArena::Current(), &arena);
+        SgNodeArena inner;
+        {
+            SgNodeArena::Scope innerScope(inner);
+            BOOST_CHECK_EQUAL(SgNodeArena::Current(), &inner);
+        }
+        BOOST_CHECK_EQUAL(SgNodeArena::Current(), &arena);
+    }
+    BOOST_CHECK(SgNodeArena::Current() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(SgNodeArenaTest_Tree)
+{
+    SgNodeArena arena(1024);
+    SgNode* root;
+    {
+        SgNodeArena::Scope scope(arena);
+        root = new SgNode();
+        root->Add(new SgPropInt(SG_PROP_SIZE, 9));
+        SgNode* node = root;
+        for (int i = 0; i < 100; ++i)
+        {
+            node = node->NewRightMostSon();
+            node->AddComment("comment");
+        }
+        // 101 nodes and 101 properties
+        BOOST_CHECK_EQUAL(arena.NuObjects(), 202u);
+        BOOST_CHECK(arena.NuBytes() > 1024);
+    }
+    // Objects from the heap and the arena can be mixed, and objects from
+    // the arena can be deleted after the scope ended
+    root->NewRightMostSon();
+    BOOST_CHECK_EQUAL(arena.NuObjects(), 202u);
+    BOOST_CHECK_EQUAL(root->RightMostSon()->Father(), root);
+    root->DeleteTree();
+    BOOST_CHECK_EQUAL(arena.NuObjects(), 0u);
+    arena.Clear();
+    BOOST_CHECK_EQUAL(arena.NuBytes(), 1024u);
+}
+
+BOOST_AUTO_TEST_CASE(SgNodeArenaTest_LargeObject)
+{
+    SgNodeArena arena(1024);
+    void* small;
+    void* large;
+    {
+        SgNodeArena::Scope scope(arena);
+        small = SgNodeArena::Allocate(16);
+        large = SgNodeArena::Allocate(4000);
+    }
+    BOOST_CHECK_EQUAL(arena.NuObjects(), 2u);
+    BOOST_CHECK(arena.NuBytes() >= 1024 + 4000);
+    SgNodeArena::Free(small);
+    SgNodeArena::Free(large);
+    BOOST_CHECK_EQUAL(arena.NuObjects(), 0u);
+    arena.Clear();
+    BOOST_CHECK_EQUAL(arena.NuBytes(), 1024u);
+}
+
+BOOST_AUTO_TEST_CASE(SgNodeArenaTest_Heap)
+{
+    SgNodeArena arena;
+    SgNode* node = new SgNode();
+    BOOST_CHECK_EQUAL(arena.NuObjects(), 0u);
+    {
+        SgNodeArena::Scope scope(arena);
+        delete node;
+    }
+    BOOST_CHECK_EQUAL(arena.NuObjects(), 0u);
+    SgNodeArena::Free(0);
+}
+
+//----------------------------------------------------------------------------
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -12,6 +12,88 @@
 
 namespace {
 
+/** Restores the global random engine and seed at end of test. */
+class EngineRestorer
+{
+public:
+    EngineRestorer()
+        : m_engine(SgRandom::Engine()),
+          m_seed(SgRandom::Seed())
+    { }
+
+    ~EngineRestorer()
+    {
+        SgRandom::SetEngine(m_engine);
+        SgRandom::SetSeed(m_seed == 0 ? -1 : m_seed);
+    }
+
+private:
+    SgRandomEngine m_engine;
+
+    int m_seed;
+};
+
+/** Check that engine SG_RANDOM_MT19937 reproduces the sequences of
+    boost::mt19937, which are used in the regression tests of the
+    deterministic mode. */
+BOOST_AUTO_TEST_CASE(SgRandomTestEngineMT19937)
+{
+    EngineRestorer restorer;
+    SgRandom::SetEngine(SG_RANDOM_MT19937);
+    SgRandom::SetSeed(1);
+    SgRandom r;
+    boost::mt19937 generator(1);
+    for (int i = 0; i < 1000; ++i)
+        BOOST_CHECK_EQUAL(r.Int(), generator());
+    for (int i = 0; i < 1000; ++i)
+        BOOST_CHECK_EQUAL(r.SmallInt(361),
+                          int(((generator() & 0xffff) * 361) >> 16));
+}
+
+BOOST_AUTO_TEST_CASE(SgRandomTestIntRange)
+{
+    EngineRestorer restorer;
+    SgRandom::SetEngine(SG_RANDOM_XOSHIRO128);
+    SgRandom r;
+    int count[3] = { 0, 0, 0 };
+    for (int i = 0; i < 3000; ++i)
+    {
+        int n = r.Int(3);
+        BOOST_REQUIRE(n >= 0 && n < 3);
+        ++count[n];
+        n = r.SmallInt(i + 1);
+        BOOST_CHECK(n >= 0 && n <= i);
+        BOOST_CHECK_LT(r.Int(std::size_t(i + 1)), std::size_t(i + 1));
+    }
+    for (int i = 0; i < 3; ++i)
+        BOOST_CHECK(count[i] > 800);
+}
+
+BOOST_AUTO_TEST_CASE(SgRandomTestNuDraws)
+{
+    SgRandom r;
+    BOOST_CHECK_EQUAL(r.NuDraws(), 0u);
+    for (int i = 0; i < 100; ++i)
+        r.Int();
+    BOOST_CHECK_EQUAL(r.NuDraws(), 100u);
+}
+
+/** Check that setting the seed makes both engines reproducible. */
+BOOST_AUTO_TEST_CASE(SgRandomTestSetSeed)
+{
+    EngineRestorer restorer;
+    for (int i = 0; i < 2; ++i)
+    {
+        SgRandom::SetEngine(i == 0 ? SG_RANDOM_MT19937 : SG_RANDOM_XOSHIRO128);
+        SgRandom r;
+        SgRandom::SetSeed(17);
+        unsigned int n1 = r.Int();
+        r.Int();
+        SgRandom::SetSeed(17);
+        BOOST_CHECK_EQUAL(r.Int(), n1);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(SgRandomTestFloat_01)
 {
     SgRandom r;
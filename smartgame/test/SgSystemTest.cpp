@@ -7,6 +7,7 @@
 
 #include <bitset>
 #include <boost/test/auto_unit_test.hpp>
+#include <boost/thread/thread.hpp>
 
 using namespace std;
 
@@ -29,6 +30,43 @@ BOOST_AUTO_TEST_CASE(SgSystemTestGccBitSetBug)
     BOOST_CHECK(set1.test(0));
 }
 
+/** Polls SgUserAbort() in another thread. */
+struct PollUserAbort
+{
+    bool& m_result;
+
+    PollUserAbort(bool& result)
+        : m_result(result)
+    { }
+
+    void operator()()
+    {
+        m_result = SgUserAbort();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(SgSystemTest_UserAbortFlag)
+{
+    volatile bool* globalFlag = SgUserAbortFlag();
+    BOOST_REQUIRE(globalFlag != 0);
+    BOOST_REQUIRE(! SgUserAbort());
+    volatile bool flag = false;
+    SgSetUserAbortFlag(&flag);
+    BOOST_CHECK(SgUserAbortFlag() == &flag);
+    SgSetUserAbort(true);
+    BOOST_CHECK(flag);
+    BOOST_CHECK(SgUserAbort());
+    BOOST_CHECK(! *globalFlag);
+    // Other threads still use the global flag
+    bool result = true;
+    boost::thread thread((PollUserAbort(result)));
+    thread.join();
+    BOOST_CHECK(! result);
+    SgSetUserAbortFlag(0);
+    BOOST_CHECK(SgUserAbortFlag() == globalFlag);
+    BOOST_CHECK(! SgUserAbort());
+}
+
 } // namespace
 
 //----------------------------------------------------------------------------